@@ -17,10 +17,23 @@ QT += widgets
 QT += printsupport 
 QT += charts
 QT += svg
+QT += concurrent
 QT += testlib
 # testlib only needed to use QTest::qWait in Chart::getPixmap()...
 
 INCLUDEPATH  += ./src
+
+# Optional decompression of gzip and zstd compressed network files
+CONFIG += link_pkgconfig
+packagesExist(zlib) {
+    PKGCONFIG += zlib
+    DEFINES += SOCNETV_HAVE_ZLIB
+}
+packagesExist(libzstd) {
+    PKGCONFIG += libzstd
+    DEFINES += SOCNETV_HAVE_ZSTD
+}
+
 FORMS += src/forms/dialogfilteredgesbyweight.ui \
     src/forms/dialogsettings.ui \
     src/forms/dialogwebcrawler.ui \
@@ -47,11 +60,14 @@ HEADERS += src/mainwindow.h \
     src/matrix.h \
     src/parser.h \
     src/webcrawler.h \
+    src/layoutrunner.h \
     src/chart.h \
     src/graphicswidget.h \
     src/graphicsedge.h \
     src/graphicsedgeweight.h \
     src/graphicsedgelabel.h \
+    src/graphicsedgelayer.h \
+    src/edgekeymap.h \
     src/graphicsguide.h \
     src/graphicsnode.h \
     src/graphicsnodelabel.h \
@@ -85,11 +101,13 @@ SOURCES += src/main.cpp \
     src/matrix.cpp \
     src/parser.cpp \
     src/webcrawler.cpp \
+    src/layoutrunner.cpp \
     src/chart.cpp \
     src/graphicswidget.cpp \
     src/graphicsedge.cpp \
     src/graphicsedgeweight.cpp \
     src/graphicsedgelabel.cpp \
+    src/graphicsedgelayer.cpp \
     src/graphicsguide.cpp \
     src/graphicsnode.cpp \
     src/graphicsnodelabel.cpp \
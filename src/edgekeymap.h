@@ -0,0 +1,258 @@
+/***************************************************************************
+ SocNetV: Social Network Visualizer
+ version: 2.5
+ Written in Qt
+
+                         edgekeymap.h  -  description
+                             -------------------
+    copyright         : (C) 2005-2019 by Dimitris B. Kalamaras
+    project site      : https://socnetv.org
+
+ ***************************************************************************/
+
+/*******************************************************************************
+*     This program is free software: you can redistribute it and/or modify     *
+*     it under the terms of the GNU General Public License as published by     *
+*     the Free Software Foundation, either version 3 of the License, or        *
+*     (at your option) any later version.                                      *
+*                                                                              *
+*     This program is distributed in the hope that it will be useful,          *
+*     but WITHOUT ANY WARRANTY; without even the implied warranty of           *
+*     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            *
+*     GNU General Public License for more details.                             *
+*                                                                              *
+*     You should have received a copy of the GNU General Public License        *
+*     along with this program.  If not, see <http://www.gnu.org/licenses/>.    *
+********************************************************************************/
+
+#ifndef EDGEKEYMAP_H
+#define EDGEKEYMAP_H
+
+
+#include <QtGlobal>
+#include <QVector>
+#include <QString>
+
+
+/**
+ * Identity of a canvas edge: the relation, and the source and target node
+ * numbers packed in 64 bits, source in the high 32 bits. Every relation and
+ * node number has its own key. EDGE_KEY_NONE, with all bits set, marks
+ * empty slots; no edge has it, since node numbers are not negative.
+ */
+struct EdgeKey {
+    quint64 nodes;
+    quint32 relation;
+
+    bool operator==(const EdgeKey &o) const {
+        return nodes == o.nodes && relation == o.relation;
+    }
+    bool operator!=(const EdgeKey &o) const {
+        return !( *this == o );
+    }
+};
+Q_DECLARE_TYPEINFO(EdgeKey, Q_PRIMITIVE_TYPE);
+
+static const EdgeKey EDGE_KEY_NONE = { ~Q_UINT64_C(0), 0xFFFFFFFF };
+
+
+inline EdgeKey edgeKey(const int &relation, const int &source, const int &target) {
+    EdgeKey key;
+    key.nodes = ( (quint64) (quint32) source << 32 ) | (quint64) (quint32) target;
+    key.relation = (quint32) relation;
+    return key;
+}
+
+inline int edgeKeyRelation(const EdgeKey &key) {
+    return (int) key.relation;
+}
+
+inline int edgeKeySource(const EdgeKey &key) {
+    return (int) (quint32) ( key.nodes >> 32 );
+}
+
+inline int edgeKeyTarget(const EdgeKey &key) {
+    return (int) (quint32) key.nodes;
+}
+
+/**
+ * @brief Returns the key as "relation:source>target", for debug messages
+ */
+inline QString edgeKeyName(const EdgeKey &key) {
+    return QString::number(edgeKeyRelation(key)) + QString(":")
+            + QString::number(edgeKeySource(key)) + QString(">")
+            + QString::number(edgeKeyTarget(key));
+}
+
+
+
+/**
+ * @brief A flat hash map from EdgeKey to T, with open addressing.
+ * Keys and values live in two arrays of power-of-two size, probed linearly.
+ * Removal shifts the following entries back, so there are no tombstones.
+ * Copies are cheap, as the arrays are implicitly shared.
+ * Iterates like QHash, in no particular order.
+ */
+template <typename T>
+class EdgeKeyMap {
+
+public:
+    EdgeKeyMap() : m_count(0), m_mask(0) { }
+
+    class const_iterator {
+    public:
+        const_iterator() : m_map(0), m_slot(0) { }
+        const_iterator(const EdgeKeyMap<T> *map, int slot) : m_map(map), m_slot(slot) {
+            skip();
+        }
+        EdgeKey key() const { return m_map->m_keys[m_slot]; }
+        const T &value() const { return m_map->m_values[m_slot]; }
+        const T &operator*() const { return value(); }
+        const_iterator &operator++() { ++m_slot; skip(); return *this; }
+        bool operator==(const const_iterator &o) const { return m_slot == o.m_slot; }
+        bool operator!=(const const_iterator &o) const { return m_slot != o.m_slot; }
+    private:
+        void skip() {
+            while ( m_slot < m_map->m_keys.size()
+                    && m_map->m_keys[m_slot] == EDGE_KEY_NONE ) {
+                ++m_slot;
+            }
+        }
+        const EdgeKeyMap<T> *m_map;
+        int m_slot;
+    };
+
+    const_iterator begin() const { return const_iterator(this, 0); }
+    const_iterator end() const { return const_iterator(this, m_keys.size()); }
+    const_iterator constBegin() const { return begin(); }
+    const_iterator constEnd() const { return end(); }
+
+    int count() const { return m_count; }
+    bool isEmpty() const { return m_count == 0; }
+
+    void clear() {
+        m_keys.clear();
+        m_values.clear();
+        m_count = 0;
+        m_mask = 0;
+    }
+
+    void reserve(const int &size) {
+        int capacity = 16;
+        while ( capacity < size + size / 2 ) {
+            capacity *= 2;
+        }
+        if ( capacity > m_keys.size() ) {
+            rehash(capacity);
+        }
+    }
+
+    bool contains(const EdgeKey &key) const {
+        return find(key) >= 0;
+    }
+
+    T value(const EdgeKey &key, const T &defaultValue = T()) const {
+        int slot = find(key);
+        return ( slot < 0 ) ? defaultValue : m_values[slot];
+    }
+
+    void insert(const EdgeKey &key, const T &value) {
+        if ( ( m_count + 1 ) * 3 > m_keys.size() * 2 ) {
+            rehash( qMax(16, m_keys.size() * 2) );
+        }
+        int slot = (int) ( hash(key) & m_mask );
+        while ( m_keys[slot] != EDGE_KEY_NONE ) {
+            if ( m_keys[slot] == key ) {
+                m_values[slot] = value;
+                return;
+            }
+            slot = ( slot + 1 ) & m_mask;
+        }
+        m_keys[slot] = key;
+        m_values[slot] = value;
+        ++m_count;
+    }
+
+    T take(const EdgeKey &key) {
+        int slot = find(key);
+        if ( slot < 0 ) {
+            return T();
+        }
+        T value = m_values[slot];
+        erase(slot);
+        return value;
+    }
+
+    bool remove(const EdgeKey &key) {
+        int slot = find(key);
+        if ( slot < 0 ) {
+            return false;
+        }
+        erase(slot);
+        return true;
+    }
+
+private:
+    static quint32 hash(const EdgeKey &key) {
+        // 64-bit finalizer of MurmurHash3, the relation mixed in first
+        quint64 h = key.nodes ^ ( (quint64) key.relation * Q_UINT64_C(0x9e3779b97f4a7c15) );
+        h ^= h >> 33;
+        h *= Q_UINT64_C(0xff51afd7ed558ccd);
+        h ^= h >> 33;
+        h *= Q_UINT64_C(0xc4ceb9fe1a85ec53);
+        h ^= h >> 33;
+        return (quint32) h;
+    }
+
+    int find(const EdgeKey &key) const {
+        if ( m_count == 0 ) {
+            return -1;
+        }
+        int slot = (int) ( hash(key) & m_mask );
+        while ( m_keys[slot] != EDGE_KEY_NONE ) {
+            if ( m_keys[slot] == key ) {
+                return slot;
+            }
+            slot = ( slot + 1 ) & m_mask;
+        }
+        return -1;
+    }
+
+    void erase(int slot) {
+        // shift back the entries which probed past the freed slot
+        int next = ( slot + 1 ) & m_mask;
+        while ( m_keys[next] != EDGE_KEY_NONE ) {
+            int home = (int) ( hash(m_keys[next]) & m_mask );
+            if ( ( ( next - home ) & m_mask ) >= ( ( next - slot ) & m_mask ) ) {
+                m_keys[slot] = m_keys[next];
+                m_values[slot] = m_values[next];
+                slot = next;
+            }
+            next = ( next + 1 ) & m_mask;
+        }
+        m_keys[slot] = EDGE_KEY_NONE;
+        m_values[slot] = T();
+        --m_count;
+    }
+
+    void rehash(const int &capacity) {
+        QVector<EdgeKey> keys = m_keys;
+        QVector<T> values = m_values;
+        m_keys = QVector<EdgeKey>(capacity, EDGE_KEY_NONE);
+        m_values = QVector<T>(capacity, T());
+        m_mask = capacity - 1;
+        m_count = 0;
+        for (int i = 0; i < keys.size(); ++i) {
+            if ( keys[i] != EDGE_KEY_NONE ) {
+                insert(keys[i], values[i]);
+            }
+        }
+    }
+
+    QVector<EdgeKey> m_keys;
+    QVector<T> m_values;
+    int m_count;
+    int m_mask;
+};
+
+#endif
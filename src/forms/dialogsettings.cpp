@@ -62,6 +62,10 @@ DialogSettings::DialogSettings(QMap<QString, QString> &appSettings,
     //data export
     ui->dataDirEdit->setText(  (m_appSettings)["dataDir"]);
 
+    ui->saveInBackgroundChkBox->setChecked(
+                (appSettings["saveInBackground"] == "true") ? true:false
+                );
+
     ui->printLogoChkBox->setChecked(
                 (appSettings["printLogo"] == "true") ? true:false
                 );
@@ -161,6 +165,9 @@ DialogSettings::DialogSettings(QMap<QString, QString> &appSettings,
     ui->canvasEdgeHighlightingChkBox->setChecked(
                 (appSettings["canvasEdgeHighlighting"] == "true") ? true:false
                 );
+    ui->canvasEdgeLayerChkBox->setChecked(
+                (appSettings["canvasEdgeLayer"] == "true") ? true:false
+                );
 
 
     QStringList optionsList;
@@ -375,6 +382,9 @@ DialogSettings::DialogSettings(QMap<QString, QString> &appSettings,
           this, SLOT(getReportsChartType(const int &)) );
 
 
+    connect (ui->saveInBackgroundChkBox, &QCheckBox::toggled,
+             this, &DialogSettings::getSaveInBackground);
+
     connect (ui->printLogoChkBox, &QCheckBox::stateChanged,
              this, &DialogSettings::setPrintLogo);
 
@@ -426,6 +436,9 @@ DialogSettings::DialogSettings(QMap<QString, QString> &appSettings,
     connect (ui->canvasEdgeHighlightingChkBox, &QCheckBox::stateChanged,
              this, &DialogSettings::setCanvasEdgeHighlighting);
 
+    connect (ui->canvasEdgeLayerChkBox, &QCheckBox::stateChanged,
+             this, &DialogSettings::setCanvasEdgeLayer);
+
 
     connect(ui->canvasUpdateModeSelect, SIGNAL ( currentIndexChanged (const QString &)),
           this, SLOT(getCanvasUpdateMode(const QString &)) );
@@ -533,6 +546,16 @@ void DialogSettings::getDataDir(){
 
 
 
+/**
+ * @brief Get whether exported network files are written in the background
+ * @param toggle
+ */
+void DialogSettings::getSaveInBackground( const bool &toggle) {
+    m_appSettings["saveInBackground"]= (toggle) ? "true" : "false";
+    emit setSaveInBackground(toggle);
+}
+
+
 /**
  * @brief Get the real number precision
  * @param size
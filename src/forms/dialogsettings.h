@@ -56,6 +56,7 @@ public slots:
     void getReportsRealNumberPrecision(const int &precision);
     void getReportsLabelsLength(const int &length);
     void getReportsChartType(const int &type);
+    void getSaveInBackground(const bool &toggle);
 
     void getCanvasBgColor();
     void getCanvasBgImage();
@@ -91,6 +92,7 @@ signals:
     void setReportsRealNumberPrecision(const int &precision);
     void setReportsLabelLength(const int &length);
     void setReportsChartType(const int &type);
+    void setSaveInBackground(const bool &toggle);
 
     void setStyleSheetDefault(const bool &toggle);
 
@@ -110,6 +112,7 @@ signals:
     void setCanvasSavePainterState(bool);
     void setCanvasCacheBackground(bool);
     void setCanvasEdgeHighlighting(bool);
+    void setCanvasEdgeLayer(bool);
     void setCanvasUpdateMode(const QString &text);
     void setCanvasIndexMethod(const QString &text);
 
@@ -34,6 +34,10 @@ SOCNETV_BEGIN_NAMESPACE
 #define M_PI_X_2 (6.28318530717958647692)
 #endif
 
+#ifndef M_SQRT3_2
+#define M_SQRT3_2 (0.86602540378443864676)
+#endif
+
 
 
     enum NodeShape{
@@ -63,6 +67,7 @@ SOCNETV_BEGIN_NAMESPACE
          EDGELIST_WEIGHTED = 7,  // .CSV, .TXT, .LIST, LST, WLST
          EDGELIST_SIMPLE   = 8,  // .CSV, .TXT, .LIST, LST
          TWOMODE           = 9,  // .2SM .AFF
+         SNVB              = 10, // .SNVB (native binary snapshot)
          UNRECOGNIZED      =-1  // UNRECOGNIZED FILE FORMAT
     };
 
@@ -102,6 +107,12 @@ SOCNETV_BEGIN_NAMESPACE
     static const int SUBGRAPH_CYCLE  = 3;
     static const int SUBGRAPH_LINE   = 4;
 
+    // two-mode sociomatrix projection: the mode, optionally or'ed with
+    // TWOMODE_NEWMAN_WEIGHTS
+    static const int TWOMODE_FIRST_MODE     = 1;  // rows are nodes
+    static const int TWOMODE_SECOND_MODE    = 2;  // columns are nodes
+    static const int TWOMODE_NEWMAN_WEIGHTS = 4;  // events weigh 1/(members-1)
+
     static const int MATRIX_ADJACENCY        = 1;
     static const int MATRIX_DISTANCES        = 2;
     static const int MATRIX_DEGREE           = 3;
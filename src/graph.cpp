@@ -40,6 +40,9 @@
 #include <QColor>
 #include <QTextCodec>
 #include <QFileInfo>
+#include <QtConcurrent>
+#include <QVarLengthArray>
+#include <QSharedPointer>
 
 #include <QAbstractSeries>
 #include <QSplineSeries>
@@ -54,6 +57,9 @@
 
 #include <queue>		//for BFS queue Q
 #include <ctime>        // for randomizeThings
+#include <algorithm>    // for std::sort in nearest neighbors
+#include <functional>   // for std::greater in layout shortest paths
+#include <cstring>      // for memcmp in binary snapshots
 
 #include "chart.h"
 
@@ -69,6 +75,8 @@
 Graph::Graph(GraphicsWidget *graphicsWidget) {
 
             qRegisterMetaType<MyEdge>("MyEdge");
+            qRegisterMetaType<ParserBatch*>("ParserBatch*");
+            qRegisterMetaType<QVector<qreal> >("QVector<qreal>");
 
     m_canvas = graphicsWidget;
 
@@ -134,7 +142,28 @@ Graph::Graph(GraphicsWidget *graphicsWidget) {
 
     m_graphFileFormatExportSupported<< FileType::GRAPHML
                                << FileType::PAJEK
-                               << FileType::ADJACENCY;
+                               << FileType::ADJACENCY
+                               << FileType::GRAPHVIZ
+                               << FileType::SNVB;
+
+    m_fileSaveInBackground = false;
+    m_fileSavePending = false;
+    m_fileSaveStale = false;
+
+    m_layoutForceDirectedTheta = 0.7;
+    m_layoutForceDirectedInitialPositions = "pivotmds";
+
+    m_layoutRunner = 0;
+    m_layoutRunnerId = 0;
+    m_layoutRunnerFit = false;
+    m_layoutInBackground = false;
+
+    m_edgeListState = 0;
+    m_appendWasNew = false;
+    m_batchChange = GraphChange::ChangedNone;
+
+    connect ( &m_fileSaveWatcher, &QFutureWatcher<bool>::finished,
+              this, &Graph::graphFileSaveFinished);
 
     randomizeThings();
 
@@ -263,6 +292,7 @@ Graph::Graph(GraphicsWidget *graphicsWidget) {
  * @brief Graph::~Graph
  */
 Graph::~Graph() {
+    m_fileSaveWatcher.waitForFinished();
     qDebug()<<"Graph::~Graph() - Calling clear()";
     clear("exit");
     delete file_parser;
@@ -277,6 +307,7 @@ Graph::~Graph() {
 void Graph::clear(const QString &reason) {
    qDebug()<< "Graph::clear() - Clearing graph... "
               "m_graph reports size "<<m_graph.size();
+    layoutRunnerStop();
     qDeleteAll(m_graph.begin(), m_graph.end());
     m_graph.clear();
     vpos.clear();
@@ -348,6 +379,9 @@ void Graph::clear(const QString &reason) {
 
     m_fileFormat=FileType::NOT_SAVED;
 
+    delete m_edgeListState;
+    m_edgeListState = 0;
+
     m_graphName="";
 
     m_totalVertices=0;
@@ -711,7 +745,8 @@ void Graph::relationsClear(){
 */
 /**
  * @brief Creates a new vertex
- * Main vertex creation slot, associated with homonymous signal from Parser.
+ * Main vertex creation slot.
+ * Nodes read by the Parser are added in batches by graphLoadBatch().
  * Adds a vertex to the Graph and signals drawNode to GW
  * The new vertex has number num and specific color, label, label color, shape and position p.
  * @param num
@@ -1976,7 +2011,7 @@ void Graph::vertexLabelDistanceInit(const int &distance) {
  * @brief Checks a) if edge exists and b) if the opposite edge exists
  * Calls edgeAdd to add the new edge to the Graph,
  * then emits drawEdge() which calls GW::drawEdge() to draw the new edge.
- * Called from homonymous signal of Parser class.
+ * Nodes and edges read by the Parser are added in batches by graphLoadBatch().
  * Also called from MW when user clicks on the "add link" button
  * Also called (via MW) from GW when user middle-clicks on two nodes.
  * @param v1
@@ -3000,6 +3035,11 @@ void Graph::verticesCreateSubgraph(QList<int> vList,
  */
 void Graph::graphSetModified(const int &graphNewStatus, const bool &signalMW){
 
+    if ( m_fileSavePending && graphNewStatus != GraphChange::ChangedNone ) {
+        // A background save is still writing the previous state
+        m_fileSaveStale = true;
+    }
+
     if ( graphNewStatus == GraphChange::ChangedNew ) {
 
         // this is called from:
@@ -13001,7 +13041,9 @@ bool Graph::writeCliqueCensus(const QString &fileName,
 
    pMsg = tr("Computing HCA for Cliques. Please wait..") ;
    emit statusMessage ( pMsg );
-   if (! graphClusteringHierarchical(CLQM,
+   Matrix CLQM_HCA;
+   CLQM.toMatrix(CLQM_HCA);
+   if (! graphClusteringHierarchical(CLQM_HCA,
                                varLocation,
                                graphMetricStrToType("Euclidean"),
                                Clustering::Complete_Linkage,
@@ -13088,6 +13130,10 @@ void Graph:: graphCliqueAdd(const QList<int> &clique){
        m_graph[ index1 ]->cliqueAdd(clique);
        foreach (int actor2, clique) {
            index2 = vpos[actor2];
+           // CLQM is symmetric: (index1,index2) and (index2,index1) are one element
+           if ( index2 < index1 ) {
+               continue;
+           }
            cliqueCount = CLQM.item(index1, index2);
            CLQM.setItem( index1, index2, ( cliqueCount + 1)  );
            qDebug() << "Graph::graphCliqueAdd() - upd. co-membership matrix CLQM"
@@ -13143,7 +13189,7 @@ void Graph::graphCliques(QSet<int> R, QSet<int> P, QSet<int> X) {
         R.reserve( V );
         X.reserve( V );
         P=verticesSet();
-        CLQM.zeroMatrix(V,V);  //co-membership matrix CLQM
+        CLQM.zeroMatrix(V);  //co-membership matrix CLQM
         m_cliques.clear();
 
         VList::const_iterator it;
@@ -13730,34 +13776,37 @@ bool Graph::graphClusteringHierarchical(Matrix &STR_EQUIV,
     QVector<QString> clusterPairNames;
     QString cluster1, cluster2;
 
-    Matrix DSM;  //dissimilarities matrix. Note: will be destroyed in the end.
+    SymmetricMatrix DSM;  //dissimilarities matrix. Note: will be destroyed in the end.
 
     // TODO: needs fix when distances matrix with -1 (infinity) elements is used.
 
     // compute, if needed, the dissimilarities matrix
     switch (metric) {
     case METRIC_NONE:
-        DSM=STR_EQUIV;
+        // STR_EQUIV may be asymmetric (i.e. the distances of a directed graph),
+        // so keep the smaller of the two directed values of each pair
+        DSM.setSinglePrecision( STR_EQUIV.rows() >= SYMMETRIC_MATRIX_SINGLE_PRECISION_DIM );
+        DSM.fromMatrix(STR_EQUIV, true);
         break;
     case METRIC_JACCARD_INDEX:
         graphMatrixDissimilaritiesCreate(STR_EQUIV, DSM, metric,varLocation,diagonal, considerWeights);
-        STR_EQUIV = DSM;
+        DSM.toMatrix(STR_EQUIV);
         break;
     case METRIC_MANHATTAN_DISTANCE:
         graphMatrixDissimilaritiesCreate(STR_EQUIV, DSM, metric,varLocation,diagonal, considerWeights);
-        STR_EQUIV = DSM;
+        DSM.toMatrix(STR_EQUIV);
         break;
     case METRIC_HAMMING_DISTANCE:
         graphMatrixDissimilaritiesCreate(STR_EQUIV, DSM, metric,varLocation,diagonal, considerWeights);
-        STR_EQUIV = DSM;
+        DSM.toMatrix(STR_EQUIV);
         break;
     case METRIC_EUCLIDEAN_DISTANCE:
         graphMatrixDissimilaritiesCreate(STR_EQUIV, DSM, metric,varLocation,diagonal, considerWeights);
-        STR_EQUIV = DSM;
+        DSM.toMatrix(STR_EQUIV);
         break;
     case METRIC_CHEBYSHEV_MAXIMUM:
         graphMatrixDissimilaritiesCreate(STR_EQUIV, DSM, metric,varLocation,diagonal, considerWeights);
-        STR_EQUIV = DSM;
+        DSM.toMatrix(STR_EQUIV);
         break;
     default:
         break;
@@ -14007,7 +14056,6 @@ bool Graph::graphClusteringHierarchical(Matrix &STR_EQUIV,
             }
 
             DSM.setItem(i, j, distanceNewCluster);
-            DSM.setItem(j, i, distanceNewCluster);
 
             // DSM.setItem(deletedClusterIndex, j, RAND_MAX);
             // DSM.setItem(j, deletedClusterIndex, RAND_MAX);
@@ -14074,7 +14122,7 @@ void Graph::writeMatrixSimilarityMatchingPlain(const QString fileName,
 
     emit statusMessage ( (tr("Examining pair-wise similarity of actors...")) );
 
-    Matrix SCM;
+    SymmetricMatrix SCM;
     if (matrix == "Adjacency") {
         graphMatrixAdjacencyCreate();
         graphMatrixSimilarityMatchingCreate(AM, SCM, measure, varLocation, diagonal, considerWeights);
@@ -14182,7 +14230,7 @@ void Graph::writeMatrixDissimilarities(const QString fileName,
     }
     QTextStream outText ( &file ); outText.setCodec("UTF-8");
 
-    Matrix DSM;
+    SymmetricMatrix DSM;
     int N = vertices();
 
     graphMatrixAdjacencyCreate();
@@ -14290,7 +14338,7 @@ void Graph::writeMatrixDissimilarities(const QString fileName,
 
 
 /**
- * @brief Calls Matrix:distancesMatrix to compute the dissimilarities matrix DSM
+ * @brief Calls SymmetricMatrix::distancesMatrix to compute the dissimilarities matrix DSM
  * of the variables (rows, columns, both) in given input matrix using the
  * user defined metric
  * @param INPUT_MATRIX
@@ -14301,14 +14349,15 @@ void Graph::writeMatrixDissimilarities(const QString fileName,
  * @param considerWeights
  */
 void Graph::graphMatrixDissimilaritiesCreate(Matrix &INPUT_MATRIX,
-                                             Matrix &DSM,
+                                             SymmetricMatrix &DSM,
                                              const int &metric,
                                              const QString &varLocation,
                                              const bool &diagonal,
                                              const bool &considerWeights){
     qDebug()<<"Graph::graphMatrixDissimilaritiesCreate() -metric" << metric;
 
-    DSM = INPUT_MATRIX.distancesMatrix(metric, varLocation, diagonal, considerWeights);
+    DSM.setSinglePrecision( INPUT_MATRIX.rows() >= SYMMETRIC_MATRIX_SINGLE_PRECISION_DIM );
+    DSM.distancesMatrix(INPUT_MATRIX, metric, varLocation, diagonal, considerWeights);
 
 //    qDebug()<<"Graph::graphMatrixDissimilaritiesCreate() - matrix DSM:";
     //DSM.printMatrixConsole(true);
@@ -14351,7 +14400,7 @@ void Graph::writeMatrixSimilarityMatching(const QString fileName,
 
     emit statusMessage ( (tr("Examining pair-wise similarity of actors...")) );
 
-    Matrix SCM;
+    SymmetricMatrix SCM;
     int N = vertices();
 
     if (matrix == "Adjacency") {
@@ -14492,7 +14541,7 @@ void Graph::writeMatrixSimilarityMatching(const QString fileName,
 
 
 /**
- * @brief Calls Matrix:similarityMatrix to compute the similarity matrix SCM
+ * @brief Calls SymmetricMatrix::similarityMatrix to compute the similarity matrix SCM
  * of the variables (rows, columns, both) in given input matrix using the
  * selected matching measure.
  *
@@ -14501,7 +14550,7 @@ void Graph::writeMatrixSimilarityMatching(const QString fileName,
  * @param rows
  */
 void Graph::graphMatrixSimilarityMatchingCreate (Matrix &AM,
-                                    Matrix &SCM,
+                                    SymmetricMatrix &SCM,
                                     const int &measure,
                                     const QString &varLocation,
                                     const bool &diagonal,
@@ -14510,6 +14559,7 @@ void Graph::graphMatrixSimilarityMatchingCreate (Matrix &AM,
 
     QString pMsg = tr ("Computing Similarity coefficients matrix. \nPlease wait...");
     emit signalProgressBoxCreate(1, pMsg);
+    SCM.setSinglePrecision( AM.rows() >= SYMMETRIC_MATRIX_SINGLE_PRECISION_DIM );
     SCM.similarityMatrix(AM, measure, varLocation, diagonal, considerWeights);
     emit signalProgressBoxUpdate(1);
     emit signalProgressBoxKill();
@@ -14517,6 +14567,406 @@ void Graph::graphMatrixSimilarityMatchingCreate (Matrix &AM,
 
 
 
+/**
+ * @brief Finds the k most similar actors of each actor, according to the
+ * Jaccard index of their tie profiles, without computing the full
+ * similarity matrix.
+ *
+ * The tie profile of each actor (its out-ties, in-ties or both, according
+ * to varLocation, ignoring self-ties) is summarized by a MinHash signature
+ * of bands * rowsPerBand values. Signatures are split in bands and actors
+ * sharing all values of a band fall in the same LSH bucket; only actors
+ * sharing at least one bucket are compared. The similarity of each
+ * candidate pair is estimated as the fraction of equal signature values,
+ * which is an unbiased estimate of their Jaccard index.
+ *
+ * With the default 16 bands of 4 rows, pairs with Jaccard index 0.5 become
+ * candidates with probability ~0.65 and pairs above 0.7 almost always.
+ * Isolated actors (empty tie profiles) have no neighbors.
+ *
+ * Complexity: O(m * h + n * h * c) for m ties, h hash values and at most
+ * c candidates per actor.
+ * @param neighbors  filled with the top k (actor, estimated Jaccard) pairs of
+ * each enabled actor, keyed by actor number, in descending similarity
+ * @param k
+ * @param varLocation "Rows", "Columns" or "Both"
+ * @param bands
+ * @param rowsPerBand
+ */
+void Graph::graphSimilarityNearestNeighbors(QHash<int, QList<pair_i_f> > &neighbors,
+                                            const int &k,
+                                            const QString &varLocation,
+                                            const int &bands,
+                                            const int &rowsPerBand){
+
+    qDebug()<<"Graph::graphSimilarityNearestNeighbors() - k" << k
+           << "varLocation" << varLocation
+           << "bands" << bands << "rowsPerBand" << rowsPerBand;
+
+    neighbors.clear();
+
+    const int H = bands * rowsPerBand;   // MinHash signature length
+
+    if ( k < 1 || H < 1 ) {
+        return;
+    }
+
+    // enabled actors, and their positions in tie profiles
+    QVector<int> actor;
+    QHash<int,int> index;
+    VList::const_iterator it;
+    for (it=m_graph.cbegin(); it!=m_graph.cend(); ++it){
+        if ( ! (*it)->isEnabled() ) {
+            continue;
+        }
+        index[(*it)->name()] = actor.size();
+        actor.append( (*it)->name() );
+    }
+
+    const int N = actor.size();
+
+    QString pMsg = tr ("Computing MinHash signatures of tie profiles. \nPlease wait...");
+    emit statusMessage (pMsg);
+    emit signalProgressBoxCreate(3, pMsg);
+
+    // The tie profile of actor i is the set of positions of its ties:
+    // j for ties to j (rows), j for ties from j (columns), N+j for ties
+    // from j when rows and columns are concatenated (both).
+    QVector< QVector<int> > profile(N);
+    QHash<int,qreal> enabledOutEdges;
+    QHash<int,qreal>::const_iterator hit;
+
+    for (int i = 0 ; i < N ; i++ ) {
+        enabledOutEdges = m_graph[ vpos[ actor[i] ] ]->outEdgesEnabledHash();
+        for ( hit = enabledOutEdges.cbegin(); hit != enabledOutEdges.cend(); ++hit ) {
+            if ( !index.contains( hit.key() ) ) {
+                continue;
+            }
+            const int j = index.value( hit.key() );
+            if ( j == i ) {
+                continue;
+            }
+            if ( varLocation == "Rows" ) {
+                profile[i].append(j);
+            }
+            else if ( varLocation == "Columns" ) {
+                profile[j].append(i);
+            }
+            else {
+                profile[i].append(j);
+                profile[j].append(N + i);
+            }
+        }
+    }
+
+    // splitmix64 finalizer, used both as hash family and to derive seeds
+    auto mix = [](quint64 z) -> quint64 {
+        z += Q_UINT64_C(0x9E3779B97F4A7C15);
+        z = (z ^ (z >> 30)) * Q_UINT64_C(0xBF58476D1CE4E5B9);
+        z = (z ^ (z >> 27)) * Q_UINT64_C(0x94D049BB133111EB);
+        return z ^ (z >> 31);
+    };
+
+    QVector<quint64> seed(H);
+    for (int h = 0 ; h < H ; h++ ) {
+        seed[h] = mix( (quint64) h + 1 );
+    }
+
+    QVector<quint32> signatures( N * H, 0xFFFFFFFF );
+    quint32 *signature = signatures.data();
+    const quint64 *seeds = seed.constData();
+
+    QVector<int> actorIndex(N);
+    for (int i = 0 ; i < N ; i++ ) {
+        actorIndex[i] = i;
+    }
+
+    QtConcurrent::blockingMap(actorIndex, [&](const int &i) {
+        quint32 *sig = signature + i * H;
+        const QVector<int> &ties = profile.at(i);
+        for (int t = 0 ; t < ties.size() ; t++ ) {
+            for (int h = 0 ; h < H ; h++ ) {
+                const quint32 value = (quint32) ( mix( (quint64) ties.at(t) ^ seeds[h] ) >> 32 );
+                if ( value < sig[h] ) {
+                    sig[h] = value;
+                }
+            }
+        }
+    });
+
+    emit signalProgressBoxUpdate(1);
+
+    qDebug()<<"Graph::graphSimilarityNearestNeighbors() - bucketing signatures";
+
+    // For each band, actors are sorted by the hash of their band values.
+    // bucketFrom/bucketTo[b*N+i] delimit, in members[b*N+...], the bucket
+    // of actor i in band b.
+    QVector<int> members( bands * N, -1 );
+    QVector<int> bucketFrom( bands * N, 0 );
+    QVector<int> bucketTo( bands * N, 0 );
+    QVector< QPair<quint64, int> > keys;
+    keys.reserve(N);
+
+    for (int b = 0 ; b < bands ; b++ ) {
+        keys.clear();
+        for (int i = 0 ; i < N ; i++ ) {
+            if ( profile.at(i).isEmpty() ) {
+                continue;
+            }
+            quint64 key = (quint64) b;
+            const quint32 *sig = signature + i * H + b * rowsPerBand;
+            for (int r = 0 ; r < rowsPerBand ; r++ ) {
+                key = mix( key ^ sig[r] );
+            }
+            keys.append( qMakePair(key, i) );
+        }
+        std::sort(keys.begin(), keys.end());
+        int from = 0;
+        for (int p = 0 ; p <= keys.size() ; p++ ) {
+            if ( p < keys.size() && keys.at(p).first == keys.at(from).first ) {
+                continue;
+            }
+            for (int q = from ; q < p ; q++ ) {
+                members[ b*N + q ] = keys.at(q).second;
+                bucketFrom[ b*N + keys.at(q).second ] = from;
+                bucketTo[ b*N + keys.at(q).second ] = p;
+            }
+            from = p;
+        }
+    }
+
+    emit signalProgressBoxUpdate(2);
+
+    qDebug()<<"Graph::graphSimilarityNearestNeighbors() - ranking candidates";
+
+    // Huge buckets (i.e. many actors with identical profiles) would make
+    // the comparisons quadratic. We stop collecting candidates at this limit,
+    // and only take a window of a bucket that does not fit in it, starting
+    // at a position which depends on the actor and the band.
+    const int maxCandidates = qMax(100, 20 * k);
+
+    QVector< QList<pair_i_f> > result(N);
+
+    QtConcurrent::blockingMap(actorIndex, [&](const int &i) {
+        if ( profile.at(i).isEmpty() ) {
+            return;
+        }
+        QVector<int> candidates;
+        for (int b = 0 ; b < bands && candidates.size() < maxCandidates ; b++ ) {
+            const int from = bucketFrom.at(b*N + i);
+            const int size = bucketTo.at(b*N + i) - from;
+            const int take = qMin( size, maxCandidates - candidates.size() );
+            const int start = ( take < size )
+                    ? (int) ( mix( ( (quint64) b << 32 ) ^ (quint64) i ) % (quint64) size )
+                    : 0;
+            for (int q = 0 ; q < take ; q++ ) {
+                const int c = members.at(b*N + from + (start + q) % size);
+                if ( c != i ) {
+                    candidates.append(c);
+                }
+            }
+        }
+        std::sort(candidates.begin(), candidates.end());
+        candidates.erase( std::unique(candidates.begin(), candidates.end()),
+                          candidates.end() );
+
+        const quint32 *si = signature + i * H;
+        QVector< QPair<qreal, int> > scored;
+        scored.reserve( candidates.size() );
+        for (int c = 0 ; c < candidates.size() ; c++ ) {
+            const quint32 *sc = signature + candidates.at(c) * H;
+            int equal = 0;
+            for (int h = 0 ; h < H ; h++ ) {
+                if ( si[h] == sc[h] ) {
+                    equal++;
+                }
+            }
+            // negated, so that sorting puts the most similar first
+            scored.append( qMakePair( - (qreal) equal / (qreal) H, candidates.at(c) ) );
+        }
+        const int top = qMin(k, scored.size());
+        std::partial_sort(scored.begin(), scored.begin() + top, scored.end());
+        for (int c = 0 ; c < top ; c++ ) {
+            result[i].append( qMakePair( actor.at( scored.at(c).second ),
+                                         - scored.at(c).first ) );
+        }
+    });
+
+    for (int i = 0 ; i < N ; i++ ) {
+        neighbors.insert( actor.at(i), result.at(i) );
+    }
+
+    emit signalProgressBoxUpdate(3);
+    emit signalProgressBoxKill();
+}
+
+
+
+
+/**
+ * @brief Writes the k most similar actors of each actor (by MinHash
+ * estimated Jaccard index of their tie profiles) to given html file.
+ * Suitable for large networks, where the full similarity matrix is
+ * too big to compute or display.
+ * @param fileName
+ * @param k
+ * @param varLocation
+ */
+void Graph::writeSimilarityNearestNeighbors(const QString fileName,
+                                            const int &k,
+                                            const QString &varLocation) {
+
+    QTime computationTimer;
+    computationTimer.start();
+
+    QFile file ( fileName );
+    if ( !file.open( QIODevice::WriteOnly | QIODevice::Text ) )  {
+        qDebug()<< "Error opening file!";
+        emit statusMessage ( tr("Error. Could not write to ") + fileName );
+        return;
+    }
+    QTextStream outText ( &file ); outText.setCodec("UTF-8");
+
+    emit statusMessage ( (tr("Examining pair-wise similarity of actors...")) );
+
+    QHash<int, QList<pair_i_f> > neighbors;
+
+    graphSimilarityNearestNeighbors(neighbors, k, varLocation);
+
+    int N = vertices();
+    int rowCount = 0;
+    int progressCounter = 0;
+
+    VList::const_iterator it;
+    QList<pair_i_f>::const_iterator nit;
+
+    QString pMsg = tr("Writing most similar actors to file. \nPlease wait...");
+    emit statusMessage( pMsg );
+    emit signalProgressBoxCreate(N, pMsg);
+
+    outText.setRealNumberPrecision(m_reportsRealPrecision);
+
+    outText << htmlHead;
+
+    outText << "<h1>";
+    outText << tr("MOST SIMILAR ACTORS (MINHASH NEAREST NEIGHBORS)");
+    outText << "</h1>";
+
+    outText << "<p>"
+            << "<span class=\"info\">"
+            << tr("Network name: ")
+            <<"</span>"
+            << graphName()
+            <<"<br />"
+            << "<span class=\"info\">"
+            << tr("Actors: ")
+            <<"</span>"
+            << N
+            << "</p>";
+
+    outText << "<p>"
+            << "<span class=\"info\">"
+            << tr("Variables in: ")
+            <<"</span>"
+            << ((varLocation != "Rows" && varLocation != "Columns") ? "Concatenated rows + columns " : varLocation)
+            << "</p>";
+
+    outText << "<p>"
+            << "<span class=\"info\">"
+            << tr("Matching measure: ")
+            << "</span>"
+            << graphMetricTypeToString(METRIC_JACCARD_INDEX)
+            << tr(" (MinHash estimate)")
+            << "</p>";
+
+    outText << "<p>"
+            << "<span class=\"info\">"
+            << tr("Neighbors per actor: ")
+            << "</span>"
+            << k
+            << "</p>";
+
+    outText << "<p class=\"description\">"
+            << tr("For each actor, the table lists up to %1 other actors with the "
+                  "most similar tie profiles, in descending order of their "
+                  "estimated Jaccard index (in parentheses). <br />"
+                  "Tie profiles are compared through MinHash signatures and "
+                  "locality-sensitive hashing, therefore actors with low "
+                  "similarity may not be listed at all and the indices are "
+                  "estimates. Isolated actors have no similar actors.").arg(k)
+            << "</p>";
+
+    outText << "<table class=\"stripes sortable\">";
+
+    outText << "<thead>"
+            <<"<tr>"
+            <<"<th id=\"col1\" onclick=\"tableSort(results, 0, asc1); asc1 *= -1; asc2 = 1; asc3 = 1;\">"
+            << tr("Node")
+            << "</th>"
+            <<"<th id=\"col2\" onclick=\"tableSort(results, 1, asc2); asc2 *= -1; asc1 = 1; asc3 = 1;\">"
+            << tr("Label")
+            << "</th>"
+            <<"<th id=\"col3\" onclick=\"tableSort(results, 2, asc3); asc3 *= -1; asc1 = 1; asc2 = 1;\">"
+            << tr("Most similar actors")
+            << "</th>"
+           <<"</tr>"
+          << "</thead>"
+          <<"<tbody id=\"results\">";
+
+    outText << fixed;
+
+    for (it=m_graph.cbegin(); it!=m_graph.cend(); ++it) {
+
+        emit signalProgressBoxUpdate( ++progressCounter );
+
+        if ( ! (*it)->isEnabled() ) {
+            continue;
+        }
+
+        rowCount++;
+
+        outText << "<tr class=" << ((rowCount%2==0) ? "even" :"odd" )<< ">"
+                <<"<td>"
+                << (*it)->name()
+                << "</td><td>"
+                << ( (! ( (*it)->label().simplified()).isEmpty()) ? (*it)->label().simplified().left(m_reportsLabelLength) : "-" )
+                << "</td><td>";
+
+        const QList<pair_i_f> &similar = neighbors[ (*it)->name() ];
+        if ( similar.isEmpty() ) {
+            outText << "-";
+        }
+        for (nit = similar.cbegin(); nit != similar.cend(); ++nit) {
+            if ( nit != similar.cbegin() ) {
+                outText << ", ";
+            }
+            outText << (*nit).first << " (" << (*nit).second << ")";
+        }
+
+        outText << "</td>"
+                <<"</tr>";
+    }
+
+    outText << "</tbody></table>";
+
+    outText << "<p>&nbsp;</p>";
+    outText << "<p class=\"small\">";
+    outText << tr("Most Similar Actors Report, <br />");
+    outText << tr("Created by <a href=\"https://socnetv.org\" target=\"_blank\">Social Network Visualizer</a> v%1: %2")
+               .arg(VERSION).arg( actualDateTime.currentDateTime().toString ( QString ("ddd, dd.MMM.yyyy hh:mm:ss")) ) ;
+    outText << "<br />";
+    outText << tr("Computation time: %1 msecs").arg( computationTimer.elapsed() );
+    outText << "</p>";
+
+    outText << htmlEnd;
+
+    file.close();
+
+    emit signalProgressBoxKill();
+}
+
+
+
 /**
  * @brief Calls Graph::graphMatrixSimilarityPearsonCreate() and
  * writes Pearson Correlation Coefficients to given file
@@ -14543,7 +14993,7 @@ void Graph::writeMatrixSimilarityPearson(const QString fileName,
 
     emit statusMessage ( (tr("Calculating Pearson Correlations...")) );
 
-    Matrix PCC;
+    SymmetricMatrix PCC;
     int N = vertices();
 
     if (matrix == "Adjacency") {
@@ -14687,7 +15137,7 @@ void Graph::writeMatrixSimilarityPearsonPlainText(const QString fileName,
 
     emit statusMessage ( (tr("Calculating Pearson Correlations...")) );
 
-    Matrix PCC;
+    SymmetricMatrix PCC;
     if (matrix == "Adjacency") {
         graphMatrixAdjacencyCreate();
         graphMatrixSimilarityPearsonCreate(AM, PCC, varLocation,diagonal);
@@ -14765,12 +15215,12 @@ void Graph::writeMatrixSimilarityPearsonPlainText(const QString fileName,
  * @param rows
  */
 void Graph::graphMatrixSimilarityPearsonCreate (Matrix &AM,
-                                                          Matrix &PCC,
+                                                          SymmetricMatrix &PCC,
                                                           const QString &varLocation,
                                                            const bool &diagonal){
     qDebug()<<"Graph::graphMatrixSimilarityPearsonCreate()";
 
-
+    PCC.setSinglePrecision( AM.rows() >= SYMMETRIC_MATRIX_SINGLE_PRECISION_DIM );
     PCC.pearsonCorrelationCoefficients(AM, varLocation,diagonal);
 
     qDebug()<<"Graph::graphMatrixSimilarityPearsonCreate() - matrix PCC";
@@ -15427,19 +15877,61 @@ void Graph::graphLoad (	const QString m_fileName,
 
     qDebug() << "Graph::graphLoad() - clearing relations ";
     relationsClear();
+
+    if ( fileFormat == FileType::SNVB ) {
+        // native snapshots need no parsing, load them right here
+        graphLoadSnapshot(m_fileName);
+        return;
+    }
     qDebug() << "Graph::graphLoad() - "<< m_fileName
                 << " calling parser.load() from thread " << this->thread();
 
+    graphLoadParserCreate();
+
+    qDebug() << "Graph::graphLoad() - Starting file_parserThread ";
+
+    file_parserThread.start();
+
+    qDebug() << "Graph::graphLoad() - calling file_parser->load() ";
+    file_parser->load(
+                m_fileName,
+                m_codecName,
+                initVertexSize,
+                initVertexColor,
+                initVertexShape,
+                initVertexNumberColor,
+                initVertexNumberSize,
+                initVertexLabelColor,
+                initVertexLabelSize,
+                initEdgeColor,
+                canvasWidth,
+                canvasHeight,
+                fileFormat,
+                two_sm_mode,
+                delimiter
+                );
+
+
+}
+
+
+
+/**
+ * @brief Creates a new Parser, moves it to the parser thread and connects
+ * its signals. Used by graphLoad() and graphLoadAppend().
+ */
+void Graph::graphLoadParserCreate() {
+
     file_parser = new Parser();
 
-    qDebug () << "Graph::graphLoad() - file_parser thread  " << file_parser->thread()
+    qDebug () << "Graph::graphLoadParserCreate() - file_parser thread  " << file_parser->thread()
                  << " moving it to new thread ";
 
     file_parser->moveToThread(&file_parserThread);
 
-    qDebug () << "Graph::graphLoad() - file_parser thread now " << file_parser->thread();
+    qDebug () << "Graph::graphLoadParserCreate() - file_parser thread now " << file_parser->thread();
 
-    qDebug () << "Graph::graphLoad() - connecting file_parser signals ";
+    qDebug () << "Graph::graphLoadParserCreate() - connecting file_parser signals ";
 
     connect(&file_parserThread, &QThread::finished,
             file_parser, &QObject::deleteLater);
@@ -15453,7 +15945,7 @@ void Graph::graphLoad (	const QString m_fileName,
                 ) ;
 
 
-    connect ( file_parser, &Parser::createNode, this, &Graph::vertexCreate );
+    connect ( file_parser, &Parser::batchReady, this, &Graph::graphLoadBatch );
 
 
     connect (
@@ -15468,10 +15960,6 @@ void Graph::graphLoad (	const QString m_fileName,
                                const int &,const QString &, const bool &) )
                 );
 
-    connect (file_parser, &Parser::edgeCreate,
-             this,&Graph::edgeCreate);
-
-
     connect (
                 file_parser, SIGNAL(networkFileLoaded(int,
                                                       QString,
@@ -15497,19 +15985,78 @@ void Graph::graphLoad (	const QString m_fileName,
                 this, SLOT (vertexRemoveDummyNode(int))
                 );
 
+    connect ( file_parser, &Parser::edgeListStateReady,
+              this, &Graph::graphLoadEdgeListState );
+
+    connect ( file_parser, &Parser::networkFileAppended,
+              this, &Graph::graphFileAppended );
+
     connect (
                 file_parser, &Parser::finished,
                 this, &Graph::graphLoadedTerminateParserThreads
                 );
+}
+
+
+
+/**
+ * @brief Returns true if the lines appended to the edge list file loaded
+ * last can be read with graphLoadAppend()
+ * @return
+ */
+bool Graph::graphLoadAppendSupported() const {
+    return ( m_edgeListState != 0 );
+}
+
+
+
+/**
+ * @brief Returns the edge list file graphLoadAppend() reads from,
+ * or an empty string if there is none
+ * @return
+ */
+QString Graph::graphLoadAppendFileName() const {
+    return ( m_edgeListState != 0 ) ? m_edgeListState->fileName : QString::null;
+}
+
 
-    qDebug() << "Graph::graphLoad() - Starting file_parserThread ";
+
+/**
+ * @brief Reads the lines appended to the edge list file loaded last,
+ * adding the new vertices and edges to the graph without loading it again.
+ * Vertices already on the canvas keep their positions.
+ * The Parser reports back with graphFileAppended().
+ */
+void Graph::graphLoadAppend() {
+
+    if ( m_edgeListState == 0 ) {
+        qDebug() << "Graph::graphLoadAppend() - no edge list loaded. Return.";
+        emit statusMessage( tr("Nothing to append. Load an edge list file first.") );
+        return;
+    }
+
+    EdgeListAppendState *state = m_edgeListState;
+    m_edgeListState = 0;
+
+    m_appendWasNew = ( m_graphHasChanged == GraphChange::ChangedNew );
+
+    qDebug() << "Graph::graphLoadAppend() - "<< state->fileName
+             << "from offset" << state->offset;
+
+    const QString fileName = state->fileName;
+    const QString codecName = state->codecName;
+    const int fileType = state->fileType;
+    const QString delimiter = state->delimiter;
+
+    graphLoadParserCreate();
+
+    file_parser->setEdgeListState(state);
 
     file_parserThread.start();
 
-    qDebug() << "Graph::graphLoad() - calling file_parser->load() ";
     file_parser->load(
-                m_fileName,
-                m_codecName,
+                fileName,
+                codecName,
                 initVertexSize,
                 initVertexColor,
                 initVertexShape,
@@ -15520,15 +16067,65 @@ void Graph::graphLoad (	const QString m_fileName,
                 initEdgeColor,
                 canvasWidth,
                 canvasHeight,
-                fileFormat,
-                two_sm_mode,
+                fileType,
+                0,
                 delimiter
                 );
+}
+
+
+
+/**
+ * @brief Keeps what the Parser needs to append the lines added later
+ * to the edge list file loaded last.
+ * Called from Parser::edgeListStateReady. Takes ownership of state.
+ * @param state
+ */
+void Graph::graphLoadEdgeListState(EdgeListAppendState *state) {
+    if ( state != m_edgeListState ) {
+        delete m_edgeListState;
+        m_edgeListState = state;
+    }
+}
+
+
+
+/**
+ * @brief Called from Parser when it has read the lines appended
+ * to an edge list file, or failed to.
+ * A graph not modified since it was loaded stays so, as it still matches
+ * the file.
+ * @param newNodes
+ * @param edges
+ * @param message
+ */
+void Graph::graphFileAppended(const int &newNodes,
+                              const int &edges,
+                              const QString &message) {
+    graphLoadBatchesFinish();
+
+    if ( !message.isEmpty() ) {
+        qDebug() << "Graph::graphFileAppended() - error:" << message;
+        emit statusMessage( message );
+        return;
+    }
+
+    qDebug() << "Graph::graphFileAppended() - new nodes" << newNodes
+             << "edges" << edges;
 
+    if ( newNodes || edges ) {
+        graphSetModified( GraphChange::ChangedVerticesEdges );
+        if ( m_appendWasNew ) {
+            graphSetModified( GraphChange::ChangedNew );
+        }
+    }
 
+    emit statusMessage( tr("Appended from file: %1 new nodes, %2 edges.")
+                        .arg(newNodes).arg(edges) );
 }
 
 
+
 /**
  * @brief Graph::graphLoadedTerminateParserThreads
  * @param reason
@@ -15549,6 +16146,164 @@ void Graph::graphLoadedTerminateParserThreads(QString reason) {
 
 
 
+/**
+ * @brief Adds a batch of nodes and edges read by the Parser to the Graph.
+ * Called from Parser::batchReady, instead of vertexCreate() and edgeCreate()
+ * for each element. The vertices and edges are added first, with reserved
+ * capacity; then the canvas draws them all. Deletes the batch.
+ * The graph is marked as modified once for the whole load, by
+ * graphLoadBatchesFinish().
+ * @param batch
+ */
+void Graph::graphLoadBatch(ParserBatch *batch) {
+
+    const int nodes = batch->nodeNumber.count();
+    const int edges = batch->edgeSource.count();
+    const QStringList &str = batch->strings;
+
+    qDebug() << "Graph::graphLoadBatch() - nodes:" << nodes << "edges:" << edges;
+
+    m_graph.reserve(m_graph.size() + nodes);
+    vpos.reserve(vpos.size() + nodes);
+
+    for (int i = 0; i < nodes; i++) {
+        const int number = batch->nodeNumber[i];
+        if (order)
+            vpos[number]=m_totalVertices;
+        else
+            vpos[number]=m_graph.size();
+
+        m_graph.append(
+                    new GraphVertex (
+                        this,
+                        number,
+                        1,
+                        m_curRelation ,
+                        batch->nodeSize[i],
+                        str[ batch->nodeColor[i] ],
+                        str[ batch->nodeNumberColor[i] ],
+                        batch->nodeNumberSize[i],
+                        str[ batch->nodeLabel[i] ],
+                        str[ batch->nodeLabelColor[i] ],
+                        batch->nodeLabelSize[i],
+                        batch->nodePos[i],
+                        str[ batch->nodeShape[i] ],
+                        str[ batch->nodeIconPath[i] ]
+                        )
+                    );
+
+        m_totalVertices++;
+    }
+
+    // add edges as edgeCreate() does, keeping the type each one is drawn with
+    QVector<int> drawType(edges, -1);
+
+    for (int e = 0; e < edges; e++) {
+        const int v1 = batch->edgeSource[e];
+        const int v2 = batch->edgeTarget[e];
+        const qreal weight = batch->edgeWeight[e];
+        const QString color = ( weight == 0 ) ? QString("blue")
+                                              : str[ batch->edgeColor[e] ];
+        if ( edgeExists(v1,v2) ) {
+            if ( batch->updateEdgeWeights && edgeWeight(v1,v2) != weight ) {
+                m_graph[ vpos[v1] ]->changeOutEdgeWeight(v2, weight);
+                emit setEdgeWeight(v1, v2, weight);
+            }
+            continue;
+        }
+        if ( batch->edgeType[e] == EdgeType::Undirected ) {
+            drawType[e] = EdgeType::Undirected;
+            edgeAdd ( v1, v2, weight, drawType[e], str[ batch->edgeLabel[e] ], color );
+        }
+        else if ( edgeExists( v2, v1 ) )  {
+            drawType[e] = EdgeType::Reciprocated;
+            edgeAdd ( v1, v2, weight, drawType[e], str[ batch->edgeLabel[e] ],
+                      str[ batch->edgeColor[e] ] );
+            m_graphIsDirected = true;
+        }
+        else {
+            drawType[e] = EdgeType::Directed;
+            edgeAdd ( v1, v2, weight, drawType[e], str[ batch->edgeLabel[e] ], color );
+            m_graphIsDirected = true;
+            m_graphIsSymmetric=false;
+        }
+    }
+
+    // now draw them
+    for (int i = 0; i < nodes; i++) {
+        emit signalDrawNode( batch->nodePos[i],
+                             batch->nodeNumber[i],
+                             batch->nodeSize[i],
+                             str[ batch->nodeShape[i] ],
+                             str[ batch->nodeIconPath[i] ],
+                             str[ batch->nodeColor[i] ],
+                             str[ batch->nodeNumberColor[i] ],
+                             batch->nodeNumberSize[i],
+                             initVertexNumberDistance,
+                             str[ batch->nodeLabel[i] ],
+                             str[ batch->nodeLabelColor[i] ],
+                             batch->nodeLabelSize[i],
+                             initVertexLabelDistance);
+    }
+
+    for (int e = 0; e < edges; e++) {
+        if ( drawType[e] == -1 ) {
+            continue;
+        }
+        const qreal weight = batch->edgeWeight[e];
+        m_canvas->drawEdge( batch->edgeSource[e],
+                            batch->edgeTarget[e],
+                            weight,
+                            str[ batch->edgeLabel[e] ],
+                            ( weight == 0 && drawType[e] != EdgeType::Reciprocated )
+                            ? QString("blue") : str[ batch->edgeColor[e] ],
+                            drawType[e],
+                            batch->edgeArrows[e],
+                            batch->edgeBezier[e],
+                            initEdgeWeightNumbers);
+    }
+
+    //to draw new vertices and edges by user with the same style of the file loaded:
+    //save color, size and shape as init values
+    if (nodes) {
+        initVertexColor=str[ batch->nodeColor.last() ];
+        initVertexSize=batch->nodeSize.last();
+        initVertexShape=str[ batch->nodeShape.last() ];
+        if (initVertexShape=="custom"){
+            initVertexIconPath=str[ batch->nodeIconPath.last() ];
+        }
+    }
+    if (edges) {
+        initEdgeColor=str[ batch->edgeColor.last() ];
+    }
+
+    delete batch;
+
+    const int change = (edges) ? GraphChange::ChangedEdges : GraphChange::ChangedVertices;
+    if ( change > m_batchChange ) {
+        m_batchChange = change;
+    }
+}
+
+
+
+/**
+ * @brief Marks the graph as modified by the batches of the Parser, once,
+ * after the last one. Called when the file is loaded or appended,
+ * successfully or not.
+ */
+void Graph::graphLoadBatchesFinish() {
+    if ( m_batchChange == GraphChange::ChangedNone ) {
+        return;
+    }
+    qDebug() << "Graph::graphLoadBatchesFinish() - change" << m_batchChange;
+    const int change = m_batchChange;
+    m_batchChange = GraphChange::ChangedNone;
+    graphSetModified( change, false );
+}
+
+
+
 
 
 /**
@@ -15568,6 +16323,8 @@ void Graph::graphFileLoaded (const int &fileType,
                              const int &edgeDirType,
                              const QString &message)
 {
+    graphLoadBatchesFinish();
+
     if ( fileType == FileType::UNRECOGNIZED ) {
         qDebug() << "Graph::graphFileLoaded() - FileType::UNRECOGNIZED. "
                     "Emitting signalGraphLoaded with error message "
@@ -15647,6 +16404,165 @@ bool Graph::graphFileFormatExportSupported(const int &fileFormat) const {
     return false;
 }
 
+/**
+ * Size of the blocks in which the network exporters flush their output.
+ */
+static const int FILE_WRITER_BLOCK_SIZE = 1 << 20;
+
+
+/**
+ * @brief Buffered output of the network exporters.
+ *
+ * Text and numbers are formatted straight into a large byte buffer, which
+ * is flushed to the file in FILE_WRITER_BLOCK_SIZE blocks. In background
+ * mode nothing is written here: Graph::graphSaveFinish() takes the whole
+ * buffer and writes it to disk on a worker thread.
+ */
+class GraphFileWriter {
+public:
+    GraphFileWriter(const QString &fileName, const bool &background) :
+        m_file(fileName), m_background(background), m_error(false)
+    {
+        if ( !m_background ) {
+            m_buffer.reserve( FILE_WRITER_BLOCK_SIZE + 4096 );
+        }
+    }
+
+    bool open() {
+        if ( m_background ) {
+            return true;
+        }
+        return m_file.open( QIODevice::WriteOnly | QIODevice::Text );
+    }
+
+    bool close() {
+        if ( m_background ) {
+            return true;
+        }
+        flush();
+        m_file.close();
+        return !m_error;
+    }
+
+    bool isBackground() const { return m_background; }
+
+    QString fileName() const { return m_file.fileName(); }
+
+    QByteArray takeBuffer() {
+        QByteArray buffer;
+        buffer.swap(m_buffer);
+        return buffer;
+    }
+
+    GraphFileWriter &operator<< (const char *str) {
+        m_buffer.append(str);
+        return flushIfFull();
+    }
+
+    GraphFileWriter &operator<< (const char &c) {
+        m_buffer.append(c);
+        return flushIfFull();
+    }
+
+    GraphFileWriter &operator<< (const QString &str) {
+        m_buffer.append( str.toUtf8() );
+        return flushIfFull();
+    }
+
+    GraphFileWriter &operator<< (const int &number) {
+        char digits[12];
+        char *end = digits + sizeof(digits);
+        char *p = end;
+        unsigned int u = ( number < 0 ) ? 0u - static_cast<unsigned int>(number)
+                                        : static_cast<unsigned int>(number);
+        do {
+            *--p = static_cast<char>( '0' + u % 10 );
+            u /= 10;
+        } while ( u );
+        if ( number < 0 ) {
+            *--p = '-';
+        }
+        m_buffer.append( p, static_cast<int>(end - p) );
+        return flushIfFull();
+    }
+
+    GraphFileWriter &operator<< (const qreal &number) {
+        // Integral values, i.e. most weights, skip the double formatting.
+        // Others use the 6 significant digits QTextStream used to write.
+        if ( number == std::floor(number) && qAbs(number) < 1e6 ) {
+            return *this << static_cast<int>(number);
+        }
+        m_buffer.append( QByteArray::number(number, 'g', 6) );
+        return flushIfFull();
+    }
+
+private:
+    GraphFileWriter &flushIfFull() {
+        if ( !m_background && m_buffer.size() >= FILE_WRITER_BLOCK_SIZE ) {
+            flush();
+        }
+        return *this;
+    }
+
+    void flush() {
+        if ( m_buffer.isEmpty() ) {
+            return;
+        }
+        if ( m_file.write(m_buffer) != m_buffer.size() ) {
+            m_error = true;
+        }
+        m_buffer.resize(0);
+    }
+
+    QFile m_file;
+    QByteArray m_buffer;
+    bool m_background;
+    bool m_error;
+};
+
+
+/**
+ * @brief Writes data to fileName. Runs on a worker thread for background saves.
+ * @param fileName
+ * @param data
+ * @return
+ */
+static bool graphFileWriteBuffer(const QString &fileName, const QByteArray &data) {
+    QFile file( fileName );
+    if ( !file.open( QIODevice::WriteOnly | QIODevice::Text ) )  {
+        return false;
+    }
+    const bool written = ( file.write(data) == data.size() );
+    file.close();
+    return written && file.error() == QFileDevice::NoError;
+}
+
+
+/**
+ * @brief Fills edges with the enabled out-edges of vertex in the current
+ * relation, ordered by the position of their targets in the vertex list,
+ * so that the exporters walk every adjacency list once.
+ * @param vertex
+ * @param vpos
+ * @param edges
+ */
+static void graphFileOutEdges(GraphVertex *vertex,
+                              const H_Int &vpos,
+                              QVector< QPair<int, qreal> > &edges) {
+    edges.clear();
+    const QHash<int, qreal> enabledOutEdges = vertex->outEdgesEnabledHash();
+    QHash<int, qreal>::const_iterator et;
+    for (et = enabledOutEdges.cbegin(); et != enabledOutEdges.cend(); ++et) {
+        edges.append( qMakePair( et.key(), et.value() ) );
+    }
+    std::sort( edges.begin(), edges.end(),
+               [&vpos] (const QPair<int, qreal> &a, const QPair<int, qreal> &b) {
+        return vpos.value(a.first) < vpos.value(b.first);
+    });
+}
+
+
+
 /**
  * @brief Our almost universal graph saving method. :)
  * Actually it just checks the requested file type and
@@ -15661,6 +16577,11 @@ void Graph::graphSave(const QString &fileName,
 {
     qDebug() << "Graph::graphSave()";
     bool saved = false;
+    if ( m_fileSaveWatcher.isRunning() ) {
+        qDebug() << "Graph::graphSave() - waiting for the previous background save";
+        m_fileSaveWatcher.waitForFinished();
+        graphFileSaveFinished();
+    }
     m_fileFormat = fileType;
     switch (fileType) {
     case FileType::PAJEK : {
@@ -15683,6 +16604,11 @@ void Graph::graphSave(const QString &fileName,
         saved=graphSaveToGraphMLFormat(fileName);
         break;
     }
+    case FileType::SNVB: {
+        qDebug() << "Graph::graphSave() - SocNetV binary snapshot file";
+        saved=graphSaveToSnapshotFormat(fileName);
+        break;
+    }
     default: {
         m_fileFormat = FileType::UNRECOGNIZED;
         qDebug() << "Graph::graphSave() - Error! Unrecognized fileType";
@@ -15690,7 +16616,10 @@ void Graph::graphSave(const QString &fileName,
     }
     };
     if (saved) {
-        graphSetModified(GraphChange::ChangedNone);
+        // Background saves report the saved status once on disk
+        if ( !m_fileSavePending ) {
+            graphSetModified(GraphChange::ChangedNone);
+        }
     }
     else {
         emit signalGraphSavedStatus(FileType::UNRECOGNIZED);
@@ -15700,6 +16629,76 @@ void Graph::graphSave(const QString &fileName,
 
 
 
+/**
+ * @brief Completes an export started with a GraphFileWriter.
+ * In the foreground, flushes the rest of the buffer and closes the file.
+ * In the background, hands the formatted buffer to a worker thread; the
+ * outcome is reported by graphFileSaveFinished() when it is done.
+ * @param out
+ * @param message to show once the file is written
+ * @return false if the file could not be written
+ */
+bool Graph::graphSaveFinish(GraphFileWriter &out, const QString &message) {
+    if ( !out.isBackground() ) {
+        if ( !out.close() ) {
+            emit statusMessage ( tr("Error. Could not write to ") + out.fileName() );
+            return false;
+        }
+        emit statusMessage (message);
+        return true;
+    }
+    qDebug() << "Graph::graphSaveFinish() - writing" << out.fileName()
+             << "in the background";
+    m_fileSavePending = true;
+    m_fileSaveStale = false;
+    m_fileSaveName = out.fileName();
+    m_fileSaveMessage = message;
+    m_fileSaveWatcher.setFuture(
+                QtConcurrent::run( graphFileWriteBuffer, out.fileName(), out.takeBuffer() )
+                );
+    emit statusMessage ( tr("Writing %1 in the background...")
+                         .arg( QFileInfo(m_fileSaveName).fileName() ) );
+    return true;
+}
+
+
+
+/**
+ * @brief Called when a background save has written its file (or failed).
+ * Marks the graph as saved, unless it was modified in the meantime.
+ */
+void Graph::graphFileSaveFinished() {
+    if ( !m_fileSavePending ) {
+        return;
+    }
+    m_fileSavePending = false;
+    if ( !m_fileSaveWatcher.result() ) {
+        qDebug() << "Graph::graphFileSaveFinished() - ERROR writing" << m_fileSaveName;
+        emit statusMessage ( tr("Error. Could not write to ") + m_fileSaveName );
+        emit signalGraphSavedStatus(FileType::UNRECOGNIZED);
+        return;
+    }
+    emit statusMessage (m_fileSaveMessage);
+    if ( m_fileSaveStale ) {
+        qDebug() << "Graph::graphFileSaveFinished() - graph changed while saving. "
+                    "Not marking it as saved.";
+        return;
+    }
+    graphSetModified(GraphChange::ChangedNone);
+}
+
+
+
+/**
+ * @brief Toggles writing exported network files on a background thread
+ * @param toggle
+ */
+void Graph::setFileSaveInBackground(const bool &toggle) {
+    m_fileSaveInBackground = toggle;
+}
+
+
+
 
 /**
     Saves the active graph to a Pajek-formatted file
@@ -15710,7 +16709,8 @@ bool Graph::graphSaveToPajekFormat (const QString &fileName, \
                                     int maxWidth, int maxHeight
                                     )
 {
-    qreal weight=0;
+    qreal weight=0, reverseWeight=0;
+    int source=0, target=0;
     QFileInfo fileInfo (fileName);
     QString fileNameNoPath = fileInfo.fileName();
 
@@ -15724,69 +16724,73 @@ bool Graph::graphSaveToPajekFormat (const QString &fileName, \
     maxHeight= (maxHeight== 0) ? canvasHeight:maxHeight;
 
 
-    QFile f( fileName );
-    if ( !f.open( QIODevice::WriteOnly | QIODevice::Text ) )  {
+    GraphFileWriter t( fileName, m_fileSaveInBackground );
+    if ( !t.open() )  {
         emit statusMessage ( tr("Error. Could not write to ") + fileName );
         return false;
     }
-    QTextStream t( &f );
-    t.setCodec("UTF-8");
     t<<"*Network "<<networkName<<"\n";
 
     t<<"*Vertices "<< vertices() <<"\n";
     VList::const_iterator it;
-    VList::const_iterator jt;
     for (it=m_graph.cbegin(); it!=m_graph.cend(); ++it){
-        qDebug()<<" Name x "<<  (*it)->name()  ;
         t<<(*it)->name()  <<" "<<"\""<<(*it)->label()<<"\"" ;
         t << " ic ";
         t<<  (*it)->colorToPajek();
-        qDebug()<<" Coordinates x " << (*it)->x()<< " "<<maxWidth<<" y " << (*it)->y()<< " "<<maxHeight;
         t << "\t\t" <<(*it)->x()/(maxWidth)<<" \t"<<(*it)->y()/(maxHeight);
         t << "\t"<<(*it)->shape();
         t<<"\n";
     }
 
+    // Arcs are the edges whose reverse edge has a different weight (or
+    // does not exist). Reciprocated edges of equal weight go to *Edges.
+    QVector< QPair<int, qreal> > outEdges;
+    QVector< QPair<int, qreal> >::const_iterator et;
+
     t<<"*Arcs \n";
     qDebug()<< "Graph::graphSaveToPajekFormat: Arcs";
     for (it=m_graph.cbegin(); it!=m_graph.cend(); ++it){
-        for (jt=m_graph.begin(); jt!=m_graph.end(); jt++){
-            qDebug() << "Graph::graphSaveToPajekFormat:  it=" << (*it)->name() << ", jt=" << (*jt)->name() ;
-            if  ( (weight=edgeExists ( (*it)->name(), (*jt)->name())) !=0
-                  &&   ( edgeExists ((*jt)->name(), (*it)->name())) != weight
-                  )
-            {
-                qDebug()<<"Graph::graphSaveToPajekFormat  weight "<< weight
-                       << " color "<<  (*it)->outLinkColor( (*jt)->name() ) ;
-                t << (*it)->name() <<" "<<(*jt)->name()<< " "<<weight;
-                //FIXME bug in outLinkColor() when we remove then add many nodes from the end
-                t<< " c "<< (*it)->outLinkColor( (*jt)->name() );
-                t <<"\n";
+        source = (*it)->name();
+        graphFileOutEdges( (*it), vpos, outEdges );
+        for (et=outEdges.cbegin(); et!=outEdges.cend(); ++et){
+            target = et->first;
+            weight = et->second;
+            if ( weight == 0 ) {
+                continue;
             }
-
+            reverseWeight = m_graph[ vpos[target] ]->hasEdgeTo(source);
+            if ( reverseWeight == weight ) {
+                continue;
+            }
+            t << source <<" "<< target << " "<<weight;
+            //FIXME bug in outLinkColor() when we remove then add many nodes from the end
+            t<< " c "<< (*it)->outLinkColor( target );
+            t <<"\n";
         }
     }
 
     t<<"*Edges \n";
     qDebug() << "Graph::graphSaveToPajekFormat: Edges";
     for (it=m_graph.cbegin(); it!=m_graph.cend(); ++it){
-        for (jt=m_graph.begin(); jt!=m_graph.end(); jt++){
-            qDebug() << "Graph::graphSaveToPajekFormat:  it=" <<  (*it)->name() << ", jt=" <<(*jt)->name() ;
-            if  ( ( weight=edgeExists((*it)->name(), (*jt)->name(), true) )!=0 )  {
-                if ( (*it)->name() > (*jt)->name() )
-                    continue;
-                t << (*it)->name() <<" "<<(*jt)->name()<< " "<<weight;
-                t << " c "<< (*it)->outLinkColor( (*jt)->name() );
-                t <<"\n";
+        source = (*it)->name();
+        graphFileOutEdges( (*it), vpos, outEdges );
+        for (et=outEdges.cbegin(); et!=outEdges.cend(); ++et){
+            target = et->first;
+            weight = et->second;
+            if ( weight == 0 || source > target ) {
+                continue;
+            }
+            reverseWeight = m_graph[ vpos[target] ]->hasEdgeTo(source);
+            if ( reverseWeight != weight ) {
+                continue;
             }
+            t << source <<" "<< target << " "<<weight;
+            t << " c "<< (*it)->outLinkColor( target );
+            t <<"\n";
         }
     }
-    f.close();
-
-    emit statusMessage (tr( "File %1 saved" ).arg( fileNameNoPath ));
-    return true;
-
 
+    return graphSaveFinish( t, tr( "File %1 saved" ).arg( fileNameNoPath ) );
 
 }
 
@@ -15798,66 +16802,136 @@ bool Graph::graphSaveToPajekFormat (const QString &fileName, \
  */
 bool Graph::graphSaveToAdjacencyFormat (const QString &fileName,
                                         const bool &saveEdgeWeights){
-    QFile file( fileName );
-    if ( !file.open( QIODevice::WriteOnly | QIODevice::Text ) )  {
+    GraphFileWriter outText( fileName, m_fileSaveInBackground );
+    if ( !outText.open() )  {
         emit statusMessage ( tr("Error. Could not write to ") + fileName );
         return false;
     }
-    QTextStream outText( &file );
-    outText.setCodec("UTF-8");
     qDebug("Graph: graphSaveToAdjacencyFormat() for %i vertices", vertices());
 
     writeMatrixAdjacencyTo(outText, saveEdgeWeights);
 
-    file.close();
     QString fileNameNoPath=fileName.split("/").last();
-    emit statusMessage (QString( tr("Adjacency matrix-formatted network saved into file %1") ).arg( fileNameNoPath ));
-    return true;
-}
-
-
-
-
-bool Graph::graphSaveToDotFormat (QString fileName){
-    Q_UNUSED(fileName);
-    return true;
+    return graphSaveFinish( outText,
+                            QString( tr("Adjacency matrix-formatted network saved into file %1") ).arg( fileNameNoPath ) );
 }
 
 
 
 /**
- * @brief Saves the current graph to fileName in GraphML format
+ * @brief Saves the current relation of the graph to fileName in GraphViz
+ * (dot) format, with the labels, colors and shapes of nodes and the
+ * weights, colors and labels of edges.
  * @param fileName
- * @param networkName
- * @param maxWidth
- * @param maxHeight
  * @return
  */
-bool Graph::graphSaveToGraphMLFormat (const QString &fileName,
-                                      QString networkName,
-                                      int maxWidth,
-                                      int maxHeight) {
-
+bool Graph::graphSaveToDotFormat (QString fileName){
 
     qreal weight=0;
-    int source=0, target=0, edgeCount=0, m_size=1, m_labelSize;
-    QString m_color, m_labelColor, m_label;
-    bool openToken;
+    int source=0, target=0;
+    QString label;
 
     QFileInfo fileInfo (fileName);
     QString fileNameNoPath = fileInfo.fileName();
 
-    QString saveDirPath= fileInfo.canonicalPath();
+    QString networkName = graphName();
+    networkName  = (networkName == "" || networkName == "unnamed")
+            ? fileNameNoPath.left(fileNameNoPath.lastIndexOf('.'))
+            : networkName;
+    networkName = networkName.simplified().remove('\"').replace(' ', '_');
 
-    qDebug () << "Graph::graphSaveToGraphMLFormat() - Save to directory:"
-              << saveDirPath;
+    qDebug () << "Graph::graphSaveToDotFormat() - file:" << fileName.toUtf8()
+              << "networkName"<< networkName;
 
-    QString iconsSubDir = fileInfo.baseName() + "_" + fileInfo.suffix() +"_images";
-    QString iconsDirPath = saveDirPath + "/" + iconsSubDir;
+    GraphFileWriter outText( fileName, m_fileSaveInBackground );
+    if ( !outText.open() )  {
+        emit statusMessage ( tr("Error. Could not write to ") + fileName );
+        return false;
+    }
 
-    QDir saveDir(saveDirPath);
+    const bool undirected = graphIsUndirected();
+    const char *edgeOp = (undirected) ? " -- " : " -> ";
 
-    // Check if there are nodes with custom icons in the network
+    outText << ( (undirected) ? "graph " : "digraph " ) << networkName << " {\n";
+    outText << "  // Created by SocNetV " << VERSION << "\n";
+
+    VList::const_iterator it;
+    for (it=m_graph.cbegin(); it!=m_graph.cend(); ++it){
+        if ( ! (*it)->isEnabled () )
+            continue;
+        label = (*it)->label().simplified().remove('\"');
+        outText << "  " << (*it)->name()
+                << " [label=\"" << label
+                << "\", color=\"" << (*it)->color()
+                << "\", shape=\"" << (*it)->shape() << "\"];\n";
+    }
+
+    QVector< QPair<int, qreal> > outEdges;
+    QVector< QPair<int, qreal> >::const_iterator et;
+    for (it=m_graph.cbegin(); it!=m_graph.cend(); ++it){
+        if ( ! (*it)->isEnabled () )
+            continue;
+        source = (*it)->name();
+        graphFileOutEdges( (*it), vpos, outEdges );
+        for (et=outEdges.cbegin(); et!=outEdges.cend(); ++et){
+            target = et->first;
+            weight = et->second;
+            if ( weight == 0 ) {
+                continue;
+            }
+            if ( undirected && vpos[target] < vpos[source] ) {
+                continue;
+            }
+            outText << "  " << source << edgeOp << target
+                    << " [value=" << weight
+                    << ", color=\"" << (*it)->outLinkColor( target ) << "\"";
+            label = (*it)->outEdgeLabel( target ).simplified().remove('\"');
+            if ( !label.isEmpty() ) {
+                outText << ", label=\"" << label << "\"";
+            }
+            outText << "];\n";
+        }
+    }
+    outText << "}\n";
+
+    return graphSaveFinish( outText, tr( "File %1 saved" ).arg( fileNameNoPath ) );
+}
+
+
+
+/**
+ * @brief Saves the current graph to fileName in GraphML format
+ * @param fileName
+ * @param networkName
+ * @param maxWidth
+ * @param maxHeight
+ * @return
+ */
+bool Graph::graphSaveToGraphMLFormat (const QString &fileName,
+                                      QString networkName,
+                                      int maxWidth,
+                                      int maxHeight) {
+
+
+    qreal weight=0;
+    int source=0, target=0, edgeCount=0, m_size=1, m_labelSize;
+    QString m_color, m_labelColor, m_label;
+    bool openToken, undirected;
+
+    QFileInfo fileInfo (fileName);
+    QString fileNameNoPath = fileInfo.fileName();
+
+    QString saveDirPath= fileInfo.canonicalPath();
+
+    qDebug () << "Graph::graphSaveToGraphMLFormat() - Save to directory:"
+              << saveDirPath;
+
+    QString iconsSubDir = fileInfo.baseName() + "_" + fileInfo.suffix() +"_images";
+    QString iconsDirPath = saveDirPath + "/" + iconsSubDir;
+
+    QDir saveDir(saveDirPath);
+
+    // Check if there are nodes with custom icons in the network
     if ( graphHasVertexCustomIcons()) {
         qDebug () << "Graph::graphSaveToGraphMLFormat() - Custom node icons exist."
                   <<  "Creating images subdir" << iconsDirPath;
@@ -15890,18 +16964,14 @@ bool Graph::graphSaveToGraphMLFormat (const QString &fileName,
     maxWidth = (maxWidth == 0) ? (int)canvasWidth:maxWidth ;
     maxHeight= (maxHeight== 0) ? (int)canvasHeight:maxHeight;
 
-    QFile f( fileName );
-    if ( !f.open( QIODevice::WriteOnly | QIODevice::Text ) )  {
+    GraphFileWriter outText( fileName, m_fileSaveInBackground );
+    if ( !outText.open() )  {
         emit statusMessage ( tr("Error. Could not write to ") + fileName );
         return false;
     }
-    QTextStream outText( &f );
-    outText.setCodec("UTF-8");
-    qDebug () << "Graph::graphSaveToGraphMLFormat() - codec used for saving stream: "
-              << outText.codec()->name();
 
     qDebug()<< "Graph::graphSaveToGraphMLFormat() -  writing xml version";
-    outText << "<?xml version=\"1.0\" encoding=\"" << outText.codec()->name() << "\"?> \n";
+    outText << "<?xml version=\"1.0\" encoding=\"UTF-8\"?> \n";
     outText << " <!-- Created by SocNetV "<<  VERSION << " --> \n" ;
     outText << "<graphml xmlns=\"http://graphml.graphdrawing.org/xmlns\" "
                "      xmlns:xsi=\"http://www.w3.org/2001/XMLSchema-instance \" "
@@ -15978,7 +17048,8 @@ bool Graph::graphSaveToGraphMLFormat (const QString &fileName,
                 "  </key> \n";
 
     VList::const_iterator it;
-    VList::const_iterator jt;
+    QVector< QPair<int, qreal> > outEdges;
+    QVector< QPair<int, qreal> >::const_iterator et;
     QString  relationName;
     int relationPrevious = relationCurrent();
     for (int i = 0; i < relations(); ++i) {
@@ -15999,8 +17070,6 @@ bool Graph::graphSaveToGraphMLFormat (const QString &fileName,
         for (it=m_graph.cbegin(); it!=m_graph.cend(); ++it){
             if ( ! (*it)->isEnabled () )
                 continue;
-            qDebug() << "Graph::graphSaveToGraphMLFormat() - Node id: "
-                     <<  (*it)->name()  ;
             outText << "    <node id=\"" << (*it)->name() << "\"> \n";
             m_color = (*it)->color();
             m_size = (*it)->size() ;
@@ -16012,10 +17081,6 @@ bool Graph::graphSaveToGraphMLFormat (const QString &fileName,
 
             outText << "      <data key=\"d0\">" << m_label <<"</data>\n";
 
-            qDebug()<<"Graph::graphSaveToGraphMLFormat() - Coordinates x "
-                   << (*it)->x()<< " "<<maxWidth
-                   <<" y " << (*it)->y()<< " "<<maxHeight;
-
             outText << "      <data key=\"d1\">" << (*it)->x()/(maxWidth) <<"</data>\n";
             outText << "      <data key=\"d2\">" << (*it)->y()/(maxHeight) <<"</data>\n";
 
@@ -16065,121 +17130,769 @@ bool Graph::graphSaveToGraphMLFormat (const QString &fileName,
 
         qDebug() << "Graph::graphSaveToGraphMLFormat() - writing edges data";
         edgeCount=0;
-        if (graphIsDirected()) {
-            for (it=m_graph.cbegin(); it!=m_graph.cend(); ++it)
+        undirected = graphIsUndirected();
+        for (it=m_graph.cbegin(); it!=m_graph.cend(); ++it)
+        {
+            source=(*it)->name();
+            graphFileOutEdges( (*it), vpos, outEdges );
+            for (et=outEdges.cbegin(); et!=outEdges.cend(); ++et)
             {
-                for (jt=m_graph.begin(); jt!=m_graph.end(); jt++)
-                {
-                    source=(*it)->name();
-                    target=(*jt)->name();
-                    m_label = "";
-                    weight= edgeExists( source,target ) ;
-                    if  (  weight !=0 )
-                    {
-                        ++edgeCount;
-                        m_color = (*it)->outLinkColor( target );
-                        m_label = edgeLabel(source, target);
-                        m_label=htmlEscaped(m_label);
-                        qDebug()<< "Graph::graphSaveToGraphMLFormat() - edge no "
-                                << edgeCount
-                                << " from n1=" << source << " to n2=" << target
-                                << " with weight " << weight
-                                << " and color " << m_color.toUtf8() ;
-                        outText << "    <edge id=\""<< "e"+QString::number(edgeCount)
-                                << "\" directed=\"" << "true" << "\" source=\"" << source
-                                << "\" target=\"" << target << "\"";
-
-                        openToken = true;
-                        if ( weight != 0 ) {
-                            outText << "> \n";
-                            outText << "      <data key=\"d8\">" << weight<<"</data>" <<" \n";
-                            openToken=false;
-                        }
-                        if (  QString::compare ( initEdgeColor, m_color,  Qt::CaseInsensitive) != 0) {
-                            if (openToken)
-                                outText << "> \n";
-                            outText << "      <data key=\"d9\">" << m_color <<"</data>" <<" \n";
-                            openToken=false;
-                        }
-                        if (  !m_label.isEmpty()) {
-                            if (openToken)
-                                outText << "> \n";
-                            outText << "      <data key=\"d10\">" << m_label<<"</data>" <<" \n";
-                            openToken=false;
-                        }
+                target=et->first;
+                weight=et->second;
+                if  (  weight == 0 ) {
+                    continue;
+                }
+                // In undirected graphs each edge is stored both ways.
+                if ( undirected && vpos[target] < vpos[source] ) {
+                    continue;
+                }
+                ++edgeCount;
+                m_color = (*it)->outLinkColor( target );
+                m_label = (*it)->outEdgeLabel( target );
+                m_label=htmlEscaped(m_label);
+                outText << "    <edge id=\"" << "e" << edgeCount
+                        << "\" directed=\"" << ( (undirected) ? "false" : "true" )
+                        << "\" source=\"" << source
+                        << "\" target=\"" << target << "\"";
+
+                openToken = true;
+                if ( weight != 0 ) {
+                    outText << "> \n";
+                    outText << "      <data key=\"d8\">" << weight<<"</data>" <<" \n";
+                    openToken=false;
+                }
+                if (  QString::compare ( initEdgeColor, m_color,  Qt::CaseInsensitive) != 0) {
+                    if (openToken)
+                        outText << "> \n";
+                    outText << "      <data key=\"d9\">" << m_color <<"</data>" <<" \n";
+                    openToken=false;
+                }
+                if (  !m_label.isEmpty()) {
+                    if (openToken)
+                        outText << "> \n";
+                    outText << "      <data key=\"d10\">" << m_label<<"</data>" <<" \n";
+                    openToken=false;
+                }
 
-                        if (openToken)
-                            outText << "/> \n";
-                        else
-                            outText << "    </edge>\n";
+                if (openToken)
+                    outText << "/> \n";
+                else
+                    outText << "    </edge>\n";
+            }
+        }
 
-                    }
+        outText << "  </graph>\n";
+    }
+    outText << "</graphml>\n";
+
+    relationSet(relationPrevious, false);
+
+    return graphSaveFinish( outText, tr( "File %1 saved" ).arg( fileNameNoPath ) );
+}
+
+
+
+/*
+ * Layout of the native SocNetV binary snapshot (.snvb):
+ * a SnapshotHeader followed by header.sections sections, each one made of a
+ * SnapshotSection and its payload, padded to 8 bytes so that every array
+ * is aligned when the file is memory-mapped. Sections may come in any order;
+ * the writer puts the string pool last. Values are in host byte order;
+ * the loader refuses snapshots whose byteOrder marker does not match.
+ *   Strings:   quint64 offsets[count+1], then the UTF-8 bytes of all strings
+ *   Vertices:  SnapshotVertex[count]
+ *   Relations: quint32 name[count] (indices into the string pool)
+ *   Edges:     one section per relation, in CSR form: quint64 rows[N+1],
+ *              then SnapshotEdge[count] sorted by source row and target.
+ *              All edges are stored, also those of disabled vertices and
+ *              those hidden by filters, with their enabled flag.
+ *   Distances: optional, SnapshotDistanceInfo, double distance[N*N],
+ *              qint32 shortestPaths[N*N], double eccentricity[N],
+ *              double distanceSum[N] of the current relation.
+ *              Not saved when larger than SNAPSHOT_DISTANCES_MAX_BYTES
+ *              (1 GiB, about 9,400 vertices); the SnapshotDistances flag
+ *              is then clear and distances are recomputed when needed.
+ */
+static const char SNAPSHOT_MAGIC[8] = { 'S','o','c','N','e','t','V','B' };
+static const quint32 SNAPSHOT_VERSION = 2;
+static const quint32 SNAPSHOT_BYTE_ORDER = 0x01020304;
+static const quint64 SNAPSHOT_DISTANCES_MAX_BYTES = Q_UINT64_C(1) << 30;
+
+enum SnapshotFlag {
+    SnapshotDirected  = 0x1,
+    SnapshotWeighted  = 0x2,
+    SnapshotDistances = 0x4
+};
+
+enum SnapshotEdgeFlag {
+    SnapshotEdgeEnabled = 0x1
+};
+
+enum SnapshotSectionId {
+    SectionStrings   = 1,
+    SectionVertices  = 2,
+    SectionRelations = 3,
+    SectionEdges     = 4,
+    SectionDistances = 5
+};
+
+struct SnapshotHeader {
+    char magic[8];
+    quint32 version;
+    quint32 byteOrder;
+    quint32 vertices;
+    quint32 relations;
+    quint32 currentRelation;
+    quint32 flags;
+    quint32 graphName;
+    quint32 sections;
+    quint64 edges;
+    double canvasWidth;
+    double canvasHeight;
+};
+
+struct SnapshotSection {
+    quint32 id;
+    quint32 reserved;
+    quint64 count;
+    quint64 bytes;
+};
+
+struct SnapshotVertex {
+    double x;           // normalized to the canvas width
+    double y;           // normalized to the canvas height
+    qint32 name;
+    qint32 size;
+    qint32 numberSize;
+    qint32 numberDistance;
+    qint32 labelSize;
+    qint32 labelDistance;
+    quint32 color;
+    quint32 numberColor;
+    quint32 label;
+    quint32 labelColor;
+    quint32 shape;
+    quint32 iconPath;
+    quint32 enabled;
+    quint32 reserved;
+};
+
+struct SnapshotEdge {
+    double weight;
+    quint32 target;     // position of the target in the Vertices section
+    quint32 color;
+    quint32 label;
+    quint32 flags;      // SnapshotEdgeFlag
+};
+
+struct SnapshotDistanceInfo {
+    double sumDistance;
+    double averageDistance;
+    double geodesicsCount;
+    qint32 diameter;
+    quint32 connected;
+};
+
+static inline quint64 snapshotPadding(const quint64 &bytes) {
+    return (8 - bytes % 8) % 8;
+}
+
+static inline quint64 snapshotDistanceBytes(const quint64 &N) {
+    const quint64 sigmaBytes = N * N * sizeof(qint32);
+    return sizeof(SnapshotDistanceInfo) + N * N * sizeof(double)
+            + sigmaBytes + snapshotPadding(sigmaBytes) + 2 * N * sizeof(double);
+}
+
+
+
+/**
+ * @brief Saves the active graph to a native SocNetV binary snapshot (.snvb)
+ * All relations, vertex and edge properties are stored in flat arrays
+ * (a string pool, a vertex table and one CSR edge table per relation),
+ * so that graphLoadSnapshot() can map the file and rebuild the graph
+ * without parsing any text. Each section is streamed to the file, so no
+ * table is held in memory at once. If geodesic distances of the current
+ * relation have been computed, they are stored too, unless too large.
+ * @param fileName
+ * @return
+ */
+bool Graph::graphSaveToSnapshotFormat (const QString &fileName) {
+
+    QFileInfo fileInfo (fileName);
+    QString fileNameNoPath = fileInfo.fileName();
+
+    qDebug () << "Graph::graphSaveToSnapshotFormat() - file:" << fileName;
+
+    QFile f( fileName );
+    if ( !f.open( QIODevice::WriteOnly ) )  {
+        emit statusMessage ( tr("Error. Could not write to ") + fileName );
+        return false;
+    }
+
+    const int N = m_graph.size();
+    const int R = relations();
+    const int relationPrevious = relationCurrent();
+    const bool saveDistances = calculatedDistances
+            && snapshotDistanceBytes(N) <= SNAPSHOT_DISTANCES_MAX_BYTES;
+
+    if ( calculatedDistances && !saveDistances ) {
+        qDebug () << "Graph::graphSaveToSnapshotFormat() - distance cache of"
+                  << N << "vertices too large, not saved";
+    }
+
+    QStringList strings;
+    QHash<QString, quint32> stringIndex;
+    auto intern = [&strings, &stringIndex] (const QString &str) -> quint32 {
+        QHash<QString, quint32>::const_iterator it = stringIndex.constFind(str);
+        if ( it != stringIndex.constEnd() ) {
+            return it.value();
+        }
+        const quint32 index = strings.count();
+        stringIndex.insert(str, index);
+        strings << str;
+        return index;
+    };
+
+    // Every section is streamed to the file: the section header first,
+    // then its payload in small pieces, then the padding.
+    auto write = [&f] (const void *data, const quint64 &bytes) {
+        f.write( reinterpret_cast<const char*>(data), bytes );
+    };
+    auto writePadding = [&f] (const quint64 &bytes) {
+        static const char zeros[8] = { 0 };
+        f.write( zeros, snapshotPadding(bytes) );
+    };
+    auto beginSection = [&write] (const quint32 &id, const quint64 &count,
+                                  const quint64 &bytes) {
+        SnapshotSection section;
+        section.id = id;
+        section.reserved = 0;
+        section.count = count;
+        section.bytes = bytes;
+        write( &section, sizeof(section) );
+    };
+
+    SnapshotHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, SNAPSHOT_MAGIC, sizeof(header.magic));
+    header.version = SNAPSHOT_VERSION;
+    header.byteOrder = SNAPSHOT_BYTE_ORDER;
+    header.vertices = N;
+    header.relations = R;
+    header.currentRelation = relationPrevious;
+    header.flags = ( graphIsDirected() ? SnapshotDirected : 0 )
+            | ( graphIsWeighted() ? SnapshotWeighted : 0 )
+            | ( saveDistances ? SnapshotDistances : 0 );
+    header.graphName = intern( graphName() );
+    header.sections = 3 + R + ( saveDistances ? 1 : 0 );
+    header.canvasWidth = canvasWidth;
+    header.canvasHeight = canvasHeight;
+
+    // The edge count is known only at the end; the header is rewritten then.
+    write( &header, sizeof(header) );
+
+    // Vertices
+    QHash<int, quint32> position;
+    position.reserve(N);
+    beginSection( SectionVertices, N, (quint64) N * sizeof(SnapshotVertex) );
+    VList::const_iterator it;
+    int i = 0;
+    for (it=m_graph.cbegin(); it!=m_graph.cend(); ++it, ++i) {
+        SnapshotVertex sv;
+        memset(&sv, 0, sizeof(sv));
+        position.insert( (*it)->name(), i );
+        sv.x = ( canvasWidth != 0 ) ? (*it)->x() / canvasWidth : (*it)->x();
+        sv.y = ( canvasHeight != 0 ) ? (*it)->y() / canvasHeight : (*it)->y();
+        sv.name = (*it)->name();
+        sv.size = (*it)->size();
+        sv.numberSize = (*it)->numberSize();
+        sv.numberDistance = (*it)->numberDistance();
+        sv.labelSize = (*it)->labelSize();
+        sv.labelDistance = (*it)->labelDistance();
+        sv.color = intern( (*it)->color() );
+        sv.numberColor = intern( (*it)->numberColor() );
+        sv.label = intern( (*it)->label() );
+        sv.labelColor = intern( (*it)->labelColor() );
+        sv.shape = intern( (*it)->shape() );
+        sv.iconPath = intern( (*it)->shapeIconPath() );
+        sv.enabled = (*it)->isEnabled() ? 1 : 0;
+        write( &sv, sizeof(sv) );
+    }
+    writePadding( (quint64) N * sizeof(SnapshotVertex) );
+
+    // Relation names
+    beginSection( SectionRelations, R, (quint64) R * sizeof(quint32) );
+    for (int r = 0; r < R; ++r) {
+        const quint32 name = intern( m_relationsList.at(r) );
+        write( &name, sizeof(name) );
+    }
+    writePadding( (quint64) R * sizeof(quint32) );
+
+    // One CSR edge table per relation: the row offsets are counted in a
+    // first pass, then the edges are written row by row.
+    QVector<quint64> rows(N + 1);
+    QVector<SnapshotEdge> rowEdges;
+    QHash<int, pair_f_b> outEdges;
+    QHash<int, pair_f_b>::const_iterator et;
+    for (int r = 0; r < R; ++r) {
+        relationSet( r, false );
+        quint64 count = 0;
+        i = 0;
+        for (it=m_graph.cbegin(); it!=m_graph.cend(); ++it, ++i) {
+            rows[i] = count;
+            count += (*it)->outEdgesHash().count();
+        }
+        rows[N] = count;
+        header.edges += count;
+
+        const quint64 bytes = (quint64) (N + 1) * sizeof(quint64)
+                + count * sizeof(SnapshotEdge);
+        beginSection( SectionEdges, count, bytes );
+        write( rows.constData(), (quint64) (N + 1) * sizeof(quint64) );
+        for (it=m_graph.cbegin(); it!=m_graph.cend(); ++it) {
+            rowEdges.clear();
+            outEdges = (*it)->outEdgesHash();
+            for (et = outEdges.cbegin(); et != outEdges.cend(); ++et) {
+                SnapshotEdge edge;
+                edge.weight = et.value().first;
+                edge.target = position.value( et.key() );
+                edge.color = intern( (*it)->outLinkColor( et.key() ) );
+                edge.label = intern( (*it)->outEdgeLabel( et.key() ) );
+                edge.flags = et.value().second ? SnapshotEdgeEnabled : 0;
+                rowEdges.append( edge );
+            }
+            std::sort( rowEdges.begin(), rowEdges.end(),
+                       [] (const SnapshotEdge &a, const SnapshotEdge &b) {
+                return a.target < b.target;
+            });
+            write( rowEdges.constData(), (quint64) rowEdges.size() * sizeof(SnapshotEdge) );
+        }
+        writePadding( bytes );
+    }
+    relationSet( relationPrevious, false );
+
+    // Geodesic distances of the current relation, one matrix row at a time
+    if ( saveDistances ) {
+        const quint64 bytes = snapshotDistanceBytes(N);
+        const quint64 sigmaBytes = (quint64) N * N * sizeof(qint32);
+        beginSection( SectionDistances, N, bytes );
+
+        SnapshotDistanceInfo info;
+        memset(&info, 0, sizeof(info));
+        info.sumDistance = m_graphSumDistance;
+        info.averageDistance = m_graphAverageDistance;
+        info.geodesicsCount = m_graphGeodesicsCount;
+        info.diameter = m_graphDiameter;
+        info.connected = m_graphIsConnected ? 1 : 0;
+        write( &info, sizeof(info) );
+
+        QVector<double> dist(N);
+        for (it=m_graph.cbegin(); it!=m_graph.cend(); ++it) {
+            VList::const_iterator jt;
+            int j = 0;
+            for (jt=m_graph.cbegin(); jt!=m_graph.cend(); ++jt, ++j) {
+                dist[j] = (*it)->distance( (*jt)->name() );
+            }
+            write( dist.constData(), (quint64) N * sizeof(double) );
+        }
+        QVector<qint32> sigma(N);
+        for (it=m_graph.cbegin(); it!=m_graph.cend(); ++it) {
+            VList::const_iterator jt;
+            int j = 0;
+            for (jt=m_graph.cbegin(); jt!=m_graph.cend(); ++jt, ++j) {
+                sigma[j] = (*it)->shortestPaths( (*jt)->name() );
+            }
+            write( sigma.constData(), (quint64) N * sizeof(qint32) );
+        }
+        writePadding( sigmaBytes );
+        i = 0;
+        for (it=m_graph.cbegin(); it!=m_graph.cend(); ++it, ++i) {
+            dist[i] = (*it)->eccentricity();
+        }
+        write( dist.constData(), (quint64) N * sizeof(double) );
+        i = 0;
+        for (it=m_graph.cbegin(); it!=m_graph.cend(); ++it, ++i) {
+            dist[i] = (*it)->distanceSum();
+        }
+        write( dist.constData(), (quint64) N * sizeof(double) );
+        writePadding( bytes );
+    }
+
+    // String pool, last, since the other sections fill it
+    {
+        QVector<quint64> offsets( strings.count() + 1 );
+        quint64 stringBytes = 0;
+        for (int s = 0; s < strings.count(); ++s) {
+            offsets[s] = stringBytes;
+            stringBytes += strings.at(s).toUtf8().size();
+        }
+        offsets[strings.count()] = stringBytes;
+        const quint64 bytes = offsets.size() * sizeof(quint64) + stringBytes;
+        beginSection( SectionStrings, strings.count(), bytes );
+        write( offsets.constData(), offsets.size() * sizeof(quint64) );
+        for (int s = 0; s < strings.count(); ++s) {
+            f.write( strings.at(s).toUtf8() );
+        }
+        writePadding( bytes );
+    }
+
+    f.seek(0);
+    write( &header, sizeof(header) );
+
+    if ( f.error() != QFileDevice::NoError ) {
+        f.close();
+        emit statusMessage ( tr("Error. Could not write to ") + fileName );
+        return false;
+    }
+    f.close();
+
+    qDebug () << "Graph::graphSaveToSnapshotFormat() - vertices" << N
+              << "relations" << R << "edges" << header.edges
+              << "strings" << strings.count() << "distances" << saveDistances;
+
+    emit statusMessage( tr( "File %1 saved" ).arg( fileNameNoPath ) );
+
+    return true;
+}
+
+
+
+/**
+ * @brief Loads a native SocNetV binary snapshot (.snvb)
+ * Called from graphLoad() instead of the Parser. The file is memory-mapped
+ * (or read at once if mapping fails) and the graph is rebuilt directly from
+ * its tables: relations, vertices, then the edges of each relation.
+ * Cached geodesic distances are restored, so that they are not recomputed.
+ * Reports the result through graphFileLoaded(), as the Parser does.
+ * @param fileName
+ * @return
+ */
+bool Graph::graphLoadSnapshot(const QString &fileName) {
+
+    qDebug() << "Graph::graphLoadSnapshot() - file:" << fileName;
+
+    auto fail = [this, &fileName] (const QString &reason) {
+        qDebug() << "Graph::graphLoadSnapshot() - error:" << reason;
+        graphFileLoaded( FileType::UNRECOGNIZED, QString::null, QString::null,
+                         0, 0, 0,
+                         tr("Error loading snapshot file %1: %2").arg(fileName).arg(reason) );
+        return false;
+    };
+
+    QFile file(fileName);
+    if ( !file.open(QIODevice::ReadOnly) ) {
+        return fail( tr("Cannot open file.") );
+    }
+
+    const quint64 size = file.size();
+    QByteArray buffer;
+    const uchar *data = file.map(0, size);
+    if ( !data ) {
+        qDebug() << "Graph::graphLoadSnapshot() - cannot map file, reading it";
+        buffer = file.readAll();
+        data = reinterpret_cast<const uchar*>( buffer.constData() );
+    }
+
+    if ( size < sizeof(SnapshotHeader) ) {
+        return fail( tr("File too short.") );
+    }
+    const SnapshotHeader *header = reinterpret_cast<const SnapshotHeader*>(data);
+    if ( memcmp(header->magic, SNAPSHOT_MAGIC, sizeof(header->magic)) != 0 ) {
+        return fail( tr("Not a SocNetV snapshot.") );
+    }
+    if ( header->byteOrder != SNAPSHOT_BYTE_ORDER ) {
+        return fail( tr("Snapshot saved on a machine with different byte order.") );
+    }
+    if ( header->version != SNAPSHOT_VERSION ) {
+        return fail( tr("Unsupported snapshot version %1.").arg(header->version) );
+    }
+
+    const quint64 N = header->vertices;
+    const quint64 R = header->relations;
 
+    const quint64 *stringOffsets = 0;
+    const char *stringBytes = 0;
+    quint64 stringCount = 0, stringBytesSize = 0;
+    const SnapshotVertex *sv = 0;
+    const quint32 *rn = 0;
+    QVector<const quint64 *> edgeRows;
+    QVector<const SnapshotEdge *> edgeTables;
+    const uchar *distanceTable = 0;
+
+    quint64 offset = sizeof(SnapshotHeader);
+    for (quint32 s = 0; s < header->sections; ++s) {
+        if ( offset > size || size - offset < sizeof(SnapshotSection) ) {
+            return fail( tr("Truncated section header.") );
+        }
+        const SnapshotSection *section =
+                reinterpret_cast<const SnapshotSection*>(data + offset);
+        offset += sizeof(SnapshotSection);
+        if ( section->bytes > size - offset ) {
+            return fail( tr("Truncated section.") );
+        }
+        const uchar *payload = data + offset;
+        switch (section->id) {
+        case SectionStrings: {
+            stringCount = section->count;
+            if ( stringCount >= section->bytes / sizeof(quint64) ) {
+                return fail( tr("Invalid string pool.") );
+            }
+            stringOffsets = reinterpret_cast<const quint64*>(payload);
+            stringBytes = reinterpret_cast<const char*>( stringOffsets + stringCount + 1 );
+            stringBytesSize = section->bytes - (stringCount + 1) * sizeof(quint64);
+            break;
+        }
+        case SectionVertices: {
+            if ( section->count != N || section->bytes != N * sizeof(SnapshotVertex) ) {
+                return fail( tr("Invalid vertex table.") );
+            }
+            sv = reinterpret_cast<const SnapshotVertex*>(payload);
+            break;
+        }
+        case SectionRelations: {
+            if ( section->count != R || section->bytes != R * sizeof(quint32) ) {
+                return fail( tr("Invalid relation table.") );
+            }
+            rn = reinterpret_cast<const quint32*>(payload);
+            break;
+        }
+        case SectionEdges: {
+            if ( section->bytes < (N + 1) * sizeof(quint64)
+                 || section->count != ( section->bytes - (N + 1) * sizeof(quint64) )
+                                      / sizeof(SnapshotEdge)
+                 || section->bytes != (N + 1) * sizeof(quint64)
+                                      + section->count * sizeof(SnapshotEdge) ) {
+                return fail( tr("Invalid edge table.") );
+            }
+            const quint64 *rows = reinterpret_cast<const quint64*>(payload);
+            const SnapshotEdge *edges = reinterpret_cast<const SnapshotEdge*>( rows + N + 1 );
+            if ( rows[0] != 0 || rows[N] != section->count ) {
+                return fail( tr("Invalid edge table.") );
+            }
+            for (quint64 i = 0; i < N; ++i) {
+                if ( rows[i] > rows[i+1] ) {
+                    return fail( tr("Invalid edge table.") );
+                }
+            }
+            for (quint64 e = 0; e < section->count; ++e) {
+                if ( edges[e].target >= N ) {
+                    return fail( tr("Invalid edge target.") );
                 }
             }
+            edgeRows << rows;
+            edgeTables << edges;
+            break;
         }
-        else {
-            for (it=m_graph.cbegin(); it!=m_graph.cend(); ++it)
-            {
-                for (jt=it; jt!=m_graph.end(); jt++)
-                {
-                    source=(*it)->name();
-                    target=(*jt)->name();
-                    weight= edgeExists( source,target );
-                    m_label = "";
-                    if  (  weight  !=0 )
-                    {
-                        ++edgeCount;
-                        m_color = (*it)->outLinkColor( target );
-                        m_label = edgeLabel(source, target);
-                        m_label=htmlEscaped(m_label);
-                        qDebug()<< "Graph::graphSaveToGraphMLFormat() - edge no "
-                                << edgeCount
-                                << " from n1=" << source << " to n2=" << target
-                                << " with weight " << weight
-                                << " and color " << m_color.toUtf8() ;
-                        outText << "    <edge id=\""<< "e"+QString::number(edgeCount)
-                                << "\" directed=\"" << "false" << "\" source=\"" << source
-                                << "\" target=\"" << target << "\"";
-
-                        openToken = true;
-                        if ( weight !=0 ) {
-                            outText << "> \n";
-                            outText << "      <data key=\"d8\">" << weight<<"</data>" <<" \n";
-                            openToken=false;
-                        }
-                        if (  QString::compare ( initEdgeColor, m_color,  Qt::CaseInsensitive) != 0) {
-                            if (openToken)
-                                outText << "> \n";
-                            outText << "      <data key=\"d9\">" << m_color <<"</data>" <<" \n";
-                            openToken=false;
-                        }
-                        if (  !m_label.isEmpty()) {
-                            if (openToken)
-                                outText << "> \n";
-                            outText << "      <data key=\"d10\">" << m_label<<"</data>" <<" \n";
-                            openToken=false;
-                        }
-                        if (openToken)
-                            outText << "/> \n";
-                        else
-                            outText << "    </edge>\n";
+        case SectionDistances: {
+            if ( section->count != N || section->bytes != snapshotDistanceBytes(N) ) {
+                return fail( tr("Invalid distance table.") );
+            }
+            distanceTable = payload;
+            break;
+        }
+        default: {
+            qDebug() << "Graph::graphLoadSnapshot() - skipping unknown section"
+                     << section->id;
+            break;
+        }
+        };
+        offset += section->bytes + snapshotPadding(section->bytes);
+    }
 
-                    }
+    if ( !stringOffsets || !sv || !rn || (quint64) edgeRows.count() != R ) {
+        return fail( tr("Missing sections.") );
+    }
+
+    QStringList strings;
+    strings.reserve(stringCount);
+    for (quint64 s = 0; s < stringCount; ++s) {
+        if ( stringOffsets[s] > stringOffsets[s+1] || stringOffsets[s+1] > stringBytesSize ) {
+            return fail( tr("Invalid string pool.") );
+        }
+        strings << QString::fromUtf8( stringBytes + stringOffsets[s],
+                                      stringOffsets[s+1] - stringOffsets[s] );
+    }
+    auto str = [&strings] (const quint32 &index) {
+        return ( index < (quint32) strings.count() ) ? strings.at(index) : QString();
+    };
+
+    m_graphIsDirected = ( header->flags & SnapshotDirected );
+
+    for (quint64 r = 0; r < R; ++r) {
+        relationAdd( str( rn[r] ), false );
+    }
 
+    // vertices
+    m_graph.reserve( m_graph.size() + N );
+    vpos.reserve( vpos.size() + N );
+    for (quint64 i = 0; i < N; ++i) {
+        const QPointF p( sv[i].x * canvasWidth, sv[i].y * canvasHeight );
+        if (order)
+            vpos[ sv[i].name ]=m_totalVertices;
+        else
+            vpos[ sv[i].name ]=m_graph.size();
+
+        GraphVertex *vertex = new GraphVertex ( this,
+                                                sv[i].name,
+                                                1,
+                                                m_curRelation ,
+                                                sv[i].size,
+                                                str( sv[i].color ),
+                                                str( sv[i].numberColor ),
+                                                sv[i].numberSize,
+                                                str( sv[i].label ),
+                                                str( sv[i].labelColor ),
+                                                sv[i].labelSize,
+                                                p,
+                                                str( sv[i].shape ),
+                                                str( sv[i].iconPath )
+                                                );
+        vertex->setNumberDistance( sv[i].numberDistance );
+        vertex->setLabelDistance( sv[i].labelDistance );
+        m_graph.append( vertex );
+        m_totalVertices++;
+
+        emit signalDrawNode( p,
+                             sv[i].name,
+                             sv[i].size,
+                             str( sv[i].shape ),
+                             str( sv[i].iconPath ),
+                             str( sv[i].color ),
+                             str( sv[i].numberColor ),
+                             sv[i].numberSize,
+                             sv[i].numberDistance,
+                             str( sv[i].label ),
+                             str( sv[i].labelColor ),
+                             sv[i].labelSize,
+                             sv[i].labelDistance );
+    }
+
+    // edges, relation by relation, as edgeCreate() would add them
+    int totalLinks = 0;
+    for (quint64 r = 0; r < R; ++r) {
+        relationSet( r, false );
+        emit signalRelationChangedToGW( r );
+        const quint64 *rows = edgeRows.at(r);
+        const SnapshotEdge *edges = edgeTables.at(r);
+        for (quint64 i = 0; i < N; ++i) {
+            const int v1 = sv[i].name;
+            for (quint64 e = rows[i]; e < rows[i+1]; ++e) {
+                const int v2 = sv[ edges[e].target ].name;
+                const qreal weight = edges[e].weight;
+                if ( edgeExists(v1, v2) ) {
+                    continue;
+                }
+                int type = EdgeType::Directed;
+                QString color = str( edges[e].color );
+                if ( !m_graphIsDirected ) {
+                    type = EdgeType::Undirected;
+                }
+                else if ( edgeExists(v2, v1) ) {
+                    type = EdgeType::Reciprocated;
+                }
+                else {
+                    m_graphIsSymmetric = false;
+                }
+                if ( weight == 0 && type != EdgeType::Reciprocated ) {
+                    color = "blue";
+                }
+                edgeAdd ( v1, v2, weight, type, str( edges[e].label ), color );
+                m_canvas->drawEdge( v1, v2, weight, str( edges[e].label ), color,
+                                    type, ( type != EdgeType::Undirected ), false,
+                                    initEdgeWeightNumbers );
+                totalLinks++;
+            }
+        }
+        // disable filtered edges only now, so that edgeExists() above
+        // judged reciprocity on the full edge set, as when first created
+        for (quint64 i = 0; i < N; ++i) {
+            for (quint64 e = rows[i]; e < rows[i+1]; ++e) {
+                if ( !( edges[e].flags & SnapshotEdgeEnabled ) ) {
+                    m_graph[ vpos[ sv[i].name ] ]->setOutEdgeEnabled(
+                                sv[ edges[e].target ].name, false );
                 }
             }
         }
+    }
 
-        outText << "  </graph>\n";
+    const int current = ( header->currentRelation < R ) ? header->currentRelation : 0;
+    relationSet( current, false );
+    emit signalRelationChangedToGW( current );
+    emit signalRelationChangedToMW( current );
+
+    for (quint64 i = 0; i < N; ++i) {
+        if ( !sv[i].enabled ) {
+            m_graph[ vpos[ sv[i].name ] ]->setEnabled( false );
+            emit setVertexVisibility( sv[i].name, false );
+        }
     }
-    outText << "</graphml>\n";
 
-    f.close();
-    relationSet(relationPrevious, false);
+    if (N) {
+        initVertexColor = str( sv[N-1].color );
+        initVertexSize = sv[N-1].size;
+        initVertexShape = str( sv[N-1].shape );
+        if (initVertexShape=="custom"){
+            initVertexIconPath = str( sv[N-1].iconPath );
+        }
+    }
 
-    emit statusMessage( tr( "File %1 saved" ).arg( fileNameNoPath ) );
+    graphSetModified( (totalLinks) ? GraphChange::ChangedEdges : GraphChange::ChangedVertices,
+                      false );
 
+    // the saved weighted flag spares graphIsWeighted() its scan of all pairs
+    graphSetWeighted( ( header->flags & SnapshotWeighted ) != 0 );
+    calculatedGraphWeighted = true;
+
+    // restore geodesic distances after graphSetModified() has reset them
+    if ( distanceTable && ( header->flags & SnapshotDistances ) ) {
+        const SnapshotDistanceInfo *info =
+                reinterpret_cast<const SnapshotDistanceInfo*>(distanceTable);
+        const double *dist = reinterpret_cast<const double*>(
+                    distanceTable + sizeof(SnapshotDistanceInfo) );
+        const qint32 *sigma = reinterpret_cast<const qint32*>( dist + N * N );
+        const quint64 sigmaBytes = N * N * sizeof(qint32);
+        const double *eccentricity = reinterpret_cast<const double*>(
+                    reinterpret_cast<const uchar*>(sigma) + sigmaBytes + snapshotPadding(sigmaBytes) );
+        const double *distanceSum = eccentricity + N;
+
+        m_vertexPairsNotConnected.clear();
+        for (quint64 i = 0; i < N; ++i) {
+            GraphVertex *vertex = m_graph[ vpos[ sv[i].name ] ];
+            vertex->clearDistance();
+            vertex->clearShortestPaths();
+            for (quint64 j = 0; j < N; ++j) {
+                const double d = dist[ i * N + j ];
+                if ( d != RAND_MAX ) {
+                    vertex->setDistance( sv[j].name, d );
+                }
+                else if ( i != j && sv[i].enabled && sv[j].enabled ) {
+                    m_vertexPairsNotConnected.insertMulti( sv[i].name, sv[j].name );
+                }
+                if ( sigma[ i * N + j ] != 0 ) {
+                    vertex->setShortestPaths( sv[j].name, sigma[ i * N + j ] );
+                }
+            }
+            vertex->setEccentricity( eccentricity[i] );
+            vertex->setDistanceSum( distanceSum[i] );
+        }
+        m_graphSumDistance = info->sumDistance;
+        m_graphAverageDistance = info->averageDistance;
+        m_graphGeodesicsCount = info->geodesicsCount;
+        m_graphDiameter = info->diameter;
+        m_graphIsConnected = ( info->connected != 0 );
+        calculatedDistances = true;
+        qDebug() << "Graph::graphLoadSnapshot() - restored geodesic distances";
+    }
+
+    file.close();
+
+    graphFileLoaded( FileType::SNVB,
+                     fileName,
+                     str( header->graphName ),
+                     N,
+                     totalLinks,
+                     ( m_graphIsDirected ) ? EdgeType::Directed : EdgeType::Undirected,
+                     QString::null );
     return true;
 }
 
@@ -20440,28 +22153,76 @@ void Graph::writeMatrixHTMLTable(QTextStream& outText,
               << "plain" << plain
               << " dropIsolates " << dropIsolates;
 
-    int rowCount=0, i=0, j=0;
-    int N = vertices();
-    qreal maxVal, minVal, element;
-    bool hasRealNumbers=false;
-
-    VList::const_iterator it, jt;
-
-    QString pMsg = tr("Writing matrix to file. \nPlease wait...");
-    emit statusMessage( pMsg );
-    emit signalProgressBoxCreate(N, pMsg );
-
-    M.findMinMaxValues(minVal, maxVal, hasRealNumbers);
+    writeMatrixHTMLTableOf(outText, M, markDiag, printInfinity, dropIsolates);
+}
 
-    outText <<  ( (hasRealNumbers) ? qSetRealNumberPrecision(3) : qSetRealNumberPrecision(0) ) ;
 
-    qDebug () << "Graph::writeMatrixHTMLTable() - minVal" << minVal
-              << "maxVal" << maxVal << "hasRealNumbers" << hasRealNumbers;
 
-    outText << "<table  border=\"1\" cellspacing=\"0\" cellpadding=\"0\" class=\"stripes\">"
-            << "<thead>"
-            << "<tr>"
-            << "<th>"
+/**
+ * @brief Writes the symmetric matrix M as HTML <table> to specified text stream outText
+ * @param outText
+ * @param M
+ * @param markDiag
+ * @param plain
+ * @param printInfinity
+ */
+void Graph::writeMatrixHTMLTable(QTextStream& outText,
+                                 SymmetricMatrix &M,
+                                 const bool &markDiag,
+                                 const bool &plain,
+                                 const bool &printInfinity,
+                                 const bool &dropIsolates) {
+
+    Q_UNUSED(plain);
+
+    qDebug () << "Graph::writeMatrixHTMLTable() - symmetric -"
+              << "markDiag" << markDiag
+              << "plain" << plain
+              << " dropIsolates " << dropIsolates;
+
+    writeMatrixHTMLTableOf(outText, M, markDiag, printInfinity, dropIsolates);
+}
+
+
+
+/**
+ * @brief Writes any matrix type with findMinMaxValues() and item() accessors
+ * (Matrix, SymmetricMatrix) as HTML <table>. See writeMatrixHTMLTable
+ * @param outText
+ * @param M
+ * @param markDiag
+ * @param printInfinity
+ * @param dropIsolates
+ */
+template <class M>
+void Graph::writeMatrixHTMLTableOf(QTextStream& outText,
+                                   M &matrix,
+                                   const bool &markDiag,
+                                   const bool &printInfinity,
+                                   const bool &dropIsolates) {
+
+    int rowCount=0, i=0, j=0;
+    int N = vertices();
+    qreal maxVal, minVal, element;
+    bool hasRealNumbers=false;
+
+    VList::const_iterator it, jt;
+
+    QString pMsg = tr("Writing matrix to file. \nPlease wait...");
+    emit statusMessage( pMsg );
+    emit signalProgressBoxCreate(N, pMsg );
+
+    matrix.findMinMaxValues(minVal, maxVal, hasRealNumbers);
+
+    outText <<  ( (hasRealNumbers) ? qSetRealNumberPrecision(3) : qSetRealNumberPrecision(0) ) ;
+
+    qDebug () << "Graph::writeMatrixHTMLTable() - minVal" << minVal
+              << "maxVal" << maxVal << "hasRealNumbers" << hasRealNumbers;
+
+    outText << "<table  border=\"1\" cellspacing=\"0\" cellpadding=\"0\" class=\"stripes\">"
+            << "<thead>"
+            << "<tr>"
+            << "<th>"
             << tr("<sub>Actor</sup>/<sup>Actor</sup>")
             << "</th>";
 
@@ -20503,9 +22264,9 @@ void Graph::writeMatrixHTMLTable(QTextStream& outText,
 
             outText <<"<td" << ((markDiag && (*it)->name() ==(*jt)->name() )? " class=\"diag\">" : ">");
 
-            element = M.item(i,j);
+            element = matrix.item(i,j);
 
-            qDebug () << "Graph::writeMatrixHTMLTable() - M(" <<i<<","<<j<<") =" <<  M.item(i,j);
+            qDebug () << "Graph::writeMatrixHTMLTable() - M(" <<i<<","<<j<<") =" <<  element;
 
             if ( ( element == RAND_MAX ) && printInfinity) {
                 // print inf symbol instead of RAND_MAX (distances matrix).
@@ -20564,23 +22325,39 @@ void Graph::writeMatrixHTMLTable(QTextStream& outText,
 /** 
     Exports the adjacency matrix to a given textstream
 */
-void Graph::writeMatrixAdjacencyTo(QTextStream& os,
+void Graph::writeMatrixAdjacencyTo(GraphFileWriter& os,
                                    const bool &saveEdgeWeights){
     qDebug("Graph: adjacencyMatrix(), writing matrix with %i vertices", vertices());
-    VList::const_iterator it, it1;
-    qreal weight=RAND_MAX;
+    VList::const_iterator it;
+    // Column of each enabled vertex. Each row is filled from the adjacency
+    // list of its vertex instead of testing every pair of vertices.
+    H_Int column;
+    int n=0;
     for (it=m_graph.cbegin(); it!=m_graph.cend(); ++it){
         if ( ! (*it)->isEnabled() ) continue;
-        for (it1=m_graph.cbegin(); it1!=m_graph.cend(); ++it1){
-            if ( ! (*it1)->isEnabled() ) continue;
-            if ( (weight = edgeExists( (*it)->name(), (*it1)->name() )  ) !=0 ) {
-                //os << static_cast<int> (weight) << " ";
-                os << ((saveEdgeWeights) ? weight : 1 ) << " ";
+        column[ (*it)->name() ] = n++;
+    }
+    QVector<qreal> row(n);
+    QHash<int, qreal> enabledOutEdges;
+    QHash<int, qreal>::const_iterator et;
+    int col = 0;
+    for (it=m_graph.cbegin(); it!=m_graph.cend(); ++it){
+        if ( ! (*it)->isEnabled() ) continue;
+        row.fill(0);
+        enabledOutEdges = (*it)->outEdgesEnabledHash();
+        for (et = enabledOutEdges.cbegin(); et != enabledOutEdges.cend(); ++et) {
+            if ( ( col = column.value( et.key(), -1 ) ) != -1 ) {
+                row[col] = et.value();
+            }
+        }
+        for (col = 0; col < n; ++col) {
+            if ( row[col] != 0 ) {
+                os << ((saveEdgeWeights) ? row[col] : 1.0 ) << " ";
             }
             else
                 os << "0 ";
         }
-        os << endl;
+        os << "\n";
     }
 
 }
@@ -21166,6 +22943,7 @@ void Graph::writeMatrixLaplacianPlainText(const QString &fn) {
  */
 void Graph::layoutRandom(){
     qDebug()<< "Graph::layoutRandom() ";
+    layoutRunnerStop();
     double new_x=0, new_y=0;
     VList::const_iterator it;
 
@@ -21205,6 +22983,7 @@ void Graph::layoutRandom(){
  */
 void Graph::layoutRadialRandom(const bool &guides){
     qDebug() << "Graph::layoutRadialRandom - ";
+    layoutRunnerStop();
     double rad=0, new_radius=0, new_x=0, new_y=0;
     double i=0;
     double x0=canvasWidth/2.0;
@@ -21272,6 +23051,7 @@ void Graph::layoutRadialRandom(const bool &guides){
 void Graph::layoutCircular (const double &x0, const double &y0,
                           const double &newRadius, const bool &guides){
     qDebug() << "Graph::layoutCircular - ";
+    layoutRunnerStop();
     double rad=0, new_x=0, new_y=0;
     double i=0;
     VList::const_iterator it;
@@ -21367,6 +23147,7 @@ void Graph::layoutByProminenceIndex (int prominenceIndex, int layoutType,
     qDebug() << "Graph::layoutByProminenceIndex - "
                 << "index = " << prominenceIndex
                 << "type = " << layoutType;
+    layoutRunnerStop();
 
     double  i=0, std=0, norm=0;
     double new_x=0, new_y=0;
@@ -21715,149 +23496,433 @@ void Graph::layoutByProminenceIndex (int prominenceIndex, int layoutType,
 
 
 /**
- * @brief Embeds a Force Directed Placement layout according to the initial Spring Embedder model proposed by Eades.
- * @param maxIterations
- *  The Spring Embedder model (Eades, 1984), part of the Force Directed Placement (FDP) family,
-    assigns forces to all vertices and edges, as if nodes were electrically charged particles (Coulomb's law)
-    and all edges were springs (i.e. Hooke's law).
+ * Cells deeper than this hold all their points in one leaf, so that
+ * (nearly) coincident vertices do not split the quadtree forever.
+ */
+static const int LAYOUT_QUADTREE_MAX_DEPTH = 24;
 
-    These forces are applied to the nodes iteratively, pulling them closer together or pushing them further apart,
-    until the system comes to an equilibrium state (node positions do not change anymore).
 
-    Note that, following Eades, we do not need to have a faithful simulation;
-    we can -and we do- apply unrealistic forces in an unrealistic manner.
-    For instance, instead of the forces described by Hooke's law,
-    we will assume weaker logarithmic forces between far apart vertices...
+/**
+ * Layout kernels run over the vertices in chunks of this size,
+ * one chunk per task of the thread pool.
  */
-void Graph::layoutForceDirectedSpringEmbedder(const int maxIterations){
+static const int LAYOUT_CHUNK_SIZE = 256;
 
-    int iteration = 1 ;
-    int progressCounter=0;
-    qreal dist = 0;
-    qreal f_rep=0, f_att=0;
-    QPointF DV;
-    qreal c4=0.1; //normalization factor for final displacement
 
+/**
+ * @brief Runs f(begin, end) over the ranges [0, count) in chunks of
+ * LAYOUT_CHUNK_SIZE, on the thread pool.
+ * @param count
+ * @param f
+ */
+template <class F>
+static void layoutParallelChunks(const int &count, F f) {
+    QVector<int> chunks;
+    for (int begin = 0 ; begin < count ; begin += LAYOUT_CHUNK_SIZE ) {
+        chunks.append(begin);
+    }
+    QtConcurrent::blockingMap(chunks, [&](const int &begin) {
+        f( begin, qMin(begin + LAYOUT_CHUNK_SIZE, count) );
+    });
+}
 
-    VList::const_iterator v1;
-    VList::const_iterator v2;
 
+/**
+ * @brief Barnes-Hut quadtree over the positions x, y of the enabled vertices.
+ * Each cell keeps the total mass of the points under it (1 per point,
+ * unless masses are given) and their center of mass.
+ * Leaves hold a chain of points (more than one only at maximum depth or
+ * for coincident points). Built once per force-directed iteration.
+ */
+class LayoutQuadTree {
+public:
+    LayoutQuadTree(const QVector<qreal> &x, const QVector<qreal> &y,
+                   const QVector<bool> &enabled,
+                   const QVector<qreal> &mass = QVector<qreal>()) :
+        m_x(x), m_y(y), m_mass(mass), m_next(x.count(), -1)
+    {
+        qreal minX = 0, minY = 0, maxX = 0, maxY = 0;
+        bool first = true;
+        for (int i = 0 ; i < x.count() ; i++ ) {
+            if ( !enabled[i] ) {
+                continue;
+            }
+            if ( first ) {
+                minX = maxX = x[i];
+                minY = maxY = y[i];
+                first = false;
+                continue;
+            }
+            minX = qMin(minX, x[i]);
+            maxX = qMax(maxX, x[i]);
+            minY = qMin(minY, y[i]);
+            maxY = qMax(maxY, y[i]);
+        }
+        const qreal half = qMax(maxX - minX, maxY - minY) / 2.0 + 1.0;
+        m_cells.reserve(2 * x.count() + 1);
+        addCell( (minX + maxX) / 2.0, (minY + maxY) / 2.0, half );
+        for (int i = 0 ; i < x.count() ; i++ ) {
+            if ( enabled[i] ) {
+                insert(i);
+            }
+        }
+    }
 
     /**
-     * compute max spring length as function of canvas area divided by the
-     * total vertices area
-    */
-    qreal V = (qreal) vertices() ;
-    qreal naturalLength= computeOptimalDistance(V);
-    qDebug() << "\n\n layoutForceDirectedSpringEmbedder() "
-             << " vertices " << V
-             << " naturalLength " << naturalLength;
+     * @brief Returns the total repulsive displacement of point i.
+     * Cells farther than cutoff are skipped, as f_rep is zero there.
+     * Cells which look smaller than theta from point i act as a single
+     * point at their center of mass, with their total mass.
+     * Like the all-pairs loop, forces are applied along each axis by the
+     * sign of the difference vector, and coincident points are ignored.
+     * @param i
+     * @param theta
+     * @param cutoff
+     * @param f_rep  the (negative) repulsive force at a distance
+     */
+    template <class F>
+    QPointF repulsion(const int &i, const qreal &theta, const qreal &cutoff,
+                      F f_rep) const {
+        const qreal px = m_x[i], py = m_y[i];
+        QPointF disp(0, 0);
+        QVarLengthArray<int, 128> stack;
+        stack.append(0);
+        while ( !stack.isEmpty() ) {
+            const Cell &cell = m_cells[ stack.last() ];
+            stack.removeLast();
+            if ( cell.mass == 0 ) {
+                continue;
+            }
+            const qreal gapX = qMax( qAbs(px - cell.cx) - cell.half, (qreal) 0 );
+            const qreal gapY = qMax( qAbs(py - cell.cy) - cell.half, (qreal) 0 );
+            if ( gapX * gapX + gapY * gapY > cutoff * cutoff ) {
+                continue;
+            }
+            if ( cell.leaf ) {
+                for (int j = cell.point ; j != -1 ; j = m_next[j] ) {
+                    if ( j != i ) {
+                        add(disp, m_x[j] - px, m_y[j] - py, mass(j), f_rep);
+                    }
+                }
+                continue;
+            }
+            const qreal DX = cell.sumX / cell.mass - px;
+            const qreal DY = cell.sumY / cell.mass - py;
+            const qreal dist = qSqrt( DX * DX + DY * DY );
+            if ( gapX + gapY > 0 && 2.0 * cell.half < theta * dist ) {
+                add(disp, DX, DY, cell.mass, f_rep);
+                continue;
+            }
+            for (int q = 0 ; q < 4 ; q++ ) {
+                if ( cell.child[q] != -1 ) {
+                    stack.append( cell.child[q] );
+                }
+            }
+        }
+        return disp;
+    }
 
+private:
+    struct Cell {
+        qreal cx, cy, half;
+        qreal mass, sumX, sumY;
+        int child[4];
+        int point;      // first point of a leaf, or -1
+        bool leaf;
+    };
+
+    template <class F>
+    static void add(QPointF &disp, const qreal &DX, const qreal &DY,
+                    const qreal &mass, F f_rep) {
+        const qreal dist = qSqrt( DX * DX + DY * DY );
+        if ( dist == 0 ) {
+            return;
+        }
+        const qreal f = mass * f_rep(dist);
+        disp.rx() += ( (DX > 0) ? f : (DX < 0) ? -f : 0 );
+        disp.ry() += ( (DY > 0) ? f : (DY < 0) ? -f : 0 );
+    }
 
-    /* apply an initial random layout */
-    //layoutCircular(canvasWidth/2.0, canvasHeight/2.0, naturalLength/2.0 ,false);
-    layoutRandom();
+    int addCell(const qreal &cx, const qreal &cy, const qreal &half) {
+        Cell cell;
+        cell.cx = cx;
+        cell.cy = cy;
+        cell.half = half;
+        cell.mass = cell.sumX = cell.sumY = 0;
+        cell.child[0] = cell.child[1] = cell.child[2] = cell.child[3] = -1;
+        cell.point = -1;
+        cell.leaf = true;
+        m_cells.append(cell);
+        return m_cells.count() - 1;
+    }
 
-    QString pMsg  = tr ( "Embedding Eades Spring-Gravitational model. \n"
-                         "Please wait ....");
-    emit statusMessage( pMsg  );
-    emit signalProgressBoxCreate (maxIterations, pMsg );
+    qreal mass(const int &i) const {
+        return ( m_mass.isEmpty() ) ? 1.0 : m_mass[i];
+    }
 
-    for ( iteration=1; iteration <= maxIterations ; iteration++) {
+    int quadrant(const int &c, const qreal &x, const qreal &y) const {
+        return ( ( x >= m_cells[c].cx ) ? 1 : 0 ) + ( ( y >= m_cells[c].cy ) ? 2 : 0 );
+    }
 
-        //setup init disp
-        for (v1=m_graph.cbegin(); v1!=m_graph.cend(); ++v1)
-        {
-            (*v1) -> disp().rx() = 0;
-            (*v1) -> disp().ry() = 0;
-            qDebug() << " 0000 s " << (*v1)->name() << " zeroing rx/ry";
+    int child(const int &c, const int &q) {
+        if ( m_cells[c].child[q] == -1 ) {
+            const qreal half = m_cells[c].half / 2.0;
+            const int created = addCell( m_cells[c].cx + ( (q & 1) ? half : -half ),
+                                         m_cells[c].cy + ( (q & 2) ? half : -half ),
+                                         half );
+            m_cells[c].child[q] = created;
+        }
+        return m_cells[c].child[q];
+    }
+
+    void insert(const int &i) {
+        const qreal x = m_x[i], y = m_y[i];
+        const qreal m = mass(i);
+        int c = 0;
+        for (int depth = 0 ; ; depth++ ) {
+            if ( m_cells[c].leaf ) {
+                const int occupant = m_cells[c].point;
+                if ( occupant == -1 || depth >= LAYOUT_QUADTREE_MAX_DEPTH
+                     || ( m_x[occupant] == x && m_y[occupant] == y ) ) {
+                    m_next[i] = occupant;
+                    m_cells[c].point = i;
+                    m_cells[c].mass += m;
+                    m_cells[c].sumX += m * x;
+                    m_cells[c].sumY += m * y;
+                    return;
+                }
+                // split: the occupants (all at one position) move down
+                const int q = quadrant(c, m_x[occupant], m_y[occupant]);
+                const int below = child(c, q);
+                m_cells[below].point = occupant;
+                m_cells[below].mass = m_cells[c].mass;
+                m_cells[below].sumX = m_cells[c].sumX;
+                m_cells[below].sumY = m_cells[c].sumY;
+                m_cells[c].point = -1;
+                m_cells[c].leaf = false;
+            }
+            m_cells[c].mass += m;
+            m_cells[c].sumX += m * x;
+            m_cells[c].sumY += m * y;
+            c = child(c, quadrant(c, x, y));
         }
+    }
+
+    const QVector<qreal> &m_x;
+    const QVector<qreal> &m_y;
+    const QVector<qreal> m_mass;
+    QVector<int> m_next;        // next point in the same leaf, or -1
+    QVector<Cell> m_cells;
+};
 
-        for (v1=m_graph.cbegin(); v1!=m_graph.cend(); ++v1)
-        {
-            qDebug() << "*********  Calculate forces for source s  "
-                     << (*v1) -> name()
-                     <<" pos "<< (*v1) -> x()<< ", "<< (*v1) -> y();
 
-            if ( ! (*v1)->isEnabled() ) {
-                qDebug() << "  vertex s disabled. Continue";
+
+/**
+ * @brief One force-directed pass over the positions of buffer: sets its
+ * displacements dx, dy to the repulsion (Barnes-Hut, in parallel chunks)
+ * plus the attraction along the CSR edges, using the force functions
+ * f_rep and f_att of distance.
+ * With symmetricEdges, every edge is listed at both ends and pulls only
+ * its source; otherwise it pulls both ends. Empty mass or edgeWeight
+ * vectors stand for 1.
+ */
+template <class Rep, class Att>
+static void layoutForces(LayoutBuffer &buffer,
+                         const QVector<qreal> &mass,
+                         const QVector<int> &edgeStart,
+                         const QVector<int> &edgeTarget,
+                         const QVector<qreal> &edgeWeight,
+                         const bool &symmetricEdges,
+                         const qreal &theta,
+                         const qreal &cutoff,
+                         Rep f_rep,
+                         Att f_att) {
+    const int N = buffer.x.count();
+    buffer.dx.fill(0, N);
+    buffer.dy.fill(0, N);
+    const qreal *x = buffer.x.constData();
+    const qreal *y = buffer.y.constData();
+    const bool *enabled = buffer.enabled.constData();
+    qreal *dx = buffer.dx.data();
+    qreal *dy = buffer.dy.data();
+
+    // repulsion between all vertices, within the cutoff
+    const LayoutQuadTree tree(buffer.x, buffer.y, buffer.enabled, mass);
+    layoutParallelChunks(N, [&](const int &begin, const int &end) {
+        for (int i = begin ; i < end ; i++ ) {
+            if ( enabled[i] ) {
+                const QPointF f = tree.repulsion(i, theta, cutoff, f_rep);
+                dx[i] = f.x();
+                dy[i] = f.y();
+            }
+        }
+    });
+
+    // attraction between neighbors, once per edge
+    for (int s = 0 ; s < N ; s++ ) {
+        for (int e = edgeStart[s] ; e < edgeStart[s + 1] ; e++ ) {
+            const int t = edgeTarget[e];
+            const qreal DX = x[t] - x[s];
+            const qreal DY = y[t] - y[s];
+            const qreal dist = qSqrt( DX * DX + DY * DY );
+            if ( dist == 0 ) {
                 continue;
             }
+            qreal f_a = f_att(dist);
+            if ( !edgeWeight.isEmpty() ) {
+                f_a *= edgeWeight[e];
+            }
+            dx[s] += Graph::sign( DX ) * f_a;
+            dy[s] += Graph::sign( DY ) * f_a;
+            if ( !symmetricEdges ) {
+                dx[t] -= Graph::sign( DX ) * f_a;
+                dy[t] -= Graph::sign( DY ) * f_a;
+            }
+        }
+    }
+}
 
-            for (v2=m_graph.cbegin(); v2!=m_graph.cend(); ++v2)
-            {
-                if ( ! (*v2)->isEnabled() ) {
-                    qDebug() << "   t " << (*v1)->name() << " disabled. Continue";
-                    continue;
-                }
 
-                if (v2 == v1) {
-                    qDebug() << "   s==t, continuing";
-                    continue;
-                }
 
-                DV.setX( (*v2) -> x() - (*v1)->x());
-                DV.setY( (*v2) -> y() - (*v1)->y());
+/**
+ * @brief Moves every vertex of buffer by its displacement, limited to
+ * temperature along each axis, and keeps it within [minX, maxX] x [minY, maxY].
+ * Runs in parallel chunks; the loop body is branch free so that the
+ * compiler can vectorize it.
+ * @return qreal the total movement (sum of absolute steps)
+ */
+static qreal layoutMove(LayoutBuffer &buffer, const qreal &temperature,
+                        const qreal &minX, const qreal &maxX,
+                        const qreal &minY, const qreal &maxY) {
+    const int N = buffer.x.count();
+    qreal *x = buffer.x.data();
+    qreal *y = buffer.y.data();
+    const qreal *dx = buffer.dx.constData();
+    const qreal *dy = buffer.dy.constData();
+    QVector<qreal> moved( (N + LAYOUT_CHUNK_SIZE - 1) / LAYOUT_CHUNK_SIZE, 0 );
+    qreal *chunkMoved = moved.data();
+    layoutParallelChunks(N, [&](const int &begin, const int &end) {
+        qreal sum = 0;
+        for (int i = begin ; i < end ; i++ ) {
+            const qreal xvel = qBound( -temperature, dx[i], temperature );
+            const qreal yvel = qBound( -temperature, dy[i], temperature );
+            x[i] = qBound( minX, x[i] + xvel, maxX );
+            y[i] = qBound( minY, y[i] + yvel, maxY );
+            sum += qAbs(xvel) + qAbs(yvel);
+        }
+        chunkMoved[ begin / LAYOUT_CHUNK_SIZE ] = sum;
+    });
+    qreal total = 0;
+    for (int c = 0 ; c < moved.count() ; c++ ) {
+        total += moved[c];
+    }
+    return total;
+}
 
-                dist = graphDistanceEuclidean(DV);
 
-                /**
-                  *  calculate electric (repulsive) forces between
-                  *  all vertices.
-                  */
-                f_rep = layoutForceDirected_F_rep ("Eades", dist, naturalLength) ;
-                (*v1)->disp().rx() += sign( DV.x() ) * f_rep ;
-                (*v1)->disp().ry() += sign( DV.y() ) * f_rep  ;
-                qDebug() <<"  s = "<< (*v1)->name()
-                         <<" pushed away from t = " << (*v2) -> name()
-                           << " dist " <<dist
-                        << " f_rep=" << f_rep
-                        << " sign * f_repx " << sign( DV.x() ) * f_rep
-                        << " sign * f_repy " << sign( DV.y() ) * f_rep ;
 
-                /**
-                * calculate spring forces between adjacent nodes
-                * that pull them together (if d > naturalLength)
-                * or push them apart (if d < naturalLength)
-                */
-                if ( this->edgeExists( (*v1) ->name(), (*v2) -> name()) ) {
+/**
+ * @brief Moves every vertex of buffer by c4 times its displacement,
+ * keeping it within [minX, maxX] x [minY, maxY]. Used by the Eades model,
+ * which rounds small positive steps up to one pixel.
+ */
+static void layoutMoveScaled(LayoutBuffer &buffer, const qreal &c4,
+                             const qreal &minX, const qreal &maxX,
+                             const qreal &minY, const qreal &maxY) {
+    qreal *x = buffer.x.data();
+    qreal *y = buffer.y.data();
+    const qreal *dx = buffer.dx.constData();
+    const qreal *dy = buffer.dy.constData();
+    layoutParallelChunks(buffer.x.count(), [&](const int &begin, const int &end) {
+        for (int i = begin ; i < end ; i++ ) {
+            // calculate new overall velocity vector
+            qreal xvel = c4 * dx[i];
+            qreal yvel = c4 * dy[i];
+            // small positive steps are rounded up to one pixel, as before
+            xvel = ( xvel > 0 && xvel < 1 ) ? 1 : xvel;
+            yvel = ( yvel > 0 && yvel < 1 ) ? 1 : yvel;
+            // check if new pos is out of usable screen and adjust
+            x[i] = qBound( minX, x[i] + xvel, maxX );
+            y[i] = qBound( minY, y[i] + yvel, maxY );
+        }
+    });
+}
 
-                    f_att = layoutForceDirected_F_att ("Eades", dist, naturalLength) ;
 
-                    (*v1)->disp().rx() += sign( DV.x() ) * f_att ;
-                    (*v1)->disp().ry() += sign( DV.y() ) * f_att ;
-                    (*v2)->disp().rx() -= sign( DV.x() ) * f_att ;
-                    (*v2)->disp().ry() -= sign( DV.y() ) * f_att ;
 
-                    qDebug() << "  s= "<<(*v1)->name()
-                             << " attracted by t= "<< (*v2)->name()
-                                << " dist " <<dist
-                             << " f_att="<< f_att
-                             << " sdx * f_att " <<sign( DV.x() ) * f_att
-                             << " sdy * f_att " <<sign( DV.y() ) * f_att
-                             << " disp_s.x="<< (*v2)->disp().rx()
-                             << " disp_s.y="<< (*v2)->disp().ry()
-                             << " disp_t.x="<< (*v2)->disp().rx()
-                             << " disp_t.y="<< (*v2)->disp().ry();
+/**
+ * @brief Embeds a Force Directed Placement layout according to the initial Spring Embedder model proposed by Eades.
+ * @param maxIterations
+ *  The Spring Embedder model (Eades, 1984), part of the Force Directed Placement (FDP) family,
+    assigns forces to all vertices and edges, as if nodes were electrically charged particles (Coulomb's law)
+    and all edges were springs (i.e. Hooke's law).
 
-                }  // end if edgeExists
+    These forces are applied to the nodes iteratively, pulling them closer together or pushing them further apart,
+    until the system comes to an equilibrium state (node positions do not change anymore).
 
-            } //end for v2
+    Note that, following Eades, we do not need to have a faithful simulation;
+    we can -and we do- apply unrealistic forces in an unrealistic manner.
+    For instance, instead of the forces described by Hooke's law,
+    we will assume weaker logarithmic forces between far apart vertices...
+ */
+void Graph::layoutForceDirectedSpringEmbedder(const int maxIterations){
 
-            qDebug() << "  >>> final s = "<< (*v1)->name()
-                     << " disp_s.x="<< (*v1)->disp().rx()
-                      << " disp_s.y="<< (*v1)->disp().ry();
+    qreal c4=0.1; //normalization factor for final displacement
 
-        } // end for v1
+    /**
+     * compute max spring length as function of canvas area divided by the
+     * total vertices area
+    */
+    qreal V = (qreal) vertices() ;
+    qreal naturalLength= computeOptimalDistance(V);
+    qDebug() << "\n\n layoutForceDirectedSpringEmbedder() "
+             << " vertices " << V
+             << " naturalLength " << naturalLength
+             << " theta " << m_layoutForceDirectedTheta;
 
 
-        layoutForceDirected_Eades_moveNodes(c4) ;
+    /* apply the initial layout, pivot MDS unless set otherwise */
+    layoutForceDirected_initialPositions(naturalLength/2.0);
 
-        emit signalProgressBoxUpdate( ++progressCounter );
+    QString pMsg  = tr ( "Embedding Eades Spring-Gravitational model. \n"
+                         "Please wait ....");
 
-    } //end iterations
+    // the springs do not change while embedding
+    QVector<int> edgeStart, edgeTarget;
+    layoutForceDirected_edges(edgeStart, edgeTarget);
+
+    // positions live in the buffer, which the layout runner owns
+    LayoutBuffer buffer;
+    QVector<int> nodes;
+    layoutForceDirected_buffer(buffer, nodes);
+
+    const QString model = "Eades";
+    const qreal theta = m_layoutForceDirectedTheta;
+    const qreal minX = canvasVisibleX(0), maxX = canvasVisibleX(canvasWidth);
+    const qreal minY = canvasVisibleY(0), maxY = canvasVisibleY(canvasHeight);
+
+    LayoutRunner::Step step = [=](LayoutBuffer &positions, const int &iteration) {
+        Q_UNUSED(iteration);
+        /**
+          * electric (repulsive) forces between all vertices and
+          * spring forces between adjacent vertices, that pull them together
+          * (if d > naturalLength) or push them apart (if d < naturalLength)
+          */
+        layoutForces(positions, QVector<qreal>(),
+                     edgeStart, edgeTarget, QVector<qreal>(), false,
+                     theta, 2.0 * naturalLength,
+                     [&](const qreal &dist) {
+                         return layoutForceDirected_F_rep(model, dist, naturalLength);
+                     },
+                     [&](const qreal &dist) {
+                         return layoutForceDirected_F_att(model, dist, naturalLength);
+                     });
+        layoutMoveScaled(positions, c4, minX, maxX, minY, maxY);
+        return true;
+    };
 
-    emit signalProgressBoxKill();
+    layoutRun(nodes, buffer, step, maxIterations, pMsg,
+              tr("Spring-Gravitational (Eades) model embedded."));
 }
 
 
@@ -21874,10 +23939,6 @@ void Graph::layoutForceDirectedSpringEmbedder(const int maxIterations){
  * @param maxIterations
  */
 void Graph::layoutForceDirectedFruchtermanReingold(const int maxIterations){
-    int progressCounter=0;
-    qreal dist = 0;
-    qreal f_att, f_rep;
-    QPointF DV;   //difference vector
 
     qreal V = (qreal) vertices() ;
     qreal C=0.9; //this is found experimentally
@@ -21885,126 +23946,783 @@ void Graph::layoutForceDirectedFruchtermanReingold(const int maxIterations){
     // we add vertexWidth to it
     qreal optimalDistance= C * computeOptimalDistance(V);
 
-    VList::const_iterator v1, v2;
-    int iteration = 1 ;
-
-    /* apply an initial circular layout */
-    //layoutCircular(canvasWidth/2.0, canvasHeight/2.0, optimalDistance/2.0,false);
-    //layoutRandom();
+    /* apply the initial layout, pivot MDS unless set otherwise */
+    layoutForceDirected_initialPositions(optimalDistance/2.0);
 
     qDebug() << "Graph: layoutForceDirectedFruchtermanReingold() ";
     qDebug () << "Graph: Setting optimalDistance = "<<  optimalDistance
               << "...following Fruchterman-Reingold (1991) formula ";
 
-    qDebug() << "Graph: canvasWidth " << canvasWidth << " canvasHeight " << canvasHeight;
+    qDebug() << "Graph: canvasWidth " << canvasWidth << " canvasHeight " << canvasHeight
+             << " theta " << m_layoutForceDirectedTheta;
 
 
     QString pMsg = tr( "Embedding Fruchterman & Reingold forces model. \n"
                        "Please wait ...");
-    emit statusMessage( pMsg );
 
-    emit signalProgressBoxCreate(maxIterations,pMsg );
+    // only neighbors attract each other, and they do not change while embedding
+    QVector<int> edgeStart, edgeTarget;
+    layoutForceDirected_edges(edgeStart, edgeTarget);
 
-    for ( iteration=1; iteration <= maxIterations ; iteration++) {
+    // positions live in the buffer, which the layout runner owns
+    LayoutBuffer buffer;
+    QVector<int> nodes;
+    layoutForceDirected_buffer(buffer, nodes);
 
-        //setup init disp
-        for (v1=m_graph.cbegin(); v1!=m_graph.cend(); ++v1)
-        {
-            (*v1)->disp().rx() = 0;
-            (*v1)->disp().ry() = 0;
-            //qDebug() << " 0000 s " << (*v1)->name() << " zeroing rx/ry";
+    // the cooling schedule, computed here since it depends on the canvas
+    QVector<qreal> temperature(maxIterations + 1, 0);
+    for (int iteration = 1 ; iteration <= maxIterations ; iteration++ ) {
+        temperature[iteration] = layoutForceDirected_FR_temperature(iteration);
+    }
+
+    const QString model = "FR";
+    const qreal theta = m_layoutForceDirectedTheta;
+    const qreal minX = canvasVisibleX(0), maxX = canvasVisibleX(canvasWidth);
+    const qreal minY = canvasVisibleY(0), maxY = canvasVisibleY(canvasHeight);
+
+    LayoutRunner::Step step = [=](LayoutBuffer &positions, const int &iteration) {
+        // once frozen, nothing moves anymore
+        if ( temperature[iteration] <= 0 ) {
+            return false;
         }
+        // repulsive forces from _near_ vertices, attracting forces from neighbors
+        layoutForces(positions, QVector<qreal>(),
+                     edgeStart, edgeTarget, QVector<qreal>(), false,
+                     theta, 2.0 * optimalDistance,
+                     [&](const qreal &dist) {
+                         return layoutForceDirected_F_rep(model, dist, optimalDistance);
+                     },
+                     [&](const qreal &dist) {
+                         return layoutForceDirected_F_att(model, dist, optimalDistance);
+                     });
+        // limit the max displacement to the temperature t
+        // prevent placement outside of the frame/canvas
+        layoutMove(positions, temperature[iteration], minX, maxX, minY, maxY);
+        return true;
+    };
+
+    layoutRun(nodes, buffer, step, maxIterations, pMsg,
+              tr("Fruchterman & Reingold model embedded."));
+}
+
+
+
+
+/**
+ * Coarsening stops when a level has no more vertices than this,
+ * or when it shrinks the graph by less than LAYOUT_MULTILEVEL_MIN_SHRINK.
+ */
+static const int LAYOUT_MULTILEVEL_COARSEST = 32;
+static const qreal LAYOUT_MULTILEVEL_MIN_SHRINK = 0.95;
+static const int LAYOUT_MULTILEVEL_MAX_LEVELS = 40;
 
-        for (v1=m_graph.cbegin(); v1!=m_graph.cend(); ++v1)
-        {
-//            qDebug() << "*****  Calculate forces for s " << (*v1)->name()
-//                     << " vpos " <<  vpos[(*v1)->name()]
-//                     << " pos "<< (*v1)->x() << ", "<< (*v1)->y();
 
-            if ( ! (*v1)->isEnabled() ) {
-//                qDebug() << "  vertex s " << (*v1)->name() << " disabled. Continue";
+/**
+ * @brief A level of the multilevel layout: vertices with masses, the
+ * undirected weighted edges between them in CSR form (every edge listed
+ * at both ends), the positions and, once coarsened, the vertex of the
+ * next coarser level each vertex was merged into.
+ */
+struct LayoutLevel {
+    QVector<qreal> mass;
+    QVector<int> edgeStart;
+    QVector<int> edgeTarget;
+    QVector<qreal> edgeWeight;
+    QVector<int> parent;
+    LayoutBuffer positions;
+};
+
+
+/**
+ * @brief Coarsens fine by heavy edge matching (Walshaw, 2003), in random
+ * order: each unmatched vertex is merged with the unmatched neighbor
+ * of heaviest edge weight per mass. Vertices whose neighbors are all
+ * matched join the group of their heaviest neighbor, so that stars
+ * shrink too. Sets fine.parent and returns the coarser level.
+ */
+static LayoutLevel layoutCoarsen(LayoutLevel &fine) {
+    const int n = fine.mass.count();
+    QVector<int> order(n);
+    for (int i = 0 ; i < n ; i++ ) {
+        order[i] = i;
+    }
+    std::random_shuffle(order.begin(), order.end());
+
+    fine.parent.fill(-1, n);
+    int coarseCount = 0;
+    for (int k = 0 ; k < n ; k++ ) {
+        const int v = order[k];
+        if ( fine.parent[v] != -1 ) {
+            continue;
+        }
+        int best = -1;
+        qreal bestScore = 0;
+        for (int e = fine.edgeStart[v] ; e < fine.edgeStart[v + 1] ; e++ ) {
+            const int u = fine.edgeTarget[e];
+            if ( fine.parent[u] != -1 ) {
                 continue;
             }
+            const qreal score = fine.edgeWeight[e] / ( fine.mass[v] + fine.mass[u] );
+            if ( score > bestScore ) {
+                best = u;
+                bestScore = score;
+            }
+        }
+        if ( best != -1 ) {
+            fine.parent[v] = fine.parent[best] = coarseCount++;
+        }
+    }
+    for (int k = 0 ; k < n ; k++ ) {
+        const int v = order[k];
+        if ( fine.parent[v] != -1 ) {
+            continue;
+        }
+        int best = -1;
+        qreal bestWeight = 0;
+        for (int e = fine.edgeStart[v] ; e < fine.edgeStart[v + 1] ; e++ ) {
+            const int u = fine.edgeTarget[e];
+            if ( fine.parent[u] != -1 && fine.edgeWeight[e] > bestWeight ) {
+                best = u;
+                bestWeight = fine.edgeWeight[e];
+            }
+        }
+        fine.parent[v] = ( best != -1 ) ? fine.parent[best] : coarseCount++;
+    }
 
-            for (v2=m_graph.cbegin(); v2!=m_graph.cend(); ++v2)
-            {
-//                qDebug () << "  t = "<< (*v2)->name()
-//                          << "  pos (" <<  (*v2)->x() << "," << (*v2)->y() << ")";
+    LayoutLevel coarse;
+    coarse.mass.fill(0, coarseCount);
+    QVector<int> memberStart(coarseCount + 1, 0), members(n);
+    for (int v = 0 ; v < n ; v++ ) {
+        coarse.mass[ fine.parent[v] ] += fine.mass[v];
+        memberStart[ fine.parent[v] + 1 ]++;
+    }
+    for (int c = 0 ; c < coarseCount ; c++ ) {
+        memberStart[c + 1] += memberStart[c];
+    }
+    {
+        QVector<int> fill = memberStart;
+        for (int v = 0 ; v < n ; v++ ) {
+            members[ fill[ fine.parent[v] ]++ ] = v;
+        }
+    }
 
-                if ( ! (*v2)->isEnabled() ) {
-//                    qDebug()<< " t "<< (*v2)->name()<< " disabled. Continue";
+    // merge the edges of the members, dropping those inside a group
+    QVector<qreal> accumulator(coarseCount, 0);
+    QVector<int> touched;
+    coarse.edgeStart.fill(0, coarseCount + 1);
+    for (int c = 0 ; c < coarseCount ; c++ ) {
+        coarse.edgeStart[c] = coarse.edgeTarget.count();
+        for (int m = memberStart[c] ; m < memberStart[c + 1] ; m++ ) {
+            const int v = members[m];
+            for (int e = fine.edgeStart[v] ; e < fine.edgeStart[v + 1] ; e++ ) {
+                const int cu = fine.parent[ fine.edgeTarget[e] ];
+                if ( cu == c ) {
                     continue;
                 }
+                if ( accumulator[cu] == 0 ) {
+                    touched.append(cu);
+                }
+                accumulator[cu] += fine.edgeWeight[e];
+            }
+        }
+        for (int t = 0 ; t < touched.count() ; t++ ) {
+            coarse.edgeTarget.append(touched[t]);
+            coarse.edgeWeight.append(accumulator[ touched[t] ]);
+            accumulator[ touched[t] ] = 0;
+        }
+        touched.clear();
+    }
+    coarse.edgeStart[coarseCount] = coarse.edgeTarget.count();
+
+    return coarse;
+}
+
+
+
+/**
+ * @brief The refinement of a multilevel layout, one iteration at a time,
+ * for the layout runner. Each level is refined with the Barnes-Hut
+ * Fruchterman-Reingold pass until it converges or runs its iterations;
+ * then the next finer level is placed where the vertices it was merged
+ * into are, slightly jittered. The coarsest level must be placed already.
+ */
+class LayoutMultilevel {
+public:
+    LayoutMultilevel(const QList<LayoutLevel> &levels,
+                     const int &levelIterations,
+                     const qreal &optimalDistance,
+                     const qreal &theta,
+                     const qreal &temperature,
+                     const qreal &minX, const qreal &maxX,
+                     const qreal &minY, const qreal &maxY) :
+        m_levels(levels), m_group(levels.count()),
+        m_level(levels.count() - 1), m_iteration(0),
+        m_levelIterations(levelIterations),
+        m_optimalDistance(optimalDistance), m_theta(theta),
+        m_temperature(temperature),
+        m_minX(minX), m_maxX(maxX), m_minY(minY), m_maxY(maxY)
+    {
+        // the group of every finest vertex on each coarser level
+        const int n = m_levels[0].mass.count();
+        for (int l = 1 ; l < m_levels.count() ; l++ ) {
+            m_group[l].resize(n);
+            for (int v = 0 ; v < n ; v++ ) {
+                const int finer = ( l == 1 ) ? v : m_group[l - 1][v];
+                m_group[l][v] = m_levels[l - 1].parent[finer];
+            }
+        }
+    }
+
+    int levels() const {
+        return m_levels.count();
+    }
+
+    /**
+     * @brief Runs one iteration on the current level
+     * @return false when the finest level is done
+     */
+    bool iterate() {
+        LayoutLevel &level = m_levels[m_level];
+        const qreal k = naturalLength();
+        const QString model = "FR";
+        layoutForces(level.positions, level.mass,
+                     level.edgeStart, level.edgeTarget, level.edgeWeight, true,
+                     m_theta, 2.0 * k,
+                     [&](const qreal &dist) {
+                         return Graph::layoutForceDirected_F_rep(model, dist, k);
+                     },
+                     [&](const qreal &dist) {
+                         return Graph::layoutForceDirected_F_att(model, dist, k);
+                     });
+        const qreal moved = layoutMove(level.positions, m_temperature,
+                                       m_minX, m_maxX, m_minY, m_maxY);
+        m_temperature *= 0.9;
+        m_iteration++;
+        if ( moved >= 0.01 * k * level.mass.count() && m_iteration < m_levelIterations ) {
+            return true;
+        }
+        if ( m_level == 0 ) {
+            return false;
+        }
+        refine();
+        return true;
+    }
+
+    /**
+     * @brief Copies to buffer the position of every finest vertex,
+     * that of its group on the current level
+     */
+    void publish(LayoutBuffer &buffer) const {
+        const LayoutBuffer &positions = m_levels[m_level].positions;
+        const int n = buffer.x.count();
+        for (int v = 0 ; v < n ; v++ ) {
+            const int g = ( m_level == 0 ) ? v : m_group[m_level][v];
+            buffer.x[v] = positions.x[g];
+            buffer.y[v] = positions.y[g];
+        }
+    }
+
+private:
+    /**
+     * @brief The natural length grows by sqrt(7/4) per coarser level
+     */
+    qreal naturalLength() const {
+        return m_optimalDistance * qPow( qSqrt(7.0 / 4.0), m_level );
+    }
+
+    /**
+     * @brief Moves on to the next finer level, placed around its parents
+     */
+    void refine() {
+        const LayoutBuffer coarser = m_levels[m_level].positions;
+        m_levels[m_level] = LayoutLevel();
+        m_group[m_level].clear();
+        m_level--;
+        m_iteration = 0;
+        const qreal k = naturalLength();
+        m_temperature = k;
+        LayoutLevel &level = m_levels[m_level];
+        const int count = level.mass.count();
+        LayoutBuffer &positions = level.positions;
+        positions.x.resize(count);
+        positions.y.resize(count);
+        positions.enabled.fill(true, count);
+        for (int v = 0 ; v < count ; v++ ) {
+            const int p = level.parent[v];
+            positions.x[v] = qBound( m_minX, coarser.x[p] + k * ( qrand() / (qreal) RAND_MAX - 0.5 ) / 5.0, m_maxX );
+            positions.y[v] = qBound( m_minY, coarser.y[p] + k * ( qrand() / (qreal) RAND_MAX - 0.5 ) / 5.0, m_maxY );
+        }
+    }
+
+    QList<LayoutLevel> m_levels;
+    QVector<QVector<int> > m_group;
+    int m_level;
+    int m_iteration;
+    int m_levelIterations;
+    qreal m_optimalDistance;
+    qreal m_theta;
+    qreal m_temperature;
+    qreal m_minX, m_maxX, m_minY, m_maxY;
+};
+
+
+
+/**
+ * @brief Embeds a multilevel force-directed layout, in the style of
+ * Walshaw (2003) and FM³ (Hachul & Jünger, 2004), for large networks.
+ *
+ * The enabled vertices and edges are coarsened level by level by heavy
+ * edge matching (see layoutCoarsen), until the graph is small or stops
+ * shrinking. The coarsest level is placed at random and laid out; then
+ * every finer level starts from the positions of the vertices it was
+ * merged into, slightly jittered, and is refined with the Barnes-Hut
+ * Fruchterman-Reingold pass (see layoutForces). Coarse vertices repel
+ * by their mass and coarse edges attract by their weight.
+ * The natural length grows by sqrt(7/4) per coarser level; the
+ * temperature starts at that length and cools geometrically.
+ * Coarsening is done here; the refinement runs in the layout runner
+ * (see LayoutMultilevel and layoutRun).
+ *
+ * @param iterations  refinement iterations per level
+ * @param quality     0 draft, 1 normal, 2 high: sets the Barnes-Hut
+ * opening angle and scales the iterations
+ */
+void Graph::layoutForceDirectedMultilevel(const int iterations,
+                                          const int quality) {
+
+    layoutRunnerStop();
+
+    qreal theta = m_layoutForceDirectedTheta;
+    int levelIterations = qMax(1, iterations);
+    if ( quality <= 0 ) {
+        theta = qMax(theta, (qreal) 1.0);
+        levelIterations = qMax(1, levelIterations / 2);
+    }
+    else if ( quality >= 2 ) {
+        theta = qMin(theta, (qreal) 0.4);
+        levelIterations *= 2;
+    }
+
+    // the finest level: enabled vertices, undirected edges
+    QVector<int> edgeStart, edgeTarget;
+    layoutForceDirected_edges(edgeStart, edgeTarget);
+
+    const int N = m_graph.size();
+    QVector<int> index(N, -1), vertexAt;
+    for (int i = 0 ; i < N ; i++ ) {
+        if ( m_graph[i]->isEnabled() ) {
+            index[i] = vertexAt.count();
+            vertexAt.append(i);
+        }
+    }
+    const int n = vertexAt.count();
+    if ( n == 0 ) {
+        return;
+    }
+
+    QList<LayoutLevel> levels;
+    levels.append(LayoutLevel());
+    {
+        LayoutLevel &finest = levels[0];
+        finest.mass.fill(1.0, n);
+        QVector<QHash<int, qreal> > adjacency(n);
+        for (int i = 0 ; i < N ; i++ ) {
+            for (int e = edgeStart[i] ; e < edgeStart[i + 1] ; e++ ) {
+                const int s = index[i], t = index[ edgeTarget[e] ];
+                adjacency[s][t] += 1;
+                adjacency[t][s] += 1;
+            }
+        }
+        finest.edgeStart.fill(0, n + 1);
+        for (int v = 0 ; v < n ; v++ ) {
+            finest.edgeStart[v] = finest.edgeTarget.count();
+            QHash<int, qreal>::const_iterator it;
+            for (it = adjacency[v].cbegin(); it != adjacency[v].cend(); ++it) {
+                finest.edgeTarget.append(it.key());
+                finest.edgeWeight.append(it.value());
+            }
+        }
+        finest.edgeStart[n] = finest.edgeTarget.count();
+    }
+
+    while ( levels.last().mass.count() > LAYOUT_MULTILEVEL_COARSEST
+            && levels.count() < LAYOUT_MULTILEVEL_MAX_LEVELS ) {
+        LayoutLevel coarse = layoutCoarsen(levels.last());
+        if ( coarse.mass.count() > LAYOUT_MULTILEVEL_MIN_SHRINK * levels.last().mass.count() ) {
+            levels.last().parent.clear();
+            break;
+        }
+        levels.append(coarse);
+    }
+
+    const qreal optimalDistance = 0.9 * computeOptimalDistance(n);
+
+    qDebug() << "Graph::layoutForceDirectedMultilevel() - vertices" << n
+             << "levels" << levels.count()
+             << "coarsest vertices" << levels.last().mass.count()
+             << "iterations per level" << levelIterations
+             << "theta" << theta;
+
+    QString pMsg = tr( "Embedding multilevel force-directed layout. \n"
+                       "Please wait ...");
+
+    // the coarsest level starts at random
+    LayoutBuffer &coarsest = levels.last().positions;
+    const int coarsestCount = levels.last().mass.count();
+    coarsest.x.resize(coarsestCount);
+    coarsest.y.resize(coarsestCount);
+    coarsest.enabled.fill(true, coarsestCount);
+    for (int v = 0 ; v < coarsestCount ; v++ ) {
+        coarsest.x[v] = canvasRandomX();
+        coarsest.y[v] = canvasRandomY();
+    }
+
+    // the runner shows the finest vertices at the positions of their groups
+    LayoutBuffer buffer;
+    QVector<int> nodes(n);
+    buffer.x.fill(0, n);
+    buffer.y.fill(0, n);
+    buffer.enabled.fill(true, n);
+    for (int v = 0 ; v < n ; v++ ) {
+        nodes[v] = m_graph[ vertexAt[v] ]->name();
+    }
+
+    QSharedPointer<LayoutMultilevel> multilevel(
+                new LayoutMultilevel(levels, levelIterations, optimalDistance, theta,
+                                     canvasWidth / 10.0,
+                                     canvasVisibleX(0), canvasVisibleX(canvasWidth),
+                                     canvasVisibleY(0), canvasVisibleY(canvasHeight)) );
+    levels.clear();
+
+    LayoutRunner::Step step = [multilevel](LayoutBuffer &positions, const int &iteration) {
+        Q_UNUSED(positions);
+        Q_UNUSED(iteration);
+        return multilevel->iterate();
+    };
+    LayoutRunner::Publish publish = [multilevel](LayoutBuffer &positions) {
+        multilevel->publish(positions);
+    };
+
+    layoutRun(nodes, buffer, step, multilevel->levels() * levelIterations, pMsg,
+              tr("Multilevel force-directed layout embedded."), false, publish);
+}
+
+
+
+
+/**
+ * Number of pivots of the sparse stress layout. Every vertex keeps its
+ * distance to each pivot, so memory and time per iteration are O(k n).
+ */
+static const int LAYOUT_STRESS_PIVOTS = 50;
+
+
+/**
+ * @brief Computes the shortest path lengths from s over the CSR graph
+ * edgeStart/edgeTarget. With weighted, edges have length edgeLength
+ * (Dijkstra), otherwise 1 (BFS). Unreachable vertices get -1.
+ * @param s
+ * @param edgeStart
+ * @param edgeTarget
+ * @param edgeLength
+ * @param weighted
+ * @param dist
+ */
+static void layoutShortestPaths(const int &s,
+                                const QVector<int> &edgeStart,
+                                const QVector<int> &edgeTarget,
+                                const QVector<qreal> &edgeLength,
+                                const bool &weighted,
+                                QVector<qreal> &dist) {
+    dist.fill(-1, edgeStart.count() - 1);
+    dist[s] = 0;
+    if ( !weighted ) {
+        QVector<int> queue;
+        queue.reserve(dist.count());
+        queue.append(s);
+        for (int q = 0 ; q < queue.count() ; q++ ) {
+            const int u = queue[q];
+            for (int e = edgeStart[u] ; e < edgeStart[u + 1] ; e++ ) {
+                const int w = edgeTarget[e];
+                if ( dist[w] < 0 ) {
+                    dist[w] = dist[u] + 1;
+                    queue.append(w);
+                }
+            }
+        }
+        return;
+    }
+    typedef std::pair<qreal, int> Entry;
+    std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry> > prQ;
+    prQ.push( Entry(0, s) );
+    while ( !prQ.empty() ) {
+        const Entry top = prQ.top();
+        prQ.pop();
+        const int u = top.second;
+        if ( top.first > dist[u] ) {
+            continue;   // stale entry
+        }
+        for (int e = edgeStart[u] ; e < edgeStart[u + 1] ; e++ ) {
+            const int w = edgeTarget[e];
+            const qreal d = dist[u] + edgeLength[e];
+            if ( dist[w] < 0 || d < dist[w] ) {
+                dist[w] = d;
+                prQ.push( Entry(d, w) );
+            }
+        }
+    }
+}
+
+
+
+/**
+ * @brief Chooses up to k pivots by max/min selection: each new pivot is
+ * the vertex farthest from all pivots chosen so far (vertices no pivot
+ * reaches come first, so that every component gets one, if k allows).
+ * Stores the distance of vertex i to pivot p in pivotDist[i*k + p],
+ * or -1 if unreachable, and returns the pivots.
+ * @param k
+ * @param edgeStart
+ * @param edgeTarget
+ * @param edgeLength
+ * @param weighted
+ * @param pivotDist
+ * @return QVector<int> the pivots
+ */
+static QVector<int> layoutPivots(const int &k,
+                                 const QVector<int> &edgeStart,
+                                 const QVector<int> &edgeTarget,
+                                 const QVector<qreal> &edgeLength,
+                                 const bool &weighted,
+                                 QVector<qreal> &pivotDist) {
+    const int n = edgeStart.count() - 1;
+    QVector<int> pivots;
+    QVector<qreal> minDist(n, -1), dist;
+    pivotDist.fill(-1, n * k);
+    int next = rand() % n;
+    for (int p = 0 ; p < k ; p++ ) {
+        pivots.append(next);
+        layoutShortestPaths(next, edgeStart, edgeTarget, edgeLength, weighted, dist);
+        next = -1;
+        for (int i = 0 ; i < n ; i++ ) {
+            pivotDist[i * k + p] = dist[i];
+            if ( dist[i] >= 0 && ( minDist[i] < 0 || dist[i] < minDist[i] ) ) {
+                minDist[i] = dist[i];
+            }
+            if ( minDist[i] < 0 ) {
+                if ( next == -1 || minDist[next] >= 0 ) {
+                    next = i;
+                }
+            }
+            else if ( minDist[i] > 0 && ( next == -1 || ( minDist[next] >= 0
+                                                          && minDist[i] > minDist[next] ) ) ) {
+                next = i;
+            }
+        }
+        if ( next == -1 ) {
+            break;      // every vertex is a pivot
+        }
+    }
+    return pivots;
+}
 
-                if (v2 == v1) {
-//                    qDebug() << "  s==t, continuing";
-                    continue;
-                }
 
-                DV.setX( (*v2)->x() - (*v1)->x() );
-                DV.setY( (*v2)->y() - (*v1)->y() );
 
-                dist = graphDistanceEuclidean( DV );
+/**
+ * @brief Returns the distance to use between actors no path connects:
+ * a bit more than the longest pivot distance D, to keep components
+ * apart, or just D (at least 1) if all actors are connected.
+ * @param k
+ * @param pivots
+ * @param pivotDist
+ * @return qreal
+ */
+static qreal layoutPivotUnreachable(const int &k,
+                                    const QVector<int> &pivots,
+                                    const QVector<qreal> &pivotDist) {
+    qreal D = 0;
+    bool disconnected = false;
+    for (int i = 0 ; i < pivotDist.count() / k ; i++ ) {
+        for (int p = 0 ; p < pivots.count() ; p++ ) {
+            D = qMax( D, pivotDist[i * k + p] );
+            disconnected = disconnected || pivotDist[i * k + p] < 0;
+        }
+    }
+    if ( D == 0 ) {
+        D = 1;
+    }
+    return ( disconnected ) ? 1.2 * D : D;
+}
 
-                //calculate repulsive force from _near_ vertices
-                f_rep = layoutForceDirected_F_rep( "FR", dist, optimalDistance);
-                (*v1)->disp().rx() += sign( DV.x() ) * f_rep;
-                (*v1)->disp().ry() += sign( DV.y() ) * f_rep ;
 
-//                qDebug()<< " dist( " << (*v1)->name() <<  "," <<  (*v2)->name() <<  " = "
-//                        << dist
-//                        << " f_rep " << f_rep
-//                        << " disp_s.x="<< (*v1)->disp().rx()
-//                        << " disp_s.y="<< (*v1)->disp().ry();
 
-                if ( edgeExists ((*v1)->name(), (*v2)->name()) ) {
-                    //calculate attracting force
-                    f_att = layoutForceDirected_F_att ("FR", dist, optimalDistance);
-                    (*v1)->disp().rx() += sign( DV.x() ) * f_att;
-                    (*v1)->disp().ry() += sign( DV.y() ) * f_att;
-                    (*v2)->disp().rx() -= sign( DV.x() ) * f_att ;
-                    (*v2)->disp().ry() -= sign( DV.y() ) * f_att ;
+/**
+ * @brief Replaces the unreachable (-1) pivot distances with unreachable
+ * and multiplies all of them by L, the length of a unit distance.
+ * @param k
+ * @param pivots
+ * @param unreachable
+ * @param L
+ * @param pivotDist
+ */
+static void layoutPivotDistancesScale(const int &k,
+                                      const QVector<int> &pivots,
+                                      const qreal &unreachable,
+                                      const qreal &L,
+                                      QVector<qreal> &pivotDist) {
+    for (int i = 0 ; i < pivotDist.count() / k ; i++ ) {
+        for (int p = 0 ; p < pivots.count() ; p++ ) {
+            qreal &d = pivotDist[i * k + p];
+            d = ( ( d < 0 ) ? unreachable : d ) * L;
+        }
+    }
+}
 
-                    qDebug() << "  s= "<<(*v1)->name()
-                             << " attracted by t= "<< (*v2)->name()
-                             <<"  optimalDistance =" << optimalDistance
-                             << " f_att " << f_att
-                             << " disp_s.x="<< (*v1)->disp().rx()
-                             << " disp_s.y="<< (*v1)->disp().ry()
-                             << " disp_t.x="<< (*v2)->disp().rx()
-                             << " disp_t.y="<< (*v2)->disp().ry();
-                } //endif
 
-            }//end for v2
 
-        } //end for v1
+/**
+ * @brief Pivot MDS (Brandes & Pich): classical scaling of the n x k
+ * matrix of distances to the pivots (unreachable ones already replaced).
+ * The double centered matrix C is projected on the two top eigenvectors
+ * of C^T C, found by power iteration, and the result is scaled to fit
+ * the distances in least squares.
+ * @param k
+ * @param pivots
+ * @param pivotDist
+ * @param pos
+ */
+static void layoutPivotMDSCoordinates(const int &k,
+                           const QVector<int> &pivots,
+                           const QVector<qreal> &pivotDist,
+                           QVector<QPointF> &pos) {
+    const int n = pivotDist.count() / k;
+    const int used = pivots.count();
+
+    // double centering of the squared distances
+    QVector<qreal> C(n * used), rowMean(n, 0), colMean(used, 0);
+    qreal mean = 0;
+    for (int i = 0 ; i < n ; i++ ) {
+        for (int p = 0 ; p < used ; p++ ) {
+            const qreal d2 = pivotDist[i * k + p] * pivotDist[i * k + p];
+            C[i * used + p] = d2;
+            rowMean[i] += d2 / used;
+            colMean[p] += d2 / n;
+            mean += d2 / ( (qreal) n * used );
+        }
+    }
+    for (int i = 0 ; i < n ; i++ ) {
+        for (int p = 0 ; p < used ; p++ ) {
+            C[i * used + p] = -0.5 * ( C[i * used + p] - rowMean[i] - colMean[p] + mean );
+        }
+    }
 
-        // limit the max displacement to the temperature t
-        // prevent placement outside of the frame/canvas
-        layoutForceDirected_FR_moveNodes( layoutForceDirected_FR_temperature (iteration) );
+    // M = C^T C, one row per thread
+    QVector<qreal> M(used * used, 0);
+    QVector<int> rows(used);
+    for (int p = 0 ; p < used ; p++ ) {
+        rows[p] = p;
+    }
+    QtConcurrent::blockingMap(rows, [&](const int &p) {
+        for (int q = 0 ; q < used ; q++ ) {
+            qreal sum = 0;
+            for (int i = 0 ; i < n ; i++ ) {
+                sum += C[i * used + p] * C[i * used + q];
+            }
+            M[p * used + q] = sum;
+        }
+    });
+
+    // the two top eigenvectors, by power iteration and deflation
+    QVector<qreal> eigen[2];
+    for (int e = 0 ; e < 2 ; e++ ) {
+        QVector<qreal> v(used), w(used);
+        for (int p = 0 ; p < used ; p++ ) {
+            v[p] = rand() / (qreal) RAND_MAX - 0.5;
+        }
+        qreal lambda = 0;
+        for (int iteration = 0 ; iteration < 100 ; iteration++ ) {
+            qreal norm = 0;
+            for (int p = 0 ; p < used ; p++ ) {
+                w[p] = 0;
+                for (int q = 0 ; q < used ; q++ ) {
+                    w[p] += M[p * used + q] * v[q];
+                }
+                norm += w[p] * w[p];
+            }
+            norm = qSqrt(norm);
+            if ( norm == 0 ) {
+                break;
+            }
+            qreal change = 0;
+            for (int p = 0 ; p < used ; p++ ) {
+                w[p] /= norm;
+                change += qAbs( w[p] - v[p] );
+            }
+            v.swap(w);
+            lambda = norm;
+            if ( change < 1e-9 ) {
+                break;
+            }
+        }
+        for (int p = 0 ; p < used ; p++ ) {
+            for (int q = 0 ; q < used ; q++ ) {
+                M[p * used + q] -= lambda * v[p] * v[q];
+            }
+        }
+        eigen[e] = v;
+    }
 
-        emit signalProgressBoxUpdate( ++progressCounter );
+    pos.fill(QPointF(0, 0), n);
+    for (int i = 0 ; i < n ; i++ ) {
+        qreal x = 0, y = 0;
+        for (int p = 0 ; p < used ; p++ ) {
+            x += C[i * used + p] * eigen[0][p];
+            y += C[i * used + p] * eigen[1][p];
+        }
+        pos[i] = QPointF(x, y);
     }
 
-    emit signalProgressBoxKill();
+    // scale s minimizing sum (s |x_i - x_p| - d_ip)^2
+    qreal sumDE = 0, sumEE = 0;
+    for (int i = 0 ; i < n ; i++ ) {
+        for (int p = 0 ; p < used ; p++ ) {
+            const QPointF DV = pos[i] - pos[ pivots[p] ];
+            const qreal e = qSqrt( DV.x() * DV.x() + DV.y() * DV.y() );
+            sumDE += pivotDist[i * k + p] * e;
+            sumEE += e * e;
+        }
+    }
+    if ( sumEE > 0 ) {
+        const qreal s = sumDE / sumEE;
+        for (int i = 0 ; i < n ; i++ ) {
+            pos[i] *= s;
+        }
+    }
 }
 
 
 
-
 /**
- * @brief Embeds a Force Directed Placement layout according to the Kamada-Kawai model.
- * In this model, the network is considered to be a dynamic system
- * where every two actors are 'particles' mutually connected by a 'spring'.
- * Each spring has a desirable length, which corresponds to their graph
- * theoretic distance. In this way, the optimal layout of the graph
- * is the state with the minimum imbalance. The degree of
- * imbalance is formulated as the total spring energy:
- * the square summation of the differences between desirable
- * distances and real ones for all pairs of particles
- * Initially, the particles/actors are placed on the vertices of a regular n-polygon
+ * @brief Embeds the Kamada-Kawai layout: the network is a system of springs
+ * between every two actors, each with a desirable length proportional to
+ * their graph theoretic distance, and the layout minimizes the total
+ * energy (stress) of the springs: the square summation of the differences
+ * between desirable and real distances, weighted by 1/d^2.
+ *
+ * To run on large networks, the stress is sparse (Ortmann, Klimenta & Brandes):
+ * every actor keeps the springs to its neighbors and to a few pivots
+ * (see layoutPivots), and the spring to a pivot stands for the actors
+ * of the pivot's region which are closer to the pivot than half the
+ * distance. Each iteration moves every actor, in parallel, to the
+ * stress majorization (localized) optimum given the others' positions.
+ * Time and memory are O(k (n + m)) instead of O(n^2).
+ *
+ * @param maxIterations
+ * @param considerWeights  if true, edge weights are distances
+ * @param inverseWeights   if true, distances are the inverse edge weights
+ * @param dropIsolates     if true, isolated actors stay where they are
+ * @param initialPositions "current", "circle", "random" or "pivotmds"
  */
-
 void Graph::layoutForceDirectedKamadaKawai(const int maxIterations,
                                            const bool considerWeights,
                                            const bool inverseWeights,
@@ -22012,375 +24730,667 @@ void Graph::layoutForceDirectedKamadaKawai(const int maxIterations,
                                            const QString  &initialPositions){
 
     qDebug()<< "Graph::layoutForceDirectedKamadaKawai() - "
-               << "maxIter " << maxIterations;
-
-    VList::const_iterator v1, v2;
+               << "maxIter " << maxIterations
+               << "initialPositions" << initialPositions;
+
+    layoutRunnerStop();
+
+    // the actors to place, and their edges as undirected springs
+    QVector<int> vertexAt, edgeStart, edgeTarget;
+    QVector<qreal> edgeLength;
+    layoutDistance_edges(considerWeights, inverseWeights, dropIsolates,
+                         vertexAt, edgeStart, edgeTarget, edgeLength);
+    const int n = vertexAt.count();
+    if ( n == 0 ) {
+        return;
+    }
 
-    int progressCounter=0, minimizationIterations=0;
+    QString pMsg = tr("Embedding Kamada & Kawai spring model.\n"
+                      "Please wait...");
+    emit statusMessage( pMsg );
 
-    int i=0, j=0, m=0, pm=0, pnm=0, pn=0;
+    // distances to the pivots
+    const int k = qMin(n, LAYOUT_STRESS_PIVOTS);
+    QVector<qreal> pivotDist;
+    const QVector<int> pivots = layoutPivots(k, edgeStart, edgeTarget, edgeLength,
+                                             considerWeights, pivotDist);
+    const int used = pivots.count();
+
+    // scale distances so that the longest one spans the display area
+    const qreal unreachable = layoutPivotUnreachable(k, pivots, pivotDist);
+    const qreal L0 = canvasMinDimension() - 100;
+    const qreal L = L0 / unreachable;
+    qDebug()<< "Graph::layoutForceDirectedKamadaKawai() - vertices" << n
+            << "pivots" << used << "L=" << L0 << "/" << unreachable << "=" << L;
+
+    // each actor belongs to the region of its nearest pivot
+    QVector<QVector<qreal> > regionDist(used);
+    for (int i = 0 ; i < n ; i++ ) {
+        int nearest = -1;
+        for (int p = 0 ; p < used ; p++ ) {
+            const qreal d = pivotDist[i * k + p];
+            if ( d >= 0 && ( nearest == -1 || d < pivotDist[i * k + nearest] ) ) {
+                nearest = p;
+            }
+        }
+        if ( nearest != -1 ) {
+            regionDist[nearest].append( pivotDist[i * k + nearest] );
+        }
+    }
+    for (int p = 0 ; p < used ; p++ ) {
+        std::sort(regionDist[p].begin(), regionDist[p].end());
+    }
 
-    int N=vertices();  // active actors
+    // spring weights: 1/d^2 for neighbors, s/d^2 for pivots, where
+    // s is the number of the pivot's region actors within d/2 of it
+    QVector<qreal> pivotWeight(n * k, 0);
+    for (int i = 0 ; i < n ; i++ ) {
+        for (int p = 0 ; p < used ; p++ ) {
+            const qreal d = pivotDist[i * k + p];
+            if ( pivots[p] == i ) {
+                continue;
+            }
+            qreal s = 1;
+            if ( d >= 0 ) {
+                s = std::upper_bound(regionDist[p].cbegin(), regionDist[p].cend(), d / 2.0)
+                        - regionDist[p].cbegin();
+            }
+            const qreal scaled = ( ( d < 0 ) ? unreachable : d ) * L;
+            pivotWeight[i * k + p] = qMax( (qreal) 1, s ) / ( scaled * scaled );
+        }
+    }
+    regionDist.clear();
+    layoutPivotDistancesScale(k, pivots, unreachable, L, pivotDist);
+    for (int e = 0 ; e < edgeLength.count() ; e++ ) {
+        edgeLength[e] *= L;
+    }
 
-    qreal K=1;  // constant
-    qreal L=0;  // the desirable length of a single edge.
-    qreal L0=0; // the length of a side of the display square area
-    qreal D=0;  // the graph diameter
+    // initial positions, around the center of the canvas
+    QVector<QPointF> pos(n);
+    if ( initialPositions == "pivotmds" ) {
+        layoutPivotMDSCoordinates(k, pivots, pivotDist, pos);
+        for (int v = 0 ; v < n ; v++ ) {
+            pos[v] += QPointF( canvasWidth / 2.0, canvasHeight / 2.0 );
+        }
+    }
+    else {
+        if (initialPositions == "circle") {
+            // placing the particles on the vertices of a regular n-polygon
+            // circumscribed by a circle whose diameter is L0
+            layoutCircular(canvasWidth/2.0, canvasHeight/2.0, L0/2, false);
+        }
+        else if (initialPositions == "random") {
+            layoutRandom();
+        }
+        for (int v = 0 ; v < n ; v++ ) {
+            pos[v] = QPointF( m_graph[ vertexAt[v] ]->x(), m_graph[ vertexAt[v] ]->y() );
+        }
+    }
 
+    // positions live in the buffer, which the layout runner owns
+    LayoutBuffer buffer;
+    QVector<int> nodes(n);
+    buffer.x.resize(n);
+    buffer.y.resize(n);
+    buffer.enabled.fill(true, n);
+    for (int v = 0 ; v < n ; v++ ) {
+        nodes[v] = m_graph[ vertexAt[v] ]->name();
+        // a little jitter, so that no two actors start at the same point
+        buffer.x[v] = pos[v].x() + ( rand() / (qreal) RAND_MAX - 0.5 ) * L / 100.0;
+        buffer.y[v] = pos[v].y() + ( rand() / (qreal) RAND_MAX - 0.5 ) * L / 100.0;
+    }
+
+    // localized stress majorization, every actor in parallel
+    const qreal epsilon = 0.01 * L;
+    LayoutRunner::Step step = [=](LayoutBuffer &positions, const int &iteration) {
+        QVector<qreal> nextX(n), nextY(n), moved(n);
+        const qreal *x = positions.x.constData();
+        const qreal *y = positions.y.constData();
+        qreal *nx = nextX.data();
+        qreal *ny = nextY.data();
+        qreal *movedBy = moved.data();
+        layoutParallelChunks(n, [&](const int &begin, const int &end) {
+            for (int i = begin ; i < end ; i++ ) {
+                qreal sumW = 0, sumX = 0, sumY = 0;
+                auto spring = [&](const int &j, const qreal &d, const qreal &w) {
+                    const qreal DX = x[i] - x[j];
+                    const qreal DY = y[i] - y[j];
+                    const qreal dist = qSqrt( DX * DX + DY * DY );
+                    sumW += w;
+                    sumX += w * x[j];
+                    sumY += w * y[j];
+                    if ( dist > 0 ) {
+                        sumX += w * d * DX / dist;
+                        sumY += w * d * DY / dist;
+                    }
+                };
+                for (int e = edgeStart[i] ; e < edgeStart[i + 1] ; e++ ) {
+                    spring( edgeTarget[e], edgeLength[e], 1.0 / ( edgeLength[e] * edgeLength[e] ) );
+                }
+                for (int p = 0 ; p < used ; p++ ) {
+                    if ( pivots[p] != i ) {
+                        spring( pivots[p], pivotDist[i * k + p], pivotWeight[i * k + p] );
+                    }
+                }
+                nx[i] = ( sumW > 0 ) ? sumX / sumW : x[i];
+                ny[i] = ( sumW > 0 ) ? sumY / sumW : y[i];
+                movedBy[i] = qAbs( nx[i] - x[i] ) + qAbs( ny[i] - y[i] );
+            }
+        });
+        positions.x.swap(nextX);
+        positions.y.swap(nextY);
 
+        qreal totalMoved = 0;
+        for (int v = 0 ; v < n ; v++ ) {
+            totalMoved += moved[v];
+        }
+        if ( totalMoved < epsilon * n ) {
+            qDebug()<< "Graph::layoutForceDirectedKamadaKawai() - "
+                       "converged at iteration" << iteration;
+            return false;
+        }
+        return true;
+    };
 
-    Matrix l; // the original spring length between pairs of particles/actors
-    Matrix k; // the strength of the spring between pairs of particles/actors
+    layoutRun(nodes, buffer, step, maxIterations, pMsg,
+              tr("Kamada & Kawai model embedded."), true);
+}
 
-    Matrix LIN_EQ_COEF(2,2);    // holds the coefficients of set of linear equations 11 and 12
-    qreal b[2];                 // holds the right hand vector of linear equations 11 and 12
 
-    qreal partDrvtEx = 0; // partial derivative of E by Xm
-    qreal partDrvtEy = 0; // partial derivative of E by Ym
-    qreal partDrvtExSec_m = 0; // partial second derivative of E by Xm
-    qreal partDrvtEySec_m = 0; // partial second derivative of E by Ym
-    qreal partDrvtExEySec_m = 0; // partial second derivative of E by Xm Ym
-    qreal partDrvtEyExSec_m = 0; // partial second derivative of E by Ym Xm
 
-    qreal partDrvtEx_m = 0; // cache for partial derivative of E by Xm, for particle with max D_i
-    qreal partDrvtEy_m = 0; // cache for partial derivative of E by Ym, for particle with max D_i
 
-    qreal partDrvDenom = 0;
-    qreal xm=0,ym=0;
-    qreal xi=0,yi=0;
-    qreal xpm=0, ypm=0; // cache for pos of particle with max D_i
+/**
+ * @brief Collects the enabled actors (but the isolated ones, if dropIsolates)
+ * in vertexAt, and the edges between them as undirected CSR lists
+ * by index in vertexAt, with lengths: 1, or the (inverse) weight if
+ * considerWeights. Of two opposite edges, the shorter one is kept.
+ * Used by the distance based layouts.
+ * @param considerWeights
+ * @param inverseWeights
+ * @param dropIsolates
+ * @param vertexAt
+ * @param edgeStart
+ * @param edgeTarget
+ * @param edgeLength
+ */
+void Graph::layoutDistance_edges(const bool &considerWeights,
+                                 const bool &inverseWeights,
+                                 const bool &dropIsolates,
+                                 QVector<int> &vertexAt,
+                                 QVector<int> &edgeStart,
+                                 QVector<int> &edgeTarget,
+                                 QVector<qreal> &edgeLength) {
+    const int N = m_graph.size();
+    QVector<int> index(N, -1);
+    vertexAt.clear();
+    for (int i = 0 ; i < N ; i++ ) {
+        if ( m_graph[i]->isEnabled() && !( dropIsolates && m_graph[i]->isIsolated() ) ) {
+            index[i] = vertexAt.count();
+            vertexAt.append(i);
+        }
+    }
+    const int n = vertexAt.count();
 
-    qreal dx=0, dy=0;
+    QVector<QHash<int, qreal> > adjacency(n);
+    for (int v = 0 ; v < n ; v++ ) {
+        const QHash<int,qreal> enabledOutEdges = m_graph[ vertexAt[v] ]->outEdgesEnabledHash();
+        QHash<int,qreal>::const_iterator it;
+        for (it = enabledOutEdges.cbegin(); it != enabledOutEdges.cend(); ++it) {
+            const int t = index.value( vpos.value(it.key(), -1), -1 );
+            if ( it.value() == 0 || t == -1 || t == v ) {
+                continue;
+            }
+            qreal length = 1;
+            if ( considerWeights ) {
+                length = ( inverseWeights ) ? 1.0 / qAbs( it.value() ) : qAbs( it.value() );
+            }
+            if ( !adjacency[v].contains(t) || length < adjacency[v][t] ) {
+                adjacency[v][t] = length;
+                adjacency[t][v] = length;
+            }
+        }
+    }
+    edgeStart.fill(0, n + 1);
+    edgeTarget.clear();
+    edgeLength.clear();
+    for (int v = 0 ; v < n ; v++ ) {
+        edgeStart[v] = edgeTarget.count();
+        QHash<int, qreal>::const_iterator it;
+        for (it = adjacency[v].cbegin(); it != adjacency[v].cend(); ++it) {
+            edgeTarget.append(it.key());
+            edgeLength.append(it.value());
+        }
+    }
+    edgeStart[n] = edgeTarget.count();
+}
 
-    qreal epsilon=0.1;
-    qreal Delta_m=0;
-    qreal Delta_max=epsilon + 0.0001;
 
 
-    // Compute graph-theoretic distances dij for 1 <= i!=j <= n
+/**
+ * @brief Embeds a Pivot MDS layout (Brandes & Pich): runs a BFS (or Dijkstra,
+ * if considerWeights) from a few pivot actors and places every actor by
+ * classical scaling of its distances to the pivots, so that the
+ * Euclidean distances approximate the graph theoretic ones.
+ * Time is O(k m), so it gives the global structure of very large networks
+ * in a second. Also used as the initial layout of the force-directed models.
+ * @param considerWeights  if true, edge weights are distances
+ * @param inverseWeights   if true, distances are the inverse edge weights
+ * @param dropIsolates     if true, isolated actors stay where they are
+ */
+void Graph::layoutPivotMDS(const bool considerWeights,
+                           const bool inverseWeights,
+                           const bool dropIsolates) {
+
+    layoutRunnerStop();
+
+    QVector<int> vertexAt, edgeStart, edgeTarget;
+    QVector<qreal> edgeLength;
+    layoutDistance_edges(considerWeights, inverseWeights, dropIsolates,
+                         vertexAt, edgeStart, edgeTarget, edgeLength);
+    const int n = vertexAt.count();
+    if ( n == 0 ) {
+        return;
+    }
 
-    qDebug()<< "Graph::layoutForceDirectedKamadaKawai() - Compute dij, where (i,j) in E";
+    QString pMsg = tr("Embedding Pivot MDS layout.\n"
+                      "Please wait...");
+    emit statusMessage( pMsg );
+    emit signalProgressBoxCreate(2, pMsg);
 
-    graphMatrixDistanceGeodesicCreate(considerWeights,inverseWeights, dropIsolates);
+    const int k = qMin(n, LAYOUT_STRESS_PIVOTS);
+    QVector<qreal> pivotDist;
+    const QVector<int> pivots = layoutPivots(k, edgeStart, edgeTarget, edgeLength,
+                                             considerWeights, pivotDist);
+    emit signalProgressBoxUpdate(1);
 
-    // Compute original spring length
-    // lij for 1 <= i!=j <= n using the formula:
-    // lij = L x dij
-    // where L the desirable length of a single edge in the display pane
-    // Since we are on a restricted display (a canvas), L depends on the
-    // diameter D of the graph and the length L of a side of the display square:
-    // L = L0 / D
+    const qreal unreachable = layoutPivotUnreachable(k, pivots, pivotDist);
+    const qreal L = ( canvasMinDimension() - 100 ) / unreachable;
+    layoutPivotDistancesScale(k, pivots, unreachable, L, pivotDist);
 
-    qDebug()<< "Graph::layoutForceDirectedKamadaKawai() - "
-               "Compute lij = L x dij. lij will be symmmetric.";
+    qDebug()<< "Graph::layoutPivotMDS() - vertices" << n
+            << "pivots" << pivots.count() << "L" << L;
 
-    D = graphDiameter(considerWeights,inverseWeights);
-    L0 = canvasMinDimension()-100;
-    L = L0 / D;
-    qDebug()<< "Graph::layoutForceDirectedKamadaKawai() - L="
-            << L0 << "/" <<D << "=" <<L;
+    QVector<QPointF> pos;
+    layoutPivotMDSCoordinates(k, pivots, pivotDist, pos);
+    emit signalProgressBoxUpdate(2);
 
-    l.zeroMatrix(DM.rows(), DM.cols());
-    l=DM;
-    l.multiplyScalar(L);
-    qDebug()<< "Graph::layoutForceDirectedKamadaKawai() - l=" ;
-    //l.printMatrixConsole();
+    QVector<int> nodes(n);
+    QVector<qreal> x(n), y(n);
+    for (int v = 0 ; v < n ; v++ ) {
+        nodes[v] = m_graph[ vertexAt[v] ]->name();
+        x[v] = pos[v].x();
+        y[v] = pos[v].y();
+    }
+    layoutApply(nodes, x, y, true);
 
+    emit signalProgressBoxKill();
 
-    // Compute kij for 1 <= i!=j <= n using the formula:
-    // kij = K / dij ^2
-    // kij is the strength of the spring between pi and pj, K a constant
+    graphSetModified(GraphChange::ChangedPositions);
+}
 
-    qDebug()<< "Graph::layoutForceDirectedKamadaKawai() - "
-               "Compute kij = K / dij ^2. kij will be symmmetric. ";
 
-    k.zeroMatrix(DM.rows(), DM.cols());
 
-    for (i=0; i<N; i++){
-        for (j=0; j<N; j++){
-            if ( i == j )
-                continue;
-            k.setItem(i,j, K / (DM.item(i,j) * DM.item(i,j)));
-        }
-    }
-    qDebug()<< "Graph::layoutForceDirectedKamadaKawai() - k=" ;
-    //k.printMatrixConsole();
+/**
+ * @brief Sets the initial layout of the Eades and Fruchterman-Reingold models:
+ * "pivotmds", "random", "circle", or "current" to start where the actors are.
+ * @param initialPositions
+ */
+void Graph::layoutForceDirectedSetInitialPositions(const QString &initialPositions) {
+    m_layoutForceDirectedInitialPositions = initialPositions;
+}
 
 
-    // initialize p1, p2, ... pn
-    qDebug()<< "Graph::layoutForceDirectedKamadaKawai() - "
-               "Set particles to initial positions p" ;
-    i=0;
 
-    if (initialPositions == "circle") {
-        double x0=0, y0=0;
-        x0=canvasWidth/2.0;
-        y0=canvasHeight/2.0;
-        // placing the particles on the vertices of a regular n-polygon
-        // circumscribed by a circle whose diameter is L0
-        layoutCircular(x0,y0,L0/2,false);
+/**
+ * @brief Applies the initial layout of the force-directed models,
+ * see layoutForceDirectedSetInitialPositions
+ * @param radius the radius of the circle, for "circle"
+ */
+void Graph::layoutForceDirected_initialPositions(const qreal &radius) {
+    layoutRunnerStop();
+    if ( m_layoutForceDirectedInitialPositions == "pivotmds" ) {
+        layoutPivotMDS();
     }
-    else if (initialPositions == "random") {
+    else if ( m_layoutForceDirectedInitialPositions == "random" ) {
         layoutRandom();
     }
+    else if ( m_layoutForceDirectedInitialPositions == "circle" ) {
+        layoutCircular(canvasWidth/2.0, canvasHeight/2.0, radius, false);
+    }
+}
 
 
-    QString pMsg = tr("Embedding Kamada & Kawai spring model.\n"
-                      "Please wait...");
-    emit statusMessage( pMsg );
-    emit signalProgressBoxCreate(maxIterations, pMsg);
 
-    // while ( max_D_i > e )
-    while (Delta_max > epsilon) {
 
-        progressCounter++;
 
-        emit signalProgressBoxUpdate( progressCounter );
 
-        if (progressCounter == maxIterations) {
-            qDebug()<< "Graph::layoutForceDirectedKamadaKawai() - "
-                       "Reached maxIterations. BREAK";
-            break;
+/**
+ * @brief Sets the Barnes-Hut opening angle of the force-directed layouts.
+ * Cells of vertices which look smaller than theta from a vertex repel it
+ * as one body. 0 computes the repulsion between every pair of vertices.
+ * @param theta
+ */
+void Graph::layoutForceDirectedSetTheta(const qreal &theta) {
+    m_layoutForceDirectedTheta = qMax( (qreal) 0, theta );
+}
+
+
+
+/**
+ * @brief Collects the enabled edges between enabled vertices in
+ * compressed sparse row form, by vertex position: the targets of the
+ * vertex at position i are edgeTarget[edgeStart[i]] .. edgeTarget[edgeStart[i+1]-1].
+ * Used by the force-directed layouts instead of testing every vertex pair.
+ * @param edgeStart
+ * @param edgeTarget
+ */
+void Graph::layoutForceDirected_edges(QVector<int> &edgeStart,
+                                      QVector<int> &edgeTarget) {
+    const int N = m_graph.size();
+    edgeStart.fill(0, N + 1);
+    edgeTarget.clear();
+    for (int i = 0 ; i < N ; i++ ) {
+        edgeStart[i] = edgeTarget.count();
+        if ( ! m_graph[i]->isEnabled() ) {
+            continue;
+        }
+        const QHash<int,qreal> enabledOutEdges = m_graph[i]->outEdgesEnabledHash();
+        QHash<int,qreal>::const_iterator it;
+        for (it = enabledOutEdges.cbegin(); it != enabledOutEdges.cend(); ++it) {
+            const int t = vpos.value(it.key(), -1);
+            if ( it.value() == 0 || t == -1 || t == i || ! m_graph[t]->isEnabled() ) {
+                continue;
+            }
+            edgeTarget.append(t);
         }
+    }
+    edgeStart[N] = edgeTarget.count();
+}
 
 
-        Delta_max = epsilon;
 
-        // choose particle with largest Delta_m = max Delta_i
-        // compute partial derivatives of E by xm and ym for every particle m
-        // using equations 7 and 8
+/**
+ * @brief Copies the positions of all vertices to buffer, where the
+ * force-directed models keep them while embedding, and their names
+ * to nodes, so that the positions can be applied back by name.
+ * @param buffer
+ * @param nodes
+ */
+void Graph::layoutForceDirected_buffer(LayoutBuffer &buffer,
+                                       QVector<int> &nodes) const {
+    const int N = m_graph.size();
+    buffer.x.resize(N);
+    buffer.y.resize(N);
+    buffer.enabled.resize(N);
+    buffer.dx.fill(0, N);
+    buffer.dy.fill(0, N);
+    nodes.resize(N);
+    for (int i = 0 ; i < N ; i++ ) {
+        buffer.x[i] = m_graph[i]->x();
+        buffer.y[i] = m_graph[i]->y();
+        buffer.enabled[i] = m_graph[i]->isEnabled();
+        nodes[i] = m_graph[i]->name();
+    }
+}
 
-        qDebug()<< "Graph::layoutForceDirectedKamadaKawai() -  Iteration"
-                << progressCounter
-                <<  "Choose particle with largest Delta_m = max Delta_i ";
 
-        pnm = -1;
 
-        for (v1=m_graph.cbegin(); v1!=m_graph.cend(); ++v1) {
+/**
+ * @brief Moves the vertices named in nodes to the positions x, y and
+ * tells GW to move the nodes, in one batch.
+ * Vertices deleted in the meantime are skipped.
+ * @param nodes
+ * @param x
+ * @param y
+ * @param fit  if true, the positions are centered on the canvas and
+ * shrunk to fit it if needed
+ */
+void Graph::layoutApply(const QVector<int> &nodes,
+                        const QVector<qreal> &x,
+                        const QVector<qreal> &y,
+                        const bool &fit) {
+    const int n = nodes.count();
+    if ( n == 0 || x.count() < n || y.count() < n ) {
+        return;
+    }
+    qreal scale = 1, shiftX = 0, shiftY = 0;
+    qreal centerX = 0, centerY = 0;
+    if ( fit ) {
+        qreal minX = x[0], maxX = x[0], minY = y[0], maxY = y[0];
+        for (int v = 1 ; v < n ; v++ ) {
+            minX = qMin(minX, x[v]);
+            maxX = qMax(maxX, x[v]);
+            minY = qMin(minY, y[v]);
+            maxY = qMax(maxY, y[v]);
+        }
+        if ( maxX - minX > canvasWidth - 100 ) {
+            scale = ( canvasWidth - 100 ) / ( maxX - minX );
+        }
+        if ( maxY - minY > canvasHeight - 100 ) {
+            scale = qMin( scale, ( canvasHeight - 100 ) / ( maxY - minY ) );
+        }
+        centerX = (minX + maxX) / 2.0;
+        centerY = (minY + maxY) / 2.0;
+        shiftX = canvasWidth / 2.0;
+        shiftY = canvasHeight / 2.0;
+    }
+    QVector<int> moved;
+    QVector<qreal> movedX, movedY;
+    moved.reserve(n);
+    movedX.reserve(n);
+    movedY.reserve(n);
+    for (int v = 0 ; v < n ; v++ ) {
+        const int i = vpos.value(nodes[v], -1);
+        if ( i == -1 ) {
+            continue;
+        }
+        GraphVertex *vertex = m_graph[i];
+        vertex->setX( canvasVisibleX( shiftX + ( x[v] - centerX ) * scale ) );
+        vertex->setY( canvasVisibleY( shiftY + ( y[v] - centerY ) * scale ) );
+        moved.append( nodes[v] );
+        movedX.append( vertex->x() );
+        movedY.append( vertex->y() );
+    }
+    emit setNodesPos(moved, movedX, movedY);
+}
 
-            pn = (*v1)->name();
-            m = vpos[pn];
-            xm = (*v1)->x();
-            ym = (*v1)->y();
 
-            qDebug()<< "Graph::layoutForceDirectedKamadaKawai() - "
-                       "Compute partial derivatives E for particle" << pn
-                     << " vpos m" <<  m
-                     << " pos"<< xm << ", "<< ym;
 
+/**
+ * @brief Embeds a layout by running step on buffer, the positions of the
+ * vertices named in nodes, for up to maxIterations.
+ *
+ * If layouts run in the background (see setLayoutInBackground), the
+ * iterations run in a LayoutRunner on layoutThread, the canvas follows
+ * the layout frame by frame (see layoutRunnerFrame) and the user may
+ * pause or stop it; otherwise they run here, behind the progress box.
+ * Any layout still running is stopped first.
+ * @param nodes
+ * @param buffer
+ * @param step  one iteration, using only its own copies of the graph data
+ * @param maxIterations
+ * @param message  the status message while embedding
+ * @param doneMessage  the status message when done
+ * @param fit  if true, positions are centered and fitted to the canvas
+ * @param publish  see LayoutRunner
+ */
+void Graph::layoutRun(const QVector<int> &nodes,
+                      const LayoutBuffer &buffer,
+                      const LayoutRunner::Step &step,
+                      const int &maxIterations,
+                      const QString &message,
+                      const QString &doneMessage,
+                      const bool &fit,
+                      const LayoutRunner::Publish &publish) {
+
+    layoutRunnerStop();
+
+    qDebug() << "Graph::layoutRun() - vertices" << nodes.count()
+             << "maxIterations" << maxIterations
+             << "in background" << m_layoutInBackground;
+
+    m_layoutRunnerId++;
+    m_layoutRunnerNodes = nodes;
+    m_layoutRunnerMessage = doneMessage;
+    m_layoutRunnerFit = fit;
+
+    if ( m_layoutInBackground ) {
+        m_layoutRunner = new LayoutRunner(m_layoutRunnerId, buffer, step,
+                                          maxIterations, publish);
+        m_layoutRunner->moveToThread(&layoutThread);
+
+        connect(&layoutThread, &QThread::started,
+                m_layoutRunner, &LayoutRunner::run);
+        connect(&layoutThread, &QThread::finished,
+                m_layoutRunner, &QObject::deleteLater);
+        connect(m_layoutRunner, &LayoutRunner::frameReady,
+                this, &Graph::layoutRunnerFrame);
+        connect(m_layoutRunner, &LayoutRunner::finished,
+                this, &Graph::layoutRunnerFinished);
+
+        emit statusMessage( message );
+        emit signalLayoutRunning(true);
+        layoutThread.start();
+        return;
+    }
 
-            if ( ! (*v1)->isEnabled() ) {
-                qDebug() << "  particle " << pn
-                         << " vpos m " << m << " disabled. Continue";
-                continue;
-            }
+    emit statusMessage( message );
+    emit signalProgressBoxCreate(maxIterations, message);
 
-            partDrvtEx = 0;
-            partDrvtEy = 0;
+    LayoutRunner runner(m_layoutRunnerId, buffer, step, maxIterations, publish);
+    connect(&runner, &LayoutRunner::progress,
+            this, &Graph::signalProgressBoxUpdate);
+    connect(&runner, &LayoutRunner::finished,
+            this, &Graph::layoutRunnerFinished);
+    runner.run();
 
-            for (v2=m_graph.cbegin(); v2!=m_graph.cend(); ++v2) {
+    emit signalProgressBoxKill();
+}
 
-                i = vpos[(*v2)->name()];
-                xi = (*v2)->x();
-                yi = (*v2)->y();
 
-                qDebug () << "  particle vpos i"<< i
-                          << "  pos (" <<  xi << "," << yi << ")";
 
-                if ( ! (*v2)->isEnabled() ) {
-                    qDebug()<< " i "<< (*v2)->name()<< " disabled. Continue";
-                    continue;
-                }
+/**
+ * @brief Shows a frame of the running layout, and tells the runner
+ * it may publish the next one. Frames of stopped runners are ignored.
+ * @param id
+ * @param x
+ * @param y
+ */
+void Graph::layoutRunnerFrame(const int &id,
+                              const QVector<qreal> &x,
+                              const QVector<qreal> &y) {
+    if ( !m_layoutRunner || id != m_layoutRunnerId ) {
+        return;
+    }
+    layoutApply(m_layoutRunnerNodes, x, y, m_layoutRunnerFit);
+    m_layoutRunner->frameShown();
+}
 
-                if (m == i) {
-                    qDebug() << "  m==i, continuing";
-                    continue;
-                }
 
-                partDrvtEx += k.item(m,i) * ( (xm - xi) - ( l.item(m,i) * (xm - xi) ) / sqrt( (xm - xi) * (xm - xi) + (ym - yi)*(ym - yi) ) );
-                partDrvtEy += k.item(m,i) * ( (ym - yi) - ( l.item(m,i) * (ym - yi) ) / sqrt( (xm - xi) * (xm - xi) + (ym - yi)*(ym - yi) ) );
 
+/**
+ * @brief Applies the final positions of a layout, which has converged,
+ * run its iterations or been cancelled, and stops layoutThread.
+ * Stopped runners are ignored.
+ * @param id
+ * @param x
+ * @param y
+ * @param cancelled
+ */
+void Graph::layoutRunnerFinished(const int &id,
+                                 const QVector<qreal> &x,
+                                 const QVector<qreal> &y,
+                                 const bool &cancelled) {
+    qDebug() << "Graph::layoutRunnerFinished() - id" << id
+             << "cancelled" << cancelled;
+    if ( id != m_layoutRunnerId ) {
+        return;
+    }
 
-            } // end v2 for loop
+    layoutApply(m_layoutRunnerNodes, x, y, m_layoutRunnerFit);
 
-            Delta_m = sqrt (partDrvtEx * partDrvtEx + partDrvtEy * partDrvtEy);
+    if ( m_layoutRunner ) {
+        layoutThread.quit();
+        layoutThread.wait();
+        m_layoutRunner = 0;
+        emit signalLayoutRunning(false);
+    }
+    m_layoutRunnerNodes.clear();
 
-            qDebug()<< "Graph::layoutForceDirectedKamadaKawai() - m" << m << " Delta_m"
-                    << Delta_m;
+    emit statusMessage( ( cancelled ) ? tr("Layout stopped.") : m_layoutRunnerMessage );
 
-            if (Delta_m > Delta_max) {
-                qDebug()<< "Graph::layoutForceDirectedKamadaKawai() - m" << m << " Delta_m > Delta_max. "
-                        << " Setting new Delta_max = "
-                        << Delta_m;
+    graphSetModified(GraphChange::ChangedPositions);
+}
 
-                Delta_max = Delta_m;
-                partDrvtEx_m = partDrvtEx;
-                partDrvtEy_m = partDrvtEy;
 
-                pnm = pn ;  // store name of particle satisfying Delta_m = max Delta_i
-                pm = m ;  // store vpos of particle satisfying Delta_m = max Delta_i
-                xpm = xm; // store particle x pos
-                ypm = ym; // store particle y pos
-            }
 
-        } // end v1 for loop
+/**
+ * @brief Stops the layout running in the background, if any, without
+ * applying its positions. Called before any other layout and on clear.
+ */
+void Graph::layoutRunnerStop() {
+    if ( !m_layoutRunner ) {
+        return;
+    }
+    qDebug() << "Graph::layoutRunnerStop()";
+    disconnect(m_layoutRunner, 0, this, 0);
+    m_layoutRunner->cancel();
+    layoutThread.quit();
+    layoutThread.wait();
+    m_layoutRunner = 0;
+    m_layoutRunnerId++;
+    m_layoutRunnerNodes.clear();
+    emit signalLayoutRunning(false);
+}
 
 
-        if (pnm < 0) {
-            qDebug () << "Graph::layoutForceDirectedKamadaKawai() - "
-                         "No particle left with Delta_m > epsilon -- BREAK";
-            break;
-        }
 
+/**
+ * @brief Pauses or resumes the layout running in the background
+ * @param toggle
+ */
+void Graph::layoutRunnerPause(const bool &toggle) {
+    if ( !m_layoutRunner ) {
+        return;
+    }
+    qDebug() << "Graph::layoutRunnerPause()" << toggle;
+    m_layoutRunner->pause(toggle);
+    emit statusMessage( ( toggle ) ? tr("Layout paused.") : tr("Layout resumed.") );
+}
 
 
-      // let pm the particle satisfying  D_m = max_D_i
-      m  = pm ;
-      xm = xpm;
-      ym = ypm;
 
-      qDebug () << "Graph::layoutForceDirectedKamadaKawai() - m"<< m
-                << " has max Delta_m"<< Delta_max
-                << " Starting minimizing Delta_m - "
-                << " initial m pos " << xm << ym;
-
-
-      minimizationIterations=0;
-
-      // while ( D_m > e)
-      do {
-          if (minimizationIterations > 10) {
-              qDebug()<< "Graph::layoutForceDirectedKamadaKawai() - "
-                         "Reached minimizationIterations threshold. BREAK";
-              break;
-          }
-          minimizationIterations++;
-           qDebug () << "Graph::layoutForceDirectedKamadaKawai() - "
-                        "Started minimizing Delta_m for m"<< m
-                     << "First compute dx and dy by solving equations 11 and 12 ";
-
-          // compute dx and dy by solving equations 11 and 12
-
-          partDrvtEx=0;
-          partDrvtEy=0;
-          partDrvtEx_m = 0;
-          partDrvtEy_m = 0;
-          partDrvtExSec_m=0;
-          partDrvtEySec_m=0;
-          partDrvtExEySec_m=0;
-          partDrvtEyExSec_m=0;
-          // first compute coefficients of the linear system equations
-          for (v2=m_graph.cbegin(); v2!=m_graph.cend(); ++v2) {
-
-              i = vpos[(*v2)->name()];
-              xi = (*v2)->x();
-              yi = (*v2)->y();
-
-              qDebug () << "  m"<< m << "  i"<< i
-                        << "  pos_i (" <<  xi << "," << yi << ")";
-
-              if ( ! (*v2)->isEnabled() ) {
-                  qDebug()<< " i "<< (*v2)->name()<< " disabled. Continue";
-                  continue;
-              }
-
-              if (i == m) {
-                  qDebug() << "  m==i, continuing";
-                  continue;
-              }
-              partDrvDenom = pow ( sqrt( (xm - xi) * (xm - xi) + (ym - yi)*(ym - yi) ) , 3 );
-
-
-              partDrvtEx_m += k.item(m,i) * ( (xm - xi) - ( l.item(m,i) * (xm - xi) ) / sqrt( (xm - xi) * (xm - xi) + (ym - yi)*(ym - yi) ) );
-              partDrvtEy_m += k.item(m,i) * ( (ym - yi) - ( l.item(m,i) * (ym - yi) ) / sqrt( (xm - xi) * (xm - xi) + (ym - yi)*(ym - yi) ) );
-
-              partDrvtExSec_m   += k.item(m,i) * ( 1 - ( l.item(m,i) * (ym - yi) * (ym - yi) ) / partDrvDenom );
-
-              partDrvtExEySec_m += k.item(m,i) * ( ( l.item(m,i) * (xm - xi) * (ym - yi) ) /   partDrvDenom );
-
-              partDrvtEyExSec_m += k.item(m,i) * (  ( l.item(m,i) * (xm - xi) * (ym - yi) ) /   partDrvDenom );
-
-              partDrvtEySec_m   += k.item(m,i) * ( 1 - ( l.item(m,i) * (xm - xi) * (xm - xi) ) / partDrvDenom );
-
-
-          } // end v2 for loop
-
-          Delta_m = sqrt (partDrvtEx_m * partDrvtEx_m + partDrvtEy_m * partDrvtEy_m);
-
-          qDebug () << "Graph::layoutForceDirectedKamadaKawai() - m"<< m << " new Delta_m"
-                  << Delta_m;
-
-          LIN_EQ_COEF.setItem(0,0,partDrvtExSec_m);
-          LIN_EQ_COEF.setItem(0,1,partDrvtExEySec_m);
-          LIN_EQ_COEF.setItem(1,0,partDrvtEyExSec_m);
-          LIN_EQ_COEF.setItem(1,1,partDrvtEySec_m);
-          qDebug()<< "Graph::layoutForceDirectedKamadaKawai() - "
-                     " Jacobian Matrix of coefficients for linear system (eq. 11 & 12) is:";
-          //LIN_EQ_COEF.printMatrixConsole();
-          b[0] = - partDrvtEx_m;
-          b[1] = - partDrvtEy_m;
-          qDebug()<< "Graph::layoutForceDirectedKamadaKawai() - right hand vector is: \n"
-                  << b[0] << " \n" << b[1];
-          qDebug()<< "Graph::layoutForceDirectedKamadaKawai() - solving linear system...";
-          LIN_EQ_COEF.solve(b);
-          qDebug()<< "Graph::layoutForceDirectedKamadaKawai() - solved linear system.";
-          dx=b[0];
-          dy=b[1];
-          qDebug()<< "Graph::layoutForceDirectedKamadaKawai() - Solution \n b[0] = dx =" << dx
-                    << "\n b[1] = dy =" << dy;
-
-          qDebug () << "Graph::layoutForceDirectedKamadaKawai() - m"<< m
-                    << " current m pos " << xm << ym
-                    << " new m pos " << xm +dx << ym+dy;
-
-          if ( (xm + dx) < 50 || (xm + dx) > (canvasWidth-50) ) {
-              qDebug () << "Graph::layoutForceDirectedKamadaKawai() - "
-                           "new xm out of canvas, setting random x";
-                           xm = canvasRandomX();
-          }
-          else {
-              xm = xm + dx;
-          }
-          if ( (ym + dy) < 50 || (ym + dy) > (canvasHeight-50) ) {
-              qDebug () << "Graph::layoutForceDirectedKamadaKawai() - "
-                           "new ym out of canvas, setting random y";
-              ym = canvasRandomY();
-          }
-          else {
-              ym = ym + dy;
-          }
-          qDebug () << "Graph::layoutForceDirectedKamadaKawai() - m"<< m
-                    << " new m pos " << xm  << ym;
-
-          // TODO CHECK IF WE HAVE REACHED A FIXED POINT LOOP
-
-      } while (Delta_m > epsilon);
-      qDebug () << "Graph::layoutForceDirectedKamadaKawai() - Finished minimizing Delta_m "
-                   "for particle" << pnm << "vpos" << m
-                << "Minimized Delta_m"<< Delta_m
-                << "moving it to new pos" << xm << ym;
-      m_graph[m]->setX(xm);
-      m_graph[m]->setY(ym);
-      //emit setNodePos( pnm,  xm,  ym);
-
-    } // end while (Delta_max > epsilon) {
-
-    qDebug () << "Graph::layoutForceDirectedKamadaKawai() - "
-                 "Delta_max =< epsilon -- RETURN";
-
-    for (v1=m_graph.cbegin(); v1!=m_graph.cend(); ++v1) {
-
-        emit setNodePos( (*v1)->name(),  (*v1)->pos().x(),  (*v1)->pos().y());
+/**
+ * @brief Stops the layout running in the background, keeping the
+ * positions it has reached (see layoutRunnerFinished).
+ */
+void Graph::layoutRunnerCancel() {
+    if ( !m_layoutRunner ) {
+        return;
     }
-    emit signalProgressBoxKill();
+    qDebug() << "Graph::layoutRunnerCancel()";
+    m_layoutRunner->cancel();
+}
 
-    graphSetModified(GraphChange::ChangedPositions);
 
 
+/**
+ * @brief Returns true if a layout is running in the background
+ */
+bool Graph::layoutRunnerIsRunning() const {
+    return ( m_layoutRunner != 0 );
 }
 
 
 
+/**
+ * @brief Sets whether the iterative layouts run in the background,
+ * drawing their progress as they go, or block behind a progress box.
+ * @param toggle
+ */
+void Graph::setLayoutInBackground(const bool &toggle) {
+    m_layoutInBackground = toggle;
+}
 
 
 
@@ -22438,7 +25448,7 @@ qreal Graph::computeOptimalDistance(const int &V){
 
 
 
-qreal Graph::layoutForceDirected_F_att( const QString model, const qreal &dist,
+qreal Graph::layoutForceDirected_F_att( const QString &model, const qreal &dist,
                                         const qreal &optimalDistance) {
     qreal f_att;
     if (model == "Eades") {
@@ -22453,7 +25463,7 @@ qreal Graph::layoutForceDirected_F_att( const QString model, const qreal &dist,
 }
 
 
-qreal Graph::layoutForceDirected_F_rep( const QString model, const qreal &dist,
+qreal Graph::layoutForceDirected_F_rep( const QString &model, const qreal &dist,
                                         const qreal &optimalDistance) {
     qreal f_rep;
     if (model == "Eades") {
@@ -22567,90 +25577,6 @@ qreal Graph::graphDistanceEuclidean (const QPointF & a){
 
 
 
-void Graph::layoutForceDirected_Eades_moveNodes(const qreal &c4) {
-    qDebug() << "\n *****  layoutForceDirected_Eades_moveNodes() " ;
-    QPointF newPos;
-    qreal xvel = 0, yvel = 0;
-    VList::const_iterator v1;
-
-    for (v1=m_graph.cbegin(); v1!=m_graph.cend(); ++v1)
-    {
-        // calculate new overall velocity vector
-        xvel =  c4 * (*v1)->disp().rx();
-        yvel =  c4 * (*v1)->disp().ry();
-        qDebug() << " ##### source vertex  " <<  (*v1)->name()
-                 << " xvel,yvel = ("<< xvel << ", "<< yvel << ")";
-
-         //fix Qt error a positive QPoint to the floor
-        // when we ask for setNodePos to happen.
-        if ( xvel < 1 && xvel > 0 )
-            xvel = 1 ;
-        if ( yvel < 1 && yvel > 0 )
-            yvel = 1 ;
-
-        //Move source node to new position according to overall velocity
-        newPos = QPointF( (qreal) (*v1)->x() + xvel, (qreal) (*v1)->y() + yvel);
-
-        qDebug() << " source vertex v1 " << (*v1)->name()
-                    << " current pos: (" <<  (*v1)->x()
-                    << " , " << (*v1)->y()
-                    << " Possible new pos (" <<  newPos.x()
-                    << " , " <<  newPos.y();
-
-        // check if new pos is out of usable screen and adjust
-        newPos.rx() = canvasVisibleX(newPos.x());
-        newPos.ry() = canvasVisibleY(newPos.y());
-
-        qDebug() << "  Final new pos (" <<  newPos.x() << ","
-                 << newPos.y()<< ")";
-        (*v1)->setX(  newPos.x() );
-        (*v1)->setY(  newPos.y() );
-        emit setNodePos((*v1)->name(),  newPos.x(),  newPos.y());
-        //vertexPosSet();
-
-    }
-
-}
-
-/**
- * @brief Graph::layoutForceDirected_FR_moveNodes
- * @param temperature
- */
-void Graph::layoutForceDirected_FR_moveNodes(const qreal &temperature) {
-
-    qDebug() << "\n\n *****  layoutForceDirected_FR_moveNodes() \n\n " ;
-    qDebug () << " temperature " << temperature;
-    QPointF newPos;
-    qreal xvel = 0, yvel = 0;
-    VList::const_iterator v1;
-
-    for (v1=m_graph.cbegin(); v1!=m_graph.cend(); ++v1)
-    {
-        // compute the new position
-        // limit the maximum displacement to a maximum temperature
-        xvel = sign((*v1)->disp().rx()) * qMin( qAbs((*v1)->disp().rx()), temperature) ;
-        yvel = sign((*v1)->disp().ry()) * qMin( qAbs((*v1)->disp().ry()), temperature) ;
-        newPos = QPointF((*v1)->x()+ xvel, (*v1)->y()+yvel);
-        qDebug()<< " source vertex v1 " << (*v1)->name()
-                << " current pos: (" << (*v1)->x() << "," << (*v1)->y() << ")"
-                << "Possible new pos (" <<  newPos.x() << ","
-                << newPos.y()<< ")";
-
-        newPos.rx() = canvasVisibleX (newPos.x());
-        newPos.ry() = canvasVisibleY (newPos.y());
-
-        //Move node to new position
-        qDebug()<< " final new pos "
-                <<  newPos.x() << ","
-                << newPos.y()<< ")";
-        (*v1)->setX(  newPos.x() );
-        (*v1)->setY(  newPos.y() );
-        emit setNodePos((*v1)->name(),  newPos.x(),  newPos.y());
-    }
-}
-
-
-
 /**
  * @brief Helper method, return the human readable name of matrix type.
  * @param matrix
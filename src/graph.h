@@ -35,6 +35,7 @@
 #include <QHash>
 #include <QTextStream>
 #include <QThread>
+#include <QFutureWatcher>
 
 #include <QtCharts/QChartGlobal>
 #include <QAbstractSeries>
@@ -48,6 +49,7 @@
 #include "matrix.h"
 #include "parser.h"
 #include "webcrawler.h"
+#include "layoutrunner.h"
 #include "graphicswidget.h"
 
 QT_BEGIN_NAMESPACE
@@ -73,6 +75,7 @@ SOCNETV_USE_NAMESPACE
 
 
 class Chart;
+class GraphFileWriter;
 
 using namespace std;
 
@@ -134,6 +137,7 @@ class Graph:  public QObject{
     QThread file_parserThread;
     QThread wc_parserThread;
     QThread wc_spiderThread;
+    QThread layoutThread;
 
 public slots:
 
@@ -166,10 +170,29 @@ public slots:
                          const int &edgeDirType=0,
                          const QString &message=QString::null);
 
+    void graphLoadBatch(ParserBatch *batch);
+
+    void graphLoadEdgeListState(EdgeListAppendState *state);
+
+    void graphFileAppended(const int &newNodes,
+                           const int &edges,
+                           const QString &message=QString::null);
+
     void vertexRemoveDummyNode(int);
 
     void graphLoadedTerminateParserThreads (QString reason);
 
+    void layoutRunnerPause(const bool &toggle);
+
+    void layoutRunnerCancel();
+
+    void layoutRunnerFrame(const int &id,
+                           const QVector<qreal> &x, const QVector<qreal> &y);
+
+    void layoutRunnerFinished(const int &id,
+                              const QVector<qreal> &x, const QVector<qreal> &y,
+                              const bool &cancelled);
+
     void graphSelectionChanged(const QList<int> selectedVertices,
                                const QList<SelectedEdge> selectedEdges);
 
@@ -354,6 +377,12 @@ signals:
 
     void setNodePos(const int &, const qreal &, const qreal &);
 
+    void setNodesPos(const QVector<int> &nodes,
+                     const QVector<qreal> &x,
+                     const QVector<qreal> &y);
+
+    void signalLayoutRunning(const bool &running);
+
     void signalNodesFound(const QList<int> foundList);
 
     void setNodeSize(const int &v, const int &size);
@@ -456,6 +485,19 @@ public:
 
     bool graphSaveToDotFormat (QString fileName);
 
+    bool graphSaveToSnapshotFormat (const QString &fileName);
+
+    bool graphSaveFinish (GraphFileWriter &out, const QString &message);
+
+    void graphFileSaveFinished();
+
+    void setFileSaveInBackground(const bool &toggle);
+
+    bool graphLoadSnapshot (const QString &fileName);
+    bool graphLoadAppendSupported() const;
+    QString graphLoadAppendFileName() const;
+    void graphLoadAppend();
+
     int graphFileFormat() const;
 
     bool graphFileFormatExportSupported(const int &fileFormat) const;
@@ -707,24 +749,30 @@ public:
 
 
     void graphMatrixSimilarityMatchingCreate(Matrix &AM,
-                                             Matrix &SEM,
+                                             SymmetricMatrix &SEM,
                                              const int &measure=METRIC_SIMPLE_MATCHING,
                                              const QString &varLocation="Rows",
                                              const bool &diagonal=false,
                                              const bool &considerWeights=true);
 
     void graphMatrixSimilarityPearsonCreate (Matrix &AM,
-                                             Matrix &PCC,
+                                             SymmetricMatrix &PCC,
                                              const QString &varLocation="Rows",
                                              const bool &diagonal=false);
 
     void graphMatrixDissimilaritiesCreate(Matrix &INPUT_MATRIX,
-                                          Matrix &DSM,
+                                          SymmetricMatrix &DSM,
                                           const int &metric,
                                           const QString &varLocation,
                                           const bool &diagonal,
                                           const bool &considerWeights);
 
+    void graphSimilarityNearestNeighbors(QHash<int, QList<pair_i_f> > &neighbors,
+                                         const int &k=10,
+                                         const QString &varLocation="Rows",
+                                         const int &bands=16,
+                                         const int &rowsPerBand=4);
+
     /* REPORT EXPORTS */
     void setReportsDataDir(const QString &reportsDir);
     void setReportsRealNumberPrecision (const int & precision);
@@ -733,7 +781,7 @@ public:
 
     void writeDataSetToFile(const QString dir, const QString );
 
-    void writeMatrixAdjacencyTo(QTextStream& os,
+    void writeMatrixAdjacencyTo(GraphFileWriter& os,
                                 const bool &saveEdgeWeights=true);
 
     void writeReciprocity( const QString fileName,
@@ -753,6 +801,12 @@ public:
                               const bool &printInfinity=true,
                               const bool &dropIsolates=false);
 
+    void writeMatrixHTMLTable(QTextStream &outText, SymmetricMatrix &M,
+                              const bool &markDiag=true,
+                              const bool &plain=false,
+                              const bool &printInfinity=true,
+                              const bool &dropIsolates=false);
+
     void writeMatrixAdjacency(const QString fileName,
                               const bool &markDiag=true);
 
@@ -807,6 +861,10 @@ public:
                                                const QString &varLocation="rows",
                                                const bool &diagonal=false);
 
+    void writeSimilarityNearestNeighbors(const QString fileName,
+                                         const int &k=10,
+                                         const QString &varLocation="Rows");
+
     void writeEccentricity( const QString fileName,
                             const bool considerWeights=false,
                             const bool inverseWeights=false,
@@ -1048,6 +1106,21 @@ public:
 
     void layoutForceDirectedFruchtermanReingold(const int maxIterations);
 
+    void layoutForceDirectedMultilevel(const int iterations=50,
+                                       const int quality=1);
+
+    void layoutForceDirectedSetTheta(const qreal &theta);
+
+    void layoutForceDirectedSetInitialPositions(const QString &initialPositions);
+
+    void setLayoutInBackground(const bool &toggle);
+
+    bool layoutRunnerIsRunning() const;
+
+    void layoutPivotMDS(const bool considerWeights=false,
+                        const bool inverseWeights=false,
+                        const bool dropIsolates=false);
+
     void layoutForceDirectedKamadaKawai(const int maxIterations=500,
                                         const bool considerWeights=false,
                                         const bool inverseWeights=false,
@@ -1058,19 +1131,45 @@ public:
 
     qreal graphDistanceEuclidean(const QPointF &a);
 
-    int sign(const qreal &D);
+    static int sign(const qreal &D);
 
-    qreal layoutForceDirected_F_rep(const QString model,
-                                    const qreal &dist,
-                                    const qreal &optimalDistance);
+    static qreal layoutForceDirected_F_rep(const QString &model,
+                                           const qreal &dist,
+                                           const qreal &optimalDistance);
 
-    qreal layoutForceDirected_F_att(const QString model,
-                                    const qreal &dist,
-                                    const qreal &optimalDistance) ;
+    static qreal layoutForceDirected_F_att(const QString &model,
+                                           const qreal &dist,
+                                           const qreal &optimalDistance) ;
 
-    void layoutForceDirected_Eades_moveNodes(const qreal &c4);
+    void layoutForceDirected_buffer(LayoutBuffer &buffer, QVector<int> &nodes) const;
 
-    void layoutForceDirected_FR_moveNodes(const qreal &temperature) ;
+    void layoutApply(const QVector<int> &nodes,
+                     const QVector<qreal> &x,
+                     const QVector<qreal> &y,
+                     const bool &fit);
+
+    void layoutRun(const QVector<int> &nodes,
+                   const LayoutBuffer &buffer,
+                   const LayoutRunner::Step &step,
+                   const int &maxIterations,
+                   const QString &message,
+                   const QString &doneMessage,
+                   const bool &fit=false,
+                   const LayoutRunner::Publish &publish=LayoutRunner::Publish());
+
+    void layoutRunnerStop();
+
+    void layoutForceDirected_edges(QVector<int> &edgeStart, QVector<int> &edgeTarget);
+
+    void layoutForceDirected_initialPositions(const qreal &radius);
+
+    void layoutDistance_edges(const bool &considerWeights,
+                              const bool &inverseWeights,
+                              const bool &dropIsolates,
+                              QVector<int> &vertexAt,
+                              QVector<int> &edgeStart,
+                              QVector<int> &edgeTarget,
+                              QVector<qreal> &edgeLength);
 
     qreal layoutForceDirected_FR_temperature(const int iteration) const;
 
@@ -1164,6 +1263,10 @@ private:
 
     /** private member functions */
 
+    void graphLoadParserCreate();
+
+    void graphLoadBatchesFinish();
+
     void edgeAdd (const int &v1,
                   const int &v2,
                   const qreal &weight,
@@ -1172,6 +1275,12 @@ private:
                   const QString &color
                   );
 
+    template <class M>
+    void writeMatrixHTMLTableOf(QTextStream &outText, M &matrix,
+                                const bool &markDiag,
+                                const bool &printInfinity,
+                                const bool &dropIsolates);
+
     /** methods used by graphDistancesGeodesic()  */
     void BFS(const int &s,
              const int &si,
@@ -1230,7 +1339,8 @@ private:
     QMap<int, V_str> m_clusterPairNamesPerSeq;
 
     Matrix  SIGMA, DM, sumM, invAM, AM, invM, WM;
-    Matrix XM, XSM, XRM, CLQM;
+    Matrix XM, XSM, XRM;
+    SymmetricMatrix CLQM;
 
     stack<int> Stack;
 
@@ -1246,6 +1356,30 @@ private:
 
     int m_fieldWidth, m_curRelation, m_fileFormat, m_vertexClicked;
 
+    /** Background writing of exported network files */
+    bool m_fileSaveInBackground, m_fileSavePending, m_fileSaveStale;
+    QString m_fileSaveName, m_fileSaveMessage;
+    QFutureWatcher<bool> m_fileSaveWatcher;
+
+    /** Barnes-Hut opening angle of the force-directed layouts */
+    qreal m_layoutForceDirectedTheta;
+    QString m_layoutForceDirectedInitialPositions;
+
+    /** The layout running in layoutThread, if any, and what it places */
+    LayoutRunner *m_layoutRunner;
+    int m_layoutRunnerId;
+    QVector<int> m_layoutRunnerNodes;
+    QString m_layoutRunnerMessage;
+    bool m_layoutRunnerFit;
+    bool m_layoutInBackground;
+
+    /** What the last edge list load needs to append new lines */
+    EdgeListAppendState *m_edgeListState;
+    bool m_appendWasNew;
+
+    /** Strongest change made by the Parser batches of the current load */
+    int m_batchChange;
+
     MyEdge m_clickedEdge;
 
     qreal edgeWeightTemp, edgeReverseWeightTemp;
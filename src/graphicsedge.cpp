@@ -125,6 +125,7 @@ GraphicsEdge::GraphicsEdge(GraphicsWidget *gw,
     //setCacheMode (QGraphicsItem::ItemCoordinateCache);
     //setCacheMode(QGraphicsItem::DeviceCoordinateCache);
 
+    m_dirty = false;
     adjust();
 }
 
@@ -138,6 +139,35 @@ void GraphicsEdge::showArrows(const bool &drawArrows){
 
 
 
+/**
+ * @brief Returns true if the edge draws arrows
+ * @return
+ */
+bool GraphicsEdge::arrowsVisible() const {
+    return m_drawArrows;
+}
+
+
+/**
+ * @brief Returns true if the edge is drawn as a curve
+ * @return
+ */
+bool GraphicsEdge::isBezier() const {
+    return m_Bezier;
+}
+
+
+/**
+ * @brief Returns the level of detail the canvas is drawn with.
+ * Used by the edge weight and label to hide themselves.
+ * @return
+ */
+int GraphicsEdge::detailLevel() const {
+    return graphicsWidget->detailLevel();
+}
+
+
+
 void GraphicsEdge::removeRefs(){
     qDebug("GraphicsEdge: removeRefs()");
     source->deleteOutLink(this);
@@ -231,6 +261,16 @@ void GraphicsEdge::setWeightNumberVisibility (const bool &toggle) {
 
 
 
+/**
+ * @brief Returns true if the weight number of the edge is shown
+ * @return
+ */
+bool GraphicsEdge::weightNumberVisible() const {
+    return m_drawWeightNumber && weightNumber->isVisible();
+}
+
+
+
 /**
  * @brief Called from MW when user wants to change an edge's label
  * @param label
@@ -344,6 +384,16 @@ void GraphicsEdge::setMinimumOffsetFromNode(const int &offset) {
 
 
 
+/**
+ * @brief Returns the minimum offset of the edge from its nodes
+ * @return
+ */
+int GraphicsEdge::minimumOffsetFromNode() const {
+    return (int) m_minOffsetFromNode;
+}
+
+
+
 qreal GraphicsEdge::dx() const
 {
     return target->x() - source->x();
@@ -363,6 +413,8 @@ qreal GraphicsEdge::length() const
 /**
  * @brief Leaves some empty space (offset) from node -
  * make the edge weight appear on the centre of the edge
+ * Recomputes the geometry right away. When nodes move, they call markDirty()
+ * instead, see GraphicsWidget::edgeGeometryFlush()
  */
 void GraphicsEdge::adjust(){
    // qDebug() << "GraphicsEdge::adjust()";
@@ -370,32 +422,70 @@ void GraphicsEdge::adjust(){
         return;
     }
 
-//    QLineF line(source->x(), source->y(), target->x(), target->y());
-    //QPointF edgeOffset;
+    qreal line_dx = dx();
+    qreal line_dy = dy();
+    qreal line_length = length();
+
+    QPointF unit(0, 0);
+    if (source!=target && line_length > 0) {
+        unit = QPointF( line_dx / line_length, line_dy / line_length );
+    }
+
+    setGeometry( source->pos() + unit * m_offsetFromTargetNode,
+                 target->pos() - unit * m_offsetFromTargetNode,
+                 unit,
+                 line_length );
+}
 
-    //line_length = line.length();
-//    line_dx = line.dx();
-//    line_dy = line.dy();
 
-    line_length = length();
-    line_dx = dx();
-    line_dy = dy();
 
-    if (source!=target) {
-        edgeOffset = QPointF(
-                    (line_dx * m_offsetFromTargetNode) / line_length,
-                    (line_dy * m_offsetFromTargetNode) / line_length);
+/**
+ * @brief Marks the edge geometry as out of date.
+ * Called when one of its nodes moves. GraphicsWidget recomputes
+ * all marked edges at once, before the canvas gets repainted.
+ */
+void GraphicsEdge::markDirty() {
+    if (m_dirty) {
+        return;
     }
-    else edgeOffset = QPointF(0, 0);
+    m_dirty = true;
+    graphicsWidget->edgeGeometryDirty(this);
+}
 
-    prepareGeometryChange();
 
-//    sourcePoint = line.p1() + edgeOffset ;
-//    targetPoint = line.p2() - edgeOffset ;
+bool GraphicsEdge::isDirty() const {
+    return m_dirty;
+}
+
+
+/**
+ * @brief Returns the distance of the edge ends from the node centres
+ * @return
+ */
+qreal GraphicsEdge::offsetFromNode() const {
+    return m_offsetFromTargetNode;
+}
+
 
-    sourcePoint = source->pos() + edgeOffset ;
-    targetPoint = target->pos() - edgeOffset ;
 
+/**
+ * @brief Sets the edge geometry and rebuilds the path the edge is drawn with.
+ * Called from adjust() and from GraphicsWidget::edgeGeometryFlush()
+ * @param p1 the point where the edge leaves its source node
+ * @param p2 the point where the edge reaches its target node
+ * @param unit the unit vector from source to target node, (0,0) for self-links
+ * @param length the distance between the node centres
+ */
+void GraphicsEdge::setGeometry(const QPointF &p1,
+                               const QPointF &p2,
+                               const QPointF &unit,
+                               const qreal &length) {
+    m_dirty = false;
+
+    prepareGeometryChange();
+
+    sourcePoint = p1;
+    targetPoint = p2;
 
     if (m_drawWeightNumber) {
         weightNumber->setPos(
@@ -414,11 +504,11 @@ void GraphicsEdge::adjust(){
     //Construct the path
     if (source!=target) {
         if ( !m_Bezier){
-            //   qDebug()<< "*** GraphicsEdge::paint(). Constructing a line";
+            //   qDebug()<< "*** GraphicsEdge::setGeometry(). Constructing a line";
             path.lineTo(targetPoint);
         }
         else {
-            qDebug() << "*** GraphicsEdge::paint(). Constructing a bezier curve";
+            qDebug() << "*** GraphicsEdge::setGeometry(). Constructing a bezier curve";
             QPointF c = QPointF( targetPoint.x() - sourcePoint.x(),
                                  targetPoint.y() - targetPoint.y());
             path.cubicTo( sourcePoint, c, targetPoint);
@@ -427,73 +517,37 @@ void GraphicsEdge::adjust(){
     else { //self-link
         QPointF c1 = QPointF( targetPoint.x() -30,  targetPoint.y() -30 );
         QPointF c2 = QPointF( targetPoint.x() +30,  targetPoint.y() -30 );
-//        qDebug()<< "*** GraphicsEdge::paint(). Constructing a bezier self curve c1 "
-//                <<c1.x()<<","<<c1.y()  << " and c2 "<<c2.x()<<","<<c2.y();
         path.cubicTo( c1, c2, targetPoint);
     }
 
     //Draw the arrows only if we have different nodes
     //and the nodes are enough far apart from each other
-    if (m_drawArrows && source!=target && line_length > 10) {
-
-        angle = 0;
-
-        if ( line_length > 0 )
-            angle = ::acos( line_dx / line_length );
-        //		qDebug() << " acos() " << ::acos( line_dx  / line_length ) ;
-
-        if ( line_dy  >= 0)
-            angle = M_PI_X_2 - angle;
-
-
-//            qDebug() << "*** GraphicsEdge::paint(). Constructing arrows. "
-//                        "First Arrow at target node"
-//                     << "target-source: " << line_dx
-//                     << " length: " << line_length
-//                     << " angle: "<< angle;
-
-            QPointF destArrowP1 = targetPoint + QPointF(sin(angle - M_PI_3) * m_arrowSize,
-                                                        cos(angle - M_PI_3) * m_arrowSize);
-            QPointF destArrowP2 = targetPoint + QPointF(sin(angle - M_PI + M_PI_3) * m_arrowSize,
-                                                        cos(angle - M_PI + M_PI_3) * m_arrowSize);
-//            qDebug() << "*** GraphicsEdge::paint() destArrowP1 "
-//                     <<  destArrowP1.x() << "," << destArrowP1.y()
-//                      << "  destArrowP2 " <<  destArrowP2.x() << "," << destArrowP2.y();
-
+    if (m_drawArrows && source!=target && length > 10) {
+
+        // The arrow sides are the reversed edge direction rotated by +/- 30 degrees
+        const qreal c = M_SQRT3_2 * m_arrowSize;
+        const qreal s = 0.5 * m_arrowSize;
+        const qreal ux = unit.x();
+        const qreal uy = unit.y();
+
+        path.addPolygon ( QPolygonF()
+                             << targetPoint
+                             << targetPoint + QPointF( -c * ux - s * uy, s * ux - c * uy )
+                             << targetPoint + QPointF( -c * ux + s * uy, -s * ux - c * uy )
+                             << targetPoint
+                             );
+
+        if (m_edgeDirType == EdgeType::Undirected || m_edgeDirType == EdgeType::Reciprocated ) {
+            // symmetric edge, we need an arrow at the source node as well
             path.addPolygon ( QPolygonF()
-                                 << targetPoint
-                                 << destArrowP1
-                                 << destArrowP2
-                                 << targetPoint
+                                 << sourcePoint
+                                 << sourcePoint + QPointF( c * ux - s * uy, s * ux + c * uy )
+                                 << sourcePoint + QPointF( c * ux + s * uy, -s * ux + c * uy )
+                                 << sourcePoint
                                  );
-
-            if (m_edgeDirType == EdgeType::Undirected || m_edgeDirType == EdgeType::Reciprocated ) {
-    //            qDebug() << "**** GraphicsEdge::paint() This edge is SYMMETRIC! "
-    //                     << " So, we need to create Arrow at src node as well";
-                QPointF srcArrowP1 = sourcePoint + QPointF(sin(angle +M_PI_3) * m_arrowSize,
-                                                           cos(angle +M_PI_3) * m_arrowSize);
-                QPointF srcArrowP2 = sourcePoint + QPointF(sin(angle +M_PI - M_PI_3) * m_arrowSize,
-                                                           cos(angle +M_PI - M_PI_3) * m_arrowSize);
-
-                path.addPolygon ( QPolygonF()
-                                     << sourcePoint
-                                     << srcArrowP1
-                                     << srcArrowP2
-                                     <<sourcePoint
-                                     );
-
-            }
-            else {
-                // qDebug() << "*** GraphicsEdge::paint() Not symmetric edge. Finish";
-            }
-
-
-    }
-    else {
-//        qDebug()<< "*** GraphicsEdge::paint(). This edge is self-link - CONTINUE!";
+        }
     }
 
-
     m_path =  path;
 }
 
@@ -513,6 +567,13 @@ QPainterPath GraphicsEdge::shape () const {
 //    m_path_shape.addPath(m_path.translated(1,1));
 //    m_path_shape.addPath(m_path.translated(-1,-1));
 //    return m_path_shape;
+    if ( m_Bezier && source != target
+         && graphicsWidget->detailLevel() < DETAIL_FULL ) {
+        // cheap hit tests when zoomed out
+        QPainterPath line(sourcePoint);
+        line.lineTo(targetPoint);
+        return line;
+    }
     return m_path;
 } 
 
@@ -642,9 +703,31 @@ void GraphicsEdge::paint(QPainter *painter, const QStyleOptionGraphicsItem *opti
          setZValue(ZValueEdge);
          setState(EDGE_STATE_REGULAR);
      }
+
+    int detail = graphicsWidget->detailLevel();
+
+    if ( detail <= DETAIL_POINTS ) {
+        // far zoomed out, draw a thin straight line without antialiasing
+        if (source == target) {
+            return;
+        }
+        bool antialiasing = painter->testRenderHint(QPainter::Antialiasing);
+        painter->setRenderHint(QPainter::Antialiasing, false);
+        painter->setPen(QPen(m_color, 0));
+        painter->drawLine(sourcePoint, targetPoint);
+        painter->setRenderHint(QPainter::Antialiasing, antialiasing);
+        return;
+    }
+
     // set painter pen to correct edge pen
     painter->setPen(pen());
 
+    if ( detail < DETAIL_FULL && !m_Bezier && source != target ) {
+        // skip the arrows
+        painter->drawLine(sourcePoint, targetPoint);
+        return;
+    }
+
     // set painter brush to paint inside the arrow
     painter->setBrush( m_color );
 
@@ -750,6 +833,19 @@ void GraphicsEdge::mousePressEvent(QGraphicsSceneMouseEvent *e) {
 
 
 
+/**
+ * @brief Lets GraphicsWidget know the cursor left this edge,
+ * so that it may return it to the edge layer.
+ * @param event
+ */
+void GraphicsEdge::hoverLeaveEvent(QGraphicsSceneHoverEvent *event) {
+    QGraphicsItem::hoverLeaveEvent(event);
+    graphicsWidget->edgeLayerHover(-1);
+}
+
+
+
+
 GraphicsEdge::~GraphicsEdge(){
     qDebug() << "GraphicsEdge::~GraphicsEdge() - self-destructing edge " << sourceNodeNumber()<< "->" << targetNodeNumber();
 
@@ -36,6 +36,7 @@
 
 class GraphicsWidget;
 class QGraphicsSceneMouseEvent;
+class QGraphicsSceneHoverEvent;
 class GraphicsNode;
 class GraphicsEdgeWeight;
 class GraphicsEdgeLabel;
@@ -92,6 +93,15 @@ public:
     void setTargetNodeSize(const int & size);
 
     void setMinimumOffsetFromNode(const int & offset);
+    int minimumOffsetFromNode() const;
+    qreal offsetFromNode() const;
+
+    void markDirty();
+    bool isDirty() const;
+    void setGeometry(const QPointF &p1,
+                     const QPointF &p2,
+                     const QPointF &unit,
+                     const qreal &length);
 
     void removeRefs();
 
@@ -100,6 +110,7 @@ public:
     void addWeightNumber ();
     //void deleteWeightNumber();
     void setWeightNumberVisibility  (const bool &toggle);
+    bool weightNumberVisible() const;
 
     void setLabel( const QString &label) ;
     QString label() const;
@@ -108,6 +119,10 @@ public:
     void setLabelVisibility  (const bool &toggle);
 
     void showArrows(const bool &);
+    bool arrowsVisible() const;
+
+    bool isBezier() const;
+    int detailLevel() const;
 
     void setDirectionType(const int &dirType=0);
     int directionType();
@@ -139,6 +154,7 @@ protected:
     void paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget);
     QVariant itemChange(GraphicsItemChange change, const QVariant &value);
     void mousePressEvent(QGraphicsSceneMouseEvent *event);
+    void hoverLeaveEvent(QGraphicsSceneHoverEvent *event);
 
 
 
@@ -155,8 +171,6 @@ private:
 
     QPointF sourcePoint, targetPoint;
 
-    QPointF edgeOffset;
-
     qreal m_arrowSize;
 
     qreal m_minOffsetFromNode;
@@ -172,11 +186,10 @@ private:
 
     int m_edgeDirType;
 
-    qreal angle, line_length, line_dx, line_dy;
-
     bool m_Bezier, m_drawArrows, m_drawWeightNumber;
     bool m_drawLabel, m_hoverHighlighting;
     bool m_isClicked;
+    bool m_dirty;
 };
 
 #endif
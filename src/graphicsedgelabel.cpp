@@ -27,6 +27,7 @@
 
 #include "graphicsedgelabel.h"
 #include "graphicsedge.h"
+#include "graphicswidget.h"
 #include <QDebug>
 #include <QFont>
 
@@ -35,6 +36,7 @@ GraphicsEdgeLabel::GraphicsEdgeLabel( GraphicsEdge *link , int size, QString lab
 : QGraphicsTextItem( 0)
 {
     qDebug()<< "GraphicsEdgeLabel:: creating new edgelabel and attaching it to link";
+    edge=link;
 	setPlainText( labelText );
     setParentItem(link); //auto disables child items like this, when link is disabled.
     this->setFont( QFont ("Courier", size, QFont::Light, true) );
@@ -42,6 +44,21 @@ GraphicsEdgeLabel::GraphicsEdgeLabel( GraphicsEdge *link , int size, QString lab
 }
 
 
+/**
+ * @brief Paints the text only when the canvas is drawn in full detail.
+ * See GraphicsWidget::detailLevel()
+ * @param painter
+ * @param option
+ * @param widget
+ */
+void GraphicsEdgeLabel::paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget) {
+    if ( edge->detailLevel() < DETAIL_FULL ) {
+        return;
+    }
+    QGraphicsTextItem::paint(painter, option, widget);
+}
+
+
 GraphicsEdgeLabel::~GraphicsEdgeLabel()
 {
 }
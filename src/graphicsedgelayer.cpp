@@ -0,0 +1,984 @@
+/***************************************************************************
+ SocNetV: Social Network Visualizer
+ version: 2.5
+ Written in Qt
+
+                        graphicsedgelayer.cpp  -  description
+                             -------------------
+    copyright         : (C) 2005-2019 by Dimitris B. Kalamaras
+    project site      : https://socnetv.org
+
+ ***************************************************************************/
+
+/*******************************************************************************
+*     This program is free software: you can redistribute it and/or modify     *
+*     it under the terms of the GNU General Public License as published by     *
+*     the Free Software Foundation, either version 3 of the License, or        *
+*     (at your option) any later version.                                      *
+*                                                                              *
+*     This program is distributed in the hope that it will be useful,          *
+*     but WITHOUT ANY WARRANTY; without even the implied warranty of           *
+*     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            *
+*     GNU General Public License for more details.                             *
+*                                                                              *
+*     You should have received a copy of the GNU General Public License        *
+*     along with this program.  If not, see <http://www.gnu.org/licenses/>.    *
+********************************************************************************/
+
+#include "graphicsedgelayer.h"
+
+#include <QGraphicsScene>
+#include <QGraphicsSceneHoverEvent>
+#include <QStyleOptionGraphicsItem>
+#include <QPainter>
+#include <QFontMetricsF>
+#include <QtDebug>
+#include <cmath>
+#include <cstdlib>
+#include <limits>
+
+#include "global.h"
+#include "graphicswidget.h"
+#include "graphicsnode.h"
+
+SOCNETV_USE_NAMESPACE
+
+
+// side of a hit test grid cell, in scene pixels
+static const qreal EDGE_LAYER_CELL = 64;
+
+// the largest query rectangle we treat as a point when hit testing
+static const qreal EDGE_LAYER_MAX_QUERY = 64;
+
+
+/**
+ * @brief Returns the pen width of an edge of the given weight.
+ * Same as in GraphicsEdge.
+ * @param weight
+ * @return
+ */
+static qreal edgeLayerWidth(const qreal &weight) {
+    if ( fabs(weight) > 1  )  {
+        return 1+log ( 1+ log(fabs(weight) )) ;
+    }
+    return fabs(weight) ;
+}
+
+
+/**
+ * @brief Returns the distance of point p from the segment ab
+ */
+static qreal edgeLayerDistance(const QPointF &p, const QPointF &a, const QPointF &b) {
+    qreal dx = b.x() - a.x();
+    qreal dy = b.y() - a.y();
+    qreal len2 = dx * dx + dy * dy;
+    qreal t = 0;
+    if ( len2 > 0 ) {
+        t = ( (p.x() - a.x()) * dx + (p.y() - a.y()) * dy ) / len2;
+        t = qBound( (qreal) 0, t, (qreal) 1 );
+    }
+    qreal ex = a.x() + t * dx - p.x();
+    qreal ey = a.y() + t * dy - p.y();
+    return sqrt( ex * ex + ey * ey );
+}
+
+
+
+/**
+ * @brief A pen and the batched geometry painted with it
+ */
+struct EdgeLayerBucket {
+    QPen pen;
+    QColor brush;
+    QVector<QLineF> lines;
+    QPainterPath path;
+};
+
+
+
+GraphicsEdgeLayer::GraphicsEdgeLayer(GraphicsWidget *gw) : graphicsWidget(gw)
+{
+    qDebug()<< "GraphicsEdgeLayer::GraphicsEdgeLayer()";
+
+    graphicsWidget->scene()->addItem(this);
+
+    m_arrowSize = 4;
+    m_drawLabels = true;
+    m_highlighting = true;
+
+    m_gridCols = m_gridRows = 0;
+    m_gridDirty = true;
+
+    m_rect = graphicsWidget->scene()->sceneRect();
+
+    // we need option->exposedRect to cull edges outside the repainted area
+    setFlags(QGraphicsItem::ItemUsesExtendedStyleOption);
+
+    setAcceptHoverEvents(true);
+
+    setZValue(ZValueEdgeLayer);
+}
+
+
+
+/**
+ * @brief Removes all edges from the layer
+ */
+void GraphicsEdgeLayer::clear() {
+    qDebug()<< "GraphicsEdgeLayer::clear()";
+    m_index.clear();
+    m_key.clear();
+    m_nodeEdges.clear();
+    m_source.clear();
+    m_target.clear();
+    m_weight.clear();
+    m_width.clear();
+    m_label.clear();
+    m_color.clear();
+    m_dirType.clear();
+    m_offset.clear();
+    m_flags.clear();
+    m_grid.clear();
+    m_gridDirty = true;
+    update();
+}
+
+
+int GraphicsEdgeLayer::count() const {
+    return m_key.size();
+}
+
+
+bool GraphicsEdgeLayer::hasEdge(const EdgeKey &key) const {
+    return m_index.contains(key);
+}
+
+
+/**
+ * @brief Returns the index of the given edge, or -1 if there is no such edge
+ * @param key
+ * @return
+ */
+int GraphicsEdgeLayer::edgeIndex(const EdgeKey &key) const {
+    return m_index.value(key, -1);
+}
+
+
+EdgeKey GraphicsEdgeLayer::edgeKey(const int &index) const {
+    return m_key.at(index);
+}
+
+
+
+/**
+ * @brief Adds a new edge to the layer.
+ * The key is the same GraphicsWidget uses in edgesHash.
+ */
+void GraphicsEdgeLayer::addEdge(const EdgeKey &key,
+                                GraphicsNode *source,
+                                GraphicsNode *target,
+                                const qreal &weight,
+                                const QString &label,
+                                const QColor &color,
+                                const int &dirType,
+                                const bool &drawArrows,
+                                const bool &bezier,
+                                const bool &weightNumber,
+                                const int &offset) {
+    if ( !source || !target ) {
+        qDebug()<< "GraphicsEdgeLayer::addEdge() - missing node for" << edgeKeyName(key);
+        return;
+    }
+    if ( m_index.contains(key) ) {
+        removeEdge(key);
+    }
+    quint8 flags = EdgeVisible;
+    if (drawArrows) flags |= EdgeArrows;
+    if (bezier) flags |= EdgeBezier;
+    if (weightNumber) flags |= EdgeWeightNumber;
+
+    int index = m_key.size();
+    m_index.insert(key, index);
+    m_key.append(key);
+    m_nodeEdges[source].append(index);
+    if ( target != source ) {
+        m_nodeEdges[target].append(index);
+    }
+    m_source.append(source);
+    m_target.append(target);
+    m_weight.append(weight);
+    m_width.append(edgeLayerWidth(weight));
+    m_label.append(label);
+    m_color.append(color);
+    m_dirType.append(dirType);
+    m_offset.append(offset);
+    m_flags.append(flags);
+
+    m_gridDirty = true;
+    update();
+}
+
+
+
+/**
+ * @brief Removes the given edge.
+ * @param key
+ */
+void GraphicsEdgeLayer::removeEdge(const EdgeKey &key) {
+    int index = m_index.value(key, -1);
+    if ( index < 0 ) {
+        return;
+    }
+    removeEdgeAt(index);
+}
+
+
+
+/**
+ * @brief Removes the edge at index.
+ * The last edge takes the place of the removed one, so indices are not stable
+ * across removals.
+ * @param index
+ */
+void GraphicsEdgeLayer::removeEdgeAt(int index) {
+    m_index.remove(m_key[index]);
+    nodeEdgeRelink(m_source[index], index, -1);
+    nodeEdgeRelink(m_target[index], index, -1);
+    int last = m_key.size() - 1;
+    if ( index != last ) {
+        nodeEdgeRelink(m_source[last], last, index);
+        nodeEdgeRelink(m_target[last], last, index);
+        m_key[index] = m_key[last];
+        m_source[index] = m_source[last];
+        m_target[index] = m_target[last];
+        m_weight[index] = m_weight[last];
+        m_width[index] = m_width[last];
+        m_label[index] = m_label[last];
+        m_color[index] = m_color[last];
+        m_dirType[index] = m_dirType[last];
+        m_offset[index] = m_offset[last];
+        m_flags[index] = m_flags[last];
+        m_index.insert(m_key[index], index);
+    }
+    m_key.removeLast();
+    m_source.removeLast();
+    m_target.removeLast();
+    m_weight.removeLast();
+    m_width.removeLast();
+    m_label.removeLast();
+    m_color.removeLast();
+    m_dirType.removeLast();
+    m_offset.removeLast();
+    m_flags.removeLast();
+
+    m_gridDirty = true;
+    update();
+}
+
+
+
+/**
+ * @brief Removes all edges from or to the given node.
+ * Called from GraphicsWidget before the node is deleted.
+ * @param node
+ */
+void GraphicsEdgeLayer::removeNodeEdges(GraphicsNode *node) {
+    while ( m_nodeEdges.contains(node) ) {
+        removeEdgeAt( m_nodeEdges[node].last() );
+    }
+}
+
+
+
+/**
+ * @brief Replaces index from with index to in the edges of the node.
+ * Removes index from, if to is negative.
+ * Searches from the back, where removeNodeEdges() takes its indices,
+ * so that removing all edges of a node stays linear in its degree.
+ * @param node
+ * @param from
+ * @param to
+ */
+void GraphicsEdgeLayer::nodeEdgeRelink(GraphicsNode *node, const int &from, const int &to) {
+    QHash<GraphicsNode*, QVector<int> >::iterator it = m_nodeEdges.find(node);
+    if ( it == m_nodeEdges.end() ) {
+        return;
+    }
+    QVector<int> &edges = it.value();
+    int i = edges.lastIndexOf(from);
+    if ( i < 0 ) {
+        return;
+    }
+    if ( to >= 0 ) {
+        edges[i] = to;
+        return;
+    }
+    edges[i] = edges.last();
+    edges.removeLast();
+    if ( edges.isEmpty() ) {
+        m_nodeEdges.erase(it);
+    }
+}
+
+
+
+GraphicsNode *GraphicsEdgeLayer::sourceNode(const int &index) const {
+    return m_source.at(index);
+}
+
+GraphicsNode *GraphicsEdgeLayer::targetNode(const int &index) const {
+    return m_target.at(index);
+}
+
+qreal GraphicsEdgeLayer::weight(const int &index) const {
+    return m_weight.at(index);
+}
+
+QString GraphicsEdgeLayer::label(const int &index) const {
+    return m_label.at(index);
+}
+
+QColor GraphicsEdgeLayer::color(const int &index) const {
+    return m_color.at(index);
+}
+
+int GraphicsEdgeLayer::directionType(const int &index) const {
+    return m_dirType.at(index);
+}
+
+int GraphicsEdgeLayer::offsetFromNode(const int &index) const {
+    return m_offset.at(index);
+}
+
+bool GraphicsEdgeLayer::arrowsVisible(const int &index) const {
+    return m_flags.at(index) & EdgeArrows;
+}
+
+bool GraphicsEdgeLayer::isBezier(const int &index) const {
+    return m_flags.at(index) & EdgeBezier;
+}
+
+bool GraphicsEdgeLayer::weightNumberVisible(const int &index) const {
+    return m_flags.at(index) & EdgeWeightNumber;
+}
+
+bool GraphicsEdgeLayer::isEdgeVisible(const int &index) const {
+    return m_flags.at(index) & EdgeVisible;
+}
+
+bool GraphicsEdgeLayer::isPromoted(const int &index) const {
+    return m_flags.at(index) & EdgePromoted;
+}
+
+
+
+void GraphicsEdgeLayer::setEdgeFlag(const int &index,
+                                    const quint8 &flag,
+                                    const bool &toggle) {
+    if (toggle) {
+        m_flags[index] |= flag;
+    }
+    else {
+        m_flags[index] &= ~flag;
+    }
+}
+
+
+void GraphicsEdgeLayer::setEdgeWeight(const EdgeKey &key, const qreal &weight) {
+    int index = m_index.value(key, -1);
+    if ( index < 0 ) {
+        return;
+    }
+    m_weight[index] = weight;
+    m_width[index] = edgeLayerWidth(weight);
+    update();
+}
+
+
+void GraphicsEdgeLayer::setEdgeLabel(const EdgeKey &key, const QString &label) {
+    int index = m_index.value(key, -1);
+    if ( index < 0 ) {
+        return;
+    }
+    m_label[index] = label;
+    update();
+}
+
+
+void GraphicsEdgeLayer::setEdgeColor(const EdgeKey &key, const QColor &color) {
+    int index = m_index.value(key, -1);
+    if ( index < 0 ) {
+        return;
+    }
+    m_color[index] = color;
+    update();
+}
+
+
+/**
+ * @brief Changes the direction type of the named edge.
+ * As in GraphicsEdge, undirected edges lose their arrows, all others get them.
+ */
+void GraphicsEdgeLayer::setEdgeDirectionType(const EdgeKey &key, const int &dirType) {
+    int index = m_index.value(key, -1);
+    if ( index < 0 ) {
+        return;
+    }
+    m_dirType[index] = dirType;
+    setEdgeFlag(index, EdgeArrows, dirType != EdgeType::Undirected);
+    update();
+}
+
+
+void GraphicsEdgeLayer::setEdgeVisible(const EdgeKey &key, const bool &toggle) {
+    int index = m_index.value(key, -1);
+    if ( index < 0 ) {
+        return;
+    }
+    setEdgeFlag(index, EdgeVisible, toggle);
+    m_gridDirty = true;
+    update();
+}
+
+
+void GraphicsEdgeLayer::setEdgeOffsetFromNode(const EdgeKey &key, const int &offset) {
+    int index = m_index.value(key, -1);
+    if ( index < 0 ) {
+        return;
+    }
+    m_offset[index] = offset;
+    m_gridDirty = true;
+    update();
+}
+
+
+/**
+ * @brief Marks an edge as promoted, i.e. drawn by its own GraphicsEdge item.
+ * Promoted edges are not painted by the layer, but they stay in the hit test
+ * grid so that the cursor does not flip between the layer and the item.
+ */
+void GraphicsEdgeLayer::setEdgePromoted(const int &index, const bool &toggle) {
+    setEdgeFlag(index, EdgePromoted, toggle);
+    update();
+}
+
+
+void GraphicsEdgeLayer::setEdgePromoted(const EdgeKey &key, const bool &toggle) {
+    int index = m_index.value(key, -1);
+    if ( index < 0 ) {
+        return;
+    }
+    setEdgePromoted(index, toggle);
+}
+
+
+void GraphicsEdgeLayer::setOffsetFromNodeAll(const int &offset) {
+    m_offset.fill(offset);
+    m_gridDirty = true;
+    update();
+}
+
+
+void GraphicsEdgeLayer::setArrowsVisibility(const bool &toggle) {
+    for (int i = 0; i < m_flags.size(); ++i) {
+        setEdgeFlag(i, EdgeArrows, toggle);
+    }
+    update();
+}
+
+
+void GraphicsEdgeLayer::setWeightNumbersVisibility(const bool &toggle) {
+    for (int i = 0; i < m_flags.size(); ++i) {
+        setEdgeFlag(i, EdgeWeightNumber, toggle);
+    }
+    update();
+}
+
+
+void GraphicsEdgeLayer::setLabelsVisibility(const bool &toggle) {
+    m_drawLabels = toggle;
+    update();
+}
+
+
+bool GraphicsEdgeLayer::labelsVisible() const {
+    return m_drawLabels;
+}
+
+
+void GraphicsEdgeLayer::setHighlighting(const bool &toggle) {
+    m_highlighting = toggle;
+    update();
+}
+
+
+
+/**
+ * @brief Returns the visible edges of the layer whose both end nodes are selected.
+ * Layer edges cannot be selected on their own, so a rubber band selection
+ * includes an edge when it includes both of its nodes.
+ * @return
+ */
+QList<QPair<int, int> > GraphicsEdgeLayer::selectedEdges() const {
+    QList<QPair<int, int> > list;
+    for (int i = 0; i < m_key.size(); ++i) {
+        if ( isPromoted(i) || !isDrawable(i) ) {
+            continue;
+        }
+        if ( m_source[i]->isSelected() && m_target[i]->isSelected() ) {
+            list << qMakePair( m_source[i]->nodeNumber(), m_target[i]->nodeNumber() );
+        }
+    }
+    return list;
+}
+
+
+
+/**
+ * @brief Sets the area covered by the layer. Called by GraphicsWidget
+ * whenever the scene rect changes.
+ * @param rect
+ */
+void GraphicsEdgeLayer::setRect(const QRectF &rect) {
+    prepareGeometryChange();
+    m_rect = rect;
+    m_gridDirty = true;
+}
+
+
+
+/**
+ * @brief Called by GraphicsWidget when nodes move, resize, hide or get selected.
+ * Invalidates the hit test grid and schedules a repaint.
+ */
+void GraphicsEdgeLayer::nodesChanged() {
+    m_gridDirty = true;
+    update();
+}
+
+
+
+/**
+ * @brief Returns true if the edge should be painted and hit tested
+ * @param index
+ * @return
+ */
+bool GraphicsEdgeLayer::isDrawable(const int &index) const {
+    return ( m_flags[index] & EdgeVisible )
+            && m_source[index]->isVisible()
+            && m_target[index]->isVisible();
+}
+
+
+
+/**
+ * @brief Computes the end points of an edge, leaving an offset from the nodes,
+ * and the control points if the edge is a curve. Mirrors GraphicsEdge::adjust().
+ * @return true if the edge is a cubic curve
+ */
+bool GraphicsEdgeLayer::edgeGeometry(const int &index,
+                                     QPointF &p1, QPointF &p2,
+                                     QPointF &c1, QPointF &c2) const {
+    const GraphicsNode *source = m_source[index];
+    const GraphicsNode *target = m_target[index];
+    QPointF sp = source->pos();
+    QPointF tp = target->pos();
+
+    if ( source == target ) {
+        p1 = p2 = tp;
+        c1 = QPointF( tp.x() -30,  tp.y() -30 );
+        c2 = QPointF( tp.x() +30,  tp.y() -30 );
+        return true;
+    }
+
+    qreal dx = tp.x() - sp.x();
+    qreal dy = tp.y() - sp.y();
+    qreal length = sqrt ( dx * dx + dy * dy );
+    QPointF offset(0,0);
+    if ( length > 0 ) {
+        qreal o = target->size() + m_offset[index];
+        offset = QPointF( dx * o / length, dy * o / length );
+    }
+    p1 = sp + offset;
+    p2 = tp - offset;
+
+    if ( ! ( m_flags[index] & EdgeBezier ) ) {
+        return false;
+    }
+    c1 = p1;
+    c2 = QPointF( p2.x() - p1.x(), p2.y() - p2.y() );
+    return true;
+}
+
+
+
+/**
+ * @brief Fills poly with the edge as a polyline; curves are flattened.
+ */
+void GraphicsEdgeLayer::edgePolyline(const int &index, QPolygonF &poly) const {
+    QPointF p1, p2, c1, c2;
+    poly.clear();
+    if ( !edgeGeometry(index, p1, p2, c1, c2) ) {
+        poly << p1 << p2;
+        return;
+    }
+    const int steps = 16;
+    for (int s = 0; s <= steps; ++s) {
+        qreal t = (qreal) s / steps;
+        qreal u = 1 - t;
+        poly << u*u*u * p1 + 3*u*u*t * c1 + 3*u*t*t * c2 + t*t*t * p2;
+    }
+}
+
+
+
+int GraphicsEdgeLayer::gridCell(const int &col, const int &row) const {
+    return qBound(0, row, m_gridRows - 1) * m_gridCols
+            + qBound(0, col, m_gridCols - 1);
+}
+
+
+
+/**
+ * @brief Inserts the edge into every grid cell crossed by segment ab,
+ * walking the cells in order (Amanatides-Woo traversal).
+ */
+void GraphicsEdgeLayer::gridInsert(const int &index,
+                                   const QPointF &a, const QPointF &b) const {
+    const qreal ax = a.x() - m_rect.left(), ay = a.y() - m_rect.top();
+    const qreal bx = b.x() - m_rect.left(), by = b.y() - m_rect.top();
+    int col = (int) floor( ax / EDGE_LAYER_CELL );
+    int row = (int) floor( ay / EDGE_LAYER_CELL );
+    const int endCol = (int) floor( bx / EDGE_LAYER_CELL );
+    const int endRow = (int) floor( by / EDGE_LAYER_CELL );
+    const qreal dx = bx - ax, dy = by - ay;
+    const qreal inf = std::numeric_limits<qreal>::max();
+    const int stepCol = (dx > 0) ? 1 : -1;
+    const int stepRow = (dy > 0) ? 1 : -1;
+    qreal tMaxX = ( dx != 0 )
+            ? ( (col + (dx > 0 ? 1 : 0)) * EDGE_LAYER_CELL - ax ) / dx : inf;
+    qreal tMaxY = ( dy != 0 )
+            ? ( (row + (dy > 0 ? 1 : 0)) * EDGE_LAYER_CELL - ay ) / dy : inf;
+    const qreal tDeltaX = ( dx != 0 ) ? EDGE_LAYER_CELL / fabs(dx) : inf;
+    const qreal tDeltaY = ( dy != 0 ) ? EDGE_LAYER_CELL / fabs(dy) : inf;
+
+    int steps = abs(endCol - col) + abs(endRow - row);
+    int last = -1;
+    for (;;) {
+        int cell = gridCell(col, row);
+        if ( cell != last ) {
+            QVector<int> &bucket = m_grid[cell];
+            if ( bucket.isEmpty() || bucket.last() != index ) {
+                bucket.append(index);
+            }
+            last = cell;
+        }
+        if ( steps-- <= 0 ) {
+            break;
+        }
+        if ( tMaxX < tMaxY ) {
+            tMaxX += tDeltaX;
+            col += stepCol;
+        }
+        else {
+            tMaxY += tDeltaY;
+            row += stepRow;
+        }
+    }
+}
+
+
+
+/**
+ * @brief Rebuilds the hit test grid from the current node positions
+ */
+void GraphicsEdgeLayer::gridBuild() const {
+    m_gridCols = qMax( 1, (int) ceil( m_rect.width() / EDGE_LAYER_CELL ) );
+    m_gridRows = qMax( 1, (int) ceil( m_rect.height() / EDGE_LAYER_CELL ) );
+    m_grid.clear();
+    m_grid.resize( m_gridCols * m_gridRows );
+
+    QPolygonF poly;
+    for (int i = 0; i < m_key.size(); ++i) {
+        if ( !isDrawable(i) ) {
+            continue;
+        }
+        edgePolyline(i, poly);
+        for (int k = 0; k + 1 < poly.size(); ++k) {
+            gridInsert(i, poly[k], poly[k+1]);
+        }
+    }
+    m_gridDirty = false;
+}
+
+
+
+/**
+ * @brief Returns the index of the edge closest to scene point p,
+ * within tolerance plus half the edge width, or -1 if there is none.
+ * @param p
+ * @param tolerance
+ * @return
+ */
+int GraphicsEdgeLayer::edgeAt(const QPointF &p, const qreal &tolerance) const {
+    if ( m_key.isEmpty() ) {
+        return -1;
+    }
+    if ( m_gridDirty ) {
+        gridBuild();
+    }
+    const qreal reach = tolerance + 4;
+    const int col0 = (int) floor( (p.x() - reach - m_rect.left()) / EDGE_LAYER_CELL );
+    const int col1 = (int) floor( (p.x() + reach - m_rect.left()) / EDGE_LAYER_CELL );
+    const int row0 = (int) floor( (p.y() - reach - m_rect.top()) / EDGE_LAYER_CELL );
+    const int row1 = (int) floor( (p.y() + reach - m_rect.top()) / EDGE_LAYER_CELL );
+
+    int found = -1;
+    qreal best = std::numeric_limits<qreal>::max();
+    QPolygonF poly;
+    int lastCell = -1;
+    for (int row = row0; row <= row1; ++row) {
+        for (int col = col0; col <= col1; ++col) {
+            int cell = gridCell(col, row);
+            if ( cell == lastCell ) {
+                continue;
+            }
+            lastCell = cell;
+            foreach (int i, m_grid[cell]) {
+                edgePolyline(i, poly);
+                for (int k = 0; k + 1 < poly.size(); ++k) {
+                    qreal d = edgeLayerDistance(p, poly[k], poly[k+1]);
+                    if ( d <= tolerance + m_width[i] / 2 && d < best ) {
+                        best = d;
+                        found = i;
+                    }
+                }
+            }
+        }
+    }
+    return found;
+}
+
+
+
+/**
+ * @brief The layer covers the whole scene; self-loops may go a bit outside.
+ * @return
+ */
+QRectF GraphicsEdgeLayer::boundingRect() const {
+    return m_rect.adjusted(-40, -40, 40, 40);
+}
+
+
+
+/**
+ * @brief Returns true only if there is an edge under the point,
+ * so that the layer does not hide empty canvas from itemAt() and hover events.
+ */
+bool GraphicsEdgeLayer::contains(const QPointF &point) const {
+    return edgeAt(point) != -1;
+}
+
+
+
+/**
+ * @brief Hit tests coming from the view use a tiny rectangle around the cursor.
+ * We answer those through the grid. Larger areas (i.e. rubber band selection)
+ * never collide, since layer edges are not selectable on their own.
+ */
+bool GraphicsEdgeLayer::collidesWithPath(const QPainterPath &path,
+                                         Qt::ItemSelectionMode mode) const {
+    if ( mode != Qt::IntersectsItemShape && mode != Qt::ContainsItemShape ) {
+        return QGraphicsItem::collidesWithPath(path, mode);
+    }
+    QRectF rect = path.controlPointRect();
+    if ( rect.width() > EDGE_LAYER_MAX_QUERY || rect.height() > EDGE_LAYER_MAX_QUERY ) {
+        return false;
+    }
+    return edgeAt( rect.center(), 4 + qMax(rect.width(), rect.height()) / 2 ) != -1;
+}
+
+
+
+/**
+ * @brief Paints all visible, non-promoted edges inside the exposed rect.
+ * Edges are grouped in buckets by colour, width, style and highlight state,
+ * so each bucket costs one drawLines() and at most one drawPath() call.
+ */
+void GraphicsEdgeLayer::paint(QPainter *painter,
+                              const QStyleOptionGraphicsItem *option,
+                              QWidget *) {
+    const QRectF exposed = option->exposedRect;
+
+    // see GraphicsWidget::detailLevel()
+    const int detail = graphicsWidget->detailLevel();
+    const bool points = ( detail <= DETAIL_POINTS );
+
+    QHash<quint64, int> bucketIndex;
+    QVector<EdgeLayerBucket> buckets;
+    QVector<int> texts;
+
+    QPointF p1, p2, c1, c2;
+
+    for (int i = 0; i < m_key.size(); ++i) {
+
+        if ( ( m_flags[i] & EdgePromoted ) || !isDrawable(i) ) {
+            continue;
+        }
+
+        if ( points && m_source[i] == m_target[i] ) {
+            continue;
+        }
+
+        bool curved = edgeGeometry(i, p1, p2, c1, c2) && !points;
+
+        QRectF box = QRectF(p1, p2).normalized();
+        if ( curved ) {
+            box = box.united( QRectF(c1, c2).normalized() );
+        }
+        qreal margin = m_width[i] + m_arrowSize + 1;
+        box.adjust(-margin, -margin, margin, margin);
+        if ( !exposed.intersects(box) ) {
+            continue;
+        }
+
+        const GraphicsNode *source = m_source[i];
+        const GraphicsNode *target = m_target[i];
+
+        bool highlighted = m_highlighting
+                && ( source->isSelected() || target->isSelected() );
+        Qt::PenStyle style = ( m_weight[i] < 0 && !points ) ? Qt::DashLine : Qt::SolidLine;
+        qreal width = ( points ) ? 0 : m_width[i];
+
+        quint64 key = ( (quint64) m_color[i].rgba() << 32 )
+                | ( (quint64) qMin( (int) (width * 64), 0xFFFF ) << 4 )
+                | ( (quint64) style << 1 )
+                | ( highlighted ? 1 : 0 );
+
+        int b = bucketIndex.value(key, -1);
+        if ( b < 0 ) {
+            b = buckets.size();
+            bucketIndex.insert(key, b);
+            EdgeLayerBucket bucket;
+            bucket.pen = QPen( highlighted ? QColor("red") : m_color[i],
+                               width, style, Qt::RoundCap, Qt::RoundJoin);
+            bucket.brush = m_color[i];
+            buckets.append(bucket);
+        }
+        EdgeLayerBucket &bucket = buckets[b];
+
+        if ( curved ) {
+            bucket.path.moveTo(p1);
+            bucket.path.cubicTo(c1, c2, p2);
+        }
+        else {
+            bucket.lines.append( QLineF(p1, p2) );
+        }
+
+        qreal dx = target->x() - source->x();
+        qreal dy = target->y() - source->y();
+        qreal length = sqrt ( dx * dx + dy * dy );
+
+        // Arrows as in GraphicsEdge::adjust()
+        if ( detail == DETAIL_FULL
+             && ( m_flags[i] & EdgeArrows ) && source != target && length > 10 ) {
+            qreal angle = ::acos( dx / length );
+            if ( dy >= 0 )
+                angle = M_PI_X_2 - angle;
+
+            bucket.path.addPolygon( QPolygonF()
+                                    << p2
+                                    << p2 + QPointF(sin(angle - M_PI_3) * m_arrowSize,
+                                                    cos(angle - M_PI_3) * m_arrowSize)
+                                    << p2 + QPointF(sin(angle - M_PI + M_PI_3) * m_arrowSize,
+                                                    cos(angle - M_PI + M_PI_3) * m_arrowSize)
+                                    << p2 );
+
+            if ( m_dirType[i] == EdgeType::Undirected
+                 || m_dirType[i] == EdgeType::Reciprocated ) {
+                bucket.path.addPolygon( QPolygonF()
+                                        << p1
+                                        << p1 + QPointF(sin(angle + M_PI_3) * m_arrowSize,
+                                                        cos(angle + M_PI_3) * m_arrowSize)
+                                        << p1 + QPointF(sin(angle + M_PI - M_PI_3) * m_arrowSize,
+                                                        cos(angle + M_PI - M_PI_3) * m_arrowSize)
+                                        << p1 );
+            }
+        }
+
+        if ( detail == DETAIL_FULL
+             && ( ( m_flags[i] & EdgeWeightNumber )
+                  || ( m_drawLabels && !m_label[i].isEmpty() ) ) ) {
+            texts.append(i);
+        }
+    }
+
+    bool antialiasing = painter->testRenderHint(QPainter::Antialiasing);
+    if ( points ) {
+        painter->setRenderHint(QPainter::Antialiasing, false);
+    }
+
+    foreach (const EdgeLayerBucket &bucket, buckets) {
+        painter->setPen(bucket.pen);
+        if ( !bucket.lines.isEmpty() ) {
+            painter->setBrush(Qt::NoBrush);
+            painter->drawLines(bucket.lines);
+        }
+        if ( !bucket.path.isEmpty() ) {
+            painter->setBrush(bucket.brush);
+            painter->drawPath(bucket.path);
+        }
+    }
+
+    painter->setRenderHint(QPainter::Antialiasing, antialiasing);
+
+    if ( texts.isEmpty() ) {
+        return;
+    }
+
+    // Weights and labels, placed like GraphicsEdgeWeight and GraphicsEdgeLabel
+    QFont font("Courier", 7, QFont::Light, true);
+    QFontMetricsF metrics(font);
+    QPointF textOffset(4, 4 + metrics.ascent());
+    painter->setFont(font);
+    foreach (int i, texts) {
+        QPointF middle = ( m_source[i]->pos() + m_target[i]->pos() ) / 2.0;
+        painter->setPen( m_color[i] );
+        if ( m_flags[i] & EdgeWeightNumber ) {
+            painter->drawText( middle + QPointF(-20, -20) + textOffset,
+                               QString::number(m_weight[i]) );
+        }
+        if ( m_drawLabels && !m_label[i].isEmpty() ) {
+            painter->drawText( middle + QPointF(5, 5) + textOffset, m_label[i] );
+        }
+    }
+}
+
+
+
+/**
+ * @brief Promotes the edge under the cursor to a real GraphicsEdge item
+ * so that it gets the usual hover highlighting, tooltips and clicks.
+ * @param event
+ */
+void GraphicsEdgeLayer::hoverEnterEvent(QGraphicsSceneHoverEvent *event) {
+    // do not call the base class, it would repaint the whole layer
+    graphicsWidget->edgeLayerHover( edgeAt( event->pos() ) );
+}
+
+
+void GraphicsEdgeLayer::hoverMoveEvent(QGraphicsSceneHoverEvent *event) {
+    graphicsWidget->edgeLayerHover( edgeAt( event->pos() ) );
+}
+
+
+void GraphicsEdgeLayer::hoverLeaveEvent(QGraphicsSceneHoverEvent *event) {
+    Q_UNUSED(event);
+    graphicsWidget->edgeLayerHover(-1);
+}
+
+
+
+GraphicsEdgeLayer::~GraphicsEdgeLayer(){
+    qDebug() << "GraphicsEdgeLayer::~GraphicsEdgeLayer() - edges:" << m_key.size();
+}
@@ -0,0 +1,175 @@
+/***************************************************************************
+ SocNetV: Social Network Visualizer
+ version: 2.5
+ Written in Qt
+
+                         graphicsedgelayer.h  -  description
+                             -------------------
+    copyright         : (C) 2005-2019 by Dimitris B. Kalamaras
+    project site      : https://socnetv.org
+
+ ***************************************************************************/
+
+/*******************************************************************************
+*     This program is free software: you can redistribute it and/or modify     *
+*     it under the terms of the GNU General Public License as published by     *
+*     the Free Software Foundation, either version 3 of the License, or        *
+*     (at your option) any later version.                                      *
+*                                                                              *
+*     This program is distributed in the hope that it will be useful,          *
+*     but WITHOUT ANY WARRANTY; without even the implied warranty of           *
+*     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            *
+*     GNU General Public License for more details.                             *
+*                                                                              *
+*     You should have received a copy of the GNU General Public License        *
+*     along with this program.  If not, see <http://www.gnu.org/licenses/>.    *
+********************************************************************************/
+
+#ifndef GRAPHICSEDGELAYER_H
+#define GRAPHICSEDGELAYER_H
+
+
+#include <QGraphicsItem>
+#include <QHash>
+#include <QVector>
+#include <QColor>
+
+#include "edgekeymap.h"
+
+
+class GraphicsWidget;
+class GraphicsNode;
+class QGraphicsSceneHoverEvent;
+
+static const int TypeEdgeLayer = QGraphicsItem::UserType+8;
+static const int ZValueEdgeLayer = 49;
+
+
+/**
+ * @brief A single canvas item which owns and paints many edges at once.
+ * Edges are kept in flat arrays and painted in batches, one
+ * QPainter::drawLines/drawPath call per colour and style bucket.
+ * Hit tests go through a uniform grid of cells, rebuilt lazily after
+ * nodes move. GraphicsWidget creates real GraphicsEdge items only for
+ * the edges the user hovers or clicks, see GraphicsWidget::edgeLayerPromote.
+ */
+class GraphicsEdgeLayer : public QGraphicsItem {
+
+public:
+    GraphicsEdgeLayer(GraphicsWidget *gw);
+    ~GraphicsEdgeLayer();
+
+    enum { Type = UserType + 8 };
+    int type() const { return Type; }
+
+    void clear();
+    int count() const;
+
+    bool hasEdge(const EdgeKey &key) const;
+    int edgeIndex(const EdgeKey &key) const;
+    EdgeKey edgeKey(const int &index) const;
+
+    void addEdge(const EdgeKey &key,
+                 GraphicsNode *source,
+                 GraphicsNode *target,
+                 const qreal &weight,
+                 const QString &label,
+                 const QColor &color,
+                 const int &dirType,
+                 const bool &drawArrows,
+                 const bool &bezier,
+                 const bool &weightNumber,
+                 const int &offset);
+    void removeEdge(const EdgeKey &key);
+    void removeNodeEdges(GraphicsNode *node);
+
+    GraphicsNode *sourceNode(const int &index) const;
+    GraphicsNode *targetNode(const int &index) const;
+    qreal weight(const int &index) const;
+    QString label(const int &index) const;
+    QColor color(const int &index) const;
+    int directionType(const int &index) const;
+    int offsetFromNode(const int &index) const;
+    bool arrowsVisible(const int &index) const;
+    bool isBezier(const int &index) const;
+    bool weightNumberVisible(const int &index) const;
+    bool isEdgeVisible(const int &index) const;
+    bool isPromoted(const int &index) const;
+
+    void setEdgeWeight(const EdgeKey &key, const qreal &weight);
+    void setEdgeLabel(const EdgeKey &key, const QString &label);
+    void setEdgeColor(const EdgeKey &key, const QColor &color);
+    void setEdgeDirectionType(const EdgeKey &key, const int &dirType);
+    void setEdgeVisible(const EdgeKey &key, const bool &toggle);
+    void setEdgeOffsetFromNode(const EdgeKey &key, const int &offset);
+    void setEdgePromoted(const int &index, const bool &toggle);
+    void setEdgePromoted(const EdgeKey &key, const bool &toggle);
+
+    void setOffsetFromNodeAll(const int &offset);
+    void setArrowsVisibility(const bool &toggle);
+    void setWeightNumbersVisibility(const bool &toggle);
+    void setLabelsVisibility(const bool &toggle);
+    bool labelsVisible() const;
+    void setHighlighting(const bool &toggle);
+
+    QList<QPair<int, int> > selectedEdges() const;
+
+    void setRect(const QRectF &rect);
+    void nodesChanged();
+
+    int edgeAt(const QPointF &p, const qreal &tolerance=4) const;
+
+    QRectF boundingRect() const;
+    bool contains(const QPointF &point) const;
+    bool collidesWithPath(const QPainterPath &path,
+                          Qt::ItemSelectionMode mode = Qt::IntersectsItemShape) const;
+
+protected:
+    void paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget);
+    void hoverEnterEvent(QGraphicsSceneHoverEvent *event);
+    void hoverMoveEvent(QGraphicsSceneHoverEvent *event);
+    void hoverLeaveEvent(QGraphicsSceneHoverEvent *event);
+
+private:
+    enum {
+        EdgeVisible      = 0x01,
+        EdgeArrows       = 0x02,
+        EdgeBezier       = 0x04,
+        EdgeWeightNumber = 0x08,
+        EdgePromoted     = 0x10
+    };
+
+    void removeEdgeAt(int index);
+    void nodeEdgeRelink(GraphicsNode *node, const int &from, const int &to);
+    void setEdgeFlag(const int &index, const quint8 &flag, const bool &toggle);
+    bool isDrawable(const int &index) const;
+    bool edgeGeometry(const int &index,
+                      QPointF &p1, QPointF &p2,
+                      QPointF &c1, QPointF &c2) const;
+    void edgePolyline(const int &index, QPolygonF &poly) const;
+    int gridCell(const int &col, const int &row) const;
+    void gridInsert(const int &index, const QPointF &a, const QPointF &b) const;
+    void gridBuild() const;
+
+    GraphicsWidget *graphicsWidget;
+
+    EdgeKeyMap<int> m_index;
+    QVector<EdgeKey> m_key;
+    QHash<GraphicsNode*, QVector<int> > m_nodeEdges;
+    QVector<GraphicsNode*> m_source, m_target;
+    QVector<qreal> m_weight, m_width;
+    QVector<QString> m_label;
+    QVector<QColor> m_color;
+    QVector<int> m_dirType, m_offset;
+    QVector<quint8> m_flags;
+
+    QRectF m_rect;
+    qreal m_arrowSize;
+    bool m_drawLabels, m_highlighting;
+
+    mutable QVector<QVector<int> > m_grid;
+    mutable int m_gridCols, m_gridRows;
+    mutable bool m_gridDirty;
+};
+
+#endif
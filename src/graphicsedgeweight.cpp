@@ -27,6 +27,7 @@
 
 #include "graphicsedgeweight.h"
 #include "graphicsedge.h"
+#include "graphicswidget.h"
 #include <QDebug>
 #include <QFont>
 
@@ -35,6 +36,7 @@ GraphicsEdgeWeight::GraphicsEdgeWeight( GraphicsEdge *link , int size, QString l
 : QGraphicsTextItem( 0)
 {
     qDebug()<< "GraphicsEdgeWeight:: creating new edgeweight and attaching it to link";
+    edge=link;
 	setPlainText( labelText );
     setParentItem(link); //auto disables child items like this, when link is disabled.
     this->setFont( QFont ("Courier", size, QFont::Light, true) );
@@ -42,6 +44,21 @@ GraphicsEdgeWeight::GraphicsEdgeWeight( GraphicsEdge *link , int size, QString l
 }
 
 
+/**
+ * @brief Paints the text only when the canvas is drawn in full detail.
+ * See GraphicsWidget::detailLevel()
+ * @param painter
+ * @param option
+ * @param widget
+ */
+void GraphicsEdgeWeight::paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget) {
+    if ( edge->detailLevel() < DETAIL_FULL ) {
+        return;
+    }
+    QGraphicsTextItem::paint(painter, option, widget);
+}
+
+
 GraphicsEdgeWeight::~GraphicsEdgeWeight()
 {
 }
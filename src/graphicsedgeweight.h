@@ -46,7 +46,10 @@ public:
     int type() const { return Type; }
 
     ~GraphicsEdgeWeight();
+protected:
+    void paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget);
 private:
+    GraphicsEdge *edge;
 };
 
 #endif
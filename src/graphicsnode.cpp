@@ -160,6 +160,7 @@ void GraphicsNode::setSize(const int &size){
         qDebug("GraphicsNode: updating edges in outEdgeList");
         edge->setSourceNodeSize(size);
     }
+    graphicsWidget->edgeLayerNodeChanged();
     setShape(m_shape);
 }
 
@@ -176,6 +177,16 @@ int GraphicsNode::size() const{
 }
 
 
+/**
+ * @brief Returns the level of detail the canvas is drawn with.
+ * Used by the node number and label to hide themselves.
+ * @return
+ */
+int GraphicsNode::detailLevel() const {
+    return graphicsWidget->detailLevel();
+}
+
+
 
 
 
@@ -329,6 +340,23 @@ QRectF GraphicsNode::boundingRect() const {
 void GraphicsNode::paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *) {
     //	painter->setClipRect( option->exposedRect );
 
+    int detail = graphicsWidget->detailLevel();
+
+    if ( detail == DETAIL_SPLATS && !isSelected() ) {
+        // the view draws unselected nodes as density splats
+        return;
+    }
+
+    if ( detail <= DETAIL_POINTS ) {
+        // far zoomed out, draw the node as a plain point
+        bool antialiasing = painter->testRenderHint(QPainter::Antialiasing);
+        painter->setRenderHint(QPainter::Antialiasing, false);
+        painter->fillRect(QRectF(-m_size, -m_size, 2*m_size, 2*m_size),
+                          ( isSelected() ) ? m_col.darker(150) : m_col );
+        painter->setRenderHint(QPainter::Antialiasing, antialiasing);
+        return;
+    }
+
     if (option->state & QStyle::State_MouseOver) {
         painter->setBrush(m_col.darker(120));
         setZValue(ZValueNodeHighlighted);
@@ -360,7 +388,7 @@ void GraphicsNode::paint(QPainter *painter, const QStyleOptionGraphicsItem *opti
     }
 
     //@TODO FIX NUMBER SIZE WHEN TOGGLING IN/OUT OF NODE SHAPE
-    if (m_hasNumberInside && m_hasNumber) {
+    if (m_hasNumberInside && m_hasNumber && detail == DETAIL_FULL) {
         // m_path->setFillRule(Qt::WindingFill);
         painter->setPen(QPen(QColor(m_numColor), 0));
         if (m_num > 999) {
@@ -401,10 +429,13 @@ QVariant GraphicsNode::itemChange(GraphicsItemChange change, const QVariant &val
     switch (change) {
     case ItemPositionHasChanged: {
         //setCacheMode( QGraphicsItem::ItemCoordinateCache );
-        foreach (GraphicsEdge *edge, inEdgeList)  //Move each inEdge of this node
-            edge->adjust();
-        foreach (GraphicsEdge *edge, outEdgeList) //Move each outEdge of this node
-            edge->adjust();
+        // Move each in and out edge of this node, on the next
+        // GraphicsWidget::edgeGeometryFlush()
+        foreach (GraphicsEdge *edge, inEdgeList)
+            edge->markDirty();
+        foreach (GraphicsEdge *edge, outEdgeList)
+            edge->markDirty();
+        graphicsWidget->edgeLayerNodeChanged();
         //Move its graphic number
         if ( m_hasNumber )
         {
@@ -454,6 +485,7 @@ QVariant GraphicsNode::itemChange(GraphicsItemChange change, const QVariant &val
     }
     case ItemVisibleHasChanged:
     {
+        graphicsWidget->edgeLayerNodeChanged();
         break;
     }
     default:
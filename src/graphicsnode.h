@@ -99,6 +99,7 @@ public:
 
     void setSize(const int &);
     int size() const;
+    int detailLevel() const;
 
     void setShape (const QString, const QString &iconPath=QString::null);
     QString nodeShape() {return m_shape;}
@@ -106,6 +107,7 @@ public:
     void setColor(const QString &colorStr);
     void setColor(QColor color);
     QString color ();
+    QColor fillColor() const { return m_col; }
 
     void addLabel();
     GraphicsNodeLabel* label();
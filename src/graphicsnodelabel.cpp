@@ -27,6 +27,7 @@
 
 #include "graphicsnodelabel.h"
 #include "graphicsnode.h"
+#include "graphicswidget.h"
 #include <QFont>
 #include <QDebug>
 
@@ -54,5 +55,20 @@ void GraphicsNodeLabel::removeRefs(){
 }
 
 
+/**
+ * @brief Paints the text only when the canvas is drawn in full detail.
+ * See GraphicsWidget::detailLevel()
+ * @param painter
+ * @param option
+ * @param widget
+ */
+void GraphicsNodeLabel::paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget) {
+    if ( source->detailLevel() < DETAIL_FULL ) {
+        return;
+    }
+    QGraphicsTextItem::paint(painter, option, widget);
+}
+
+
 GraphicsNodeLabel::~GraphicsNodeLabel(){
 }
@@ -44,6 +44,8 @@ public:
     void setSize(const int &size);
     ~GraphicsNodeLabel();
 	GraphicsNode* node() { return source; }
+protected:
+    void paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget);
 private:
 	GraphicsNode *source;	
 };
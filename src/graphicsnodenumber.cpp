@@ -26,6 +26,7 @@
 
 #include "graphicsnodenumber.h"
 #include "graphicsnode.h"
+#include "graphicswidget.h"
 #include <QFont>
 #include <QDebug>
 
@@ -52,6 +53,21 @@ void GraphicsNodeNumber::removeRefs(){
 
 }
 
+/**
+ * @brief Paints the text only when the canvas is drawn in full detail.
+ * See GraphicsWidget::detailLevel()
+ * @param painter
+ * @param option
+ * @param widget
+ */
+void GraphicsNodeNumber::paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget) {
+    if ( source->detailLevel() < DETAIL_FULL ) {
+        return;
+    }
+    QGraphicsTextItem::paint(painter, option, widget);
+}
+
+
 GraphicsNodeNumber::~GraphicsNodeNumber(){
 
 }
@@ -45,6 +45,8 @@ public:
 	GraphicsNode* node() { return source; }
     void setSize(const int size);
     ~GraphicsNodeNumber();
+protected:
+    void paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget);
 private:
 	GraphicsNode *source;
 };
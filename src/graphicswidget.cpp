@@ -33,6 +33,8 @@
 #include <QtMath>
 #include <QDebug>
 #include <QWheelEvent>
+#include <QTimer>
+#include <QPainter>
 
 
 #include "mainwindow.h"
@@ -43,6 +45,7 @@
 #include "graphicsguide.h"
 #include "graphicsedgeweight.h"
 #include "graphicsedgelabel.h"
+#include "graphicsedgelayer.h"
 
 /** 
     Constructor method. Called when a GraphicsWidget object is created in MW
@@ -69,6 +72,17 @@ GraphicsWidget::GraphicsWidget(QGraphicsScene *sc, MainWindow* m_parent)  :
 
         m_edgeHighlighting = true;
         m_edgeMinOffsetFromNode=6;
+        m_edgeLayerMode = false;
+        m_edgeLayerSettlePending = false;
+        m_edgeLayer = 0;
+        m_edgeLayerHovered = EDGE_KEY_NONE;
+        m_edgeGeometryFlushPending = false;
+        m_detailLevel = DETAIL_FULL;
+        m_detailRamp = DETAIL_FULL;
+        m_detailMinNodes = 2000;
+        m_detailTextScale = 0.6;
+        m_detailShapeScale = 0.35;
+        m_detailSplatScale = 0.15;
         m_nodeNumberVisibility = true;
         m_nodeLabelVisibility = true;
 
@@ -87,22 +101,26 @@ GraphicsWidget::GraphicsWidget(QGraphicsScene *sc, MainWindow* m_parent)  :
         connect ( scene() , &QGraphicsScene::selectionChanged,
                      this, &GraphicsWidget::getSelectedItems);
 
+        // restores the full detail once the user stops panning or zooming
+        m_detailTimer = new QTimer(this);
+        m_detailTimer->setSingleShot(true);
+        connect ( m_detailTimer, &QTimer::timeout,
+                  this, &GraphicsWidget::detailRampUp);
+
 
 
 }
 
 
 /**
- * @brief creates a QString of the edge name - used for indexing edgesHash
+ * @brief Creates the key of the edge v1->v2 - used for indexing edgesHash
  * @param v1
  * @param v2
- * @param relation
+ * @param relation the current relation, if -1
  * @return
  */
-QString GraphicsWidget::createEdgeName(const int &v1, const int &v2, const int &relation) {
-    edgeName = QString::number((relation != -1) ? relation : m_curRelation) + QString(":")
-            + QString::number(v1) + QString(">")+ QString::number(v2);
-    return edgeName;
+EdgeKey GraphicsWidget::createEdgeKey(const int &v1, const int &v2, const int &relation) const {
+    return edgeKey( (relation != -1) ? relation : m_curRelation, v1, v2 );
 }
 
 
@@ -120,6 +138,77 @@ void GraphicsWidget::paintEvent ( QPaintEvent * event ){
 
 
 
+/**
+ * @brief Called when the user pans the canvas.
+ * Drops to a lower level of detail until the view is idle again.
+ * @param dx
+ * @param dy
+ */
+void GraphicsWidget::scrollContentsBy(int dx, int dy) {
+    detailInteraction();
+    QGraphicsView::scrollContentsBy(dx, dy);
+}
+
+
+
+/**
+ * @brief Draws the nodes as density splats when the canvas is zoomed far out.
+ * Nodes falling in the same few screen pixels are drawn as a single square,
+ * more opaque the more nodes it aggregates.
+ * Selected nodes are still drawn by GraphicsNode::paint
+ * @param painter
+ * @param rect
+ */
+void GraphicsWidget::drawForeground(QPainter *painter, const QRectF &rect) {
+    if ( m_detailLevel != DETAIL_SPLATS ) {
+        return;
+    }
+
+    const qreal cellSize = 4 / m_currentScaleFactor;
+
+    QHash<qint64, int> cellIndex;
+    QVector<QPointF> cellPos;
+    QVector<QColor> cellColor;
+    QVector<int> cellCount;
+
+    H_NumToNode::const_iterator it;
+    for ( it = nodeHash.constBegin(); it != nodeHash.constEnd(); ++it ) {
+        GraphicsNode *node = it.value();
+        if ( !node->isVisible() || node->isSelected() ) {
+            continue;
+        }
+        QPointF pos = node->pos();
+        if ( !rect.contains(pos) ) {
+            continue;
+        }
+        qint64 col = (qint64) floor( pos.x() / cellSize );
+        qint64 row = (qint64) floor( pos.y() / cellSize );
+        qint64 key = ( col << 32 ) ^ ( row & 0xFFFFFFFF );
+        int cell = cellIndex.value(key, -1);
+        if ( cell < 0 ) {
+            cellIndex.insert(key, cellPos.size());
+            cellPos.append( QPointF(col * cellSize, row * cellSize) );
+            cellColor.append( node->fillColor() );
+            cellCount.append(1);
+        }
+        else {
+            cellCount[cell]++;
+        }
+    }
+
+    bool antialiasing = painter->testRenderHint(QPainter::Antialiasing);
+    painter->setRenderHint(QPainter::Antialiasing, false);
+    painter->setPen(Qt::NoPen);
+    for (int i = 0; i < cellPos.size(); ++i) {
+        QColor color = cellColor[i];
+        color.setAlpha( qMin( 255, 110 + 30 * cellCount[i] ) );
+        painter->fillRect( QRectF(cellPos[i], QSizeF(cellSize, cellSize)), color );
+    }
+    painter->setRenderHint(QPainter::Antialiasing, antialiasing);
+}
+
+
+
 
 /**
  * @brief Clears the scene and all hashes, lists, var etc
@@ -130,7 +219,14 @@ void GraphicsWidget::clear() {
     edgesHash.clear();
     m_selectedNodes.clear();
     m_selectedEdges.clear();
+    // delete the edge layer first, so that nodes deleted by the scene
+    // do not try to remove their edges from it
+    delete m_edgeLayer;
+    m_edgeLayer = 0;
+    m_edgeLayerHovered = EDGE_KEY_NONE;
+    m_dirtyEdges.clear();
     scene()->clear();
+    detailUpdate();
     m_curRelation=0;
     clickedEdge=0;
     firstNode=0;
@@ -212,6 +308,10 @@ void GraphicsWidget::drawNode( const QPointF &p,
 
     // Add new node to a container to ease finding, edge creation etc
     nodeHash.insert(num, jim);
+
+    if ( nodeHash.count() == m_detailMinNodes ) {
+        detailUpdate();
+    }
 }
 
 
@@ -242,15 +342,26 @@ void GraphicsWidget::drawEdge(const int &source, const int &target,
                               const bool &bezier,
                               const bool &weightNumbers){
 
-    edgeName = createEdgeName(source, target);
+    EdgeKey key = createEdgeKey(source, target);
 
-    qDebug()<<"GW::drawEdge() - "<< edgeName
+    qDebug()<<"GW::drawEdge() - "<< source << "->" << target
            << "weight:"<<weight
            << "label:" << label
            << "direction type:" << type
            << " - nodeHash reports "<< nodeHash.size()<<" nodes.";
 
-    if ( type != EdgeType::Reciprocated ) {
+    if ( type != EdgeType::Reciprocated && m_edgeLayerMode ) {
+
+        edgeLayer()->addEdge(key,
+                             nodeHash.value(source), nodeHash.value(target),
+                             weight, label, QColor(color),
+                             type,
+                             drawArrows,
+                             (source==target) ? true: bezier,
+                             weightNumbers,
+                             m_edgeMinOffsetFromNode);
+    }
+    else if ( type != EdgeType::Reciprocated ) {
 
         GraphicsEdge *edge=new GraphicsEdge (
                     this,
@@ -263,14 +374,19 @@ void GraphicsWidget::drawEdge(const int &source, const int &target,
                     weightNumbers,
                     m_edgeHighlighting);
 
-        edgesHash.insert(edgeName, edge);
+        edgesHash.insert(key, edge);
     }
     else {
         // if type is EdgeType::Reciprocated, we just need to change the direction type
         // of the existing opposite edge.
-        edgeName = createEdgeName(target,source);
-        qDebug()<< "GW::drawEdge() - Reciprocating existing directed edge"<<edgeName;
-        edgesHash.value(edgeName)->setDirectionType(type);
+        key = createEdgeKey(target,source);
+        qDebug()<< "GW::drawEdge() - Reciprocating existing directed edge"<<edgeKeyName(key);
+        if (m_edgeLayer) {
+            m_edgeLayer->setEdgeDirectionType(key, type);
+        }
+        if ( edgesHash.contains(key) ) {
+            edgesHash.value(key)->setDirectionType(type);
+        }
 
     }
     //	qDebug()<< "Scene items now: "<< scene()->items().size() << " - GW items now: "<< items().size();
@@ -351,6 +467,7 @@ void GraphicsWidget::setEdgeClicked(GraphicsEdge *edge, const bool &openMenu){
         emit userClickedEdge(0,0,openMenu);
     }
 
+    edgeLayerScheduleSettle();
 
 
 }
@@ -376,6 +493,109 @@ void GraphicsWidget::moveNode(const int &num, const qreal &x, const qreal &y){
 
 
 
+/**
+ * @brief Called from activeGraph to move many nodes at once, i.e.
+ * on every frame of a running layout.
+ * @param nodes
+ * @param x
+ * @param y
+ */
+void GraphicsWidget::moveNodes(const QVector<int> &nodes,
+                               const QVector<qreal> &x,
+                               const QVector<qreal> &y){
+    qDebug() << "   GW: moveNodes() " << nodes.count();
+    detailInteraction();
+    for (int i = 0 ; i < nodes.count() ; i++ ) {
+        GraphicsNode *node = nodeHash.value(nodes[i], 0);
+        if ( node ) {
+            node->setPos( x[i], y[i] );
+        }
+    }
+}
+
+
+
+/**
+ * @brief Called from GraphicsEdge::markDirty() when a node of the edge moved.
+ * Queues the edge for the next edgeGeometryFlush(), which runs once
+ * after the current batch of node moves, before the canvas repaints.
+ * @param edge
+ */
+void GraphicsWidget::edgeGeometryDirty(GraphicsEdge *edge) {
+    m_dirtyEdges.append(edge);
+    if ( m_edgeGeometryFlushPending ) {
+        return;
+    }
+    m_edgeGeometryFlushPending = true;
+    // queued after the scene's own processing of the moved nodes,
+    // and before the repaint it schedules
+    QMetaObject::invokeMethod(this, "edgeGeometryFlush", Qt::QueuedConnection);
+}
+
+
+
+/**
+ * @brief Recomputes the geometry of all edges whose nodes moved,
+ * once per batch of node moves instead of once per endpoint move.
+ * Positions are gathered in flat arrays, so the unit vectors and the
+ * end points of all edges are computed in tight loops over the batch.
+ */
+void GraphicsWidget::edgeGeometryFlush() {
+    m_edgeGeometryFlushPending = false;
+
+    QVector<GraphicsEdge*> edges;
+    edges.swap(m_dirtyEdges);
+    const int n = edges.size();
+    if ( n == 0 ) {
+        return;
+    }
+    qDebug() << "GW::edgeGeometryFlush() - edges:" << n;
+
+    QVector<qreal> sx(n), sy(n), tx(n), ty(n), offset(n);
+    QVector<qreal> ux(n), uy(n), length(n);
+
+    for (int i = 0; i < n; ++i) {
+        const QPointF source = edges[i]->sourceNode()->pos();
+        const QPointF target = edges[i]->targetNode()->pos();
+        sx[i] = source.x();
+        sy[i] = source.y();
+        tx[i] = target.x();
+        ty[i] = target.y();
+        offset[i] = edges[i]->offsetFromNode();
+    }
+
+    qreal *psx = sx.data(), *psy = sy.data(), *ptx = tx.data(), *pty = ty.data();
+    const qreal *poffset = offset.constData();
+    qreal *pux = ux.data(), *puy = uy.data(), *plength = length.data();
+
+    for (int i = 0; i < n; ++i) {
+        const qreal dx = ptx[i] - psx[i];
+        const qreal dy = pty[i] - psy[i];
+        const qreal l = std::sqrt( dx * dx + dy * dy );
+        // self-links and coincident nodes get a zero direction
+        const qreal inv = ( l > 0 ) ? 1 / l : 0;
+        pux[i] = dx * inv;
+        puy[i] = dy * inv;
+        plength[i] = l;
+    }
+
+    for (int i = 0; i < n; ++i) {
+        psx[i] += pux[i] * poffset[i];
+        psy[i] += puy[i] * poffset[i];
+        ptx[i] -= pux[i] * poffset[i];
+        pty[i] -= puy[i] * poffset[i];
+    }
+
+    for (int i = 0; i < n; ++i) {
+        edges[i]->setGeometry( QPointF(psx[i], psy[i]),
+                               QPointF(ptx[i], pty[i]),
+                               QPointF(pux[i], puy[i]),
+                               plength[i] );
+    }
+}
+
+
+
 /**
  * @brief Removes a node from the scene.
  * Called from Graph signalEraseNode(int)
@@ -393,6 +613,10 @@ void GraphicsWidget::removeNode(const int &number){
         delete nodeHash.value(number);
     }
 
+    if ( nodeHash.count() == m_detailMinNodes - 1 ) {
+        detailUpdate();
+    }
+
     qDebug() << "GW::removeNode() - node erased! ";
 //             << " scene items now: " << scene()->items().size()
 //             << " view items: " << items().size()
@@ -414,23 +638,30 @@ void GraphicsWidget::removeEdge(const int &source,
                                 const int &target,
                                 const bool &removeOpposite){
 
-    edgeName = createEdgeName(source,target);
+    EdgeKey key = createEdgeKey(source,target);
 
-    qDebug() << "GW::removeEdge() - " << edgeName
+    qDebug() << "GW::removeEdge() - " << edgeKeyName(key)
              << "removeOpposite"<<removeOpposite
              << " scene items: " << scene()->items().size()
              << " view items: " << items().size()
              << " edgesHash.count: " << edgesHash.count();
 
-    if ( edgesHash.contains(edgeName) ) {
-        int directionType = edgesHash.value(edgeName)->directionType();
-        delete edgesHash.value(edgeName);
+    if ( edgeExists(key) ) {
+        int directionType = ( edgesHash.contains(key) )
+                ? edgesHash.value(key)->directionType()
+                : m_edgeLayer->directionType( m_edgeLayer->edgeIndex(key) );
+        if (m_edgeLayer) {
+            m_edgeLayer->removeEdge(key);
+        }
+        if ( edgesHash.contains(key) ) {
+            delete edgesHash.value(key);
+        }
         if (directionType == EdgeType::Reciprocated) {
             if (!removeOpposite) {
                 drawEdge(target, source, 1,"");
             }
         }
-            qDebug() << "GW::removeEdge() - Deleted edge" << edgeName
+            qDebug() << "GW::removeEdge() - Deleted edge" << edgeKeyName(key)
                  << " scene items: " << scene()->items().size()
                  << " view items: " << items().size()
                  << " edgesHash.count: " << edgesHash.count();
@@ -438,13 +669,21 @@ void GraphicsWidget::removeEdge(const int &source,
     }
     else {
         //check opposite edge. If it exists, then transform it to directed
-        edgeName = createEdgeName(target, source);
+        key = createEdgeKey(target, source);
         qDebug() << "GW::removeEdge() - Edge did not exist, checking for opposite:"
-                 << edgeName;
-        if ( edgesHash.contains(edgeName) ) {
+                 << edgeKeyName(key);
+        if ( edgeExists(key) ) {
             qDebug() << "GW::removeEdge() - Opposite edge exists. Check if it is reciprocated";
-            if ( edgesHash.value(edgeName)->directionType() == EdgeType::Reciprocated ) {
-                edgesHash.value(edgeName)->setDirectionType(EdgeType::Directed);
+            int directionType = ( edgesHash.contains(key) )
+                    ? edgesHash.value(key)->directionType()
+                    : m_edgeLayer->directionType( m_edgeLayer->edgeIndex(key) );
+            if ( directionType == EdgeType::Reciprocated ) {
+                if (m_edgeLayer) {
+                    m_edgeLayer->setEdgeDirectionType(key, EdgeType::Directed);
+                }
+                if ( edgesHash.contains(key) ) {
+                    edgesHash.value(key)->setDirectionType(EdgeType::Directed);
+                }
                 return;
             }
         }
@@ -473,6 +712,9 @@ void GraphicsWidget::removeItem( GraphicsNode *node){
         secondDoubleClick = false;
         emit setCursor(Qt::ArrowCursor);
     }
+    if (m_edgeLayer) {
+        m_edgeLayer->removeNodeEdges(node);
+    }
     nodeHash.remove(i);
     scene()->removeItem(node);
     node->deleteLater ();
@@ -493,11 +735,21 @@ void GraphicsWidget::removeItem( GraphicsNode *node){
  *
  */
 void GraphicsWidget::removeItem( GraphicsEdge * edge){
-    qDebug() << "GW::removeItem(edge) - calling edgeClicked(0)" ;
-    setEdgeClicked(0);
-    edgeName = createEdgeName(edge->sourceNodeNumber(), edge->targetNodeNumber() ) ;
+    // In edge layer mode, edge items come and go as the user hovers them,
+    // so only unset the clicked edge if it is this one.
+    if ( !m_edgeLayerMode || clickedEdge == edge ) {
+        qDebug() << "GW::removeItem(edge) - calling edgeClicked(0)" ;
+        setEdgeClicked(0);
+    }
+    if ( edge->isDirty() ) {
+        m_dirtyEdges.removeOne(edge);
+    }
+    EdgeKey key = createEdgeKey(edge->sourceNodeNumber(), edge->targetNodeNumber() ) ;
     qDebug() << "GW::removeItem(edge) - removing edge from edges hash" ;
-    edgesHash.remove(edgeName);
+    edgesHash.remove(key);
+    if (m_edgeLayer) {
+        m_edgeLayer->setEdgePromoted(key, false);
+    }
     qDebug() << "GW::removeItem(edge) - removing edge scene" ;
     scene()->removeItem(edge);
     qDebug() << "GW::removeItem(edge) - calling edge->deleteLater()" ;
@@ -938,11 +1190,14 @@ void GraphicsWidget::setEdgeLabel(const int &source,
                                   const int &target,
                                   const QString &label){
 
-    edgeName = createEdgeName( source, target );
+    EdgeKey key = createEdgeKey( source, target );
 
-    qDebug()<<"GW::setEdgeLabel() -" << edgeName <<  " new label "  << label;
-    if  ( edgesHash.contains (edgeName) ) {
-        edgesHash.value(edgeName) -> setLabel(label);
+    qDebug()<<"GW::setEdgeLabel() -" << edgeKeyName(key) <<  " new label "  << label;
+    if (m_edgeLayer) {
+        m_edgeLayer->setEdgeLabel(key, label);
+    }
+    if  ( edgesHash.contains (key) ) {
+        edgesHash.value(key) -> setLabel(label);
     }
 
 
@@ -960,11 +1215,14 @@ void GraphicsWidget::setEdgeColor(const int &source,
                                   const int &target,
                                   const QString &color){
 
-    edgeName =  createEdgeName( source, target );
+    EdgeKey key = createEdgeKey( source, target );
 
-    qDebug()<<"GW::setEdgeColor() -" << edgeName <<  " new color "  << color;
-    if  ( edgesHash.contains (edgeName) ) {
-        edgesHash.value(edgeName) -> setColor(color);
+    qDebug()<<"GW::setEdgeColor() -" << edgeKeyName(key) <<  " new color "  << color;
+    if (m_edgeLayer) {
+        m_edgeLayer->setEdgeColor(key, QColor(color));
+    }
+    if  ( edgesHash.contains (key) ) {
+        edgesHash.value(key) -> setColor(color);
     }
 
 }
@@ -989,14 +1247,18 @@ bool GraphicsWidget::setEdgeDirectionType(const int &source,
              << "->" << target
              << "type" << dirType;
 
-    edgeName = createEdgeName( source, target );
-    qDebug()<<"GW::setEdgeDirectionType() - checking edgesHash for:" << edgeName ;
+    EdgeKey key = createEdgeKey( source, target );
+    qDebug()<<"GW::setEdgeDirectionType() - checking edgesHash for:" << edgeKeyName(key) ;
 
-    if  ( edgesHash.contains (edgeName) ) {
+    if  ( edgeExists (key) ) {
         qDebug()<<"GW::setEdgeDirectionType() - edge exists in edgesHash. "
                   << " Transforming it to reciprocated";
-        edgesHash.value(edgeName) -> setDirectionType(dirType);
-
+        if (m_edgeLayer) {
+            m_edgeLayer->setEdgeDirectionType(key, dirType);
+        }
+        if  ( edgesHash.contains (key) ) {
+            edgesHash.value(key) -> setDirectionType(dirType);
+        }
         return true;
     }
     return false;
@@ -1017,22 +1279,32 @@ bool GraphicsWidget::setEdgeWeight(const int &source,
                                    const int &target,
                                    const qreal &weight){
 
-    edgeName = createEdgeName( source, target );
+    EdgeKey key = createEdgeKey( source, target );
 
-    qDebug()<<"GW::setEdgeWeight() -" << edgeName <<  " new weight "  << weight;
-    if  ( edgesHash.contains (edgeName) ) {
-        edgesHash.value(edgeName) -> setWeight(weight);
+    qDebug()<<"GW::setEdgeWeight() -" << edgeKeyName(key) <<  " new weight "  << weight;
+    if  ( edgeExists (key) ) {
+        if (m_edgeLayer) {
+            m_edgeLayer->setEdgeWeight(key, weight);
+        }
+        if  ( edgesHash.contains (key) ) {
+            edgesHash.value(key) -> setWeight(weight);
+        }
         return true;
     }
 
     else {
         //check opposite edge. If it exists, then transform it to directed
-        edgeName = createEdgeName(target, source);
+        key = createEdgeKey(target, source);
         qDebug() << "GW::setEdgeWeight() - Edge did not exist, checking for opposite:"
-                 << edgeName;
-        if ( edgesHash.contains(edgeName) ) {
+                 << edgeKeyName(key);
+        if ( edgeExists(key) ) {
             qDebug() << "GW::setEdgeWeight() - Opposite edge exists. Check if it is reciprocated";
-            edgesHash.value(edgeName) -> setWeight(weight);
+            if (m_edgeLayer) {
+                m_edgeLayer->setEdgeWeight(key, weight);
+            }
+            if  ( edgesHash.contains (key) ) {
+                edgesHash.value(key) -> setWeight(weight);
+            }
             return true;
         }
         qDebug() << "GW::setEdgeWeight() - No such edge to delete";
@@ -1060,6 +1332,9 @@ void GraphicsWidget::setEdgeArrowsVisibility(const bool &toggle){
     foreach ( GraphicsEdge *m_edge, edgesHash) {
         m_edge->showArrows(toggle);
     }
+    if (m_edgeLayer) {
+        m_edgeLayer->setArrowsVisibility(toggle);
+    }
 
 }
 
@@ -1079,12 +1354,14 @@ void GraphicsWidget::setEdgeOffsetFromNode(const int &source,
 
     if (source && target) {
 
-        QString edgeName =  QString::number(m_curRelation) + QString(":") +
-                QString::number( source ) + QString(">")+ QString::number( target );
+        EdgeKey key = createEdgeKey( source, target );
 
-        qDebug()<<"GW::setEdgeWeight() -" << edgeName <<  " new offset "  << offset;
-        if  ( edgesHash.contains (edgeName) ) {
-            edgesHash.value(edgeName) -> setMinimumOffsetFromNode(offset);
+        qDebug()<<"GW::setEdgeWeight() -" << edgeKeyName(key) <<  " new offset "  << offset;
+        if (m_edgeLayer) {
+            m_edgeLayer->setEdgeOffsetFromNode(key, offset);
+        }
+        if  ( edgesHash.contains (key) ) {
+            edgesHash.value(key) -> setMinimumOffsetFromNode(offset);
             return;
         }
 
@@ -1099,6 +1376,9 @@ void GraphicsWidget::setEdgeOffsetFromNode(const int &source,
                 edge->setMinimumOffsetFromNode(offset);
             }
         }
+        if (m_edgeLayer) {
+            m_edgeLayer->setOffsetFromNodeAll(offset);
+        }
 
 
     }
@@ -1115,6 +1395,9 @@ void GraphicsWidget::setEdgeWeightNumbersVisibility (const bool &toggle){
     foreach ( GraphicsEdge *m_edge, edgesHash) {
         m_edge->setWeightNumberVisibility(toggle);
     }
+    if (m_edgeLayer) {
+        m_edgeLayer->setWeightNumbersVisibility(toggle);
+    }
 }
 
 
@@ -1129,6 +1412,9 @@ void GraphicsWidget::setEdgeLabelsVisibility (const bool &toggle){
     foreach ( GraphicsEdge *m_edge, edgesHash) {
         m_edge->setLabelVisibility(toggle);
     }
+    if (m_edgeLayer) {
+        m_edgeLayer->setLabelsVisibility(toggle);
+    }
 }
 
 
@@ -1151,11 +1437,319 @@ void   GraphicsWidget::setEdgeHighlighting(const bool &toggle){
         m_edge->setHighlighting(toggle);
     }
 
+    if (m_edgeLayer) {
+        m_edgeLayer->setHighlighting(toggle);
+    }
+
     m_edgeHighlighting = toggle;
 }
 
 
 
+/**
+ * @brief Turns the edge layer rendering mode on or off.
+ * In edge layer mode, edges are kept and painted by a single GraphicsEdgeLayer
+ * item, and GraphicsEdge items are created only for the edges the user
+ * hovers, clicks or selects. Existing edges are moved over to the new mode.
+ * Called from MW
+ * @param toggle
+ */
+void GraphicsWidget::setEdgeLayerMode(const bool &toggle) {
+    qDebug()<< "GW::setEdgeLayerMode()" << toggle
+            << "edgesHash.count:" << edgesHash.count();
+    if ( toggle == m_edgeLayerMode ) {
+        return;
+    }
+    m_edgeLayerMode = toggle;
+
+    if (toggle) {
+        H_KeyToEdge edges = edgesHash;
+        H_KeyToEdge::const_iterator it;
+        for (it = edges.constBegin(); it != edges.constEnd(); ++it) {
+            GraphicsEdge *edge = it.value();
+            edgeLayer()->addEdge(it.key(),
+                                 edge->sourceNode(), edge->targetNode(),
+                                 edge->weight(), edge->label(), edge->color(),
+                                 edge->directionType(),
+                                 edge->arrowsVisible(),
+                                 edge->isBezier(),
+                                 edge->weightNumberVisible(),
+                                 edge->minimumOffsetFromNode());
+            m_edgeLayer->setEdgeVisible(it.key(), edge->isEnabled());
+            edgesHash.remove(it.key());
+            delete edge;
+        }
+    }
+    else if (m_edgeLayer) {
+        for (int i = 0; i < m_edgeLayer->count(); ++i) {
+            edgeLayerPromote(i);
+        }
+        delete m_edgeLayer;
+        m_edgeLayer = 0;
+        m_edgeLayerHovered = EDGE_KEY_NONE;
+    }
+}
+
+
+
+/**
+ * @brief Returns the edge layer, creating it on first use
+ * @return
+ */
+GraphicsEdgeLayer *GraphicsWidget::edgeLayer() {
+    if ( !m_edgeLayer ) {
+        m_edgeLayer = new GraphicsEdgeLayer(this);
+        m_edgeLayer->setHighlighting(m_edgeHighlighting);
+    }
+    return m_edgeLayer;
+}
+
+
+
+/**
+ * @brief Creates a real GraphicsEdge item for the edge at index of the layer,
+ * and stops the layer from painting it. Returns the existing item if the
+ * edge is already promoted.
+ * @param index
+ * @return
+ */
+GraphicsEdge *GraphicsWidget::edgeLayerPromote(const int &index) {
+    if ( !m_edgeLayer || index < 0 || index >= m_edgeLayer->count() ) {
+        return 0;
+    }
+    EdgeKey key = m_edgeLayer->edgeKey(index);
+    GraphicsEdge *promoted = edgesHash.value(key, 0);
+    if ( promoted ) {
+        return promoted;
+    }
+    qDebug()<< "GW::edgeLayerPromote() -" << edgeKeyName(key);
+
+    GraphicsNode *source = m_edgeLayer->sourceNode(index);
+    GraphicsNode *target = m_edgeLayer->targetNode(index);
+
+    GraphicsEdge *edge=new GraphicsEdge (
+                this,
+                source, target,
+                m_edgeLayer->weight(index),
+                m_edgeLayer->label(index),
+                m_edgeLayer->color(index).name(),
+                Qt::SolidLine,
+                m_edgeLayer->directionType(index),
+                m_edgeLayer->arrowsVisible(index),
+                m_edgeLayer->isBezier(index),
+                m_edgeLayer->weightNumberVisible(index),
+                m_edgeHighlighting);
+
+    if ( m_edgeLayer->offsetFromNode(index) != edge->minimumOffsetFromNode() ) {
+        edge->setMinimumOffsetFromNode( m_edgeLayer->offsetFromNode(index) );
+    }
+    if ( !m_edgeLayer->labelsVisible() ) {
+        edge->setLabelVisibility(false);
+    }
+    bool visible = m_edgeLayer->isEdgeVisible(index);
+    edge->setVisible( visible && m_edgeLayer->isVisible() );
+    edge->setEnabled( visible );
+    if ( source->isSelected() || target->isSelected() ) {
+        edge->setHighlighted(true);
+    }
+
+    edgesHash.insert(key, edge);
+    m_edgeLayer->setEdgePromoted(index, true);
+    return edge;
+}
+
+
+
+/**
+ * @brief Called from the edge layer when the cursor moves over the edge
+ * at index, or leaves it (index -1). Also called from GraphicsEdge on hover leave.
+ * @param index
+ */
+void GraphicsWidget::edgeLayerHover(const int &index) {
+    if ( !m_edgeLayer ) {
+        return;
+    }
+    if ( index < 0 ) {
+        m_edgeLayerHovered = EDGE_KEY_NONE;
+    }
+    else if ( edgeLayerPromote(index) ) {
+        m_edgeLayerHovered = m_edgeLayer->edgeKey(index);
+    }
+    edgeLayerScheduleSettle();
+}
+
+
+
+/**
+ * @brief Called from GraphicsNode when a node moves, resizes, hides or
+ * gets selected, so that the edge layer repaints and rebuilds its hit grid.
+ */
+void GraphicsWidget::edgeLayerNodeChanged() {
+    if (m_edgeLayer) {
+        m_edgeLayer->nodesChanged();
+    }
+}
+
+
+
+/**
+ * @brief Like itemAt(), but if the item is the edge layer, returns the
+ * (promoted) edge under pos, or 0 if there is none.
+ * @param pos
+ * @return
+ */
+QGraphicsItem *GraphicsWidget::edgeLayerItemAt(const QPoint &pos) {
+    QGraphicsItem *item = itemAt(pos);
+    if ( item && item->type() == TypeEdgeLayer ) {
+        return edgeLayerPromote( m_edgeLayer->edgeAt( mapToScene(pos) ) );
+    }
+    return item;
+}
+
+
+
+/**
+ * @brief Schedules edgeLayerSettle() to run once the current event is processed.
+ */
+void GraphicsWidget::edgeLayerScheduleSettle() {
+    if ( !m_edgeLayer || m_edgeLayerSettlePending ) {
+        return;
+    }
+    m_edgeLayerSettlePending = true;
+    QTimer::singleShot(0, this, SLOT(edgeLayerSettle()));
+}
+
+
+
+/**
+ * @brief Returns promoted edges that are no longer hovered, clicked or selected
+ * to the edge layer and deletes their GraphicsEdge items.
+ */
+void GraphicsWidget::edgeLayerSettle() {
+    m_edgeLayerSettlePending = false;
+    if ( !m_edgeLayer ) {
+        return;
+    }
+    QVector<EdgeKey> keys;
+    H_KeyToEdge::const_iterator it;
+    for (it = edgesHash.constBegin(); it != edgesHash.constEnd(); ++it) {
+        GraphicsEdge *edge = it.value();
+        if ( edge == clickedEdge
+             || edge->isSelected()
+             || it.key() == m_edgeLayerHovered
+             || ( edge->isVisible() && edge->isUnderMouse() )
+             || !m_edgeLayer->hasEdge(it.key()) ) {
+            continue;
+        }
+        keys << it.key();
+    }
+    foreach (const EdgeKey &key, keys) {
+        qDebug()<< "GW::edgeLayerSettle() - returning" << edgeKeyName(key) << "to the edge layer";
+        GraphicsEdge *edge = edgesHash.take(key);
+        m_edgeLayer->setEdgePromoted(key, false);
+        delete edge;
+    }
+}
+
+
+
+/**
+ * @brief Returns true if the edge exists either as an item or in the edge layer
+ * @param key
+ * @return
+ */
+bool GraphicsWidget::edgeExists(const EdgeKey &key) const {
+    return edgesHash.contains(key)
+            || ( m_edgeLayer && m_edgeLayer->hasEdge(key) );
+}
+
+
+
+/**
+ * @brief Sets when the canvas switches to lower levels of detail.
+ * Called from MW::initApp with the values of the settings file
+ * @param minNodes only canvases with at least that many nodes use lower levels
+ * @param textScale below this zoom scale, texts and arrows are hidden
+ * @param shapeScale below this zoom scale, nodes are drawn as points and edges as thin lines
+ * @param splatScale below this zoom scale, nodes are aggregated in density splats
+ */
+void GraphicsWidget::setDetailThresholds(const int &minNodes,
+                                         const qreal &textScale,
+                                         const qreal &shapeScale,
+                                         const qreal &splatScale) {
+    qDebug() << "GW::setDetailThresholds() - minNodes" << minNodes
+             << "textScale" << textScale
+             << "shapeScale" << shapeScale
+             << "splatScale" << splatScale;
+    m_detailMinNodes = minNodes;
+    m_detailTextScale = textScale;
+    m_detailShapeScale = shapeScale;
+    m_detailSplatScale = splatScale;
+    detailUpdate();
+}
+
+
+
+/**
+ * @brief Called when the user pans, zooms or rotates the canvas or a layout
+ * moves the nodes. Large canvases are drawn with points and thin lines until
+ * the view is idle again, see detailRampUp()
+ */
+void GraphicsWidget::detailInteraction() {
+    if ( nodeHash.count() >= m_detailMinNodes ) {
+        m_detailRamp = DETAIL_POINTS;
+        m_detailTimer->start(200);
+    }
+    detailUpdate();
+}
+
+
+
+/**
+ * @brief Called when the view has been idle for a while.
+ * Raises the level of detail one step at a time, up to the level
+ * allowed by the current zoom.
+ */
+void GraphicsWidget::detailRampUp() {
+    m_detailRamp++;
+    if ( m_detailRamp < DETAIL_FULL ) {
+        m_detailTimer->start(100);
+    }
+    detailUpdate();
+}
+
+
+
+/**
+ * @brief Computes the level of detail from the current zoom scale,
+ * the number of nodes and any ongoing interaction.
+ * Repaints the canvas if the level changed.
+ */
+void GraphicsWidget::detailUpdate() {
+    int level = DETAIL_FULL;
+    if ( nodeHash.count() >= m_detailMinNodes ) {
+        if ( m_currentScaleFactor < m_detailSplatScale ) {
+            level = DETAIL_SPLATS;
+        }
+        else if ( m_currentScaleFactor < m_detailShapeScale ) {
+            level = DETAIL_POINTS;
+        }
+        else if ( m_currentScaleFactor < m_detailTextScale ) {
+            level = DETAIL_NO_TEXT;
+        }
+        level = qMin(level, m_detailRamp);
+    }
+    if ( level == m_detailLevel ) {
+        return;
+    }
+    qDebug() << "GW::detailUpdate() - level of detail" << m_detailLevel
+             << "->" << level;
+    m_detailLevel = level;
+    viewport()->update();
+}
+
+
+
 /**
  * @brief Changes the visibility of an GraphicsView edge (number, label, edge, etc)
  * @param relation
@@ -1165,27 +1759,40 @@ void   GraphicsWidget::setEdgeHighlighting(const bool &toggle){
  */
 void GraphicsWidget::setEdgeVisibility(int relation, int source, int target, bool toggle){
 
-    edgeName = createEdgeName( source, target, relation );
+    EdgeKey key = createEdgeKey( source, target, relation );
 
-    qDebug()<<"GW::setEdgeVisibility() - trying to set edge"<<edgeName<<"to"<<toggle;
+    qDebug()<<"GW::setEdgeVisibility() - trying to set edge"
+           << relation << ":" << source << ">" << target << "to"<<toggle;
 
-    if  ( edgesHash.contains (edgeName) ) {
-        qDebug()<<"GW::setEdgeVisibility() - edge" << edgeName
-               << "set to" << toggle;
-        edgesHash.value(edgeName) -> setVisible(toggle);
-        edgesHash.value(edgeName) -> setEnabled(toggle);
+    GraphicsEdge *edge = edgesHash.value(key, 0);
+    if (m_edgeLayer && m_edgeLayer->hasEdge(key)) {
+        m_edgeLayer->setEdgeVisible(key, toggle);
+        if  ( !edge ) {
+            return;
+        }
+    }
+    if  ( edge ) {
+        qDebug()<<"GW::setEdgeVisibility() - edge set to" << toggle;
+        edge -> setVisible(toggle);
+        edge -> setEnabled(toggle);
         return;
     }
-    edgeName = createEdgeName( target, source, relation );
-    qDebug()<<"GW: setEdgeVisibility() - trying to set edge"<<edgeName<<"to"<<toggle;
-    if  ( edgesHash.contains (edgeName) ) {
-        qDebug()<<"GW::setEdgeVisibility() - reciprocated edge" << edgeName
-               << "set to" << toggle;
-        edgesHash.value(edgeName) -> setVisible(toggle);
-        edgesHash.value(edgeName) -> setEnabled(toggle);
+    key = createEdgeKey( target, source, relation );
+    qDebug()<<"GW: setEdgeVisibility() - trying to set the opposite edge to"<<toggle;
+    edge = edgesHash.value(key, 0);
+    if (m_edgeLayer && m_edgeLayer->hasEdge(key)) {
+        m_edgeLayer->setEdgeVisible(key, toggle);
+        if  ( !edge ) {
+            return;
+        }
+    }
+    if  ( edge ) {
+        qDebug()<<"GW::setEdgeVisibility() - reciprocated edge set to" << toggle;
+        edge -> setVisible(toggle);
+        edge -> setEnabled(toggle);
         return;
     }
-    qDebug()<<"GW::setEdgeVisibility() - Cannot find edge" << edgeName << "or the opposite in the edgesHash";
+    qDebug()<<"GW::setEdgeVisibility() - Cannot find edge or the opposite in the edgesHash";
 
 }
 
@@ -1205,6 +1812,9 @@ void GraphicsWidget::setAllItemsVisibility(int type, bool visible){
             else	(*item)->hide();
         }
     }
+    if ( type == TypeEdge && m_edgeLayer ) {
+        m_edgeLayer->setVisible(visible);
+    }
 }
 
 
@@ -1297,6 +1907,8 @@ void GraphicsWidget::getSelectedItems() {
 
     emit userSelectedItems(selectedNodes(), selectedEdges());
 
+    edgeLayerScheduleSettle();
+
 }
 
 
@@ -1345,6 +1957,9 @@ QList<SelectedEdge> GraphicsWidget::selectedEdges() {
             m_selectedEdges << selEdge;
         }
     }
+    if (m_edgeLayer) {
+        m_selectedEdges << m_edgeLayer->selectedEdges();
+    }
     qDebug() <<"GW::selectedEdges() - " << m_selectedEdges.count();
     return m_selectedEdges;
 }
@@ -1361,7 +1976,7 @@ QList<SelectedEdge> GraphicsWidget::selectedEdges() {
  */
 void GraphicsWidget::mouseDoubleClickEvent ( QMouseEvent * e ) {
 
-    if ( QGraphicsItem *item= itemAt(e->pos() ) ) {
+    if ( QGraphicsItem *item= edgeLayerItemAt(e->pos() ) ) {
         if (GraphicsNode *node = qgraphicsitem_cast<GraphicsNode *>(item)) {
             qDebug() << "GW::mouseDoubleClickEvent() - on a node!"
                      << "Scene items:"<< scene()->items().size()
@@ -1399,7 +2014,7 @@ void GraphicsWidget::mousePressEvent( QMouseEvent * e ) {
 
     // bool ctrlKey = (e->modifiers() == Qt::ControlModifier);
 
-    if ( QGraphicsItem *item = itemAt(e->pos() )   ) {
+    if ( QGraphicsItem *item = edgeLayerItemAt(e->pos() )   ) {
 
         //
         // if user clicked on some item
@@ -1498,7 +2113,7 @@ void GraphicsWidget::mouseReleaseEvent( QMouseEvent * e ) {
 
     QPointF p = mapToScene(e->pos());
 
-    if ( QGraphicsItem *item= itemAt(e->pos() ) ) {
+    if ( QGraphicsItem *item= edgeLayerItemAt(e->pos() ) ) {
         if (GraphicsNode *node = qgraphicsitem_cast<GraphicsNode *>(item)) {
             qDebug() << "GW::mouseReleaseEvent() - at:"
                      << e->pos() << "~"<< p
@@ -1620,6 +2235,8 @@ void GraphicsWidget::changeMatrixScale(int value) {
     scale(m_currentScaleFactor, m_currentScaleFactor);
     rotate(m_currentRotationAngle);
 
+    detailInteraction();
+
 }
 
 
@@ -1655,6 +2272,8 @@ void GraphicsWidget::changeMatrixRotation(int angle){
     scale(m_currentScaleFactor, m_currentScaleFactor);
     rotate(angle);
 
+    detailInteraction();
+
 }
 
 /**
@@ -1712,6 +2331,9 @@ void GraphicsWidget::resizeEvent( QResizeEvent *e ) {
 
     //update the scene width and height with that of the graphicsWidget
     scene()->setSceneRect(0, 0, (qreal) ( w ), (qreal) ( h  ) );
+    if (m_edgeLayer) {
+        m_edgeLayer->setRect(scene()->sceneRect());
+    }
 
     qDebug () << "GW::resizeEvent() - old size: ("
               << w0 << "," << h0
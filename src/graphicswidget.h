@@ -32,6 +32,8 @@
 #include <QGraphicsView>
 //#include <QMetaType>
 
+#include "edgekeymap.h"
+
 class MainWindow;
 
 class GraphicsNode;
@@ -41,8 +43,10 @@ class GraphicsNodeLabel;
 class GraphicsGuide;
 class GraphicsEdgeWeight;
 class GraphicsEdgeLabel;
+class GraphicsEdgeLayer;
+class QTimer;
 
-typedef QHash<QString, GraphicsEdge*> H_StrToEdge;
+typedef EdgeKeyMap<GraphicsEdge*> H_KeyToEdge;
 typedef QHash <int, GraphicsNode*> H_NumToNode;
 
 using namespace std;
@@ -52,6 +56,13 @@ typedef QPair<int, int> SelectedEdge;
 Q_DECLARE_METATYPE(SelectedEdge)
 
 
+// Levels of detail the canvas items are drawn with, see detailLevel()
+static const int DETAIL_SPLATS = 0;
+static const int DETAIL_POINTS = 1;
+static const int DETAIL_NO_TEXT = 2;
+static const int DETAIL_FULL = 3;
+
+
 class GraphicsWidget : public QGraphicsView {
     Q_OBJECT
 
@@ -62,9 +73,9 @@ public:
 
     void clear();
 
-    QString createEdgeName(const int &v1,
-                           const int &v2,
-                           const int &relation=-1);
+    EdgeKey createEdgeKey(const int &v1,
+                          const int &v2,
+                          const int &relation=-1) const;
 
     void setInitNodeSize(int);
 
@@ -93,6 +104,19 @@ public:
 
     void removeAllItems(int);
 
+    void setEdgeLayerMode(const bool &toggle);
+    GraphicsEdge *edgeLayerPromote(const int &index);
+    void edgeLayerHover(const int &index);
+    void edgeLayerNodeChanged();
+
+    void edgeGeometryDirty(GraphicsEdge *edge);
+
+    int detailLevel() const { return m_detailLevel; }
+    void setDetailThresholds(const int &minNodes,
+                             const qreal &textScale,
+                             const qreal &shapeScale,
+                             const qreal &splatScale);
+
 protected:
 
     void wheelEvent(QWheelEvent *event);
@@ -101,6 +125,8 @@ protected:
     void mouseReleaseEvent(QMouseEvent * e );
     void resizeEvent( QResizeEvent *e );
     void paintEvent ( QPaintEvent * event );
+    void scrollContentsBy(int dx, int dy);
+    void drawForeground(QPainter *painter, const QRectF &rect);
 
 public slots:
 
@@ -125,6 +151,9 @@ public slots:
     void setNodeVisibility(int, bool );	//Called from Graph via MW
     void setNodeClicked(GraphicsNode *);
     void moveNode(const int &num, const qreal &x, const qreal &y);
+    void moveNodes(const QVector<int> &nodes,
+                   const QVector<qreal> &x,
+                   const QVector<qreal> &y);
 
     bool setNodeSize(const int &nodeNumber, const int &size=0);
     void setNodeSizeAll(const int &size=0);
@@ -182,6 +211,12 @@ public slots:
 
     void setEdgeHighlighting(const bool &toggle);
 
+    void edgeLayerSettle();
+
+    void detailRampUp();
+
+    void edgeGeometryFlush();
+
     void startEdge(GraphicsNode *node);
 
     void clearGuides();
@@ -216,8 +251,16 @@ signals:
 
 private:
 
+    GraphicsEdgeLayer *edgeLayer();
+    QGraphicsItem *edgeLayerItemAt(const QPoint &pos);
+    void edgeLayerScheduleSettle();
+    bool edgeExists(const EdgeKey &key) const;
+
+    void detailInteraction();
+    void detailUpdate();
+
     H_NumToNode nodeHash;	//This is used in drawEdge() method
-    H_StrToEdge edgesHash; // helper hash to easily find edges
+    H_KeyToEdge edgesHash; // helper hash to easily find edges
     QList<int> m_selectedNodes;
     QList<SelectedEdge> m_selectedEdges;
     int m_curRelation, m_nodeSize;
@@ -227,11 +270,18 @@ private:
     double m_currentScaleFactor;
     qreal fX,fY, factor;
     QString m_nodeLabel, m_numberColor, m_labelColor;
-    QString edgeName;
     bool transformationActive;
     bool secondDoubleClick, clickedEdgeExists;
     bool m_nodeNumbersInside, m_nodeNumberVisibility, m_nodeLabelVisibility;
     bool m_edgeHighlighting;
+    bool m_edgeLayerMode, m_edgeLayerSettlePending;
+    EdgeKey m_edgeLayerHovered;
+    GraphicsEdgeLayer *m_edgeLayer;
+    int m_detailLevel, m_detailRamp, m_detailMinNodes;
+    qreal m_detailTextScale, m_detailShapeScale, m_detailSplatScale;
+    QTimer *m_detailTimer;
+    QVector<GraphicsEdge*> m_dirtyEdges;
+    bool m_edgeGeometryFlushPending;
     GraphicsNode *firstNode, *secondNode;
     GraphicsNode *markedEdgeSource;
     GraphicsNode *markedEdgeTarget;
@@ -524,6 +524,23 @@ QHash<int,qreal> GraphVertex::outEdgesEnabledHash(const bool &allRelations){
 }
 
 
+/**
+ * @brief Returns a qhash of all outEdges in the active relation, enabled
+ * or not, with their weight and enabled status
+ * @return
+ */
+QHash<int, pair_f_b> GraphVertex::outEdgesHash() const {
+    QHash<int, pair_f_b> outEdges;
+    H_edges::const_iterator it1;
+    for ( it1 = m_outEdges.constBegin(); it1 != m_outEdges.constEnd(); ++it1 ) {
+        if ( it1.value().first == m_curRelation ) {
+            outEdges.insert( it1.key(), it1.value().second );
+        }
+    }
+    return outEdges;
+}
+
+
 /**
  * @brief  Returns a qhash of all edges to neighbors in all relations
  * @return
@@ -103,6 +103,7 @@ public:
     void edgeRemoveFrom(const int source);
 
     QHash<int, qreal> outEdgesEnabledHash(const bool &allRelations=false);
+    QHash<int, pair_f_b> outEdgesHash() const;
     QHash<int,qreal>* outEdgesAllRelationsUniqueHash();
     QHash<int,qreal>* inEdgesEnabledHash();
     QHash<int,qreal> reciprocalEdgesHash();
@@ -0,0 +1,166 @@
+/***************************************************************************
+ SocNetV: Social Network Visualizer
+ version: 2.5
+ Written in Qt
+ 
+                         layoutrunner.cpp  -  description
+                             -------------------
+    copyright         : (C) 2005-2019 by Dimitris B. Kalamaras
+    project site      : https://socnetv.org
+
+ ***************************************************************************/
+
+/*******************************************************************************
+*     This program is free software: you can redistribute it and/or modify     *
+*     it under the terms of the GNU General Public License as published by     *
+*     the Free Software Foundation, either version 3 of the License, or        *
+*     (at your option) any later version.                                      *
+*                                                                              *
+*     This program is distributed in the hope that it will be useful,          *
+*     but WITHOUT ANY WARRANTY; without even the implied warranty of           *
+*     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            *
+*     GNU General Public License for more details.                             *
+*                                                                              *
+*     You should have received a copy of the GNU General Public License        *
+*     along with this program.  If not, see <http://www.gnu.org/licenses/>.    *
+********************************************************************************/
+
+
+#include "layoutrunner.h"
+
+#include <QDebug>
+#include <QElapsedTimer>
+#include <QMutexLocker>
+
+
+/**
+ * @brief Constructs a runner for the layout step on a copy of buffer
+ * @param id  sent with every frame
+ * @param buffer  the initial positions
+ * @param step  one iteration of the layout, returns false when converged
+ * @param maxIterations
+ * @param publish  fills the buffer with the positions to show, if the
+ * step does not keep them there
+ * @param frameRate  maximum frames per second published by frameReady
+ */
+LayoutRunner::LayoutRunner(const int &id,
+                           const LayoutBuffer &buffer,
+                           const Step &step,
+                           const int &maxIterations,
+                           const Publish &publish,
+                           const int &frameRate) :
+    m_id(id),
+    m_buffer(buffer),
+    m_step(step),
+    m_publish(publish),
+    m_maxIterations(maxIterations),
+    m_frameInterval( 1000 / qMax(1, frameRate) ),
+    m_paused(false),
+    m_cancelled(false),
+    m_framePending(false)
+{
+    qDebug() << "LayoutRunner::LayoutRunner() - id" << id
+             << "maxIterations" << maxIterations
+             << "frame interval" << m_frameInterval << "ms";
+}
+
+
+LayoutRunner::~LayoutRunner() {
+    qDebug() << "LayoutRunner::~LayoutRunner()";
+}
+
+
+/**
+ * @brief Pauses or resumes the iterations. Called from the GUI thread.
+ * @param toggle
+ */
+void LayoutRunner::pause(const bool &toggle) {
+    QMutexLocker locker(&m_mutex);
+    m_paused = toggle;
+    if ( !m_paused ) {
+        m_resumed.wakeAll();
+    }
+}
+
+
+/**
+ * @brief Stops the iterations after the current one, keeping the
+ * positions reached so far. Called from the GUI thread.
+ */
+void LayoutRunner::cancel() {
+    QMutexLocker locker(&m_mutex);
+    m_cancelled = true;
+    m_resumed.wakeAll();
+}
+
+
+bool LayoutRunner::isPaused() {
+    QMutexLocker locker(&m_mutex);
+    return m_paused;
+}
+
+
+/**
+ * @brief Tells the runner the last frame has been drawn, so that the
+ * next one may be published. Called from the GUI thread.
+ */
+void LayoutRunner::frameShown() {
+    QMutexLocker locker(&m_mutex);
+    m_framePending = false;
+}
+
+
+/**
+ * @brief Runs the layout iterations and emits finished with the final
+ * positions. While running, emits progress after every iteration and
+ * frameReady whenever a frame interval has passed and the previous
+ * frame has been shown.
+ */
+void LayoutRunner::run() {
+    qDebug() << "LayoutRunner::run() - thread" << thread();
+
+    QElapsedTimer frameTimer;
+    frameTimer.start();
+    bool cancelled = false;
+    bool framePending = false;
+
+    for (int iteration = 1 ; iteration <= m_maxIterations ; iteration++ ) {
+        {
+            QMutexLocker locker(&m_mutex);
+            while ( m_paused && !m_cancelled ) {
+                m_resumed.wait(&m_mutex);
+            }
+            cancelled = m_cancelled;
+            framePending = m_framePending;
+        }
+        if ( cancelled ) {
+            qDebug() << "LayoutRunner::run() - cancelled at iteration" << iteration;
+            break;
+        }
+
+        const bool more = m_step(m_buffer, iteration);
+
+        emit progress(iteration);
+
+        if ( !more ) {
+            qDebug() << "LayoutRunner::run() - converged at iteration" << iteration;
+            break;
+        }
+        if ( !framePending && frameTimer.elapsed() >= m_frameInterval ) {
+            if ( m_publish ) {
+                m_publish(m_buffer);
+            }
+            {
+                QMutexLocker locker(&m_mutex);
+                m_framePending = true;
+            }
+            emit frameReady(m_id, m_buffer.x, m_buffer.y);
+            frameTimer.restart();
+        }
+    }
+
+    if ( m_publish ) {
+        m_publish(m_buffer);
+    }
+    emit finished(m_id, m_buffer.x, m_buffer.y, cancelled);
+}
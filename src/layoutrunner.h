@@ -0,0 +1,114 @@
+/***************************************************************************
+ SocNetV: Social Network Visualizer
+ version: 2.5
+ Written in Qt
+ 
+                         layoutrunner.h  -  description
+                             -------------------
+    copyright         : (C) 2005-2019 by Dimitris B. Kalamaras
+    project site      : https://socnetv.org
+
+ ***************************************************************************/
+
+/*******************************************************************************
+*     This program is free software: you can redistribute it and/or modify     *
+*     it under the terms of the GNU General Public License as published by     *
+*     the Free Software Foundation, either version 3 of the License, or        *
+*     (at your option) any later version.                                      *
+*                                                                              *
+*     This program is distributed in the hope that it will be useful,          *
+*     but WITHOUT ANY WARRANTY; without even the implied warranty of           *
+*     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            *
+*     GNU General Public License for more details.                             *
+*                                                                              *
+*     You should have received a copy of the GNU General Public License        *
+*     along with this program.  If not, see <http://www.gnu.org/licenses/>.    *
+********************************************************************************/
+
+#ifndef LAYOUTRUNNER_H
+#define LAYOUTRUNNER_H
+
+#include <QObject>
+#include <QVector>
+#include <QMutex>
+#include <QWaitCondition>
+
+#include <functional>
+
+
+/**
+ * @brief Positions and displacements of the vertices while a layout
+ * is being embedded, in contiguous arrays (one per coordinate) instead
+ * of on the GraphVertex objects, so that the layout kernels stream
+ * through memory. Positions go back to the vertices once per frame
+ * or at the end.
+ */
+struct LayoutBuffer {
+    QVector<qreal> x;
+    QVector<qreal> y;
+    QVector<qreal> dx;
+    QVector<qreal> dy;
+    QVector<bool> enabled;
+};
+
+
+/**
+ * @brief Runs the iterations of a layout on a snapshot of the positions.
+ * Graph builds the snapshot (a LayoutBuffer) and a step function, which
+ * must use only its own copies of the graph data. The runner calls the
+ * step once per iteration, until it returns false (converged), the
+ * iterations run out, or it is cancelled.
+ * Moved to a worker thread, it publishes the positions at most
+ * frameRate times per second (frameReady), never while the previous
+ * frame has not been shown yet (see frameShown), and can be paused,
+ * resumed and cancelled from the GUI thread. run() may also be called
+ * directly, to embed synchronously.
+ * Steps which keep their positions elsewhere than in the buffer (e.g.
+ * on a coarser level) pass a publish function, which fills the buffer
+ * before each frame and at the end.
+ * Signals carry the id of the runner, so that frames still queued from
+ * a stopped runner can be told apart.
+ */
+class LayoutRunner : public QObject  {
+    Q_OBJECT
+public:
+    typedef std::function<bool (LayoutBuffer &buffer, const int &iteration)> Step;
+    typedef std::function<void (LayoutBuffer &buffer)> Publish;
+
+    LayoutRunner(const int &id,
+                 const LayoutBuffer &buffer,
+                 const Step &step,
+                 const int &maxIterations,
+                 const Publish &publish=Publish(),
+                 const int &frameRate=30);
+    ~LayoutRunner();
+
+    void pause(const bool &toggle);
+    void cancel();
+    bool isPaused();
+    void frameShown();
+
+public slots:
+    void run();
+
+signals:
+    void progress(const int &iteration);
+    void frameReady(const int &id, const QVector<qreal> &x, const QVector<qreal> &y);
+    void finished(const int &id, const QVector<qreal> &x, const QVector<qreal> &y,
+                  const bool &cancelled);
+
+private:
+    int m_id;
+    LayoutBuffer m_buffer;
+    Step m_step;
+    Publish m_publish;
+    int m_maxIterations;
+    int m_frameInterval;
+    bool m_paused;
+    bool m_cancelled;
+    bool m_framePending;
+    QMutex m_mutex;
+    QWaitCondition m_resumed;
+};
+
+#endif // LAYOUTRUNNER_H
@@ -430,12 +430,23 @@ QMap<QString,QString> MainWindow::initSettings() {
     appSettings["canvasUpdateMode"] = "Full";
     appSettings["canvasIndexMethod"] = "BspTreeIndex";
     appSettings["canvasEdgeHighlighting"] = "true";
+    appSettings["canvasEdgeLayer"] = "false";
     appSettings["canvasNodeHighlighting"] = "true";
+    appSettings["canvasLodMinNodes"] = "2000";
+    appSettings["canvasLodTextScale"] = "0.6";
+    appSettings["canvasLodShapeScale"] = "0.35";
+    appSettings["canvasLodSplatScale"] = "0.15";
     appSettings["dataDir"]= dataDir ;
     appSettings["lastUsedDirPath"]= dataDir ;
     appSettings["showRightPanel"] = "true";
     appSettings["showLeftPanel"] = "true";
     appSettings["printLogo"] = "true";
+    appSettings["saveInBackground"] = "false";
+    appSettings["layoutBarnesHutTheta"] = "0.7";
+    appSettings["layoutMultilevelIterations"] = "50";
+    appSettings["layoutMultilevelQuality"] = "1";
+    appSettings["layoutInitialPositions"] = "pivotmds";
+    appSettings["layoutInBackground"] = "true";
     appSettings["initStatusBarDuration"] = "5000";
     appSettings["randomErdosEdgeProbability"] = "0.04";
     appSettings["initReportsRealNumberPrecision"] = "6";
@@ -571,6 +582,9 @@ void MainWindow::slotOpenSettingsDialog() {
     connect (m_settingsDialog, &DialogSettings::setReportsChartType,
              activeGraph, &Graph::setReportsChartType);
 
+    connect (m_settingsDialog, &DialogSettings::setSaveInBackground,
+             activeGraph, &Graph::setFileSaveInBackground);
+
     connect( m_settingsDialog, &DialogSettings::setDebugMsgs,
              this, &MainWindow::slotOptionsDebugMessages);
 
@@ -620,6 +634,9 @@ void MainWindow::slotOpenSettingsDialog() {
     connect( m_settingsDialog, &DialogSettings::setCanvasEdgeHighlighting,
              this, &MainWindow::slotOptionsCanvasEdgeHighlighting);
 
+    connect( m_settingsDialog, &DialogSettings::setCanvasEdgeLayer,
+             this, &MainWindow::slotOptionsCanvasEdgeLayer);
+
 
     connect( m_settingsDialog, &DialogSettings::setCanvasUpdateMode,
              this, &MainWindow::slotOptionsCanvasUpdateMode);
@@ -984,6 +1001,36 @@ void MainWindow::initActions(){
             this, SLOT(slotNetworkImportTwoModeSM()));
 
 
+    networkAppendAct = new QAction( QIcon(":/images/file_upload_48px.svg"),
+                                    tr("&Append New Edges from File"), this);
+    networkAppendAct->setStatusTip(tr("Read the lines appended to the loaded edge list file"));
+    networkAppendAct->setWhatsThis(
+                tr("Append New Edges from File\n\n"
+                   "Reads only the lines appended to the loaded edge list file "
+                   "since it was loaded, and adds their new nodes and edges "
+                   "to the network. Existing nodes keep their positions."));
+    networkAppendAct->setEnabled(false);
+    connect(networkAppendAct, SIGNAL(triggered()),
+            this, SLOT(slotNetworkFileAppend()));
+
+    networkFollowAct = new QAction( tr("&Follow Edge List File"), this);
+    networkFollowAct->setStatusTip(tr("Append new edges whenever the loaded edge list file grows"));
+    networkFollowAct->setWhatsThis(
+                tr("Follow Edge List File\n\n"
+                   "Watches the loaded edge list file and appends the new "
+                   "nodes and edges to the network each time lines are "
+                   "added to it, i.e. by a logging or crawling process."));
+    networkFollowAct->setCheckable(true);
+    networkFollowAct->setChecked(false);
+    networkFollowAct->setEnabled(false);
+    connect(networkFollowAct, &QAction::toggled,
+            this, &MainWindow::slotNetworkFileFollow);
+
+    fileWatcher = new QFileSystemWatcher(this);
+    connect(fileWatcher, &QFileSystemWatcher::fileChanged,
+            this, &MainWindow::slotNetworkFileChanged);
+
+
     networkSaveAct = new QAction(QIcon(":/images/file_download_48px.svg"), tr("&Save"),  this);
     networkSaveAct->setShortcut(Qt::CTRL+Qt::Key_S);
     networkSaveAct->setStatusTip(tr("Save social network to a file"));
@@ -1030,6 +1077,23 @@ void MainWindow::initActions(){
                                         "Exports the social network to a Pajek-formatted file"));
     connect(networkExportPajek, SIGNAL(triggered()), this, SLOT(slotNetworkExportPajek()));
 
+    networkExportSnapshotAct = new QAction( QIcon(":/images/file_download_48px.svg"), tr("SocNetV &Snapshot"), this);
+    networkExportSnapshotAct->setStatusTip(tr("Export social network to a SocNetV binary snapshot file"));
+    networkExportSnapshotAct->setWhatsThis(tr("Export SocNetV Snapshot \n\n"
+                                              "Exports the social network to a native binary "
+                                              "snapshot file (.snvb), which stores all relations, "
+                                              "positions and properties of nodes and edges, and "
+                                              "any computed geodesic distances. Snapshots "
+                                              "load much faster than text formats."));
+    connect(networkExportSnapshotAct, SIGNAL(triggered()), this, SLOT(slotNetworkExportSnapshot()));
+
+    networkExportGraphvizAct = new QAction( QIcon(":/images/file_download_48px.svg"), tr("Graph&Viz (.dot)"), this);
+    networkExportGraphvizAct->setStatusTip(tr("Export social network to a GraphViz (dot) file"));
+    networkExportGraphvizAct->setWhatsThis(tr("Export GraphViz \n\n"
+                                              "Exports the current relation of the social network "
+                                              "to a GraphViz-formatted (dot) file"));
+    connect(networkExportGraphvizAct, SIGNAL(triggered()), this, SLOT(slotNetworkExportGraphviz()));
+
 
     networkExportListAct = new QAction( QIcon(":/images/file_download_48px.svg"), tr("&List"), this);
     networkExportListAct->setStatusTip(tr("Export to List-formatted file. "));
@@ -2665,6 +2729,61 @@ void MainWindow::initActions(){
                     ));
     connect(layoutFDP_KamadaKawai_Act, SIGNAL(triggered()), this, SLOT(slotLayoutKamadaKawai()));
 
+    layoutFDP_Multilevel_Act= new QAction( tr("Multilevel (large networks)"),	this);
+    layoutFDP_Multilevel_Act-> setShortcut(
+                QKeySequence(Qt::CTRL + Qt::Key_L, Qt::CTRL + Qt::Key_M));
+    layoutFDP_Multilevel_Act->setStatusTip(
+                tr("Embeds a multilevel force-directed layout, suitable for large networks."));
+    layoutFDP_Multilevel_Act->setWhatsThis(
+                tr("Multilevel Layout\n\n "
+                   "Coarsens the network by merging adjacent nodes, level by level, "
+                   "lays out the coarsest network, and then refines the layout "
+                   "of each finer level with Fruchterman-Reingold forces, "
+                   "starting from the positions of the coarser one. \n"
+                   "Much faster than the single-level models on networks of "
+                   "thousands of nodes, and less likely to get stuck in poor layouts. "
+                   "The iterations per level and the quality (0: draft, 1: normal, "
+                   "2: high) are read from the settings file."));
+    connect(layoutFDP_Multilevel_Act, SIGNAL(triggered()), this, SLOT(slotLayoutMultilevel()));
+
+    layoutPivotMDSAct= new QAction( tr("Pivot MDS (distance-preserving)"),	this);
+    layoutPivotMDSAct-> setShortcut(
+                QKeySequence(Qt::CTRL + Qt::Key_L, Qt::CTRL + Qt::Key_D));
+    layoutPivotMDSAct->setStatusTip(
+                tr("Embeds a fast layout where distances reflect the graph theoretic distances."));
+    layoutPivotMDSAct->setWhatsThis(
+                tr("Pivot MDS Layout\n\n "
+                   "Computes the distances from a few pivot nodes to all other nodes, "
+                   "and places the nodes by multidimensional scaling of these distances, "
+                   "so that nodes at short graph theoretic distances are placed close "
+                   "to each other. \n"
+                   "Gives the global structure of very large networks in seconds. "
+                   "It is also the initial layout of the force-directed models, "
+                   "unless set otherwise in the settings file."));
+    connect(layoutPivotMDSAct, SIGNAL(triggered()), this, SLOT(slotLayoutPivotMDS()));
+
+    layoutPauseAct= new QAction( tr("Pause Layout"),	this);
+    layoutPauseAct->setCheckable(true);
+    layoutPauseAct->setChecked(false);
+    layoutPauseAct->setEnabled(false);
+    layoutPauseAct->setStatusTip(
+                tr("Pauses or resumes the force-directed layout running in the background."));
+    layoutPauseAct->setWhatsThis(
+                tr("Pause Layout\n\n "
+                   "Pauses the force-directed layout which is being embedded, "
+                   "so that you can look at the network, or resumes it."));
+    connect(layoutPauseAct, &QAction::toggled, this, &MainWindow::slotLayoutPause);
+
+    layoutStopAct= new QAction( tr("Stop Layout"),	this);
+    layoutStopAct->setEnabled(false);
+    layoutStopAct->setStatusTip(
+                tr("Stops the force-directed layout running in the background."));
+    layoutStopAct->setWhatsThis(
+                tr("Stop Layout\n\n "
+                   "Stops the force-directed layout which is being embedded, "
+                   "keeping the node positions it has reached so far."));
+    connect(layoutStopAct, SIGNAL(triggered()), this, SLOT(slotLayoutStop()));
+
 
 
 
@@ -3039,6 +3158,30 @@ void MainWindow::initActions(){
 
 
 
+    analyzeStrEquivalenceNearestNeighborsAct = new QAction(QIcon(":/images/similarity.png"),
+                                                  tr("Most similar actors (large networks)"),this);
+    analyzeStrEquivalenceNearestNeighborsAct-> setShortcut(
+                QKeySequence(Qt::CTRL + Qt::Key_T, Qt::CTRL + Qt::Key_N)
+                );
+    analyzeStrEquivalenceNearestNeighborsAct->setStatusTip(tr("Find the k most similar actors of each actor "
+                                                     "by the Jaccard index of their tie profiles, "
+                                                     "without computing the full similarity matrix."));
+    analyzeStrEquivalenceNearestNeighborsAct->setWhatsThis(
+                tr("Most similar actors\n\n"
+                   "For each actor, finds the k other actors with the most "
+                   "similar tie profiles, in terms of their Jaccard Index "
+                   "(Positive Matches).\n\n"
+                   "Instead of comparing all pairs of actors, the tie profiles "
+                   "are summarized by MinHash signatures and only actors with "
+                   "similar signatures are compared (locality-sensitive hashing). "
+                   "The reported indices are estimates.\n\n"
+                   "Use this in large networks, where the full similarity matrix "
+                   "is too slow to compute or too big to display."));
+    connect(analyzeStrEquivalenceNearestNeighborsAct, SIGNAL(triggered()),
+            this, SLOT(slotAnalyzeStrEquivalenceNearestNeighbors() )  );
+
+
+
     analyzeStrEquivalenceTieProfileDissimilaritiesAct = new QAction(QIcon(":/images/dm.png"),
                                                                     tr("Tie Profile Dissimilarities/Distances"),this);
     analyzeStrEquivalenceTieProfileDissimilaritiesAct->setShortcut(
@@ -3595,6 +3738,8 @@ void MainWindow::initMenuBar() {
     importSubMenu->addAction(networkImportUcinetAct);
     importSubMenu->addAction(networkImportGraphvizAct);
     networkMenu ->addMenu (importSubMenu);
+    networkMenu->addAction (networkAppendAct);
+    networkMenu->addAction (networkFollowAct);
 
     networkMenu->addSeparator();
     networkMenu->addAction (openTextEditorAct);
@@ -3635,6 +3780,8 @@ void MainWindow::initMenuBar() {
 
     exportSubMenu->addAction (networkExportSMAct);
     exportSubMenu->addAction (networkExportPajek);
+    exportSubMenu->addAction (networkExportGraphvizAct);
+    exportSubMenu->addAction (networkExportSnapshotAct);
     //exportSubMenu->addAction (networkExportList);
     //exportSubMenu->addAction (networkExportDL);
     //exportSubMenu->addAction (networkExportGW);
@@ -3823,6 +3970,7 @@ void MainWindow::initMenuBar() {
     analysisMenu->addMenu (strEquivalenceMenu);
     strEquivalenceMenu->addAction (analyzeStrEquivalencePearsonAct);
     strEquivalenceMenu->addAction(analyzeStrEquivalenceMatchesAct);
+    strEquivalenceMenu->addAction(analyzeStrEquivalenceNearestNeighborsAct);
     strEquivalenceMenu->addSeparator();
     strEquivalenceMenu->addAction (analyzeStrEquivalenceTieProfileDissimilaritiesAct);
     strEquivalenceMenu->addSeparator();
@@ -3923,6 +4071,10 @@ void MainWindow::initMenuBar() {
     layoutForceDirectedMenu->addAction (layoutFDP_KamadaKawai_Act);
     layoutForceDirectedMenu->addAction (layoutFDP_FR_Act);
     layoutForceDirectedMenu->addAction (layoutFDP_Eades_Act);
+    layoutForceDirectedMenu->addAction (layoutFDP_Multilevel_Act);
+    layoutMenu->addAction (layoutPivotMDSAct);
+    layoutMenu->addAction (layoutPauseAct);
+    layoutMenu->addAction (layoutStopAct);
 
     layoutMenu->addSeparator();
     layoutMenu->addAction (layoutGuidesAct);
@@ -4640,6 +4792,7 @@ void MainWindow::initPanels(){
                << tr("Kamada-Kawai")
                << tr("Fruchterman-Reingold")
                << tr("Eades Spring Embedder")
+               << tr("Multilevel")
                   ;
 
     toolBoxLayoutForceDirectedSelect->addItems(modelsList);
@@ -4673,6 +4826,11 @@ void MainWindow::initPanels(){
                      "regarded as physical object (ring) repelling all other non-adjacent "
                      "nodes, while springs between connected nodes attract them.</p>"
 
+                     "<p><em>Multilevel:</em></p>"
+                     "<p>For large networks. The network is coarsened by merging "
+                     "adjacent nodes, the coarsest one is laid out, and every finer "
+                     "level is refined with Fruchterman-Reingold forces.</p>"
+
                      );
     toolBoxLayoutForceDirectedSelect->setToolTip ( helpMessage );
     toolBoxLayoutForceDirectedSelect->setWhatsThis( helpMessage );
@@ -5299,6 +5457,12 @@ void MainWindow::initSignalSlots() {
     connect( activeGraph, SIGNAL( setNodePos(const int &, const qreal &, const qreal &) ),
              graphicsWidget, SLOT( moveNode(const int &, const qreal &, const qreal &) ) ) ;
 
+    connect( activeGraph, &Graph::setNodesPos,
+             graphicsWidget, &GraphicsWidget::moveNodes );
+
+    connect( activeGraph, &Graph::signalLayoutRunning,
+             this, &MainWindow::slotLayoutRunning );
+
     connect( activeGraph,&Graph::signalNodesFound,
              graphicsWidget,  &GraphicsWidget::setNodesMarked  );
 
@@ -5578,6 +5742,10 @@ void MainWindow::initApp(){
     networkSaveAct->setIcon(QIcon(":/images/file_download_48px.svg"));
     networkSaveAct->setEnabled(true);
 
+    networkFollowAct->setChecked(false);
+    networkFollowAct->setEnabled(false);
+    networkAppendAct->setEnabled(false);
+
     /** Clear previous network data */
     activeGraph->clear();
     activeGraph->setSocNetV_Version(VERSION);
@@ -5605,6 +5773,16 @@ void MainWindow::initApp(){
     activeGraph->setReportsLabelLength(appSettings["initReportsLabelsLength"].toInt());
     activeGraph->setReportsChartType(appSettings["initReportsChartType"].toInt());
 
+    activeGraph->setFileSaveInBackground(
+                (appSettings["saveInBackground"] == "true") ? true:false
+                );
+
+    activeGraph->layoutForceDirectedSetTheta(appSettings["layoutBarnesHutTheta"].toDouble());
+    activeGraph->layoutForceDirectedSetInitialPositions(appSettings["layoutInitialPositions"]);
+    activeGraph->setLayoutInBackground(
+                (appSettings["layoutInBackground"] == "true") ? true:false
+                );
+
     emit signalSetReportsDataDir(appSettings["dataDir"]);
 
     /** Clear graphicsWidget scene and reset settings and transformations **/
@@ -5626,6 +5804,14 @@ void MainWindow::initApp(){
     graphicsWidget->setEdgeHighlighting(
                 ( appSettings["canvasEdgeHighlighting"] == "true" ) ? true: false
                                                                       );
+    graphicsWidget->setEdgeLayerMode(
+                ( appSettings["canvasEdgeLayer"] == "true" ) ? true: false
+                                                                      );
+    graphicsWidget->setDetailThresholds(
+                appSettings["canvasLodMinNodes"].toInt(),
+                appSettings["canvasLodTextScale"].toDouble(),
+                appSettings["canvasLodShapeScale"].toDouble(),
+                appSettings["canvasLodSplatScale"].toDouble() );
 
     if (appSettings["initBackgroundImage"] != ""
             && QFileInfo(appSettings["initBackgroundImage"]).exists()) {
@@ -6298,6 +6484,10 @@ void MainWindow::toolBoxLayoutForceDirectedApplyBtnPressed(){
         slotLayoutGuides(false);
         slotLayoutSpringEmbedder();
         break;
+    case 4:
+        slotLayoutGuides(false);
+        slotLayoutMultilevel();
+        break;
     default:
         toolBoxLayoutForceDirectedSelect->setCurrentIndex(0);
         break;
@@ -6422,6 +6612,9 @@ void MainWindow::slotNetworkFileChoose(QString m_fileName,
         case FileType::TWOMODE:
             fileType_filter = tr("Two-Mode Sociomatrix (*.2sm *.aff);;All (*)");
             break;
+        case FileType::SNVB:
+            fileType_filter = tr("SocNetV Snapshot (*.snvb);;All (*)");
+            break;
         default:	//All
             fileType_filter = tr("GraphML (*.graphml *.xml);;"
                                  "GML (*.gml *.xml);;"
@@ -6432,6 +6625,7 @@ void MainWindow::slotNetworkFileChoose(QString m_fileName,
                                  "Weighted Edge List (*.txt *.edgelist *.list *.lst *.wlst);;"
                                  "Simple Edge List (*.txt *.edgelist *.list *.lst);;"
                                  "Two-Mode Sociomatrix (*.2sm *.aff);;"
+                                 "SocNetV Snapshot (*.snvb);;"
                                  "All (*)");
             break;
 
@@ -6484,20 +6678,30 @@ void MainWindow::slotNetworkFileChoose(QString m_fileName,
      */
     if (checkSelectFileType || m_fileFormat==FileType::UNRECOGNIZED) {
 
+        // compressed files (i.e. net.paj.gz) are recognized by their inner extension
+        QString baseFileName = m_fileName;
+        if ( baseFileName.endsWith(".gz",Qt::CaseInsensitive ) ) {
+            baseFileName.chop(3);
+        }
+        else if ( baseFileName.endsWith(".zst",Qt::CaseInsensitive ) ) {
+            baseFileName.chop(4);
+        }
+
         // This happens only on application startup or on loading a recent file.
-        if ( ! m_fileName.endsWith(".graphml",Qt::CaseInsensitive ) &&
-             ! m_fileName.endsWith(".net",Qt::CaseInsensitive ) &&
-             ! m_fileName.endsWith(".paj",Qt::CaseInsensitive )  &&
-             ! m_fileName.endsWith(".pajek",Qt::CaseInsensitive ) &&
-             ! m_fileName.endsWith(".dl",Qt::CaseInsensitive ) &&
-             ! m_fileName.endsWith(".dat",Qt::CaseInsensitive ) &&
-             ! m_fileName.endsWith(".gml",Qt::CaseInsensitive ) &&
-             ! m_fileName.endsWith(".wlst",Qt::CaseInsensitive ) &&
-             ! m_fileName.endsWith(".wlist",Qt::CaseInsensitive )&&
-             ! m_fileName.endsWith(".2sm",Qt::CaseInsensitive ) &&
-             ! m_fileName.endsWith(".sm",Qt::CaseInsensitive ) &&
-             ! m_fileName.endsWith(".csv",Qt::CaseInsensitive ) &&
-             ! m_fileName.endsWith(".aff",Qt::CaseInsensitive ))
+        if ( ! baseFileName.endsWith(".graphml",Qt::CaseInsensitive ) &&
+             ! baseFileName.endsWith(".net",Qt::CaseInsensitive ) &&
+             ! baseFileName.endsWith(".paj",Qt::CaseInsensitive )  &&
+             ! baseFileName.endsWith(".pajek",Qt::CaseInsensitive ) &&
+             ! baseFileName.endsWith(".dl",Qt::CaseInsensitive ) &&
+             ! baseFileName.endsWith(".dat",Qt::CaseInsensitive ) &&
+             ! baseFileName.endsWith(".gml",Qt::CaseInsensitive ) &&
+             ! baseFileName.endsWith(".wlst",Qt::CaseInsensitive ) &&
+             ! baseFileName.endsWith(".wlist",Qt::CaseInsensitive )&&
+             ! baseFileName.endsWith(".2sm",Qt::CaseInsensitive ) &&
+             ! baseFileName.endsWith(".sm",Qt::CaseInsensitive ) &&
+             ! baseFileName.endsWith(".csv",Qt::CaseInsensitive ) &&
+             ! baseFileName.endsWith(".aff",Qt::CaseInsensitive ) &&
+             ! baseFileName.endsWith(".snvb",Qt::CaseInsensitive ))
         {
             //ambigious file type. Open an input dialog for the user to choose
             // what kind of network file this is.
@@ -6580,48 +6784,59 @@ void MainWindow::slotNetworkFileChoose(QString m_fileName,
 
         }
 
-        else if (m_fileName.endsWith(".graphml",Qt::CaseInsensitive ) ||
-                 m_fileName.endsWith(".xml",Qt::CaseInsensitive ) ) {
+        else if (baseFileName.endsWith(".graphml",Qt::CaseInsensitive ) ||
+                 baseFileName.endsWith(".xml",Qt::CaseInsensitive ) ) {
             m_fileFormat=FileType::GRAPHML;
         }
-        else if (m_fileName.endsWith(".net",Qt::CaseInsensitive ) ||
-                 m_fileName.endsWith(".paj",Qt::CaseInsensitive )  ||
-                 m_fileName.endsWith(".pajek",Qt::CaseInsensitive ) ) {
+        else if (baseFileName.endsWith(".net",Qt::CaseInsensitive ) ||
+                 baseFileName.endsWith(".paj",Qt::CaseInsensitive )  ||
+                 baseFileName.endsWith(".pajek",Qt::CaseInsensitive ) ) {
             m_fileFormat=FileType::PAJEK;
         }
-        else if (m_fileName.endsWith(".dl",Qt::CaseInsensitive ) ||
-                 m_fileName.endsWith(".dat",Qt::CaseInsensitive ) ) {
+        else if (baseFileName.endsWith(".dl",Qt::CaseInsensitive ) ||
+                 baseFileName.endsWith(".dat",Qt::CaseInsensitive ) ) {
             m_fileFormat=FileType::UCINET;
         }
-        else if (m_fileName.endsWith(".sm",Qt::CaseInsensitive ) ||
-                 m_fileName.endsWith(".csv",Qt::CaseInsensitive ) ||
-                 m_fileName.endsWith(".adj",Qt::CaseInsensitive ) ||
-                 m_fileName.endsWith(".txt",Qt::CaseInsensitive )) {
+        else if (baseFileName.endsWith(".sm",Qt::CaseInsensitive ) ||
+                 baseFileName.endsWith(".csv",Qt::CaseInsensitive ) ||
+                 baseFileName.endsWith(".adj",Qt::CaseInsensitive ) ||
+                 baseFileName.endsWith(".txt",Qt::CaseInsensitive )) {
             m_fileFormat=FileType::ADJACENCY;
         }
-        else if (m_fileName.endsWith(".dot",Qt::CaseInsensitive ) ) {
+        else if (baseFileName.endsWith(".dot",Qt::CaseInsensitive ) ) {
             m_fileFormat=FileType::GRAPHVIZ;
         }
-        else if (m_fileName.endsWith(".gml",Qt::CaseInsensitive ) ) {
+        else if (baseFileName.endsWith(".gml",Qt::CaseInsensitive ) ) {
             m_fileFormat=FileType::GML;
         }
-        else if (m_fileName.endsWith(".list",Qt::CaseInsensitive ) ||
-                 m_fileName.endsWith(".lst",Qt::CaseInsensitive )  ) {
+        else if (baseFileName.endsWith(".list",Qt::CaseInsensitive ) ||
+                 baseFileName.endsWith(".lst",Qt::CaseInsensitive )  ) {
             m_fileFormat=FileType::EDGELIST_SIMPLE;
         }
-        else if (m_fileName.endsWith(".wlist",Qt::CaseInsensitive ) ||
-                 m_fileName.endsWith(".wlst",Qt::CaseInsensitive )  ) {
+        else if (baseFileName.endsWith(".wlist",Qt::CaseInsensitive ) ||
+                 baseFileName.endsWith(".wlst",Qt::CaseInsensitive )  ) {
             m_fileFormat=FileType::EDGELIST_WEIGHTED;
         }
-        else if (m_fileName.endsWith(".2sm",Qt::CaseInsensitive ) ||
-                 m_fileName.endsWith(".aff",Qt::CaseInsensitive )  ) {
+        else if (baseFileName.endsWith(".2sm",Qt::CaseInsensitive ) ||
+                 baseFileName.endsWith(".aff",Qt::CaseInsensitive )  ) {
             m_fileFormat=FileType::TWOMODE;
         }
+        else if (baseFileName.endsWith(".snvb",Qt::CaseInsensitive ) ) {
+            m_fileFormat=FileType::SNVB;
+        }
         else
             m_fileFormat=FileType::UNRECOGNIZED;
     }
 
 
+    if ( m_fileFormat == FileType::SNVB ) {
+        // binary snapshots have no text to preview or codec to select
+        qDebug()<<"MW::slotNetworkFileChoose() - Calling slotNetworkFileLoad"
+               << "with m_fileName" << m_fileName;
+        slotNetworkFileLoad(m_fileName, "UTF-8", m_fileFormat);
+        return;
+    }
+
     qDebug()<<"MW::slotNetworkFileChoose() - Calling slotNetworkFilePreview"
            << "with m_fileName" << m_fileName
            << "and m_fileFormat " << m_fileFormat;
@@ -6650,6 +6865,10 @@ void MainWindow::slotNetworkFileDialogFilterSelected(const QString &filter) {
         fileType=FileType::GRAPHML;
         qDebug() << "MW::slotNetworkFileDialogFilterSelected() - fileType FileType::GRAPHML";
     }
+    else if (filter.contains("Snapshot",Qt::CaseInsensitive ) ) {
+        fileType=FileType::SNVB;
+        qDebug() << "MW::slotNetworkFileDialogFilterSelected() - fileType FileType::SNVB";
+    }
     else if (filter.contains("PAJEK",Qt::CaseInsensitive ) ) {
         fileType=FileType::PAJEK;
         qDebug() << "MW::slotNetworkFileDialogFilterSelected() - fileType FileType::PAJEK";
@@ -7087,8 +7306,10 @@ bool MainWindow::slotNetworkFilePreview(const QString &m_fileName,
 
     if (!m_fileName.isEmpty()) {
         QApplication::setOverrideCursor( QCursor(Qt::WaitCursor) );
-        QFile file(m_fileName);
+        // compressed files are decompressed while read
+        NetworkFile file(m_fileName);
         if (!file.open(QFile::ReadOnly)) {
+            QApplication::restoreOverrideCursor();
             slotHelpMessageToUserError(
                         tr("Cannot read file %1:\n%2")
                         .arg(m_fileName)
@@ -7126,6 +7347,96 @@ void MainWindow::slotNetworkFileLoadRecent() {
 
 
 
+/**
+ * @brief Reads the lines appended to the loaded edge list file since it
+ * was loaded (or last appended), adding the new nodes and edges.
+ * Called from networkAppendAct and on changes of a followed file.
+ */
+void MainWindow::slotNetworkFileAppend() {
+    qDebug() << "MW::slotNetworkFileAppend()";
+
+    if ( !activeGraph->graphLoadAppendSupported() ) {
+        slotHelpMessageToUser(USER_MSG_INFO,
+                              tr("Nothing to append"),
+                              tr("Nothing to append"),
+                              tr("New lines can be appended only to a network "
+                                 "loaded from an edge list file. \n\n"
+                                 "Please load the edge list file again.")
+                              );
+        networkFollowAct->setChecked(false);
+        return;
+    }
+
+    QApplication::setOverrideCursor( QCursor(Qt::WaitCursor) );
+
+    activeGraph->graphLoadAppend();
+
+    QApplication::restoreOverrideCursor();
+
+    if ( !activeGraph->graphLoadAppendSupported() ) {
+        // the file was rewritten, it has to be loaded again
+        networkFollowAct->setChecked(false);
+        networkFollowAct->setEnabled(false);
+        networkAppendAct->setEnabled(false);
+    }
+}
+
+
+
+/**
+ * @brief Turns following the loaded edge list file on or off.
+ * When on, the lines appended to the file are read as soon as it changes.
+ * @param toggle
+ */
+void MainWindow::slotNetworkFileFollow(const bool &toggle) {
+    qDebug() << "MW::slotNetworkFileFollow()" << toggle;
+
+    if ( !fileWatcher->files().isEmpty() ) {
+        fileWatcher->removePaths( fileWatcher->files() );
+    }
+
+    if ( !toggle ) {
+        return;
+    }
+
+    const QString followedFile = activeGraph->graphLoadAppendFileName();
+    if ( followedFile.isEmpty() || !fileWatcher->addPath(followedFile) ) {
+        statusMessage( tr("Cannot follow this file. Load an edge list file first.") );
+        networkFollowAct->setChecked(false);
+        return;
+    }
+
+    statusMessage( tr("Following file %1 for new edges.")
+                   .arg( QFileInfo(followedFile).fileName() ) );
+
+    // catch up with what was written since loading
+    slotNetworkFileAppend();
+}
+
+
+
+/**
+ * @brief Called when a followed edge list file changes on disk.
+ * @param path
+ */
+void MainWindow::slotNetworkFileChanged(const QString &path) {
+    qDebug() << "MW::slotNetworkFileChanged()" << path;
+
+    if ( !networkFollowAct->isChecked() ) {
+        return;
+    }
+
+    // some writers replace the file, which drops it from the watcher
+    if ( !fileWatcher->files().contains(path) && QFile::exists(path) ) {
+        fileWatcher->addPath(path);
+    }
+
+    slotNetworkFileAppend();
+}
+
+
+
+
 /**
  * @brief Main network file loader method
  * Called from m_dialogPreviewFile and slotNetworkDataSetRecreate
@@ -7164,12 +7475,26 @@ void MainWindow::slotNetworkFileLoad(const QString m_fileName,
 
                    )
                ) {
-        case 1:
-            two_sm_mode = 1;
-            break;
         case 2:
-            two_sm_mode = 2;
+            two_sm_mode = TWOMODE_SECOND_MODE;
             break;
+        default:
+            two_sm_mode = TWOMODE_FIRST_MODE;
+            break;
+        }
+        if ( slotHelpMessageToUser (
+                 USER_MSG_QUESTION,
+                 tr("Two-mode sociomatrix. Select tie weights..."),
+                 tr("Weight ties by event size?"),
+                 tr("By default, the weight of the tie between two nodes "
+                    "is the number of events (or actors) they share. \n\n"
+                    "Select Yes to weigh each shared event by 1/(n-1), "
+                    "where n is the number of its members, so that ties "
+                    "made in large events count less (Newman's weighting)."),
+                 QMessageBox::Yes|QMessageBox::No,
+                 QMessageBox::No
+                 ) == QMessageBox::Yes ) {
+            two_sm_mode |= TWOMODE_NEWMAN_WEIGHTS;
         }
     }
 
@@ -7244,6 +7569,9 @@ void MainWindow::slotNetworkFileLoaded (const int &type,
 
         setWindowTitle("SocNetV "+ VERSION +" - "+fileNameNoPath);
         setLastPath(fileName); // store this path and file
+
+        networkAppendAct->setEnabled( activeGraph->graphLoadAppendSupported() );
+        networkFollowAct->setEnabled( activeGraph->graphLoadAppendSupported() );
     }
     else {
 
@@ -7307,6 +7635,9 @@ void MainWindow::slotNetworkFileLoaded (const int &type,
     case 9:
         statusMessage( tr("Two-mode affiliation network, named %1, loaded with %2 Nodes and %3 total Edges.").arg( netName ).arg( totalNodes ).arg(totalEdges ) );
         break;
+    case 10:
+        statusMessage( tr("SocNetV snapshot of network named %1, loaded with %2 Nodes and %3 total Edges.").arg( netName ).arg( totalNodes ).arg(totalEdges ) );
+        break;
 
     default: // just for sanity
         QMessageBox::critical(this, "Error","Unrecognized format. \nPlease specify"
@@ -7734,6 +8065,86 @@ void MainWindow::slotNetworkExportPajek()
 
 
 
+/**
+ * @brief Exports the network to a GraphViz-formatted file
+ * Calls the relevant Graph method.
+ */
+void MainWindow::slotNetworkExportGraphviz()
+{
+    qDebug () << "MW::slotNetworkExportGraphviz";
+
+    if ( !activeNodes() )  {
+        slotHelpMessageToUser(USER_MSG_CRITICAL_NO_NETWORK);
+        return;
+    }
+
+    statusMessage( tr("Exporting active network under new filename..."));
+    QString fn =  QFileDialog::getSaveFileName(
+                this,
+                tr("Export Network to File Named..."),
+                getLastPath(), tr("GraphViz (*.dot);;All (*)") );
+    if (!fn.isEmpty())  {
+        if  ( QFileInfo(fn).suffix().isEmpty() ){
+            QMessageBox::information(this, "Missing Extension ",
+                                     tr("File extension was missing! \n"
+                                        "Appending a standard .dot to the given filename."), "OK",0);
+            fn.append(".dot");
+        }
+        fileName=fn;
+        setLastPath(fileName);
+        QFileInfo fileInfo (fileName);
+        fileNameNoPath = fileInfo.fileName();
+    }
+    else  {
+        statusMessage( tr("Saving aborted"));
+        return;
+    }
+
+    activeGraph->graphSave(fileName, FileType::GRAPHVIZ);
+}
+
+
+
+/**
+ * @brief Exports the network to a native SocNetV binary snapshot file
+ * Calls the relevant Graph method.
+ */
+void MainWindow::slotNetworkExportSnapshot()
+{
+    qDebug () << "MW::slotNetworkExportSnapshot";
+
+    if ( !activeNodes() )  {
+        slotHelpMessageToUser(USER_MSG_CRITICAL_NO_NETWORK);
+        return;
+    }
+
+    statusMessage( tr("Exporting active network under new filename..."));
+    QString fn =  QFileDialog::getSaveFileName(
+                this,
+                tr("Export Network to File Named..."),
+                getLastPath(), tr("SocNetV Snapshot (*.snvb);;All (*)") );
+    if (!fn.isEmpty())  {
+        if  ( QFileInfo(fn).suffix().isEmpty() ){
+            QMessageBox::information(this, "Missing Extension ",
+                                     tr("File extension was missing! \n"
+                                        "Appending a standard .snvb to the given filename."), "OK",0);
+            fn.append(".snvb");
+        }
+        fileName=fn;
+        setLastPath(fileName);
+        QFileInfo fileInfo (fileName);
+        fileNameNoPath = fileInfo.fileName();
+    }
+    else  {
+        statusMessage( tr("Saving aborted"));
+        return;
+    }
+
+    activeGraph->graphSave(fileName, FileType::SNVB);
+}
+
+
+
 /**
  * @brief Exports the network to a adjacency matrix-formatted file
  * Calls the relevant Graph method.
@@ -10863,8 +11274,6 @@ void MainWindow::slotLayoutSpringEmbedder(){
     }
 
     activeGraph->layoutForceDirectedSpringEmbedder(500);
-
-    statusMessage( tr("Spring-Gravitational (Eades) model embedded.") );
 }
 
 
@@ -10884,8 +11293,6 @@ void MainWindow::slotLayoutFruchterman(){
     }
 
     activeGraph->layoutForceDirectedFruchtermanReingold(100);
-
-    statusMessage( tr("Fruchterman & Reingold model embedded.") );
 }
 
 
@@ -10903,9 +11310,88 @@ void MainWindow::slotLayoutKamadaKawai(){
         return;
     }
 
-    activeGraph->layoutForceDirectedKamadaKawai(400);
+    activeGraph->layoutForceDirectedKamadaKawai(400, false, false, false,
+                                                appSettings["layoutInitialPositions"]);
+}
+
+
+
 
-    statusMessage( tr("Kamada & Kawai model embedded.") );
+
+/**
+ * @brief Calls Graph::layoutPivotMDS to embed a distance-preserving
+ * layout to the network.
+ */
+void MainWindow::slotLayoutPivotMDS(){
+    qDebug()<< "MW::slotLayoutPivotMDS ()";
+    if ( !activeNodes() )  {
+        slotHelpMessageToUser(USER_MSG_CRITICAL_NO_NETWORK);
+        return;
+    }
+
+    activeGraph->layoutPivotMDS();
+
+    statusMessage( tr("Pivot MDS layout embedded.") );
+}
+
+
+
+
+
+/**
+ * @brief Calls Graph::layoutForceDirectedMultilevel to embed
+ * a multilevel force-directed layout to the network.
+ * Called from menu or toolbox
+ */
+void MainWindow::slotLayoutMultilevel(){
+    qDebug()<< "MW::slotLayoutMultilevel ()";
+    if ( !activeNodes() )  {
+        slotHelpMessageToUser(USER_MSG_CRITICAL_NO_NETWORK);
+        return;
+    }
+
+    activeGraph->layoutForceDirectedMultilevel(
+                appSettings["layoutMultilevelIterations"].toInt(),
+                appSettings["layoutMultilevelQuality"].toInt() );
+}
+
+
+
+/**
+ * @brief Pauses or resumes the layout running in the background.
+ * Called from layoutPauseAct
+ * @param toggle
+ */
+void MainWindow::slotLayoutPause(const bool &toggle){
+    qDebug()<< "MW::slotLayoutPause ()" << toggle;
+    activeGraph->layoutRunnerPause(toggle);
+}
+
+
+
+/**
+ * @brief Stops the layout running in the background, where it is.
+ * Called from layoutStopAct
+ */
+void MainWindow::slotLayoutStop(){
+    qDebug()<< "MW::slotLayoutStop ()";
+    activeGraph->layoutRunnerCancel();
+}
+
+
+
+/**
+ * @brief Enables the pause and stop layout actions while a layout runs
+ * in the background. Called from Graph::signalLayoutRunning
+ * @param running
+ */
+void MainWindow::slotLayoutRunning(const bool &running){
+    qDebug()<< "MW::slotLayoutRunning ()" << running;
+    layoutPauseAct->blockSignals(true);
+    layoutPauseAct->setChecked(false);
+    layoutPauseAct->blockSignals(false);
+    layoutPauseAct->setEnabled(running);
+    layoutStopAct->setEnabled(running);
 }
 
 
@@ -12303,6 +12789,64 @@ void MainWindow::slotAnalyzeStrEquivalenceSimilarityByMeasure(const QString &mat
 
 
 
+/**
+ * @brief Asks the user for the number of neighbors and the variables location
+ * and calls Graph::writeSimilarityNearestNeighbors() to write the most
+ * similar actors of each actor into a file, and displays it.
+ */
+void MainWindow::slotAnalyzeStrEquivalenceNearestNeighbors() {
+    qDebug()<< "MW::slotAnalyzeStrEquivalenceNearestNeighbors()";
+
+    if ( !activeNodes()   )  {
+        slotHelpMessageToUser(USER_MSG_CRITICAL_NO_NETWORK);
+        return;
+    }
+
+    bool ok;
+
+    int k = QInputDialog::getInt(
+                this,
+                tr("Most similar actors"),
+                tr("Enter the number of most similar actors to find for each actor:"),
+                5, 1, 100, 1, &ok);
+    if (!ok) {
+        statusMessage( tr("Most similar actors cancelled.") );
+        return;
+    }
+
+    QStringList variablesLocationList;
+    variablesLocationList << "Rows" << "Columns" << "Both";
+
+    QString varLocation = QInputDialog::getItem(
+                this,
+                tr("Most similar actors"),
+                tr("Compare actor tie profiles in:"),
+                variablesLocationList, 0, false, &ok);
+    if (!ok) {
+        statusMessage( tr("Most similar actors cancelled.") );
+        return;
+    }
+
+    QString dateTime=QDateTime::currentDateTime().toString ( QString ("yy-MM-dd-hhmmss"));
+    QString fn = appSettings["dataDir"] + "socnetv-report-equivalence-most-similar-"+dateTime+".html";
+
+    activeGraph->writeSimilarityNearestNeighbors(fn, k, varLocation);
+
+    if ( appSettings["viewReportsInSystemBrowser"] == "true" ) {
+        QDesktopServices::openUrl(QUrl::fromLocalFile(fn));
+    }
+    else {
+        TextEditor *ed = new TextEditor(fn,this,true);
+        ed->show();
+        m_textEditors << ed;
+    }
+
+    statusMessage(tr("Most similar actors saved as: ") + QDir::toNativeSeparators(fn));
+}
+
+
+
+
 /**
  * @brief Displays the DialogDissimilarities dialog.
  */
@@ -13678,6 +14222,37 @@ void MainWindow::slotOptionsCanvasEdgeHighlighting(const bool &toggle) {
 
 
 
+/**
+ * @brief Turns the edge layer rendering mode on or off.
+ * In this mode all edges are painted by a single canvas item,
+ * which makes large networks much faster to load, zoom and pan.
+ * @param toggle
+ */
+void MainWindow::slotOptionsCanvasEdgeLayer(const bool &toggle) {
+
+    qDebug()<< "MW::slotOptionsCanvasEdgeLayer() " << toggle;
+
+    statusMessage( tr("Toggle edge layer mode. Please wait...") );
+
+    QApplication::setOverrideCursor( QCursor(Qt::WaitCursor) );
+
+    graphicsWidget->setEdgeLayerMode(toggle);
+
+    if (!toggle) {
+        appSettings["canvasEdgeLayer"] = "false";
+        statusMessage( tr("Edge layer mode off.") );
+    }
+    else {
+        appSettings["canvasEdgeLayer"] = "true";
+        statusMessage( tr("Edge layer mode on.") );
+    }
+
+    QApplication::restoreOverrideCursor();
+}
+
+
+
+
 
 /**
  * @brief Sets canvas update mode
@@ -80,6 +80,7 @@ class QSpinBox;
 class QNetworkReply;
 class QDateTime;
 class QNetworkAccessManager;
+class QFileSystemWatcher;
 QT_END_NAMESPACE
 
 using namespace std;
@@ -189,6 +190,9 @@ public slots:
                                const int &totalEdges=0,
                                const QString &message=QString::null);
     void slotNetworkFileLoadRecent();
+    void slotNetworkFileAppend();
+    void slotNetworkFileFollow(const bool &toggle);
+    void slotNetworkFileChanged(const QString &path);
     void slotNetworkSavedStatus(const int &status);
     void slotNetworkFileView();
     void slotNetworkImportGraphML();
@@ -225,6 +229,8 @@ public slots:
                               const int &dpi,
                               const QPrinter::PrinterMode printerMode);
     void slotNetworkExportPajek();
+    void slotNetworkExportSnapshot();
+    void slotNetworkExportGraphviz();
     void slotNetworkExportSM();
     bool slotNetworkExportDL();
     bool slotNetworkExportGW();
@@ -392,6 +398,11 @@ public slots:
     void slotLayoutSpringEmbedder();
     void slotLayoutFruchterman();
     void slotLayoutKamadaKawai();
+    void slotLayoutMultilevel();
+    void slotLayoutPivotMDS();
+    void slotLayoutPause(const bool &toggle);
+    void slotLayoutStop();
+    void slotLayoutRunning(const bool &running);
 
     void slotLayoutColorationStrongStructural();
     void slotLayoutColorationRegular();
@@ -472,6 +483,8 @@ public slots:
                                const QString &varLocation,
                                const bool &diagonal=false);
 
+    void slotAnalyzeStrEquivalenceNearestNeighbors();
+
 
 
     //OPTIONS MENU
@@ -511,6 +524,7 @@ public slots:
     void slotOptionsCanvasSavePainterState(const bool &toggle=false);
     void slotOptionsCanvasCacheBackground(const bool &toggle=false);
     void slotOptionsCanvasEdgeHighlighting(const bool &toggle=false);
+    void slotOptionsCanvasEdgeLayer(const bool &toggle=false);
 
     void slotOptionsCanvasUpdateMode(const QString &mode);
     void slotOptionsCanvasIndexMethod(const QString &method);
@@ -654,7 +668,8 @@ private:
     *networkCloseAct, *networkPrintAct,*networkQuitAct;
     QAction *networkExportImageAct, *networkExportPNGAct, *networkExportPajek,
     *networkExportPDFAct, *networkExportDLAct, *networkExportGWAct, *networkExportSMAct,
-    *networkExportListAct;
+    *networkExportListAct, *networkExportSnapshotAct, *networkExportGraphvizAct;
+    QAction *networkAppendAct, *networkFollowAct;
     QAction *networkImportPajekAct, *networkImportGMLAct, *networkImportAdjAct, *networkImportListAct,
     *networkImportGraphvizAct , *networkImportUcinetAct, *networkImportTwoModeSM;
     QAction *networkViewFileAct, *openTextEditorAct, *networkViewSociomatrixAct,
@@ -712,6 +727,7 @@ private:
     QAction *analyzeMatrixDegreeAct, *analyzeMatrixLaplacianAct;
     QAction *analyzeStrEquivalenceClusteringHierarchicalAct, *analyzeStrEquivalencePearsonAct;
     QAction *analyzeStrEquivalenceMatchesAct;
+    QAction *analyzeStrEquivalenceNearestNeighborsAct;
     QAction *cDegreeAct, *cInDegreeAct, *cClosenessAct, *cInfluenceRangeClosenessAct,
             *cBetweennessAct, *cInformationAct, *cEigenvectorAct, *cPageRankAct,
             *cStressAct, *cPowerAct, *cEccentAct, *cProximityPrestigeAct;
@@ -739,7 +755,9 @@ private:
 
     QAction *strongColorationAct, *regularColorationAct;
     QAction *layoutFDP_Eades_Act, *layoutFDP_FR_Act;
-    QAction *layoutFDP_KamadaKawai_Act;
+    QAction *layoutFDP_KamadaKawai_Act, *layoutFDP_Multilevel_Act;
+    QAction *layoutPivotMDSAct;
+    QAction *layoutPauseAct, *layoutStopAct;
 
     QAction *editRelationNextAct, *editRelationPreviousAct, *editRelationAddAct;
     QAction *editRelationRenameAct;
@@ -789,6 +807,7 @@ private:
     QTime eTime;     //used  to time algorithms.
 
     QNetworkAccessManager *http;
+    QFileSystemWatcher *fileWatcher;   // for following appended edge lists
     QNetworkReply *reply;
 
 };
@@ -35,6 +35,24 @@
 #include <QDebug>
 #include <QtMath>		//needed for fabs, qFloor etc
 #include <QTextStream>
+#include <QVector>
+#include <QtAlgorithms>    //for qPopulationCount
+#include <QtConcurrent>
+#include <cstring>    //for memcpy
+#include <limits>
+
+// Vector instruction sets used by the distance kernels.
+// The scalar code is always compiled as fallback and for the remainders.
+#if defined(__AVX__)
+#  include <immintrin.h>
+#  define SOCNETV_SIMD_AVX
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#  include <emmintrin.h>
+#  define SOCNETV_SIMD_SSE2
+#elif defined(__aarch64__) && defined(__ARM_NEON)
+#  include <arm_neon.h>
+#  define SOCNETV_SIMD_NEON
+#endif
 
 
 /**
@@ -1352,9 +1370,288 @@ bool Matrix::solve(qreal b[])
 }
 
 
+/**
+ * @brief Returns the sum of squared differences (a[j]-b[j])^2 of two vectors
+ * @param a
+ * @param b
+ * @param n
+ * @return
+ */
+static inline double distanceKernelSumSquares(const double *a,
+                                              const double *b,
+                                              const int &n) {
+    int j = 0;
+    double sum = 0;
+#if defined(SOCNETV_SIMD_AVX)
+    __m256d acc = _mm256_setzero_pd();
+    for ( ; j + 4 <= n ; j += 4 ) {
+        __m256d d = _mm256_sub_pd( _mm256_loadu_pd(a+j), _mm256_loadu_pd(b+j) );
+        acc = _mm256_add_pd( acc, _mm256_mul_pd(d, d) );
+    }
+    double lanes[4];
+    _mm256_storeu_pd(lanes, acc);
+    sum = (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+#elif defined(SOCNETV_SIMD_SSE2)
+    __m128d acc = _mm_setzero_pd();
+    for ( ; j + 2 <= n ; j += 2 ) {
+        __m128d d = _mm_sub_pd( _mm_loadu_pd(a+j), _mm_loadu_pd(b+j) );
+        acc = _mm_add_pd( acc, _mm_mul_pd(d, d) );
+    }
+    double lanes[2];
+    _mm_storeu_pd(lanes, acc);
+    sum = lanes[0] + lanes[1];
+#elif defined(SOCNETV_SIMD_NEON)
+    float64x2_t acc = vdupq_n_f64(0);
+    for ( ; j + 2 <= n ; j += 2 ) {
+        float64x2_t d = vsubq_f64( vld1q_f64(a+j), vld1q_f64(b+j) );
+        acc = vfmaq_f64(acc, d, d);
+    }
+    sum = vaddvq_f64(acc);
+#endif
+    for ( ; j < n ; j++ ) {
+        sum += (a[j] - b[j]) * (a[j] - b[j]);
+    }
+    return sum;
+}
+
+
+/**
+ * @brief Returns the sum of absolute differences |a[j]-b[j]| of two vectors
+ * @param a
+ * @param b
+ * @param n
+ * @return
+ */
+static inline double distanceKernelSumAbs(const double *a,
+                                          const double *b,
+                                          const int &n) {
+    int j = 0;
+    double sum = 0;
+#if defined(SOCNETV_SIMD_AVX)
+    const __m256d signMask = _mm256_set1_pd(-0.0);
+    __m256d acc = _mm256_setzero_pd();
+    for ( ; j + 4 <= n ; j += 4 ) {
+        __m256d d = _mm256_sub_pd( _mm256_loadu_pd(a+j), _mm256_loadu_pd(b+j) );
+        acc = _mm256_add_pd( acc, _mm256_andnot_pd(signMask, d) );
+    }
+    double lanes[4];
+    _mm256_storeu_pd(lanes, acc);
+    sum = (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+#elif defined(SOCNETV_SIMD_SSE2)
+    const __m128d signMask = _mm_set1_pd(-0.0);
+    __m128d acc = _mm_setzero_pd();
+    for ( ; j + 2 <= n ; j += 2 ) {
+        __m128d d = _mm_sub_pd( _mm_loadu_pd(a+j), _mm_loadu_pd(b+j) );
+        acc = _mm_add_pd( acc, _mm_andnot_pd(signMask, d) );
+    }
+    double lanes[2];
+    _mm_storeu_pd(lanes, acc);
+    sum = lanes[0] + lanes[1];
+#elif defined(SOCNETV_SIMD_NEON)
+    float64x2_t acc = vdupq_n_f64(0);
+    for ( ; j + 2 <= n ; j += 2 ) {
+        acc = vaddq_f64( acc, vabdq_f64( vld1q_f64(a+j), vld1q_f64(b+j) ) );
+    }
+    sum = vaddvq_f64(acc);
+#endif
+    for ( ; j < n ; j++ ) {
+        sum += fabs(a[j] - b[j]);
+    }
+    return sum;
+}
+
+
+/**
+ * @brief Returns the maximum absolute difference |a[j]-b[j]| of two vectors
+ * @param a
+ * @param b
+ * @param n
+ * @return
+ */
+static inline double distanceKernelMaxAbs(const double *a,
+                                          const double *b,
+                                          const int &n) {
+    int j = 0;
+    double max = 0;
+#if defined(SOCNETV_SIMD_AVX)
+    const __m256d signMask = _mm256_set1_pd(-0.0);
+    __m256d acc = _mm256_setzero_pd();
+    for ( ; j + 4 <= n ; j += 4 ) {
+        __m256d d = _mm256_sub_pd( _mm256_loadu_pd(a+j), _mm256_loadu_pd(b+j) );
+        acc = _mm256_max_pd( acc, _mm256_andnot_pd(signMask, d) );
+    }
+    double lanes[4];
+    _mm256_storeu_pd(lanes, acc);
+    max = qMax( qMax(lanes[0], lanes[1]), qMax(lanes[2], lanes[3]) );
+#elif defined(SOCNETV_SIMD_SSE2)
+    const __m128d signMask = _mm_set1_pd(-0.0);
+    __m128d acc = _mm_setzero_pd();
+    for ( ; j + 2 <= n ; j += 2 ) {
+        __m128d d = _mm_sub_pd( _mm_loadu_pd(a+j), _mm_loadu_pd(b+j) );
+        acc = _mm_max_pd( acc, _mm_andnot_pd(signMask, d) );
+    }
+    double lanes[2];
+    _mm_storeu_pd(lanes, acc);
+    max = qMax(lanes[0], lanes[1]);
+#elif defined(SOCNETV_SIMD_NEON)
+    float64x2_t acc = vdupq_n_f64(0);
+    for ( ; j + 2 <= n ; j += 2 ) {
+        acc = vmaxq_f64( acc, vabdq_f64( vld1q_f64(a+j), vld1q_f64(b+j) ) );
+    }
+    max = vmaxvq_f64(acc);
+#endif
+    for ( ; j < n ; j++ ) {
+        max = qMax( max, fabs(a[j] - b[j]) );
+    }
+    return max;
+}
+
+
+/**
+ * @brief Returns the number of positions where a[j] != b[j]
+ * @param a
+ * @param b
+ * @param n
+ * @return
+ */
+static inline int distanceKernelCountDifferent(const double *a,
+                                               const double *b,
+                                               const int &n) {
+    int j = 0;
+    int count = 0;
+#if defined(SOCNETV_SIMD_AVX)
+    for ( ; j + 4 <= n ; j += 4 ) {
+        __m256d neq = _mm256_cmp_pd( _mm256_loadu_pd(a+j), _mm256_loadu_pd(b+j), _CMP_NEQ_UQ );
+        count += qPopulationCount( (quint32) _mm256_movemask_pd(neq) );
+    }
+#elif defined(SOCNETV_SIMD_SSE2)
+    for ( ; j + 2 <= n ; j += 2 ) {
+        __m128d neq = _mm_cmpneq_pd( _mm_loadu_pd(a+j), _mm_loadu_pd(b+j) );
+        count += qPopulationCount( (quint32) _mm_movemask_pd(neq) );
+    }
+#elif defined(SOCNETV_SIMD_NEON)
+    for ( ; j + 2 <= n ; j += 2 ) {
+        uint64x2_t eq = vceqq_f64( vld1q_f64(a+j), vld1q_f64(b+j) );
+        count += 2 - (int) ( ( vgetq_lane_u64(eq, 0) & 1 ) + ( vgetq_lane_u64(eq, 1) & 1 ) );
+    }
+#endif
+    for ( ; j < n ; j++ ) {
+        if ( a[j] != b[j] ) {
+            count++;
+        }
+    }
+    return count;
+}
+
+
+/**
+ * @brief Counts the positions where a[j] == b[j] != 0 (matches) and
+ * the positions where a[j] != 0 or b[j] != 0 (ties)
+ * @param a
+ * @param b
+ * @param n
+ * @param matches
+ * @param ties
+ */
+static inline void distanceKernelJaccard(const double *a,
+                                         const double *b,
+                                         const int &n,
+                                         int &matches,
+                                         int &ties) {
+    int j = 0;
+#if defined(SOCNETV_SIMD_AVX)
+    const __m256d zero = _mm256_setzero_pd();
+    for ( ; j + 4 <= n ; j += 4 ) {
+        __m256d va = _mm256_loadu_pd(a+j);
+        __m256d vb = _mm256_loadu_pd(b+j);
+        __m256d nzA = _mm256_cmp_pd( va, zero, _CMP_NEQ_UQ );
+        __m256d nzB = _mm256_cmp_pd( vb, zero, _CMP_NEQ_UQ );
+        __m256d eq = _mm256_cmp_pd( va, vb, _CMP_EQ_OQ );
+        matches += qPopulationCount( (quint32) _mm256_movemask_pd( _mm256_and_pd(eq, nzA) ) );
+        ties += qPopulationCount( (quint32) _mm256_movemask_pd( _mm256_or_pd(nzA, nzB) ) );
+    }
+#elif defined(SOCNETV_SIMD_SSE2)
+    const __m128d zero = _mm_setzero_pd();
+    for ( ; j + 2 <= n ; j += 2 ) {
+        __m128d va = _mm_loadu_pd(a+j);
+        __m128d vb = _mm_loadu_pd(b+j);
+        __m128d nzA = _mm_cmpneq_pd( va, zero );
+        __m128d nzB = _mm_cmpneq_pd( vb, zero );
+        __m128d eq = _mm_cmpeq_pd( va, vb );
+        matches += qPopulationCount( (quint32) _mm_movemask_pd( _mm_and_pd(eq, nzA) ) );
+        ties += qPopulationCount( (quint32) _mm_movemask_pd( _mm_or_pd(nzA, nzB) ) );
+    }
+#elif defined(SOCNETV_SIMD_NEON)
+    for ( ; j + 2 <= n ; j += 2 ) {
+        float64x2_t va = vld1q_f64(a+j);
+        float64x2_t vb = vld1q_f64(b+j);
+        uint64x2_t zA = vceqzq_f64(va);
+        uint64x2_t zB = vceqzq_f64(vb);
+        uint64x2_t match = vbicq_u64( vceqq_f64(va, vb), zA );
+        uint64x2_t noTie = vandq_u64( zA, zB );
+        matches += (int) ( ( vgetq_lane_u64(match, 0) & 1 ) + ( vgetq_lane_u64(match, 1) & 1 ) );
+        ties += 2 - (int) ( ( vgetq_lane_u64(noTie, 0) & 1 ) + ( vgetq_lane_u64(noTie, 1) & 1 ) );
+    }
+#endif
+    for ( ; j < n ; j++ ) {
+        if ( a[j] == b[j] && a[j] != 0 ) {
+            matches++;
+        }
+        if ( a[j] != 0 || b[j] != 0 ) {
+            ties++;
+        }
+    }
+}
+
+
+/**
+ * @brief Accumulates the contribution of the first n elements of
+ * vectors a and b to their distance in the given metric
+ * @param metric
+ * @param a
+ * @param b
+ * @param n
+ * @param sum  accumulated sum (Euclidean, Manhattan) or max (Chebyshev)
+ * @param count  differences (Hamming) or matches (Jaccard)
+ * @param ties  ties (Jaccard)
+ */
+static inline void distanceKernel(const int &metric,
+                                  const double *a,
+                                  const double *b,
+                                  const int &n,
+                                  double &sum,
+                                  int &count,
+                                  int &ties) {
+    if ( n <= 0 ) {
+        return;
+    }
+    switch (metric) {
+    case METRIC_JACCARD_INDEX:
+        distanceKernelJaccard(a, b, n, count, ties);
+        break;
+    case METRIC_HAMMING_DISTANCE:
+        count += distanceKernelCountDifferent(a, b, n);
+        break;
+    case METRIC_EUCLIDEAN_DISTANCE:
+        sum += distanceKernelSumSquares(a, b, n);
+        break;
+    case METRIC_MANHATTAN_DISTANCE:
+        sum += distanceKernelSumAbs(a, b, n);
+        break;
+    case METRIC_CHEBYSHEV_MAXIMUM:
+        sum = qMax( sum, distanceKernelMaxAbs(a, b, n) );
+        break;
+    default:
+        break;
+    }
+}
+
+
+
 /**
  * @brief Computes the dissimilarities matrix of the variables (rows, columns, both)
  * of this matrix using the user defined metric
+ * See SymmetricMatrix::distancesMatrix
  * @param metric
  * @param varLocation
  * @param diagonal
@@ -1365,397 +1662,1007 @@ Matrix& Matrix::distancesMatrix(const int &metric,
                         const QString varLocation,
                         const bool &diagonal,
                         const bool &considerWeights) {
-    Q_UNUSED(considerWeights);
 
-    Matrix *T = new Matrix(cols(), rows());
+    Matrix *T = new Matrix(cols(), rows());
+
+    SymmetricMatrix DSM;
+    DSM.distancesMatrix(*this, metric, varLocation, diagonal, considerWeights);
+    DSM.toMatrix(*T);
+
+    return *T;
+}
+
+
+
+/**
+ * @brief  Computes the pair-wise matching score of the rows, columns
+ * or both of the given matrix AM, based on the given matching measure
+ * and returns the similarity matrix.
+ * See SymmetricMatrix::similarityMatrix
+ * @param AM Matrix
+ * @return Matrix nxn with matching scores for every pair of rows/columns of AM
+ */
+Matrix& Matrix::similarityMatrix(Matrix &AM,
+                                   const int &measure,
+                                   const QString varLocation,
+                                   const bool &diagonal,
+                                   const bool &considerWeights){
+
+    SymmetricMatrix SCM;
+    SCM.similarityMatrix(AM, measure, varLocation, diagonal, considerWeights);
+    SCM.toMatrix(*this);
+
+    return *this;
+}
+
+
+
+/**
+ * @brief  Computes the Pearson Correlation Coefficient of the rows or the columns
+ * of the given matrix AM
+ * See SymmetricMatrix::pearsonCorrelationCoefficients
+ * @param AM Matrix
+ * @return Matrix nxn with PPC values for every pair of rows/columns of AM
+ */
+Matrix& Matrix::pearsonCorrelationCoefficients(Matrix &AM,
+                                               const QString &varLocation,
+                                               const bool &diagonal){
+
+    SymmetricMatrix PCC;
+    PCC.pearsonCorrelationCoefficients(AM, varLocation, diagonal);
+    PCC.toMatrix(*this);
+
+    return *this;
+}
+
+
+
+/**
+ * @brief Prints the square matrix m (Matrix or SymmetricMatrix) to given textstream
+ * @param os
+ * @param m
+ * @return
+ */
+template <class M>
+static QTextStream& printMatrixText (QTextStream& os, M& m){
+    int actorNumber=1, fieldWidth = 13;
+    qreal maxVal, minVal, maxAbsVal, element;
+    bool hasRealNumbers=false;
+
+    m.findMinMaxValues(minVal, maxVal, hasRealNumbers);
+
+    maxAbsVal = ( fabs(minVal) > fabs(maxVal) ) ? fabs(minVal) : fabs(maxVal) ;
+
+
+    os << qSetFieldWidth(0) << endl ;
+
+    os << "- Values:        "
+       << ( (hasRealNumbers) ? ("real numbers (printed decimals 3)") : ("integers only" ) ) << endl;
+
+    os << "- Max value:  ";
+
+    if ( maxVal==RAND_MAX )
+        os <<  infinity << " (=not connected nodes, in distance matrix)";
+    else
+        os <<   maxVal;
+
+    os << qSetFieldWidth(0) << endl ;
+
+    os << "- Min value:   ";
+
+    if ( minVal==RAND_MAX )
+        os << infinity;
+    else
+        os << minVal;
+
+
+    os << qSetFieldWidth(0) << endl << endl;
+
+    os << qSetFieldWidth(7) << fixed << right << "v"<< qSetFieldWidth(3) << "" ;
+
+    os <<  ( (hasRealNumbers) ? qSetRealNumberPrecision(3) : qSetRealNumberPrecision(0) ) ;
+
+    // Note: In the case of Distance Matrix,
+    // if there is DM(i,j)=RAND_MAX (not connected), we always use fieldWidth  = 13
+    if ( maxAbsVal  > 999)
+        fieldWidth  = 13 ;
+    else if  ( maxAbsVal > 99)
+        fieldWidth  = 10 ;
+    else if ( maxAbsVal > 9   )
+        fieldWidth  = 9 ;
+    else
+        fieldWidth  = 8 ;
+
+    // print first/header row
+    for (int r = 0; r < m.cols(); ++r) {
+        actorNumber = r+1;
+
+        if ( actorNumber > 999)
+            os << qSetFieldWidth(fieldWidth-3) ;
+        else if  ( actorNumber > 99)
+            os << qSetFieldWidth(fieldWidth-2) ;
+        else if ( actorNumber > 9)
+            os << qSetFieldWidth(fieldWidth-1) ;
+        else
+            os << qSetFieldWidth(fieldWidth) ;
+
+        os <<  fixed << actorNumber;
+    }
+
+    os << qSetFieldWidth(0) << endl;
+
+    os << qSetFieldWidth(7)<< endl;
+
+    // print rows
+    for (int r = 0; r < m.rows(); ++r) {
+        actorNumber = r+1;
+
+        if ( actorNumber > 999)
+            os << qSetFieldWidth(4) ;
+        else if  ( actorNumber > 99)
+            os << qSetFieldWidth(5) ;
+        else if ( actorNumber > 9)
+            os << qSetFieldWidth(6) ;
+        else
+            os << qSetFieldWidth(7) ;
+
+
+        os <<  fixed << actorNumber
+            << qSetFieldWidth(3) <<"" ;
+
+        for (int c = 0; c < m.cols(); ++c) {
+            element = m.item(r,c) ;
+            os << qSetFieldWidth(fieldWidth) << fixed << right;
+            if ( element == RAND_MAX)  // we print inf symbol instead of RAND_MAX (distances matrix).
+                os << fixed << right << qSetFieldWidth(fieldWidth) << infinity ;
+            else {
+                if ( element > 999)
+                    os << qSetFieldWidth(fieldWidth-3) ;
+                else if  ( element > 99)
+                    os << qSetFieldWidth(fieldWidth-2) ;
+                else if ( element > 9)
+                    os << qSetFieldWidth(fieldWidth-1) ;
+                else
+                    os << qSetFieldWidth(fieldWidth) ;
+                os <<  element;
+            }
+        }
+        os << qSetFieldWidth(0) << endl;
+    }
+    return os;
+}
+
+
+
+/**
+ * @brief Prints matrix m to given textstream
+ * @param os
+ * @param m
+ * @return
+ */
+QTextStream& operator <<  (QTextStream& os, Matrix& m){
+    qDebug() << "Matrix: << Matrix";
+    return printMatrixText(os, m);
+}
+
+
+
+/**
+ * @brief Prints symmetric matrix m to given textstream
+ * @param os
+ * @param m
+ * @return
+ */
+QTextStream& operator <<  (QTextStream& os, SymmetricMatrix& m){
+    qDebug() << "Matrix: << SymmetricMatrix";
+    return printMatrixText(os, m);
+}
+
+
+
+
+
+/**
+ * @brief  Prints this matrix as HTML table
+ * This has the problem that the real actorNumber != elementLabel i.e. when we
+ * have deleted a node/vertex
+ * @param os
+ * @param debug
+ * @return
+ */
+bool Matrix::printHTMLTable(QTextStream& os,
+                            const bool markDiag,
+                            const bool &plain,
+                            const bool &printInfinity){
+    qDebug() << "Matrix::printHTMLTable()";
+    int elementLabel=0, rowCount = 0;
+    qreal maxVal, minVal, element;
+    bool hasRealNumbers=false;
+
+    findMinMaxValues(minVal, maxVal, hasRealNumbers);
+
+    //maxAbsVal = ( fabs(minVal) > fabs(maxVal) ) ? fabs(minVal) : fabs(maxVal) ;
+
+    os <<  ( (hasRealNumbers) ? qSetRealNumberPrecision(3) : qSetRealNumberPrecision(0) ) ;
+
+    if (plain) {
+        os << "<pre>";
+
+        // print first/header row
+        os << "<span class=\"header\">" << qSetFieldWidth(5) << right << "A/A";
+        os <<  fixed << qSetFieldWidth(10) << right ;
+        for (int r = 0; r < cols(); ++r) {
+            elementLabel = r+1;
+            os << elementLabel;
+        }
+        os << qSetFieldWidth(0) << "</span>"<< endl;
+
+        for (int r = 0; r < rows(); ++r) {
+            elementLabel = r+1;
+            rowCount++;
+
+            os << "<span class=\"header\">" << qSetFieldWidth(5) << right;
+            os << elementLabel;
+            os << qSetFieldWidth(0) << "</span>";
+
+            for (int c = 0; c < cols(); ++c) {
+                element = item(r,c) ;
+                os << fixed << qSetFieldWidth(10) << right;
+                if (  element == RAND_MAX)  // print inf symbol instead of RAND_MAX (distances matrix).
+                    os << infinity;
+                else {
+                    os << element ;
+
+                }
+               // os << "";
+            }
+
+            os << qSetFieldWidth(0) << endl;
+        }
+
+        os << "</pre>";
+        return true;
+    }
+
+    os << "<table  border=\"1\" cellspacing=\"0\" cellpadding=\"0\" class=\"stripes\">"
+            << "<thead>"
+            << "<tr>"
+            << "<th>"
+            << ("<sub>Actor</sup>/<sup>Actor</sup>")
+            << "</th>";
+
+
+    // print first/header row
+    for (int r = 0; r < cols(); ++r) {
+        elementLabel = r+1;
+        os << "<th>"
+                << elementLabel
+                << "</th>";
+
+    }
+    os << "</tr>"
+            << "</thead>"
+            << "<tbody>";
+
+    // print rows
+    rowCount = 0;
+    for (int r = 0; r < rows(); ++r) {
+        elementLabel = r+1;
+        rowCount++;
+        os << "<tr class=" << ((rowCount%2==0) ? "even" :"odd" )<< ">";
+
+        os <<"<td class=\"header\">"
+               << elementLabel
+               << "</td>";
+
+        for (int c = 0; c < cols(); ++c) {
+            element = item(r,c) ;
+            os << fixed << right;
+            os <<"<td" << ((markDiag && r==c)? " class=\"diag\">" : ">");
+            if ( ( element == RAND_MAX ) && printInfinity) {
+                // print inf symbol instead of RAND_MAX (distances matrix).
+                os << infinity;
+            }
+            else {
+                os << element ;
+            }
+            os << "</td>";
+        }
+
+        os <<"</tr>";
+    }
+    os << "</tbody></table>";
+
+
+    os << qSetFieldWidth(0) << endl ;
+
+
+    os << "<p>"
+       << "<span class=\"info\">"
+       << ("Values: ")
+       <<"</span>"
+       << ( (hasRealNumbers) ? ("real numbers (printed decimals 3)") : ("integers only" ) )
+       << "<br />"
+       << "<span class=\"info\">"
+       << ("- Max value: ")
+       <<"</span>"
+       << ( ( maxVal==RAND_MAX ) ?
+                ( (printInfinity) ? infinity : QString::number(maxVal) ) +
+                " (=not connected nodes, in distance matrix)" : QString::number(maxVal) )
+       << "<br />"
+       << "<span class=\"info\">"
+       << ("- Min value: ")
+       <<"</span>"
+       << ( ( minVal==RAND_MAX ) ?
+                ( (printInfinity) ? infinity : QString::number(minVal) ) +
+                + " (usually denotes unconnected nodes, in distance matrix)" : QString::number(minVal ) )
+       << "</p>";
+
+    return true;
+}
+
+
+
+
+/**
+ * @brief  Prints this matrix to stderr or stdout
+ * @return
+ */
+bool Matrix::printMatrixConsole(bool debug){
+    qDebug() << "Matrix::printMatrixConsole() - debug " << debug
+             << "matrix rows" << rows()<< "cols"<< cols();
+    QTextStream out ( (debug ? stderr : stdout) );
+
+    for (int r = 0; r < rows(); ++r) {
+        for (int c = 0; c < cols(); ++c) {
+            if ( item(r,c) < RAND_MAX  ) {
+                out <<  qSetFieldWidth(12) << qSetRealNumberPrecision(3)
+                     <<  forcepoint << fixed<<right
+                        << item(r,c);
+            }
+            else {
+                out <<  qSetFieldWidth(12) << qSetRealNumberPrecision(3)
+                     <<  forcepoint << fixed<<right
+                        << "x";
+            }
+
+//            QTextStream( (debug ? stderr : stdout) )
+//                    << ( (item(r,c) < RAND_MAX ) ? item(r,c) : INFINITY  )<<' ';
+        }
+        out <<qSetFieldWidth(0)<< endl;
+    }
+    return true;
+}
+
+
+/**
+ * @brief Checks if every element of this matrix is either 0 or 1,
+ * i.e. if it is the adjacency matrix of an unweighted network.
+ * Complexity: O(n^2)
+ * @return
+ */
+bool Matrix::isBinary(){
+    for (int r = 0; r < rows(); ++r) {
+        for (int c = 0; c < cols(); ++c) {
+            if ( item(r,c) != 0 && item(r,c) != 1 ) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+
+
+/**
+ * @brief  Checks if matrix is ill-defined (contains at least an inf element)
+ * @return
+ */
+bool Matrix::illDefined(){
+    qDebug() << "Matrix::illDefined() " ;
+
+    for (int r = 0; r < rows(); ++r) {
+        for (int c = 0; c < cols(); ++c) {
+            if ( item(r,c) < RAND_MAX  ) {
+            }
+            else {
+                qDebug() << "Matrix::illDefined() - matrix ill-defined: TRUE" ;
+                return true;
+
+            }
+        }
+    }
+    return false;
+}
+
+
+
+
+
+/**
+ * @brief SymmetricMatrix::SymmetricMatrix
+ * Default constructor - creates a symmetric matrix of given dimension,
+ * with all elements zero.
+ * Use resize(n) or zeroMatrix(n) to resize it
+ * @param dim
+ * @param singlePrecision  if true, elements are stored as float
+ */
+SymmetricMatrix::SymmetricMatrix (int dim, bool singlePrecision) :
+    m_cells(0), m_cellsF(0), m_dim(dim), m_singlePrecision(singlePrecision) {
+    allocate();
+}
+
+
+
+/**
+ * @brief SymmetricMatrix::SymmetricMatrix
+ * Copy constructor. Creates a SymmetricMatrix identical to b
+ * @param b
+ */
+SymmetricMatrix::SymmetricMatrix(const SymmetricMatrix &b) :
+    m_cells(0), m_cellsF(0), m_dim(b.m_dim), m_singlePrecision(b.m_singlePrecision) {
+    allocate();
+    if (m_singlePrecision) {
+        memcpy(m_cellsF, b.m_cellsF, packedSize() * sizeof(float) );
+    }
+    else {
+        memcpy(m_cells, b.m_cells, packedSize() * sizeof(qreal) );
+    }
+}
+
+
+
+/**
+ * @brief SymmetricMatrix::~SymmetricMatrix
+ * Destructor
+ */
+SymmetricMatrix::~SymmetricMatrix() {
+    clear();
+}
+
+
+
+/**
+ * @brief Copies the elements of symmetric matrix a to this matrix
+ * @param a
+ * @return
+ */
+SymmetricMatrix& SymmetricMatrix::operator = (const SymmetricMatrix & a) {
+    if (this != &a) {
+        clear();
+        m_dim = a.m_dim;
+        m_singlePrecision = a.m_singlePrecision;
+        allocate();
+        if (m_singlePrecision) {
+            memcpy(m_cellsF, a.m_cellsF, packedSize() * sizeof(float) );
+        }
+        else {
+            memcpy(m_cells, a.m_cells, packedSize() * sizeof(qreal) );
+        }
+    }
+    return *this;
+}
+
+
+
+/**
+ * @brief Allocates the packed storage for the current dimension and
+ * sets every element to zero.
+ */
+void SymmetricMatrix::allocate() {
+    m_cells = 0;
+    m_cellsF = 0;
+    if ( m_dim <= 0 ) {
+        return;
+    }
+    if (m_singlePrecision) {
+        m_cellsF = new (nothrow) float [ packedSize() ];
+        Q_CHECK_PTR( m_cellsF );
+    }
+    else {
+        m_cells = new (nothrow) qreal [ packedSize() ];
+        Q_CHECK_PTR( m_cells );
+    }
+    fillMatrix(0);
+}
+
+
+
+/**
+ * @brief Clears data
+ */
+void SymmetricMatrix::clear() {
+    delete [] m_cells;
+    delete [] m_cellsF;
+    m_cells = 0;
+    m_cellsF = 0;
+    m_dim = 0;
+}
+
+
+
+/**
+ * @brief Resizes this matrix to n x n. All elements are set to zero.
+ * @param n
+ * @param singlePrecision
+ */
+void SymmetricMatrix::resize (const int n, const bool singlePrecision) {
+    qDebug() << "SymmetricMatrix::resize() - n" << n
+             << "singlePrecision" << singlePrecision;
+    clear();
+    m_dim = n;
+    m_singlePrecision = singlePrecision;
+    allocate();
+}
+
+
+
+/**
+ * @brief Switches the storage of this matrix to single or double precision.
+ * If the precision changes, the matrix keeps its size but all elements are
+ * set to zero, so call it before computing the matrix.
+ * @param singlePrecision
+ */
+void SymmetricMatrix::setSinglePrecision(const bool &singlePrecision) {
+    if ( singlePrecision != m_singlePrecision ) {
+        resize(m_dim, singlePrecision);
+    }
+}
+
+
+
+/**
+ * @brief Makes this matrix the zero matrix of size nxn, keeping the
+ * current precision.
+ * @param n
+ */
+void SymmetricMatrix::zeroMatrix(const int n) {
+    resize(n, m_singlePrecision);
+}
+
+
+
+/**
+ * @brief Sets every element to value
+ * @param value
+ */
+void SymmetricMatrix::fillMatrix(qreal value) {
+    const qint64 elements = packedSize();
+    for (qint64 p = 0 ; p < elements ; p++ ) {
+        if (m_singlePrecision) {
+            m_cellsF[p] = ( value == RAND_MAX ) ? std::numeric_limits<float>::infinity() : (float) value;
+        }
+        else {
+            m_cells[p] = value;
+        }
+    }
+}
+
+
+
+/**
+ * @brief Returns the (r,c) matrix element, which is the same as (c,r)
+ * @param r
+ * @param c
+ * @return
+ */
+qreal SymmetricMatrix::item( int r, int c ){
+    if (m_singlePrecision) {
+        const float value = m_cellsF[ index(r,c) ];
+        return ( value == std::numeric_limits<float>::infinity() ) ? RAND_MAX : value;
+    }
+    return m_cells[ index(r,c) ];
+}
+
 
-    qDebug()<< "Matrix::distancesMatrix() -"
-            <<"metric"<< metric
-            << "varLocation"<< varLocation
-            << "diagonal"<<diagonal;
 
-    int N = 0;
-    qreal sum = 0;
-    qreal distance = 0;
-    qreal distTemp = 0;
-    qreal ties = 0;
-    qreal max = 0 ; // for Chebyshev metric
-    if (varLocation=="Rows") {
+/**
+ * @brief Sets both the (r,c) and the (c,r) matrix element
+ * @param r
+ * @param c
+ * @param elem
+ */
+void SymmetricMatrix::setItem( const int r, const int c, const qreal elem ) {
+    if (m_singlePrecision) {
+        m_cellsF[ index(r,c) ] = ( elem == RAND_MAX ) ? std::numeric_limits<float>::infinity() : (float) elem;
+    }
+    else {
+        m_cells[ index(r,c) ] = elem;
+    }
+}
 
-        N = rows() ;
 
-        QVector<qreal> mean (N,0); // holds mean values
 
-        qDebug()<< "Matrix::distancesMatrix() - input matrix:";
-        //this->printMatrixConsole();
+/**
+ * @brief finds Min-Max values in current matrix
+ * @param min value in the matrix
+ * @param max value
+ * Complexity: O(n^2/2)
+ */
+void SymmetricMatrix::findMinMaxValues (qreal &min, qreal & max, bool &hasRealNumbers){
+    max=0;
+    min=RAND_MAX;
+    hasRealNumbers = false;
+    for (int r = 0; r < rows(); ++r) {
+        for (int c = r; c < cols(); ++c) {
+            const qreal value = item(r,c);
+            if ( fmod (value, 1.0)  != 0 )  {
+                hasRealNumbers = true;
+            }
+            if ( value > max) {
+                max = value ;
+            }
+            if ( value < min){
+                min = value ;
+            }
+        }
+    }
+}
 
-        for (int i = 0 ; i < N ; i++ ) {
-            sum = 0 ;
-            for (int k = i ; k < N ; k++ ) {
-                distTemp = 0;
-                ties = 0;
-                max = 0;
-                for (int j = 0 ; j < N ; j++ ) {
 
-//                    qDebug() <<  "(i,j)" << i<< ","<<j << "(k,j)" << k<<","<<j;
 
-                    if (!diagonal && (i==j || k==j)) {
-                        continue;
-                    }
+/**
+ * @brief Like SymmetricMatrix::findMinMaxValues only it skips r==c
+ * Returns the same elements as Matrix::NeighboursNearestFarthest would,
+ * always with imin < jmin and imax < jmax.
+ * @param min value. If (r,c) = minimum, it mean that neighbors r and c are the nearest in the matrix/network
+ * @param max value
+ * Complexity: O(n^2/2)
+ */
+void SymmetricMatrix::NeighboursNearestFarthest (qreal &min, qreal & max,
+                                                 int &imin, int &jmin,
+                                                 int &imax, int &jmax){
+    max=0;
+    min=RAND_MAX;
+    for (int r = 0; r < rows(); ++r) {
+        for (int c = r+1; c < cols(); ++c) {
+            const qreal value = item(r,c);
+            if ( value > max) {
+                max = value ;
+                imax = r; jmax=c;
+            }
+            if ( value < min){
+                min = value ;
+                imin = r; jmin=c;
+            }
+        }
+    }
+}
 
-                    switch (metric) {
-                    case METRIC_JACCARD_INDEX:
-                        if (item(i,j) == item(k,j)  && (item(i,j) != 0 && item(i,j) != RAND_MAX)) {
-                            distTemp++;
-                        }
-                        if ( ( item(i,j) != 0 && item(i,j) != RAND_MAX ) ||
-                             ( item(k,j) != 0 && item(k,j) != RAND_MAX )) {
-                           ties++;
-                        }
-                        break;
-                    case METRIC_HAMMING_DISTANCE:
-                        if (item(i,j) != item(k,j) ) {
-                            distTemp++;
-                        }
-                        break;
-                    case METRIC_EUCLIDEAN_DISTANCE:
-                        if (item(i,j) == RAND_MAX || item(k,j) == RAND_MAX || distTemp == RAND_MAX) {
-                            distTemp = RAND_MAX;
-                        }
-                        else {
-//                            qDebug() <<  item(i,j) << "-" << item(k,j) <<"^2";
-                            distTemp += ( item(i,j) - item(k,j) )*( item(i,j) - item(k,j) ); //compute (x - y)^2
-                        }
-                        break;
-                    case METRIC_MANHATTAN_DISTANCE:
-                        if (item(i,j) == RAND_MAX || item(k,j) == RAND_MAX || distTemp == RAND_MAX ) {
-                            distTemp = RAND_MAX;
-                        }
-                        else {
-                            distTemp += fabs( item(i,j) - item(k,j) ); //compute |x - y|
-                        }
-                        break;
-                    case METRIC_CHEBYSHEV_MAXIMUM:
-                        if (item(i,j) == RAND_MAX || item(k,j) == RAND_MAX || distTemp == RAND_MAX) {
-                            distTemp = RAND_MAX;
-                            max = RAND_MAX;
-                        }
-                        else {
-                            distTemp =  fabs( item(i,j) - item(k,j) );
-                            max = ( distTemp  > max ) ? distTemp : max;
-                            distTemp = max;
-                        }
-                        break;
-                    default:
-                        break;
-                    }
 
-                }
 
-                switch (metric) {
-                case METRIC_JACCARD_INDEX:
-                    if (ties!=0)
-                        distance =  1 -  distTemp/  (  ties ) ;
-                    else
-                        distance = 1;
-                    break;
-                case METRIC_HAMMING_DISTANCE:
-                    distance = distTemp;
-                    break;
-                case METRIC_EUCLIDEAN_DISTANCE:
-                     distance = (distTemp == RAND_MAX) ? distTemp : sqrt(distTemp);
-                     break;
-                case METRIC_MANHATTAN_DISTANCE:
-                    distance = distTemp ;
-                    break;
-                case METRIC_CHEBYSHEV_MAXIMUM:
-                    distance = distTemp ;
-                    break;
-                default:
-                    break;
-                }
+/**
+ * @brief Deletes row and column and shifts rows and cols accordingly
+ * @param erased row/col to delete
+ */
+void SymmetricMatrix::deleteRowColumn(int erased){
+    qDebug() << "SymmetricMatrix:deleteRowColumn() - will delete row and column"
+             << erased
+             << "m_dim before" <<  m_dim;
 
+    SymmetricMatrix T(m_dim - 1, m_singlePrecision);
+    for (int i = 0 ; i < m_dim - 1 ; i++ ) {
+        for (int j = i ; j < m_dim - 1 ; j++ ) {
+            T.setItem(i, j, item( (i < erased) ? i : i + 1,
+                                  (j < erased) ? j : j + 1 ) );
+        }
+    }
+    *this = T;
+}
 
-//                qDebug() << "distTemp("<<i+1<<","<<k+1<<") =" << distTemp
-//                         << "matchRatio("<<i+1<<","<<k+1<<") =" << distance;
 
-                T->setItem(i,k, distance);
-                T->setItem(k,i, distance);
 
-                sum += distance;
+/**
+ * @brief Copies the square matrix A to this matrix, which is resized
+ * accordingly. By default only the upper triangle of A is read, so A must
+ * be symmetric. If minOfPair is true, each element is the minimum of
+ * A(r,c) and A(c,r), which symmetrizes an asymmetric A, i.e. the distances
+ * of a directed graph.
+ * @param A
+ * @param minOfPair
+ */
+void SymmetricMatrix::fromMatrix(Matrix &A, const bool &minOfPair) {
+    resize(A.rows(), m_singlePrecision);
+    for (int r = 0; r < m_dim; ++r) {
+        for (int c = r; c < m_dim; ++c) {
+            if ( minOfPair ) {
+                setItem(r, c, qMin( A.item(r,c), A.item(c,r) ) );
+            }
+            else {
+                setItem(r, c, A.item(r,c) );
             }
-            //compute mean match value
-            mean[i] = sum / ( N ) ;
-
         }
-
     }
-    else if (varLocation=="Columns") {
+}
 
-        N = rows() ;
 
-        QVector<qreal> mean (N,0); // holds mean values
 
-        qDebug()<< "Matrix::distancesMatrix() -"
-                <<"input matrix";
-        //printMatrixConsole(true);
+/**
+ * @brief Expands this matrix to the full (square) matrix A
+ * @param A
+ */
+void SymmetricMatrix::toMatrix(Matrix &A) {
+    A.resize(m_dim, m_dim);
+    for (int r = 0; r < m_dim; ++r) {
+        for (int c = r; c < m_dim; ++c) {
+            const qreal value = item(r,c);
+            A.setItem(r, c, value);
+            A.setItem(c, r, value);
+        }
+    }
+}
 
-        for (int i = 0 ; i < N ; i++ ) {
-            sum = 0 ;
-            for (int k = i ; k < N ; k++ ) {
-                distTemp = 0;
-                ties = 0;
-                max = 0;
-                for (int j = 0 ; j < N ; j++ ) {
 
-                    if (!diagonal && (i==j || k==j))
-                        continue;
 
+/**
+ * @brief  Checks if matrix is ill-defined (contains at least an inf element)
+ * @return
+ */
+bool SymmetricMatrix::illDefined(){
+    for (int r = 0; r < rows(); ++r) {
+        for (int c = r; c < cols(); ++c) {
+            if ( item(r,c) == RAND_MAX ) {
+                qDebug() << "SymmetricMatrix::illDefined() - matrix ill-defined: TRUE" ;
+                return true;
+            }
+        }
+    }
+    return false;
+}
 
-                    switch (metric) {
-                    case METRIC_JACCARD_INDEX:
-                        if (item(j,i) == item(j,k)  && (item(j,i) != 0 && item(j,i) != RAND_MAX)) {
-                            distTemp++;
-                        }
-                        if ( ( item(j,i) != 0 && item(j,i) != RAND_MAX ) ||
-                             ( item(j,k) != 0 && item(j,k) != RAND_MAX )) {
-                           ties++;
-                        }
-                        break;
-                    case METRIC_HAMMING_DISTANCE:
-                        if (item(j,i) != item(j,k) ) {
-                            distTemp++;
-                        }
-                        break;
-                    case METRIC_EUCLIDEAN_DISTANCE:
-                        if (item(j,i) == RAND_MAX || item(j,k) == RAND_MAX || distTemp == RAND_MAX) {
-                            distTemp = RAND_MAX;
-                        }
-                        else {
-                            distTemp += ( item(j,i) - item(j,k) )*( item(j,i) - item(j,k) ); //compute (x - y)^2
-                        }
-                        break;
-                    case METRIC_MANHATTAN_DISTANCE:
-                        if (item(j,i) == RAND_MAX || item(j,k) == RAND_MAX || distTemp == RAND_MAX ) {
-                            distTemp = RAND_MAX;
-                        }
-                        else {
-                            distTemp += fabs( item(j,i) - item(j,k) ); //compute |x - y|
-                        }
-                        break;
-                    case METRIC_CHEBYSHEV_MAXIMUM:
-                        if (item(j,i) == RAND_MAX || item(j,k) == RAND_MAX || distTemp == RAND_MAX) {
-                            distTemp = RAND_MAX;
-                            max = RAND_MAX;
-                        }
-                        else {
-                            distTemp =  fabs( item(j,i) - item(j,k) );
-                            max = ( distTemp  > max ) ? distTemp : max;
-                            distTemp = max;
-                        }
-                        break;
-                    default:
-                        break;
-                    }
-                }
 
-                switch (metric) {
-                case METRIC_JACCARD_INDEX:
-                    if (ties!=0)
-                        distance =  1 -  distTemp/  (  ties ) ;
-                    else
-                        distance = 1;
-                    break;
-                case METRIC_HAMMING_DISTANCE:
-                    distance = distTemp;
-                    break;
-                case METRIC_EUCLIDEAN_DISTANCE:
-                     distance = (distTemp == RAND_MAX) ? distTemp : sqrt(distTemp);
-                     break;
-                case METRIC_MANHATTAN_DISTANCE:
-                    distance = distTemp ;
-                    break;
-                case METRIC_CHEBYSHEV_MAXIMUM:
-                    distance = distTemp ;
-                    break;
-                default:
-                    break;
-                }
 
+/**
+ * @brief Computes the symmetric product X * X^T (a rank-k update) into
+ * this symmetric matrix, which is resized to n x n for the given n x k
+ * matrix X.
+ *
+ * The work is split in square tiles of the upper triangle, which are
+ * computed in parallel. Each tile walks the rows of X in blocks that fit
+ * in cache. Only the upper triangle is computed and stored.
+ * @param X
+ */
+void SymmetricMatrix::productByTranspose(Matrix &X) {
 
-//                qDebug() << "distTemp("<<i+1<<","<<k+1<<") =" << distTemp
+    const int n = X.rows();
+    const int k = X.cols();
+    const int tile = 64;     // variables (rows of X) per tile
+    const int block = 256;   // observations (columns of X) per pass
 
-//                         << "distance("<<i+1<<","<<k+1<<") =" << distance;
+    qDebug()<< "SymmetricMatrix::productByTranspose() - X" << n << "x" << k;
 
-                T->setItem(i,k, distance);
-                T->setItem(k,i, distance);
+    zeroMatrix(n);
 
-                sum += distance;
-            }
-            //compute mean match value
-            mean[i] = sum / ( N ) ;
+    const int tiles = (n + tile - 1) / tile;
 
+    QVector< QPair<int,int> > tilePairs;
+    for (int ti = 0 ; ti < tiles ; ti++ ) {
+        for (int tk = ti ; tk < tiles ; tk++ ) {
+            tilePairs.append( qMakePair(ti, tk) );
         }
-
     }
-    else if (varLocation=="Both") {
-        Matrix CM;
-        N = rows() ;
-        int M = N * 2; // CM will have double rows
-
-        CM.zeroMatrix(M,N);
 
-        QVector<qreal> mean (N,0); // holds mean values
-
-        //create augmented matrix (concatenated rows and columns) from input matrix
-        for (int i = 0 ; i < N  ; i++ ) {
-            for (int j = 0 ; j < N  ; j++ ) {
-                CM.setItem(j,i, item(i,j));
-                CM.setItem(j + N,i, item(j,i));
+    QtConcurrent::blockingMap(tilePairs, [&](const QPair<int,int> &t) {
+        const int iFrom = t.first * tile;
+        const int iTo = qMin(iFrom + tile, n);
+        const int kFrom = t.second * tile;
+        const int kTo = qMin(kFrom + tile, n);
+
+        for (int jFrom = 0 ; jFrom < k ; jFrom += block ) {
+            const int jTo = qMin(jFrom + block, k);
+            for (int i = iFrom ; i < iTo ; i++ ) {
+                const qreal *xi = &X[i][0];
+                for (int r = qMax(kFrom, i) ; r < kTo ; r++ ) {
+                    const qreal *xr = &X[r][0];
+                    qreal s0 = 0, s1 = 0, s2 = 0, s3 = 0;
+                    int j = jFrom;
+                    for ( ; j + 3 < jTo ; j += 4 ) {
+                        s0 += xi[j] * xr[j];
+                        s1 += xi[j+1] * xr[j+1];
+                        s2 += xi[j+2] * xr[j+2];
+                        s3 += xi[j+3] * xr[j+3];
+                    }
+                    for ( ; j < jTo ; j++ ) {
+                        s0 += xi[j] * xr[j];
+                    }
+                    setItem(i, r, item(i,r) + (s0 + s1) + (s2 + s3) );
+                }
             }
         }
+    });
+}
 
-        qDebug()<< "Matrix::distancesMatrix() -"
-                <<"input matrix";
-        //CM.printMatrixConsole(true);
-
-
-        for (int i = 0 ; i < N ; i++ ) {
 
-            for (int k = i ; k < N ; k++ ) {
 
-                distTemp = 0;
-                ties = 0;
-                max = 0;
-                for (int j = 0 ; j < M ; j++ ) {
+/**
+ * @brief Computes the dissimilarities matrix of the variables (rows, columns, both)
+ * of this matrix using the user defined metric
+ *
+ * The variables are copied to a contiguous buffer once and every pair i<=k
+ * is compared with a vectorised distance kernel (AVX, SSE2 or NEON,
+ * depending on the target, with a scalar fallback). Skipped cells
+ * (diagonal==false) split each comparison in segments, so they do not
+ * need to be tested per element. Rows of the result are computed in
+ * parallel into the packed upper triangle of this matrix.
+ *
+ * In Euclidean, Manhattan and Chebyshev metrics, the distance of a pair is
+ * infinite (RAND_MAX) if any compared element is infinite. In Jaccard,
+ * infinite elements are not ties.
+ * @param INPUT
+ * @param metric
+ * @param varLocation
+ * @param diagonal
+ * @param considerWeights
+ * @return
+ */
+SymmetricMatrix& SymmetricMatrix::distancesMatrix(Matrix &INPUT,
+                                                  const int &metric,
+                                                  const QString varLocation,
+                                                  const bool &diagonal,
+                                                  const bool &considerWeights) {
+    Q_UNUSED(considerWeights);
 
-                    if (!diagonal) {
-                        if ( (i==j || k==j ))
-                            continue;
-                        if ( j>=N && ( (i+N)==j || (k+N)==j ))
-                            continue;
-                    }
+    zeroMatrix(INPUT.rows());
 
-                    switch (metric) {
-                    case METRIC_JACCARD_INDEX:
-                        if (CM.item(j,i) == CM.item(j,k)  && (CM.item(j,i) != 0 && CM.item(j,i) != RAND_MAX)) {
-                            distTemp++;
-                        }
-                        if ( ( CM.item(j,i) != 0 && CM.item(j,i) != RAND_MAX ) ||
-                             ( CM.item(j,k) != 0 && CM.item(j,k) != RAND_MAX )) {
-                           ties++;
-                        }
-                        break;
-                    case METRIC_HAMMING_DISTANCE:
-                        if (  CM.item(j,i) != CM.item(j,k) ) {
-                            distTemp++;
-                        }
-                        break;
-                    case METRIC_EUCLIDEAN_DISTANCE:
-                        if ( CM.item(j,i) == RAND_MAX || CM.item(j,k) == RAND_MAX || distTemp == RAND_MAX) {
-                            distTemp = RAND_MAX;
-                        }
-                        else {
-                            distTemp += ( CM.item(j,i) - CM.item(j,k) )*( CM.item(j,i) - CM.item(j,k) ); //compute (x - y)^2
-                        }
-                        break;
-                    case METRIC_MANHATTAN_DISTANCE:
-                        if ( CM.item(j,i) == RAND_MAX || CM.item(j,k) == RAND_MAX || distTemp == RAND_MAX ) {
-                            distTemp = RAND_MAX;
-                        }
-                        else {
-                            distTemp += fabs( CM.item(j,i) - CM.item(j,k) ); //compute |x - y|
-                        }
-                        break;
-                    case METRIC_CHEBYSHEV_MAXIMUM:
-                        if ( CM.item(j,i) == RAND_MAX || CM.item(j,k) == RAND_MAX || distTemp == RAND_MAX) {
-                            distTemp = RAND_MAX;
-                            max = RAND_MAX;
-                        }
-                        else {
-                            distTemp =  fabs( CM.item(j,i) - CM.item(j,k) );
-                            max = ( distTemp  > max ) ? distTemp : max;
-                            distTemp = max;
-                        }
-                        break;
-                    default:
-                        break;
-                    }
+    qDebug()<< "SymmetricMatrix::distancesMatrix() -"
+            <<"metric"<< metric
+            << "varLocation"<< varLocation
+            << "diagonal"<<diagonal;
 
-                }
+    switch (metric) {
+    case METRIC_JACCARD_INDEX:
+    case METRIC_HAMMING_DISTANCE:
+    case METRIC_EUCLIDEAN_DISTANCE:
+    case METRIC_MANHATTAN_DISTANCE:
+    case METRIC_CHEBYSHEV_MAXIMUM:
+        break;
+    default:
+        return *this;
+    }
 
+    if (varLocation!="Rows" && varLocation!="Columns" && varLocation!="Both") {
+        return *this;
+    }
 
-                switch (metric) {
-                case METRIC_JACCARD_INDEX:
-                    if (ties!=0)
-                        distance =  1 -  distTemp/  (  ties ) ;
-                    else
-                        distance = 1;
-                    break;
-                case METRIC_HAMMING_DISTANCE:
-                    distance = distTemp;
-                    break;
-                case METRIC_EUCLIDEAN_DISTANCE:
-                     distance = (distTemp == RAND_MAX) ? distTemp : sqrt(distTemp);
-                     break;
-                case METRIC_MANHATTAN_DISTANCE:
-                    distance = distTemp ;
-                    break;
-                case METRIC_CHEBYSHEV_MAXIMUM:
-                    distance = distTemp ;
-                    break;
-                default:
-                    break;
+    const int N = INPUT.rows();
+    const bool both = (varLocation=="Both");
+    const int L = (both) ? 2 * N : N;   // elements per variable
+    const bool infinityMatters = ( metric == METRIC_EUCLIDEAN_DISTANCE
+                                   || metric == METRIC_MANHATTAN_DISTANCE
+                                   || metric == METRIC_CHEBYSHEV_MAXIMUM );
+
+    // variable i occupies data[i*L, (i+1)*L)
+    QVector<double> data (N * L, 0);
+    QVector<int> infinite (N, 0);    // infinite elements of each variable
+
+    for (int i = 0 ; i < N ; i++ ) {
+        for (int j = 0 ; j < L ; j++ ) {
+            qreal value = 0;
+            if (varLocation=="Rows") {
+                value = INPUT.item(i,j);
+            }
+            else if (varLocation=="Columns") {
+                value = INPUT.item(j,i);
+            }
+            else {
+                value = ( j < N ) ? INPUT.item(i,j) : INPUT.item(j-N,i);
+            }
+            if ( value == RAND_MAX ) {
+                infinite[i]++;
+                if ( metric == METRIC_JACCARD_INDEX ) {
+                    value = 0;
                 }
+            }
+            data[i*L + j] = value;
+        }
+    }
+
+    QVector<int> rowIndex(N);
+    for (int i = 0 ; i < N ; i++ ) {
+        rowIndex[i] = i;
+    }
+
+    QtConcurrent::blockingMap(rowIndex, [&](const int &i) {
 
+        const double *x = data.constData() + i*L;
+        int excluded[4];
 
+        for (int k = i ; k < N ; k++ ) {
 
-//                qDebug() << "distTemp("<<i+1<<","<<k+1<<") =" << distTemp
+            const double *y = data.constData() + k*L;
+
+            // skipped positions, in ascending order
+            int e = 0;
+            if (!diagonal) {
+                excluded[e++] = i;
+                if (k != i) excluded[e++] = k;
+                if (both) {
+                    excluded[e++] = N + i;
+                    if (k != i) excluded[e++] = N + k;
+                }
+            }
 
-//                         << "matchRatio("<<i+1<<","<<k+1<<") =" << distance;
+            qreal distance = 0;
 
-                T->setItem(i,k, distance);
-                T->setItem(k,i, distance);
+            if ( infinityMatters ) {
+                int inf = infinite[i] + infinite[k];
+                for (int p = 0; p < e; p++) {
+                    if ( x[excluded[p]] == RAND_MAX ) inf--;
+                    if ( y[excluded[p]] == RAND_MAX ) inf--;
+                }
+                if ( inf > 0 ) {
+                    setItem(i,k, RAND_MAX);
+                    continue;
+                }
+            }
 
-                sum += distance;
+            double sum = 0;
+            int count = 0;
+            int ties = 0;
+            int from = 0;
+            for (int p = 0; p < e; p++) {
+                distanceKernel(metric, x + from, y + from,
+                               excluded[p] - from, sum, count, ties);
+                from = excluded[p] + 1;
+            }
+            distanceKernel(metric, x + from, y + from, L - from, sum, count, ties);
 
+            switch (metric) {
+            case METRIC_JACCARD_INDEX:
+                if (ties!=0)
+                    distance =  1 - (qreal) count / (qreal) ties ;
+                else
+                    distance = 1;
+                break;
+            case METRIC_HAMMING_DISTANCE:
+                distance = count;
+                break;
+            case METRIC_EUCLIDEAN_DISTANCE:
+                distance = sqrt(sum);
+                break;
+            case METRIC_MANHATTAN_DISTANCE:
+            case METRIC_CHEBYSHEV_MAXIMUM:
+                distance = sum;
+                break;
+            default:
+                break;
             }
-            //compute mean match value
-            mean[i] = sum / ( N ) ;
 
+            setItem(i,k, distance);
         }
-    }
-    else {
+    });
 
-    }
-    qDebug() << "Matrix::distancesMatrix() - FINISHED - Returning matrix:";
-    //T->printMatrixConsole();
-    return *T;
+    qDebug() << "SymmetricMatrix::distancesMatrix() - FINISHED";
+    return *this;
 }
 
 
 
-
 /**
  * @brief  Computes the pair-wise matching score of the rows, columns
  * or both of the given matrix AM, based on the given matching measure
  * and returns the similarity matrix.
  * @param AM Matrix
- * @return Matrix nxn with matching scores for every pair of rows/columns of AM
+ * @return SymmetricMatrix nxn with matching scores for every pair of rows/columns of AM
  */
 
-Matrix& Matrix::similarityMatrix(Matrix &AM,
-                                   const int &measure,
-                                   const QString varLocation,
-                                   const bool &diagonal,
-                                   const bool &considerWeights){
+SymmetricMatrix& SymmetricMatrix::similarityMatrix(Matrix &AM,
+                                                   const int &measure,
+                                                   const QString varLocation,
+                                                   const bool &diagonal,
+                                                   const bool &considerWeights){
 
     Q_UNUSED(considerWeights);
 
-    qDebug()<< "Matrix::similarityMatrix() -"
+    qDebug()<< "SymmetricMatrix::similarityMatrix() -"
             <<"measure"<< measure
             << "varLocation"<< varLocation;
 
+    // Binary tie profiles (unweighted networks) take the bitset fast path
+    if ( similarityMatrixBinary(AM, measure, varLocation, diagonal) ) {
+        return *this;
+    }
+
     int N = 0;
     qreal sum = 0;
     qreal matchRatio = 0;
@@ -1766,11 +2673,11 @@ Matrix& Matrix::similarityMatrix(Matrix &AM,
 
         N = AM.rows() ;
 
-        this->zeroMatrix(N,N);
+        this->zeroMatrix(N);
 
         QVector<qreal> mean (N,0); // holds mean values
 
-        qDebug()<< "Matrix::similarityMatrix() -"
+        qDebug()<< "SymmetricMatrix::similarityMatrix() -"
                 <<"input matrix";
         //AM.printMatrixConsole(true);
 
@@ -1853,7 +2760,6 @@ Matrix& Matrix::similarityMatrix(Matrix &AM,
 
                          << "matchRatio("<<i+1<<","<<k+1<<") =" << matchRatio;
                 setItem(i,k, matchRatio);
-                setItem(k,i, matchRatio);
 
                 sum += matchRatio;
             }
@@ -1867,11 +2773,11 @@ Matrix& Matrix::similarityMatrix(Matrix &AM,
 
         N = AM.rows() ;
 
-        this->zeroMatrix(N,N);
+        this->zeroMatrix(N);
 
         QVector<qreal> mean (N,0); // holds mean values
 
-        qDebug()<< "Matrix::similarityMatrix() -"
+        qDebug()<< "SymmetricMatrix::similarityMatrix() -"
                 <<"input matrix";
         //AM.printMatrixConsole(true);
 
@@ -1954,7 +2860,6 @@ Matrix& Matrix::similarityMatrix(Matrix &AM,
 
                          << "matchRatio("<<i+1<<","<<k+1<<") =" << matchRatio;
                 setItem(i,k, matchRatio);
-                setItem(k,i, matchRatio);
 
                 sum += matchRatio;
             }
@@ -1969,7 +2874,7 @@ Matrix& Matrix::similarityMatrix(Matrix &AM,
         N = AM.rows() ;
         int M = N * 2; // CM will have double rows
 
-        this->zeroMatrix(N,N);
+        this->zeroMatrix(N);
         CM.zeroMatrix(M,N);
 
         QVector<qreal> mean (N,0); // holds mean values
@@ -1982,7 +2887,7 @@ Matrix& Matrix::similarityMatrix(Matrix &AM,
                 CM.setItem(j + N,i, AM.item(j,i));
             }
         }
-        qDebug()<< "Matrix::similarityMatrix() -"
+        qDebug()<< "SymmetricMatrix::similarityMatrix() -"
                 <<"input matrix";
         //CM.printMatrixConsole(true);
 
@@ -2070,7 +2975,6 @@ Matrix& Matrix::similarityMatrix(Matrix &AM,
 
                          << "matchRatio("<<i+1<<","<<k+1<<") =" << matchRatio;
                 setItem(i,k, matchRatio);
-                setItem(k,i, matchRatio);
 
                 sum += matchRatio;
 
@@ -2086,606 +2990,338 @@ Matrix& Matrix::similarityMatrix(Matrix &AM,
 
     return *this;
 
-}
-
-
-
-
-/**
- * @brief  Computes the Pearson Correlation Coefficient of the rows or the columns
- * of the given matrix AM
- * @param AM Matrix
- * @return Matrix nxn with PPC values for every pair of rows/columns of AM
- */
-Matrix& Matrix::pearsonCorrelationCoefficients(Matrix &AM,
-                                               const QString &varLocation,
-                                               const bool &diagonal){
-    qDebug()<< "Matrix::pearsonCorrelationCoefficients() -"
-            << "varLocation"<< varLocation;
-
-    int N = 0;
-    qreal sumi = 0;
-    qreal sumk = 0;
-    qreal varianceTimesNi = 0; // = sqrDeviationsFromMean
-    qreal varianceTimesNk = 0; // = sqrDeviationsFromMean
-    qreal covariance = 0;
-    qreal pcc = 0;
-
-
-    if (varLocation=="Rows") {
-
-        N = AM.rows() ;
-
-        this->zeroMatrix(N,N);
-
-        QVector<qreal> mean (N,0); // holds mean values
-        QVector<qreal> sigma(N,0);
-        qDebug()<< "Matrix::pearsonCorrelationCoefficients() -"
-                <<"input matrix";
-        //AM.printMatrixConsole(true);
-
-        for (int i = 0 ; i < N ; i++ ) {
-
-            for (int k = i ; k < N ; k++ ) {
-
-                qDebug() << "comparing rows i"<<i+1<<"k"<<k+1;
-
-                // compute mean and variance  values
-                sumi = 0;
-                sumk = 0;
-                for (int j = 0 ; j < N ; j++ ) {
-                    if (!diagonal && ( i==j || k==j ) )
-                        continue;
-                    sumi += AM.item(i,j);
-                    sumk += AM.item(k,j);
-                }
-                mean[i] = sumi / ( (diagonal) ? (qreal) N : (qreal) (N-2) ) ;
-                mean[k] = sumk / ( (diagonal) ? (qreal) N : (qreal) (N-2) ) ;
-                varianceTimesNi = 0;
-                varianceTimesNk = 0;
-                for (int j = 0 ; j < N ; j++ ) {
-                    if (!diagonal && ( i==j || k==j ) )
-                        continue;
-                    varianceTimesNi +=  ( AM.item(i,j)  - mean[i] ) *  ( AM.item(i,j)  - mean[i] );
-                    varianceTimesNk +=  ( AM.item(k,j)  - mean[k] ) *  ( AM.item(k,j)  - mean[k] );
-                }
-                sigma[i] = sqrt (varianceTimesNi); //actually this is sigma * sqrt (N)
-                sigma[k] = sqrt (varianceTimesNk); //actually this is sigma * sqrt (N)
-
-
-                covariance = 0;
-
-                for (int j = 0 ; j < N ; j++ ) {
-
-                    qDebug() << "AM.item(i,j)=AM.item("<<i+1<<","<<j+1<<") = "<<AM.item(i,j)
-                             << " mean(i)=mean("<<i+1<<") = "<<mean[i]
-                                << "AM.item(k,j)=AM.item("<<k+1<<","<<j+1<<") = "<<AM.item(k,j)
-                                << " mean(k)=mean("<<k+1<<") = "<<mean[k];
-
-                    if (!diagonal && (i==j ) ) {
-                        qDebug() << "skipping because i"<<i+1<<"k"<<k+1 <<"j"<<j+1;
-                        continue;
-                    }
-                    if (!diagonal && (k==j) ) {
-                        qDebug() << "skipping because i"<<i+1<<"k"<<k+1 <<"j"<<j+1;
-                        continue;
-                    }
-                    else
-                        covariance  +=  ( AM.item(i,j)  - mean[i] ) * ( AM.item(k,j)  - mean[k] ) ;
-                }
-
-
-                if ( ( sigma[i] != 0 ) && ( sigma[k] != 0  ) ) {
-                    pcc =   covariance   /  (( sigma[i] ) * ( sigma[k] )) ;
-                }
-                else {
-                    pcc = 0;
-                }
-
-
-                qDebug() << "covariance("<<i+1<<","<<k+1<<") =" << covariance
-                         << "sigma["<<i+1<<"]" << sigma[i]
-                         << "sigma["<<k+1<<"]" << sigma[k]
-                         << "pcc("<<i+1<<","<<k+1<<") =" << pcc;
-                setItem(i,k, pcc);
-                setItem(k,i, pcc);
-            }
-
-        }
-
-    }
-    else if (varLocation=="Columns") {
-
-
-        N = AM.rows() ;
-
-        this->zeroMatrix(N,N);
-
-        QVector<qreal> mean (N,0); // holds mean values
-        QVector<qreal> sigma(N,0);
-
-        qDebug()<< "Matrix::pearsonCorrelationCoefficients() -"
-                <<"input matrix";
-        //AM.printMatrixConsole(true);
-
-
-        for (int i = 0 ; i < N ; i++ ) {
-
-            for (int k = i ; k < N ; k++ ) {
-
-                qDebug() << "comparing columns i"<<i+1<<"k"<<k+1;
-
-                // compute mean and variance  values
-                sumi = 0;
-                sumk = 0;
-                for (int j = 0 ; j < N ; j++ ) {
-                    if (!diagonal && ( i==j || k==j ) )
-                        continue;
-                    sumi += AM.item(j,i);
-                    sumk += AM.item(j,k);
-                }
-                mean[i] = sumi / ( (diagonal) ? (qreal) N : (qreal) (N-2) ) ;
-                mean[k] = sumk / ( (diagonal) ? (qreal) N : (qreal) (N-2) ) ;
-                varianceTimesNi = 0;
-                varianceTimesNk = 0;
-                for (int j = 0 ; j < N ; j++ ) {
-                    if (!diagonal && ( i==j || k==j ) )
-                        continue;
-                    varianceTimesNi +=  ( AM.item(j,i)  - mean[i] ) *  ( AM.item(j,i)  - mean[i] );
-                    varianceTimesNk +=  ( AM.item(j,k)  - mean[k] ) *  ( AM.item(j,k)  - mean[k] );
-                }
-                sigma[i] = sqrt (varianceTimesNi); //actually this is sigma * sqrt (N)
-                sigma[k] = sqrt (varianceTimesNk); //actually this is sigma * sqrt (N)
-
-                covariance = 0;
-                for (int j = 0 ; j < N ; j++ ) {
-                    if (!diagonal && (i==j || k==j) ) {
-                        qDebug() << "skipping because i"<<i+1<<"k"<<k+1 <<"j"<<j+1;
-                        continue;
-                    }
-                    covariance  +=  ( AM.item(j,i)  - mean[i] ) * ( AM.item(j,k)  - mean[k] ) ;
-                }
-
-
-                if ( ( sigma[i] != 0 ) && ( sigma[k] != 0  ) ) {
-                    pcc =   covariance   /  (( sigma[i] ) * ( sigma[k] )) ;
-                }
-                else {
-                    pcc = 0;
-                }
-
-
-                qDebug() << "covariance("<<i+1<<","<<k+1<<") =" << covariance
-                         << "sigma["<<i+1<<"]" << sigma[i]
-                         << "sigma["<<k+1<<"]" << sigma[k]
-                         << "pcc("<<i+1<<","<<k+1<<") =" << pcc;
-
-                setItem(i,k, pcc);
-                setItem(k,i, pcc);
-            }
-
-        }
-
-    }
-    else if (varLocation=="Both") {
-        Matrix CM;
-
-        N = AM.rows() ;
-
-        int M = N * 2; // CM will have double rows
-
-
-        this->zeroMatrix(N,N);
-
-        CM.zeroMatrix(M,N);
-
-        QVector<qreal> mean (N,0); // holds mean values
-        QVector<qreal> sigma(N,0);
-
-
-        //create augmented matrix (concatenated rows and columns) from input matrix
-        for (int i = 0 ; i < N  ; i++ ) {
-            for (int j = 0 ; j < N  ; j++ ) {
-                CM.setItem(j,i, AM.item(i,j));
-                CM.setItem(j + N,i, AM.item(j,i));
-            }
-        }
-
-        qDebug()<< "Matrix::pearsonCorrelationCoefficients() -"
-                <<"input matrix";
-        //CM.printMatrixConsole(true);
-
-
-        for (int i = 0 ; i < N ; i++ ) {  //a column
-
-            for (int k = i ; k < N ; k++ ) {  // next column
-
-               qDebug() << "comparing augmented columns i"<<i+1<<"k"<<k+1;
-
-                // compute mean and variance  values
-                sumi = 0;
-                sumk = 0;
-                for (int j = 0 ; j < M ; j++ ) {
-                    if (!diagonal && ( i==j || k==j || (i+N)==j || (k+N)==j  ) )
-                        continue;
-                    sumi += CM.item(j,i);
-                    sumk += CM.item(j,k);
-                }
-                mean[i] = sumi / ( (diagonal) ? (qreal) M : (qreal) (M-4) ) ;
-                mean[k] = sumk / ( (diagonal) ? (qreal) M : (qreal) (M-4) ) ;
-                varianceTimesNi = 0;
-                varianceTimesNk = 0;
-                for (int j = 0 ; j < M; j++ ) {
-                    if (!diagonal && ( i==j || k==j || (i+N)==j || (k+N)==j  ) )
-                        continue;
-                    varianceTimesNi +=  ( CM.item(j,i)  - mean[i] ) *  ( CM.item(j,i)  - mean[i] );
-                    varianceTimesNk +=  ( CM.item(j,k)  - mean[k] ) *  ( CM.item(j,k)  - mean[k] );
-                }
-                sigma[i] = sqrt (varianceTimesNi); //actually this is sigma * sqrt (N)
-                sigma[k] = sqrt (varianceTimesNk); //actually this is sigma * sqrt (N)
-
-                covariance = 0;
-
-                for (int j = 0 ; j < M ; j++ ) {
-                    qDebug() << "CM.item(j,i)=CM.item("<<j+1<<","<<i+1<<") = "<<CM.item(j,i)
-                             << " mean(i)=mean("<<i+1<<") = "<<mean[i]
-                                << "CM.item(j,k)=CM.item("<<j+1<<","<<k+1<<") = "<<CM.item(j,k)
-                                << " mean(k)=mean("<<k+1<<") = "<<mean[k];
-
-
-                    if (!diagonal) {
-                        if ( (i==j || k==j )) {
-                            qDebug() << "skipping because i"<<i+1<<"k"<<k+1 <<"j"<<j+1;
-                            continue;
-                        }
-                        if ( j>=N && ( (i+N)==j || (k+N)==j )) {
-                            qDebug() << "skipping because j>=N and i"<<i+1<<"k"<<k+1 <<"j"<<j+1;
-                            continue;
-                        }
-                    }
-
-                    covariance  +=  ( CM.item(j,i)  - mean[i] ) * ( CM.item(j,k)  - mean[k] ) ;
-                }
-
-                if ( ( sigma[i] != 0 ) && ( sigma[k] != 0  ) ) {
-                    pcc =   covariance   /  (( sigma[i] ) * ( sigma[k] )) ;
-                }
-                else {
-                    pcc = 0;
-                }
-
-                qDebug() << "final covariance("<<i+1<<","<<k+1<<") =" << covariance
-                         << "sigma["<<i+1<<"]" << sigma[i]
-                         << "sigma["<<k+1<<"]" << sigma[k]
-                         << "pcc("<<i+1<<","<<k+1<<") =" << pcc;
-
-                setItem(i,k, pcc);
-                setItem(k,i, pcc);
-            }
-
-        }
-    }
-    else {
-
-    }
-
-    return *this;
-
-}
-
-
-
-/**
- * @brief Prints matrix m to given textstream
- * @param os
- * @param m
- * @return
- */
-QTextStream& operator <<  (QTextStream& os, Matrix& m){
-    qDebug() << "Matrix: << Matrix";
-    int actorNumber=1, fieldWidth = 13;
-    qreal maxVal, minVal, maxAbsVal, element;
-    bool hasRealNumbers=false;
-
-    m.findMinMaxValues(minVal, maxVal, hasRealNumbers);
-
-    maxAbsVal = ( fabs(minVal) > fabs(maxVal) ) ? fabs(minVal) : fabs(maxVal) ;
-
-
-    os << qSetFieldWidth(0) << endl ;
-
-    os << "- Values:        "
-       << ( (hasRealNumbers) ? ("real numbers (printed decimals 3)") : ("integers only" ) ) << endl;
-
-    os << "- Max value:  ";
-
-    if ( maxVal==RAND_MAX )
-        os <<  infinity << " (=not connected nodes, in distance matrix)";
-    else
-        os <<   maxVal;
-
-    os << qSetFieldWidth(0) << endl ;
-
-    os << "- Min value:   ";
-
-    if ( minVal==RAND_MAX )
-        os << infinity;
-    else
-        os << minVal;
-
-
-    os << qSetFieldWidth(0) << endl << endl;
-
-    os << qSetFieldWidth(7) << fixed << right << "v"<< qSetFieldWidth(3) << "" ;
-
-    os <<  ( (hasRealNumbers) ? qSetRealNumberPrecision(3) : qSetRealNumberPrecision(0) ) ;
-
-    // Note: In the case of Distance Matrix,
-    // if there is DM(i,j)=RAND_MAX (not connected), we always use fieldWidth  = 13
-    if ( maxAbsVal  > 999)
-        fieldWidth  = 13 ;
-    else if  ( maxAbsVal > 99)
-        fieldWidth  = 10 ;
-    else if ( maxAbsVal > 9   )
-        fieldWidth  = 9 ;
-    else
-        fieldWidth  = 8 ;
-
-    // print first/header row
-    for (int r = 0; r < m.cols(); ++r) {
-        actorNumber = r+1;
+}
 
-        if ( actorNumber > 999)
-            os << qSetFieldWidth(fieldWidth-3) ;
-        else if  ( actorNumber > 99)
-            os << qSetFieldWidth(fieldWidth-2) ;
-        else if ( actorNumber > 9)
-            os << qSetFieldWidth(fieldWidth-1) ;
-        else
-            os << qSetFieldWidth(fieldWidth) ;
 
-        os <<  fixed << actorNumber;
-    }
 
-    os << qSetFieldWidth(0) << endl;
+/**
+ * @brief Fast path of similarityMatrix() for binary (0/1) input matrices.
+ *
+ * Packs the tie profile of each actor (row, column or concatenated row+column
+ * of AM) into 64-bit words and computes matches, ties and differences of
+ * every pair with population counts (AND, OR, XOR) instead of comparing
+ * qreal cells one by one. Rows of the result are processed in parallel.
+ *
+ * Excluded cells (the diagonal, when diagonal==false) are handled by
+ * subtracting their contribution from the word-wise counts, so the results
+ * are identical to the generic code.
+ *
+ * Returns false, without touching this matrix, if AM is not square and
+ * binary or the measure has no bitset counterpart. In that case the caller
+ * must use the generic code path.
+ *
+ * Complexity: O(n^3 / 64)
+ * @param AM
+ * @param measure
+ * @param varLocation
+ * @param diagonal
+ * @return true if the similarity matrix has been computed
+ */
+bool SymmetricMatrix::similarityMatrixBinary(Matrix &AM,
+                                    const int &measure,
+                                    const QString &varLocation,
+                                    const bool &diagonal) {
+
+    switch (measure) {
+    case METRIC_SIMPLE_MATCHING :
+    case METRIC_JACCARD_INDEX:
+    case METRIC_HAMMING_DISTANCE:
+    case METRIC_COSINE_SIMILARITY:
+    case METRIC_EUCLIDEAN_DISTANCE:
+        break;
+    default:
+        return false;
+    }
 
-    os << qSetFieldWidth(7)<< endl;
+    if (varLocation!="Rows" && varLocation!="Columns" && varLocation!="Both") {
+        return false;
+    }
 
-    // print rows
-    for (int r = 0; r < m.rows(); ++r) {
-        actorNumber = r+1;
+    if ( AM.rows() != AM.cols() || !AM.isBinary() ) {
+        return false;
+    }
 
-        if ( actorNumber > 999)
-            os << qSetFieldWidth(4) ;
-        else if  ( actorNumber > 99)
-            os << qSetFieldWidth(5) ;
-        else if ( actorNumber > 9)
-            os << qSetFieldWidth(6) ;
-        else
-            os << qSetFieldWidth(7) ;
+    qDebug()<< "SymmetricMatrix::similarityMatrixBinary() -"
+            <<"measure"<< measure
+            << "varLocation"<< varLocation;
 
+    const int N = AM.rows();
+    const bool both = (varLocation=="Both");
+    const int L = (both) ? 2 * N : N ;   // length of each tie profile
+    const int W = (L + 63) / 64;         // 64-bit words per tie profile
 
-        os <<  fixed << actorNumber
-            << qSetFieldWidth(3) <<"" ;
+    // profile i occupies words [i*W, (i+1)*W)
+    QVector<quint64> bits ( N * W, 0 );
+    QVector<int> ones (N, 0);
 
-        for (int c = 0; c < m.cols(); ++c) {
-            element = m(r,c) ;
-            os << qSetFieldWidth(fieldWidth) << fixed << right;
-            if ( element == RAND_MAX)  // we print inf symbol instead of RAND_MAX (distances matrix).
-                os << fixed << right << qSetFieldWidth(fieldWidth) << infinity ;
+    for (int r = 0 ; r < N ; r++ ) {
+        for (int c = 0 ; c < N ; c++ ) {
+            if ( AM.item(r,c) == 0 ) {
+                continue;
+            }
+            if (varLocation=="Rows") {
+                bits[ r*W + c/64 ] |= Q_UINT64_C(1) << (c % 64);
+            }
+            else if (varLocation=="Columns") {
+                bits[ c*W + r/64 ] |= Q_UINT64_C(1) << (r % 64);
+            }
             else {
-                if ( element > 999)
-                    os << qSetFieldWidth(fieldWidth-3) ;
-                else if  ( element > 99)
-                    os << qSetFieldWidth(fieldWidth-2) ;
-                else if ( element > 9)
-                    os << qSetFieldWidth(fieldWidth-1) ;
-                else
-                    os << qSetFieldWidth(fieldWidth) ;
-                os <<  element;
+                // profile of r is (row r, column r): cell (r,c) goes to
+                // position c of profile r and position N+r of profile c.
+                bits[ r*W + c/64 ] |= Q_UINT64_C(1) << (c % 64);
+                bits[ c*W + (N+r)/64 ] |= Q_UINT64_C(1) << ((N+r) % 64);
             }
         }
-        os << qSetFieldWidth(0) << endl;
     }
-    return os;
-}
-
-
 
+    for (int i = 0 ; i < N ; i++ ) {
+        for (int w = 0 ; w < W ; w++ ) {
+            ones[i] += qPopulationCount( bits[i*W + w] );
+        }
+    }
 
+    this->zeroMatrix(N);
 
-/**
- * @brief  Prints this matrix as HTML table
- * This has the problem that the real actorNumber != elementLabel i.e. when we
- * have deleted a node/vertex
- * @param os
- * @param debug
- * @return
- */
-bool Matrix::printHTMLTable(QTextStream& os,
-                            const bool markDiag,
-                            const bool &plain,
-                            const bool &printInfinity){
-    qDebug() << "Matrix::printHTMLTable()";
-    int elementLabel=0, rowCount = 0;
-    qreal maxVal, minVal, element;
-    bool hasRealNumbers=false;
+    const quint64 *profiles = bits.constData();
 
-    findMinMaxValues(minVal, maxVal, hasRealNumbers);
+    QVector<int> rowIndex(N);
+    for (int i = 0 ; i < N ; i++ ) {
+        rowIndex[i] = i;
+    }
 
-    //maxAbsVal = ( fabs(minVal) > fabs(maxVal) ) ? fabs(minVal) : fabs(maxVal) ;
+    QtConcurrent::blockingMap(rowIndex, [&](const int &i) {
 
-    os <<  ( (hasRealNumbers) ? qSetRealNumberPrecision(3) : qSetRealNumberPrecision(0) ) ;
+        const quint64 *pi = profiles + i*W;
+        int excluded[4];
 
-    if (plain) {
-        os << "<pre>";
+        for (int k = i ; k < N ; k++ ) {
 
-        // print first/header row
-        os << "<span class=\"header\">" << qSetFieldWidth(5) << right << "A/A";
-        os <<  fixed << qSetFieldWidth(10) << right ;
-        for (int r = 0; r < cols(); ++r) {
-            elementLabel = r+1;
-            os << elementLabel;
-        }
-        os << qSetFieldWidth(0) << "</span>"<< endl;
+            const quint64 *pk = profiles + k*W;
 
-        for (int r = 0; r < rows(); ++r) {
-            elementLabel = r+1;
-            rowCount++;
+            int cAnd = 0, cOr = 0, cXor = 0;
+            for (int w = 0 ; w < W ; w++ ) {
+                cAnd += qPopulationCount( pi[w] & pk[w] );
+                cOr  += qPopulationCount( pi[w] | pk[w] );
+                cXor += qPopulationCount( pi[w] ^ pk[w] );
+            }
 
-            os << "<span class=\"header\">" << qSetFieldWidth(5) << right;
-            os << elementLabel;
-            os << qSetFieldWidth(0) << "</span>";
+            int n = L;
+            int onesI = ones[i];
+            int onesK = ones[k];
+
+            if (!diagonal) {
+                // remove the contribution of the skipped cells
+                int e = 0;
+                excluded[e++] = i;
+                if (k != i) excluded[e++] = k;
+                if (both) {
+                    excluded[e++] = N + i;
+                    if (k != i) excluded[e++] = N + k;
+                }
+                for (int x = 0; x < e; x++) {
+                    const int p = excluded[x];
+                    const int a = ( pi[p/64] >> (p % 64) ) & 1;
+                    const int b = ( pk[p/64] >> (p % 64) ) & 1;
+                    cAnd -= a & b;
+                    cOr  -= a | b;
+                    cXor -= a ^ b;
+                    onesI -= a;
+                    onesK -= b;
+                    n--;
+                }
+            }
 
-            for (int c = 0; c < cols(); ++c) {
-                element = item(r,c) ;
-                os << fixed << qSetFieldWidth(10) << right;
-                if (  element == RAND_MAX)  // print inf symbol instead of RAND_MAX (distances matrix).
-                    os << infinity;
+            qreal matchRatio = 0;
+            switch (measure) {
+            case METRIC_SIMPLE_MATCHING :
+                matchRatio = (qreal) (n - cXor) / (qreal) n;
+                break;
+            case METRIC_JACCARD_INDEX:
+                matchRatio = (qreal) cAnd / (qreal) cOr;
+                break;
+            case METRIC_HAMMING_DISTANCE:
+                matchRatio = cXor;
+                break;
+            case METRIC_COSINE_SIMILARITY:
+                // By convention, sigma(i,j) = 0 when one or both vertices
+                // have degree zero (cosine similarity is undefined).
+                if ( !onesI || !onesK ) {
+                    matchRatio = 0;
+                }
                 else {
-                    os << element ;
-
+                    matchRatio = cAnd / sqrt( (qreal) onesI * (qreal) onesK );
                 }
-               // os << "";
+                break;
+            case METRIC_EUCLIDEAN_DISTANCE:
+                matchRatio = sqrt( (qreal) cXor );
+                break;
+            default:
+                break;
             }
 
-            os << qSetFieldWidth(0) << endl;
+            setItem(i,k, matchRatio);
         }
+    });
 
-        os << "</pre>";
-        return true;
-    }
+    qDebug()<< "SymmetricMatrix::similarityMatrixBinary() - finished";
 
-    os << "<table  border=\"1\" cellspacing=\"0\" cellpadding=\"0\" class=\"stripes\">"
-            << "<thead>"
-            << "<tr>"
-            << "<th>"
-            << ("<sub>Actor</sup>/<sup>Actor</sup>")
-            << "</th>";
+    return true;
+}
 
 
-    // print first/header row
-    for (int r = 0; r < cols(); ++r) {
-        elementLabel = r+1;
-        os << "<th>"
-                << elementLabel
-                << "</th>";
 
-    }
-    os << "</tr>"
-            << "</thead>"
-            << "<tbody>";
+/**
+ * @brief  Computes the Pearson Correlation Coefficient of the rows or the columns
+ * of the given matrix AM
+ *
+ * The variables (rows, columns or concatenated rows+columns of AM) are
+ * centred at their means and their cross products are computed at once
+ * with a single symmetric rank-k update (see productByTranspose).
+ * When the diagonal is not included, the contribution of the skipped
+ * cells of each pair is subtracted from the sums before the pair's
+ * covariance and variances are computed, so the results match the
+ * pair-wise definition.
+ *
+ * Complexity: O(n^2 * m) for n variables with m observations each.
+ * @param AM Matrix
+ * @return SymmetricMatrix nxn with PPC values for every pair of rows/columns of AM
+ */
+SymmetricMatrix& SymmetricMatrix::pearsonCorrelationCoefficients(Matrix &AM,
+                                                                 const QString &varLocation,
+                                                                 const bool &diagonal){
+    qDebug()<< "SymmetricMatrix::pearsonCorrelationCoefficients() -"
+            << "varLocation"<< varLocation;
 
-    // print rows
-    rowCount = 0;
-    for (int r = 0; r < rows(); ++r) {
-        elementLabel = r+1;
-        rowCount++;
-        os << "<tr class=" << ((rowCount%2==0) ? "even" :"odd" )<< ">";
+    if (varLocation!="Rows" && varLocation!="Columns" && varLocation!="Both") {
+        return *this;
+    }
 
-        os <<"<td class=\"header\">"
-               << elementLabel
-               << "</td>";
+    const int N = AM.rows() ;
+    const bool both = (varLocation=="Both");
+    const int M = (both) ? 2 * N : N;   // observations per variable
 
-        for (int c = 0; c < cols(); ++c) {
-            element = item(r,c) ;
-            os << fixed << right;
-            os <<"<td" << ((markDiag && r==c)? " class=\"diag\">" : ">");
-            if ( ( element == RAND_MAX ) && printInfinity) {
-                // print inf symbol instead of RAND_MAX (distances matrix).
-                os << infinity;
+    // returns the j-th observation of the i-th variable
+    auto observation = [&](const int &i, const int &j) -> qreal {
+        if (varLocation=="Rows") {
+            return AM.item(i,j);
+        }
+        else if (varLocation=="Columns") {
+            return AM.item(j,i);
+        }
+        return ( j < N ) ? AM.item(i,j) : AM.item(j-N,i);
+    };
+
+    // X holds one variable per row, centred at its mean
+    Matrix X(N, M);
+    QVector<qreal> sum(N,0);    // sum of centred observations (~0)
+    QVector<qreal> sumSq(N,0);  // sum of squared deviations from mean
+    QVector<bool> variesAll(N,false);  // not all observations equal
+    QVector<int> nonZero(N,0);  // non zero observations
+
+    for (int i = 0 ; i < N ; i++ ) {
+        qreal mean = 0;
+        for (int j = 0 ; j < M ; j++ ) {
+            X[i][j] = observation(i,j);
+            mean += X[i][j];
+            if ( X[i][j] != 0 ) {
+                nonZero[i]++;
             }
-            else {
-                os << element ;
+            if ( X[i][j] != X[i][0] ) {
+                variesAll[i] = true;
             }
-            os << "</td>";
         }
-
-        os <<"</tr>";
+        mean = mean / (qreal) M;
+        for (int j = 0 ; j < M ; j++ ) {
+            X[i][j] -= mean;
+            sum[i] += X[i][j];
+            sumSq[i] += X[i][j] * X[i][j];
+        }
     }
-    os << "</tbody></table>";
-
-
-    os << qSetFieldWidth(0) << endl ;
 
+    qDebug()<< "SymmetricMatrix::pearsonCorrelationCoefficients() -"
+            << "computing cross products";
 
-    os << "<p>"
-       << "<span class=\"info\">"
-       << ("Values: ")
-       <<"</span>"
-       << ( (hasRealNumbers) ? ("real numbers (printed decimals 3)") : ("integers only" ) )
-       << "<br />"
-       << "<span class=\"info\">"
-       << ("- Max value: ")
-       <<"</span>"
-       << ( ( maxVal==RAND_MAX ) ?
-                ( (printInfinity) ? infinity : QString::number(maxVal) ) +
-                " (=not connected nodes, in distance matrix)" : QString::number(maxVal) )
-       << "<br />"
-       << "<span class=\"info\">"
-       << ("- Min value: ")
-       <<"</span>"
-       << ( ( minVal==RAND_MAX ) ?
-                ( (printInfinity) ? infinity : QString::number(minVal) ) +
-                + " (usually denotes unconnected nodes, in distance matrix)" : QString::number(minVal ) )
-       << "</p>";
+    this->productByTranspose(X);
 
-    return true;
-}
+    // variances below this fraction of the total are rounding residues
+    const qreal eps = 1.0e-12;
 
+    QVector<int> rowIndex(N);
+    for (int i = 0 ; i < N ; i++ ) {
+        rowIndex[i] = i;
+    }
 
+    QtConcurrent::blockingMap(rowIndex, [&](const int &i) {
 
+        int excluded[4];
 
-/**
- * @brief  Prints this matrix to stderr or stdout
- * @return
- */
-bool Matrix::printMatrixConsole(bool debug){
-    qDebug() << "Matrix::printMatrixConsole() - debug " << debug
-             << "matrix rows" << rows()<< "cols"<< cols();
-    QTextStream out ( (debug ? stderr : stdout) );
+        for (int k = i ; k < N ; k++ ) {
 
-    for (int r = 0; r < rows(); ++r) {
-        for (int c = 0; c < cols(); ++c) {
-            if ( item(r,c) < RAND_MAX  ) {
-                out <<  qSetFieldWidth(12) << qSetRealNumberPrecision(3)
-                     <<  forcepoint << fixed<<right
-                        << item(r,c);
-            }
-            else {
-                out <<  qSetFieldWidth(12) << qSetRealNumberPrecision(3)
-                     <<  forcepoint << fixed<<right
-                        << "x";
+            int e = 0;
+            if (!diagonal) {
+                excluded[e++] = i;
+                if (k != i) excluded[e++] = k;
+                if (both) {
+                    excluded[e++] = N + i;
+                    if (k != i) excluded[e++] = N + k;
+                }
             }
 
-//            QTextStream( (debug ? stderr : stdout) )
-//                    << ( (item(r,c) < RAND_MAX ) ? item(r,c) : INFINITY  )<<' ';
-        }
-        out <<qSetFieldWidth(0)<< endl;
-    }
-    return true;
-}
-
+            qreal pcc = 0;
 
-/**
- * @brief  Checks if matrix is ill-defined (contains at least an inf element)
- * @return
- */
-bool Matrix::illDefined(){
-    qDebug() << "Matrix::illDefined() " ;
+            if ( i == k ) {
+                // A variable is perfectly correlated with itself,
+                // unless it has zero variance.
+                if (diagonal) {
+                    pcc = ( variesAll[i] ) ? 1 : 0;
+                }
+                else {
+                    int nz = nonZero[i];
+                    for (int x = 0; x < e; x++) {
+                        if ( observation(i, excluded[x]) != 0 ) {
+                            nz--;
+                        }
+                    }
+                    pcc = ( nz > 0 ) ? 1 : 0;
+                }
+                setItem(i,i, pcc);
+                continue;
+            }
 
-    for (int r = 0; r < rows(); ++r) {
-        for (int c = 0; c < cols(); ++c) {
-            if ( item(r,c) < RAND_MAX  ) {
+            int n = M;
+            qreal sumi = sum[i];
+            qreal sumk = sum[k];
+            qreal sqi = sumSq[i];
+            qreal sqk = sumSq[k];
+            qreal prod = item(i,k);
+
+            for (int x = 0; x < e; x++) {
+                const qreal a = X[i][excluded[x]];
+                const qreal b = X[k][excluded[x]];
+                sumi -= a;
+                sumk -= b;
+                sqi -= a * a;
+                sqk -= b * b;
+                prod -= a * b;
+                n--;
             }
-            else {
-                qDebug() << "Matrix::illDefined() - matrix ill-defined: TRUE" ;
-                return true;
 
+            if ( n > 0 ) {
+                const qreal varianceTimesNi = sqi - sumi * sumi / n;
+                const qreal varianceTimesNk = sqk - sumk * sumk / n;
+                const qreal covariance = prod - sumi * sumk / n;
+                if ( varianceTimesNi > eps * sumSq[i]
+                     && varianceTimesNk > eps * sumSq[k] ) {
+                    pcc = covariance / sqrt( varianceTimesNi * varianceTimesNk );
+                }
             }
+
+            setItem(i,k, pcc);
         }
-    }
-    return false;
-}
+    });
+
+    qDebug()<< "SymmetricMatrix::pearsonCorrelationCoefficients() - finished";
 
+    return *this;
 
+}
@@ -251,7 +251,6 @@ public:
                                const bool &diagonal=false,
                                const bool &considerWeights=true);
 
-
     Matrix& pearsonCorrelationCoefficients(Matrix &AM,
                                           const QString &varLocation="Rows",
                                            const bool &diagonal=false);
@@ -266,6 +265,8 @@ public:
 
     bool illDefined();
 
+    bool isBinary();
+
 private:
     MatrixRow *row;
     int m_rows;
@@ -275,6 +276,111 @@ private:
 
 
 
+// Similarity and dissimilarity matrices of at least this many variables
+// are stored in single precision (over 256 MB as packed doubles).
+static const int SYMMETRIC_MATRIX_SINGLE_PRECISION_DIM = 8192;
+
+
+/**
+ * @brief The SymmetricMatrix class
+ * A square symmetric matrix which stores only its upper triangle
+ * (diagonal included) in packed form, that is n(n+1)/2 elements instead
+ * of n^2. Elements are double precision by default, or single precision
+ * if singlePrecision is true, which quarters the memory of a full Matrix.
+ * In single precision, RAND_MAX (infinity, in distance matrices) is
+ * stored as +inf and returned as RAND_MAX.
+ * Used for similarity, Pearson, dissimilarity and clique co-membership
+ * matrices.
+ */
+class SymmetricMatrix {
+public:
+    SymmetricMatrix (int dim=0, bool singlePrecision=false);
+
+    SymmetricMatrix (const SymmetricMatrix &b);
+
+    ~SymmetricMatrix();
+
+    SymmetricMatrix& operator =(const SymmetricMatrix & a);
+
+    void clear();
+
+    void resize (const int n, const bool singlePrecision=false);
+
+    qreal item( int r, int c ) ;
+
+    void setItem(const int r, const int c, const qreal elem );
+
+    int cols() {return m_dim;}
+
+    int rows() {return m_dim;}
+
+    int size() { return m_dim * m_dim; }
+
+    bool isSinglePrecision() { return m_singlePrecision; }
+
+    void setSinglePrecision(const bool &singlePrecision);
+
+    void findMinMaxValues(qreal&min, qreal&max, bool &hasRealNumbers);
+
+    void NeighboursNearestFarthest(qreal&min,qreal&max,
+                          int &imin, int &jmin,
+                          int &imax, int &jmax);
+
+    void deleteRowColumn(int i);	/* deletes row i and column i */
+
+    void zeroMatrix (const int n);
+
+    void fillMatrix (qreal value );
+
+    void fromMatrix(Matrix &A, const bool &minOfPair=false);
+
+    void toMatrix(Matrix &A);
+
+    void productByTranspose(Matrix &X);
+
+    SymmetricMatrix& distancesMatrix(Matrix &INPUT,
+                                     const int &metric,
+                                     const QString varLocation,
+                                     const bool &diagonal,
+                                     const bool &considerWeights);
+
+    SymmetricMatrix& similarityMatrix(Matrix &AM,
+                                      const int &measure,
+                                      const QString varLocation="Rows",
+                                      const bool &diagonal=false,
+                                      const bool &considerWeights=true);
+
+    bool similarityMatrixBinary(Matrix &AM,
+                                const int &measure,
+                                const QString &varLocation="Rows",
+                                const bool &diagonal=false);
+
+    SymmetricMatrix& pearsonCorrelationCoefficients(Matrix &AM,
+                                                    const QString &varLocation="Rows",
+                                                    const bool &diagonal=false);
+
+    friend QTextStream& operator <<  (QTextStream& os, SymmetricMatrix& m);
+
+    bool illDefined();
+
+private:
+    qint64 index(int r, int c) const {
+        if (r > c) { int t = r; r = c; c = t; }
+        return (qint64) r * m_dim - (qint64) r * (r - 1) / 2 + (c - r);
+    }
+    qint64 packedSize() const { return (qint64) m_dim * (m_dim + 1) / 2; }
+    void allocate();
+
+    qreal *m_cells;
+    float *m_cellsF;
+    int m_dim;
+    bool m_singlePrecision;
+
+};
+
+
+
+
 
 
 #endif
@@ -40,16 +40,378 @@
 #include <QTextCodec>
 #include <QRegularExpression>
 #include <list>  // used as list<int> listDummiesPajek
-#include <queue>		//for priority queue
+#include <cstring>     //for memchr, memcmp
+#include <algorithm>   //for std::stable_sort
+#include <QtConcurrent>
+
+#ifdef SOCNETV_HAVE_ZLIB
+#include <zlib.h>
+#endif
+#ifdef SOCNETV_HAVE_ZSTD
+#include <zstd.h>
+#endif
 
 #include "graph.h"	//needed for setParent
 
 using namespace std;
 
+
+
+/**
+ * @brief Size of the compressed blocks read by NetworkFile
+ */
+static const qint64 NETWORK_FILE_BLOCK_SIZE = 65536;
+
+
+
+NetworkFile::NetworkFile(const QString &fileName) :
+    m_file(fileName), m_compression(None), m_gzip(0), m_zstd(0),
+    m_inputPos(0), m_finished(false), m_zstdRemaining(0) {
+}
+
+
+
+NetworkFile::~NetworkFile() {
+    close();
+}
+
+
+
+/**
+ * @brief Returns the compression of a file starting with the bytes in magic
+ * @param magic
+ * @return
+ */
+NetworkFile::Compression NetworkFile::compression(const QByteArray &magic) {
+    const uchar *m = reinterpret_cast<const uchar *>( magic.constData() );
+    if ( magic.size() >= 2 && m[0] == 0x1F && m[1] == 0x8B ) {
+        return Gzip;
+    }
+    if ( magic.size() >= 4 && m[0] == 0x28 && m[1] == 0xB5
+         && m[2] == 0x2F && m[3] == 0xFD ) {
+        return Zstd;
+    }
+    return None;
+}
+
+
+
+/**
+ * @brief Returns true if this build can decompress files of the given
+ * compression
+ * @param compression
+ * @return
+ */
+bool NetworkFile::supported(const Compression &compression) {
+    switch (compression) {
+    case Gzip:
+#ifdef SOCNETV_HAVE_ZLIB
+        return true;
+#else
+        return false;
+#endif
+    case Zstd:
+#ifdef SOCNETV_HAVE_ZSTD
+        return true;
+#else
+        return false;
+#endif
+    default:
+        return true;
+    }
+}
+
+
+
+/**
+ * @brief Opens the file for reading and prepares the decompressor, if the
+ * file starts with gzip or zstd magic bytes.
+ * @param mode
+ * @return
+ */
+bool NetworkFile::open(OpenMode mode) {
+    if ( mode & QIODevice::WriteOnly ) {
+        setErrorString( tr("Network files can be opened for reading only") );
+        return false;
+    }
+    if ( !m_file.open(QIODevice::ReadOnly) ) {
+        setErrorString( m_file.errorString() );
+        return false;
+    }
+    m_compression = compression( m_file.peek(4) );
+    if ( !supported(m_compression) ) {
+        setErrorString( tr("The file is compressed with %1, "
+                           "which is not supported by this build of SocNetV.")
+                        .arg( (m_compression == Gzip) ? "gzip" : "zstd" ) );
+        m_file.close();
+        return false;
+    }
+    m_input.clear();
+    m_inputPos = 0;
+    m_finished = false;
+    m_zstdRemaining = 1;
+    m_streamError.clear();
+
+    switch (m_compression) {
+    case Gzip: {
+#ifdef SOCNETV_HAVE_ZLIB
+        m_gzip = new z_stream;
+        memset(m_gzip, 0, sizeof(z_stream));
+        // 15 window bits, +32 to detect and skip the gzip header
+        if ( inflateInit2(m_gzip, 15 + 32) != Z_OK ) {
+            delete m_gzip;
+            m_gzip = 0;
+            setErrorString( tr("Cannot initialize gzip decompression") );
+            m_file.close();
+            return false;
+        }
+#endif
+        break;
+    }
+    case Zstd: {
+#ifdef SOCNETV_HAVE_ZSTD
+        m_zstd = ZSTD_createDStream();
+        if ( m_zstd == 0 || ZSTD_isError( ZSTD_initDStream(m_zstd) ) ) {
+            ZSTD_freeDStream(m_zstd);
+            m_zstd = 0;
+            setErrorString( tr("Cannot initialize zstd decompression") );
+            m_file.close();
+            return false;
+        }
+#endif
+        break;
+    }
+    default: {
+        // plain files are read straight from the QFile
+        mode |= QIODevice::Unbuffered;
+        break;
+    }
+    };
+
+    qDebug() << "NetworkFile::open() -" << m_file.fileName()
+             << "compression" << m_compression;
+
+    return QIODevice::open(mode);
+}
+
+
+
+void NetworkFile::close() {
+#ifdef SOCNETV_HAVE_ZLIB
+    if ( m_gzip ) {
+        inflateEnd(m_gzip);
+        delete m_gzip;
+        m_gzip = 0;
+    }
+#endif
+#ifdef SOCNETV_HAVE_ZSTD
+    if ( m_zstd ) {
+        ZSTD_freeDStream(m_zstd);
+        m_zstd = 0;
+    }
+#endif
+    m_input.clear();
+    m_inputPos = 0;
+    m_finished = false;
+    if ( isOpen() ) {
+        QIODevice::close();
+    }
+    m_file.close();
+}
+
+
+
+bool NetworkFile::isSequential() const {
+    return m_compression != None;
+}
+
+
+
+bool NetworkFile::atEnd() const {
+    if ( m_compression == None ) {
+        return QIODevice::bytesAvailable() == 0 && m_file.atEnd();
+    }
+    return m_finished && QIODevice::bytesAvailable() == 0;
+}
+
+
+
+/**
+ * @brief Returns the size of plain files. Compressed files are sequential,
+ * and only the bytes available are known.
+ * @return
+ */
+qint64 NetworkFile::size() const {
+    if ( m_compression == None ) {
+        return m_file.size();
+    }
+    return QIODevice::size();
+}
+
+
+
+bool NetworkFile::seek(qint64 pos) {
+    if ( m_compression != None ) {
+        return QIODevice::seek(pos);
+    }
+    return QIODevice::seek(pos) && m_file.seek(pos);
+}
+
+
+
+qint64 NetworkFile::readData(char *data, qint64 maxSize) {
+    switch (m_compression) {
+    case Gzip:
+        return inflateGzip(data, maxSize);
+    case Zstd:
+        return inflateZstd(data, maxSize);
+    default:
+        return m_file.read(data, maxSize);
+    }
+}
+
+
+
+/**
+ * @brief Reads the next compressed block, if the current one is consumed.
+ * @return false if there is no more compressed input
+ */
+bool NetworkFile::fillInput() {
+    if ( m_inputPos < m_input.size() ) {
+        return true;
+    }
+    m_input = m_file.read(NETWORK_FILE_BLOCK_SIZE);
+    m_inputPos = 0;
+    return !m_input.isEmpty();
+}
+
+
+
+/**
+ * @brief Records why the compressed stream cannot be read further.
+ * The bytes decompressed so far are returned; the next read fails.
+ * @param message
+ */
+void NetworkFile::setStreamError(const QString &message) {
+    m_streamError = message;
+    setErrorString(message);
+    m_finished = true;
+}
+
+
+
+/**
+ * @brief Inflates gzip data into data, up to maxSize bytes.
+ * Concatenated gzip members are read as a single stream.
+ * @param data
+ * @param maxSize
+ * @return the number of bytes inflated, or -1 on error
+ */
+qint64 NetworkFile::inflateGzip(char *data, const qint64 &maxSize) {
+    qint64 total = 0;
+#ifdef SOCNETV_HAVE_ZLIB
+    while ( total < maxSize && !m_finished ) {
+        const bool input = fillInput();
+        m_gzip->next_in = input ? (Bytef *) m_input.constData() + m_inputPos : Z_NULL;
+        m_gzip->avail_in = input ? (uInt) ( m_input.size() - m_inputPos ) : 0;
+        m_gzip->next_out = (Bytef *) ( data + total );
+        m_gzip->avail_out = (uInt) qMin<qint64>( maxSize - total, NETWORK_FILE_BLOCK_SIZE );
+        const uInt availIn = m_gzip->avail_in;
+        const uInt availOut = m_gzip->avail_out;
+
+        const int ret = inflate(m_gzip, Z_NO_FLUSH);
+
+        m_inputPos += availIn - m_gzip->avail_in;
+        total += availOut - m_gzip->avail_out;
+
+        if ( ret == Z_STREAM_END ) {
+            if ( fillInput() ) {
+                inflateReset(m_gzip);
+            }
+            else {
+                m_finished = true;
+            }
+        }
+        else if ( ret != Z_OK && ret != Z_BUF_ERROR ) {
+            qDebug() << "NetworkFile::inflateGzip() - error" << ret;
+            setStreamError( tr("Corrupt gzip data: %1")
+                            .arg( m_gzip->msg ? m_gzip->msg : "" ) );
+        }
+        else if ( !input && availOut == m_gzip->avail_out ) {
+            qDebug() << "NetworkFile::inflateGzip() - truncated gzip data";
+            setStreamError( tr("Unexpected end of gzip data") );
+        }
+    }
+#else
+    Q_UNUSED(data);
+    Q_UNUSED(maxSize);
+#endif
+    return ( total == 0 && !m_streamError.isEmpty() ) ? -1 : total;
+}
+
+
+
+/**
+ * @brief Decompresses zstd data into data, up to maxSize bytes.
+ * Consecutive zstd frames are read as a single stream.
+ * @param data
+ * @param maxSize
+ * @return the number of bytes decompressed, or -1 on error
+ */
+qint64 NetworkFile::inflateZstd(char *data, const qint64 &maxSize) {
+    qint64 total = 0;
+#ifdef SOCNETV_HAVE_ZSTD
+    while ( total < maxSize && !m_finished ) {
+        const bool input = fillInput();
+        ZSTD_inBuffer in;
+        in.src = input ? m_input.constData() + m_inputPos : 0;
+        in.size = input ? (size_t) ( m_input.size() - m_inputPos ) : 0;
+        in.pos = 0;
+        ZSTD_outBuffer out;
+        out.dst = data + total;
+        out.size = (size_t) ( maxSize - total );
+        out.pos = 0;
+
+        const size_t ret = ZSTD_decompressStream(m_zstd, &out, &in);
+
+        m_inputPos += in.pos;
+        total += out.pos;
+
+        if ( ZSTD_isError(ret) ) {
+            qDebug() << "NetworkFile::inflateZstd() - error" << ZSTD_getErrorName(ret);
+            setStreamError( tr("Corrupt zstd data: %1").arg( ZSTD_getErrorName(ret) ) );
+        }
+        else if ( in.pos != 0 || out.pos != 0 ) {
+            // 0 once a frame is complete and flushed; a call with no input
+            // after it returns the size hint of the next frame header instead
+            m_zstdRemaining = ret;
+        }
+        else if ( !input ) {
+            if ( m_zstdRemaining != 0 ) {
+                // the last frame misses its end
+                qDebug() << "NetworkFile::inflateZstd() - truncated zstd data";
+                setStreamError( tr("Unexpected end of zstd data") );
+            }
+            m_finished = true;
+        }
+    }
+#else
+    Q_UNUSED(data);
+    Q_UNUSED(maxSize);
+#endif
+    return ( total == 0 && !m_streamError.isEmpty() ) ? -1 : total;
+}
+
+
+
+
 Parser::Parser()
 {
     qDebug() << "Parser::Parser() - running on thread "  << this->thread() ;
 
+    m_batch = 0;
+    m_batchUpdatesEdgeWeights = false;
+    m_edgeListState = 0;
 
 }
 
@@ -63,11 +425,12 @@ Parser::~Parser () {
     keyName.clear();
     keyType.clear();
     keyDefaultValue.clear();
+    keyRole.clear();
     edgesMissingNodesHash.clear();
     edgeMissingNodesList.clear();
     edgeMissingNodesListData.clear();
-    firstModeMultiMap.clear();
-    secondModeMultiMap.clear();
+    delete m_batch;
+    delete m_edgeListState;
     if (xml!=0) {
         qDebug()<< "**** Parser::~Parser() clearing xml reader object " ;
         xml->clear();
@@ -138,6 +501,23 @@ void Parser::load(const QString fn,
 
     errorMessage=QString::null;
 
+    if ( m_edgeListState != 0 ) {
+        // read only what was appended to an edge list loaded before
+        appendEdgeList();
+        emit finished ("Parser::load() - appended");
+        return;
+    }
+
+    {
+        // report files which cannot be read or decompressed before parsing
+        NetworkFile file ( fileName );
+        if ( ! file.open(QIODevice::ReadOnly ) ) {
+            loadFileError( tr("Cannot read file %1: %2")
+                           .arg(fileName).arg(file.errorString()) );
+            return;
+        }
+    }
+
     switch (fileFormat){
     case FileType::GRAPHML:
         qDebug()<< "Parser::load() - calling loadGraphML()";
@@ -232,6 +612,7 @@ void Parser::load(const QString fn,
 void Parser::loadFileError(const QString &errorMessage) {
     qDebug()<<"Parser::loadFileError() - errorMessage:"
            <<errorMessage;
+    batchFlush();
     emit networkFileLoaded(FileType::UNRECOGNIZED,
                            QString::null,
                            QString::null,
@@ -242,6 +623,25 @@ void Parser::loadFileError(const QString &errorMessage) {
                            );
 }
 
+/**
+ * @brief Returns true, setting errorMessage, if the file could not be read
+ * to its end, i.e. compressed data which is corrupt or truncated.
+ * Called by the load methods before reporting the network as loaded.
+ * @param file
+ * @return
+ */
+bool Parser::fileReadFailed(const NetworkFile &file) {
+    if ( file.streamError().isEmpty() ) {
+        return false;
+    }
+    qDebug() << "Parser::fileReadFailed() -" << file.streamError();
+    errorMessage = tr("Cannot read file %1: %2")
+            .arg(fileName).arg(file.streamError());
+    return true;
+}
+
+
+
 /**
  * @brief Parser::createRandomNodes
  * @param fixedNum
@@ -254,6 +654,7 @@ void Parser::createRandomNodes(const int &fixedNum,
                                const QString &label,
                                const int &newNodes){
     qDebug() << "Parser::createRandomNodes()";
+    batchFlush();
     if (newNodes != 1 ) {
         for (int i=0; i<newNodes; i++) {
             qDebug() << "Parser::createRandomNodes() - Multiple nodes. "
@@ -270,93 +671,509 @@ void Parser::createRandomNodes(const int &fixedNum,
     }
 }
 
+
+
 /**
-    Tries to load a file as DL-formatted network (UCINET)
-    If not it returns -1
-*/
-bool Parser::loadDL(){
+ * @brief Number of nodes and edges collected before a batch is handed to Graph
+ */
+static const int PARSER_BATCH_SIZE = 65536;
 
-    qDebug() << "Parser::loadDL() - Reading UCINET formatted file ";
-    QFile file ( fileName );
-    if ( ! file.open(QIODevice::ReadOnly )) {
-        errorMessage = tr("Cannot open UCINET file ");
-        return false;
-    }
-    QTextStream ts( &file );
-    ts.setCodec(userSelectedCodecName.toUtf8());
 
-    QString str=QString::null;
-    QString relation=QString::null;
-    QString prevLineStr=QString::null;
-    QString label=QString::null;
-    QString value=QString::null;
-    QString dlFormat=QString::null;
-    QString edgeStr;
 
-    int lineCounter = 0;
-    int source=1;
-    int target=1;
-    int NM=0;
-    int NR=0;
-    int NC=0;
-    int nodeSum=0;
-    int relationCounter=0;
+/**
+ * @brief Appends a node to the current batch, instead of emitting it alone.
+ * The batch is handed to Graph when it is full, or by batchFlush().
+ * @param num
+ * @param size
+ * @param color
+ * @param numColor
+ * @param numSize
+ * @param label
+ * @param lColor
+ * @param lSize
+ * @param p
+ * @param shape
+ * @param iconPath
+ */
+void Parser::batchNode(const int &num,
+                       const int &size,
+                       const QString &color,
+                       const QString &numColor,
+                       const int &numSize,
+                       const QString &label,
+                       const QString &lColor,
+                       const int &lSize,
+                       const QPointF &p,
+                       const QString &shape,
+                       const QString &iconPath) {
+    if (m_batch == 0) {
+        m_batch = new ParserBatch;
+        m_batch->updateEdgeWeights = m_batchUpdatesEdgeWeights;
+    }
+    m_batch->nodeNumber.append(num);
+    m_batch->nodeSize.append(size);
+    m_batch->nodeColor.append(m_batch->intern(color));
+    m_batch->nodeNumberColor.append(m_batch->intern(numColor));
+    m_batch->nodeNumberSize.append(numSize);
+    m_batch->nodeLabel.append(m_batch->intern(label));
+    m_batch->nodeLabelColor.append(m_batch->intern(lColor));
+    m_batch->nodeLabelSize.append(lSize);
+    m_batch->nodePos.append(p);
+    m_batch->nodeShape.append(m_batch->intern(shape));
+    m_batch->nodeIconPath.append(m_batch->intern(iconPath));
+    if (m_batch->count() >= PARSER_BATCH_SIZE) {
+        batchFlush();
+    }
+}
 
-    bool rowLabels_flag=false;
-    bool colLabels_flag=false;
-    bool data_flag=false;
-    bool relation_flag=false;
-    bool nodesCreated_flag=false;
-    bool twoMode_flag=false;
 
-    bool fullmatrixFormat=false;
-    bool edgelist1Format=false;
 
-    bool intOK=false;
-    bool conversionOK=false;
+/**
+ * @brief Appends an edge to the current batch, instead of emitting it alone.
+ * The batch is handed to Graph when it is full, or by batchFlush().
+ * @param source
+ * @param target
+ * @param weight
+ * @param color
+ * @param edgeDirType
+ * @param arrows
+ * @param bezier
+ * @param edgeLabel
+ */
+void Parser::batchEdge(const int &source, const int &target, const qreal &weight,
+                       const QString &color, const int &edgeDirType,
+                       const bool &arrows, const bool &bezier,
+                       const QString &edgeLabel) {
+    if (m_batch == 0) {
+        m_batch = new ParserBatch;
+        m_batch->updateEdgeWeights = m_batchUpdatesEdgeWeights;
+    }
+    m_batch->edgeSource.append(source);
+    m_batch->edgeTarget.append(target);
+    m_batch->edgeWeight.append(weight);
+    m_batch->edgeColor.append(m_batch->intern(color));
+    m_batch->edgeType.append(edgeDirType);
+    m_batch->edgeArrows.append(arrows);
+    m_batch->edgeBezier.append(bezier);
+    m_batch->edgeLabel.append(m_batch->intern(edgeLabel));
+    if (m_batch->count() >= PARSER_BATCH_SIZE) {
+        batchFlush();
+    }
+}
 
-    QStringList lineElement;
-    QStringList tempList;
-    QStringList rowLabels;
-    QStringList colLabels;
 
-    relationsList.clear();
 
-    totalLinks=0;
-    arrows=true;
-    bezier=false;
-    edgeWeight=0;
+/**
+ * @brief Hands the current batch of nodes and edges over to Graph.
+ * Must be called before any other signal to Graph (i.e. addRelation),
+ * so that Graph receives everything in the order it was read.
+ */
+void Parser::batchFlush() {
+    if (m_batch == 0) {
+        return;
+    }
+    qDebug() << "Parser::batchFlush() - emitting batchReady() with"
+             << m_batch->nodeNumber.count() << "nodes and"
+             << m_batch->edgeSource.count() << "edges";
+    ParserBatch *batch = m_batch;
+    m_batch = 0;
+    emit batchReady(batch);
+}
 
-    while ( !ts.atEnd() )   {
+/**
+ * @brief Returns true if the byte c is a white space, as in QString::simplified()
+ * @param c
+ * @return
+ */
+static inline bool isSpaceByte(const char &c) {
+    return ( c == ' ' || c == '\t' || c == '\r' || c == '\v' || c == '\f' );
+}
 
-        str= ts.readLine();
-        str=str.simplified();
 
-        if ( isComment(str) )
-            continue;
 
-        lineCounter++;
+/**
+ * @brief Copies the bytes [from, to) of a line into buffer, trimmed and with
+ * every white space run collapsed to a single space, as QString::simplified()
+ * does.
+ * @param from
+ * @param to
+ * @param buffer
+ * @param hasLetters  set to true if the line contains ASCII letters
+ * @return the length of the simplified line
+ */
+static int simplifyLine(const char *from, const char *to,
+                        QByteArray &buffer, bool &hasLetters) {
+    buffer.resize( (int) (to - from) );
+    char *out = buffer.data();
+    int n = 0;
+    bool space = false;
+    hasLetters = false;
+    for (const char *p = from ; p < to ; ++p ) {
+        if ( isSpaceByte(*p) ) {
+            space = ( n > 0 );
+            continue;
+        }
+        if (space) {
+            out[n++] = ' ';
+            space = false;
+        }
+        if ( ( *p | 0x20 ) >= 'a' && ( *p | 0x20 ) <= 'z' ) {
+            hasLetters = true;
+        }
+        out[n++] = *p;
+    }
+    return n;
+}
 
-        qDebug() << "Parser::loadDL() - lineCount " << lineCounter
-                 << "str.simplified: \n" << str;
 
-        if ( lineCounter == 1) {
-            if (!str.startsWith("DL",Qt::CaseInsensitive)  )  {
-                qDebug() << "Parser::loadDL() - Not a DL file. Aborting!";
-                errorMessage = tr("File does not start with DL in line 1");
-                file.close();
-                return false;
-            }
-        } // end if lineCounter == 1
 
-        //
-        // This is a DL file.
-        // Check if the line contains DL and comma
-        // or we are still in search for N,NM, and FORMAT keywords
-        //
+/**
+ * @brief Byte counterpart of Parser::isComment for a simplified line
+ * @param line
+ * @param n
+ * @return
+ */
+static inline bool isCommentLine(const char *line, const int &n) {
+    return ( n == 0 || line[0] == '#' || line[0] == '%'
+             || ( n > 1 && line[0] == '/' && ( line[1] == '*' || line[1] == '/' ) ) );
+}
 
 
-        if (  str.startsWith("DL",Qt::CaseInsensitive) ) {
+
+/**
+ * @brief Returns true if the n bytes at line contain the lower case ASCII
+ * needle, ignoring case.
+ * @param line
+ * @param n
+ * @param needle
+ * @return
+ */
+static bool containsNoCase(const char *line, const int &n, const char *needle) {
+    const int m = (int) strlen(needle);
+    for (int i = 0 ; i + m <= n ; i++ ) {
+        int j = 0;
+        while ( j < m && ( line[i+j] | 0x20 ) == needle[j] ) {
+            j++;
+        }
+        if ( j == m ) {
+            return true;
+        }
+    }
+    return false;
+}
+
+
+
+/**
+ * @brief Returns true if the simplified line contains any of the keywords
+ * of other formats (vertices, network, graph, DL, list, xml), ignoring case.
+ * @param line
+ * @param n
+ * @return
+ */
+static bool containsOtherFormatKeywords(const char *line, const int &n) {
+    return ( containsNoCase(line, n, "vertices")
+             || containsNoCase(line, n, "network")
+             || containsNoCase(line, n, "graph")
+             || containsNoCase(line, n, "dl")
+             || containsNoCase(line, n, "list")
+             || containsNoCase(line, n, "xml") );
+}
+
+
+
+/**
+ * @brief Parses a real number from the n bytes at p.
+ * Plain decimals (i.e. 2, -1.5, 0.25) are parsed in place. Anything else
+ * (exponents, long mantissas, surrounding spaces) goes through
+ * QByteArray::toDouble, which accepts the same input as QString::toDouble.
+ * @param p
+ * @param n
+ * @param value
+ * @return true on success
+ */
+static bool parseReal(const char *p, const int &n, qreal &value) {
+    int i = 0;
+    bool negative = false;
+    if ( i < n && ( p[i] == '-' || p[i] == '+' ) ) {
+        negative = ( p[i] == '-' );
+        i++;
+    }
+    quint64 mantissa = 0;
+    int digits = 0, decimals = 0;
+    bool point = false;
+    for ( ; i < n ; i++ ) {
+        if ( p[i] >= '0' && p[i] <= '9' ) {
+            mantissa = mantissa * 10 + ( p[i] - '0' );
+            digits++;
+            if (point) {
+                decimals++;
+            }
+        }
+        else if ( p[i] == '.' && !point ) {
+            point = true;
+        }
+        else {
+            break;
+        }
+    }
+    if ( i == n && digits > 0 && digits <= 15 ) {
+        // both mantissa and 10^decimals are exact doubles,
+        // so a single division is correctly rounded.
+        static const double powersOf10[] = { 1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6,
+                                             1e7, 1e8, 1e9, 1e10, 1e11, 1e12,
+                                             1e13, 1e14, 1e15 };
+        value = (double) mantissa / powersOf10[decimals];
+        if (negative) {
+            value = -value;
+        }
+        return true;
+    }
+    bool ok = false;
+    value = QByteArray::fromRawData(p, n).toDouble(&ok);
+    return ok;
+}
+
+
+
+/**
+ * @brief Splits the size bytes at data in chunks which start at line
+ * boundaries, one per available thread, but no smaller than minChunk bytes.
+ * @param data
+ * @param size
+ * @param minChunk
+ * @return the chunk boundaries: chunk k is [bounds[k], bounds[k+1])
+ */
+static QVector<qint64> splitAtLines(const char *data, const qint64 &size,
+                                    const qint64 &minChunk = 1 << 20) {
+    int chunks = qMax(1, QThread::idealThreadCount());
+    chunks = (int) qMin( (qint64) chunks, size / minChunk + 1 );
+    QVector<qint64> bounds;
+    bounds.append(0);
+    for (int k = 1 ; k < chunks ; k++ ) {
+        qint64 at = qMax( bounds.last(), size * k / chunks );
+        const char *newline = (const char *) memchr(data + at, '\n', size - at);
+        if ( newline == 0 ) {
+            break;
+        }
+        at = newline - data + 1;
+        if ( at > bounds.last() && at < size ) {
+            bounds.append(at);
+        }
+    }
+    bounds.append(size);
+    return bounds;
+}
+
+
+
+/**
+ * @brief Maps the whole (open) file in memory, or reads it at once if
+ * mapping is not possible (i.e. the file is compressed), and returns
+ * a pointer to its bytes.
+ * Files in encodings which are not ASCII compatible (UTF-16/32) are
+ * converted to UTF-8 in buffer, and codec is set to UTF-8.
+ * A leading UTF-8 byte order mark is skipped.
+ * The caller must unmap mapped, if not null.
+ * @param file
+ * @param buffer
+ * @param size   set to the number of bytes
+ * @param mapped set to the mapped memory, or 0
+ * @param codec  the user selected codec
+ * @return
+ */
+static const char *fileBytes(NetworkFile &file, QByteArray &buffer, qint64 &size,
+                             uchar *&mapped, QTextCodec *&codec) {
+    size = file.size();
+    mapped = ( size > 0 && !file.isCompressed() ) ? file.file().map(0, size) : 0;
+    const char *data = 0;
+    if ( mapped ) {
+        data = (const char *) mapped;
+    }
+    else {
+        buffer = file.readAll();
+        data = buffer.constData();
+        size = buffer.size();
+    }
+
+    const int mib = codec->mibEnum();
+    if ( mib == 1013 || mib == 1014 || mib == 1015
+         || mib == 1017 || mib == 1018 || mib == 1019 ) {
+        qDebug() << "fileBytes() - converting" << codec->name() << "to UTF-8";
+        buffer = codec->toUnicode(data, (int) size).toUtf8();
+        data = buffer.constData();
+        size = buffer.size();
+        codec = QTextCodec::codecForName("UTF-8");
+    }
+
+    if ( size >= 3 && (uchar) data[0] == 0xEF && (uchar) data[1] == 0xBB
+         && (uchar) data[2] == 0xBF ) {
+        data += 3;
+        size -= 3;
+    }
+    return data;
+}
+
+
+
+/**
+ * @brief Values found in a chunk of the data section of a fullmatrix
+ * UCINET file. Values are numbered from 0 within the chunk.
+ * Scanning stops at the first value which cannot be converted to a number.
+ */
+struct MatrixValuesChunk {
+    qint64 values;
+    qint64 errorValue;      // value that cannot be converted, or -1
+    QByteArray errorToken;
+    QVector<qint64> nonZero;
+    QVector<qreal> weight;
+};
+
+
+
+/**
+ * @brief Scans the size bytes at data as white space separated matrix
+ * values, skipping comment lines.
+ * @param data
+ * @param size
+ * @param chunk
+ */
+static void scanMatrixValuesChunk(const char *data, const qint64 &size,
+                                  MatrixValuesChunk &chunk) {
+    const char *end = data + size;
+    const char *lineStart = data;
+
+    chunk.values = 0;
+    chunk.errorValue = -1;
+
+    while ( lineStart < end ) {
+
+        const char *lineEnd = (const char *) memchr(lineStart, '\n', end - lineStart);
+        if ( lineEnd == 0 ) {
+            lineEnd = end;
+        }
+        const char *p = lineStart;
+        lineStart = lineEnd + 1;
+
+        while ( p < lineEnd && isSpaceByte(*p) ) {
+            p++;
+        }
+        if ( isCommentLine(p, (int) (lineEnd - p) ) ) {
+            continue;
+        }
+
+        while ( p < lineEnd ) {
+            const char *token = p;
+            while ( p < lineEnd && !isSpaceByte(*p) ) {
+                p++;
+            }
+            qreal weight = 0;
+            if ( ! parseReal(token, (int) (p - token), weight) ) {
+                chunk.errorValue = chunk.values;
+                chunk.errorToken = QByteArray(token, (int) (p - token));
+                return;
+            }
+            if ( weight ) {
+                chunk.nonZero.append(chunk.values);
+                chunk.weight.append(weight);
+            }
+            chunk.values++;
+            while ( p < lineEnd && isSpaceByte(*p) ) {
+                p++;
+            }
+        }
+    }
+}
+
+
+
+/**
+    Tries to load a file as DL-formatted network (UCINET)
+    If not it returns -1
+*/
+bool Parser::loadDL(){
+
+    qDebug() << "Parser::loadDL() - Reading UCINET formatted file ";
+    NetworkFile file ( fileName );
+    if ( ! file.open(QIODevice::ReadOnly )) {
+        errorMessage = tr("Cannot open UCINET file ");
+        return false;
+    }
+    QTextStream ts( &file );
+    ts.setCodec(userSelectedCodecName.toUtf8());
+
+    QString str=QString::null;
+    QString relation=QString::null;
+    QString prevLineStr=QString::null;
+    QString label=QString::null;
+    QString value=QString::null;
+    QString dlFormat=QString::null;
+    QString edgeStr;
+
+    int lineCounter = 0;
+    int source=1;
+    int target=1;
+    int NM=0;
+    int NR=0;
+    int NC=0;
+    int nodeSum=0;
+    int relationCounter=0;
+
+    bool rowLabels_flag=false;
+    bool colLabels_flag=false;
+    bool data_flag=false;
+    bool relation_flag=false;
+    bool nodesCreated_flag=false;
+    bool twoMode_flag=false;
+
+    bool fullmatrixFormat=false;
+    bool edgelist1Format=false;
+
+    bool intOK=false;
+    bool conversionOK=false;
+
+    QStringList lineElement;
+    QStringList tempList;
+    QStringList rowLabels;
+    QStringList colLabels;
+
+    relationsList.clear();
+
+    totalLinks=0;
+    arrows=true;
+    bezier=false;
+    edgeWeight=0;
+
+    while ( !ts.atEnd() )   {
+
+        str= ts.readLine();
+        str=str.simplified();
+
+        if ( isComment(str) )
+            continue;
+
+        lineCounter++;
+
+        qDebug() << "Parser::loadDL() - lineCount " << lineCounter
+                 << "str.simplified: \n" << str;
+
+        if ( lineCounter == 1) {
+            if (!str.startsWith("DL",Qt::CaseInsensitive)  )  {
+                qDebug() << "Parser::loadDL() - Not a DL file. Aborting!";
+                errorMessage = tr("File does not start with DL in line 1");
+                file.close();
+                return false;
+            }
+        } // end if lineCounter == 1
+
+        //
+        // This is a DL file.
+        // Check if the line contains DL and comma
+        // or we are still in search for N,NM, and FORMAT keywords
+        //
+
+
+        if (  str.startsWith("DL",Qt::CaseInsensitive) ) {
 
             if ( str.contains(",") ) {
                 qDebug() << "Parser::loadDL() - DL starting line contains a comma" ;
@@ -567,6 +1384,7 @@ bool Parser::loadDL(){
                 qDebug() << "Parser::loadDL() - adding relation "<< relation
                          << " to relationsList and emitting addRelation ";
                 relationsList << relation;
+                batchFlush();
                 emit addRelation( relation );
             }
         }
@@ -675,81 +1493,13 @@ bool Parser::loadDL(){
 
                     qDebug() << "Parser::loadDL() - reading edges in fullmatrix format";
 
-                    //SPLIT EACH LINE (ON EMPTY SPACE CHARACTERS)
-                    if (!prevLineStr.isEmpty()) {
-                        str=(prevLineStr.append(" ")).append(str) ;
-                        qDebug() << "Parser::loadDL() -prevLineStr not empty - "
-                                    "prepending it to str - new str: \n" << str;
-                        str=str.simplified();
-                    }
-                    qDebug() << "Parser::loadDL() - splitting str to elements ";
-                    lineElement=str.split(QRegExp("\\s+"), QString::SkipEmptyParts);
-                    qDebug() << "Parser::loadDL() - line elements " << lineElement.count();
-                    if (lineElement.count() < totalNodes ) {
-                        qDebug() << "Parser::loadDL() -This line has "
-                                 << lineElement.count()
-                                 << " elements, expected "
-                                 << totalNodes << " - appending next line";
-                        prevLineStr=str;
-                        continue;
-                    }
-                    prevLineStr.clear();
-                    target=1;
-                    if (source==1 && relationCounter>0){
-                        qDebug() << "Parser::loadDL() - we are at source 1. "
-                                    "Checking relationList";
-                        relation = relationsList[ relationCounter ];
-                        qDebug() << "Parser::loadDL() - "
-                                    "WE ARE THE FIRST DATASET/MATRIX"
-                                 << " source node counter is " << source
-                                 << " and relation to " << relation<< ": "
-                                 << relationCounter;
-                        emit relationSet (relationCounter);
-                    }
-                    else if (source>totalNodes) {
-                        source=1;
-                        relationCounter++;
-                        relation = relationsList[ relationCounter ];
-                        qDebug() << "Parser::loadDL() - "
-                                    "LOOKS LIKE WE ENTERED A NEW DATASET/MATRIX "
-                                 << " init source node counter to " << source
-                                 << " and relation to " << relation << ": "
-                                 << relationCounter;
-                        emit relationSet (relationCounter);
-                    }
-                    else {
-                        qDebug() << "Parser::loadDL() - source node counter is " << source;
+                    // The rest of the file holds the matrices:
+                    // parse them at once, in parallel.
+                    if ( ! loadDLFullMatrix(ts, str) ) {
+                        file.close();
+                        return false;
                     }
-
-                    for (QStringList::Iterator it1 = lineElement.begin(); it1!=lineElement.end(); ++it1)   {
-
-                        edgeStr = (*it1);
-                        edgeWeight=(*it1).toDouble(&conversionOK);
-                        if ( !conversionOK )  {
-                            errorMessage = tr("Error reading loadDL-formatted fullmatrix file. "
-                                                    "in edge (%1->%2), the weight (%3) cannot be converted.").arg(source).arg(target).arg(edgeWeight);
-                            return false;
-                        }
-
-                        if ( edgeWeight ){
-
-                            qDebug() << "Parser::loadDL() - relation "
-                                     << relationCounter
-                                     << " found edge from "
-                                     << source << " to " << target
-                                     << " weight " << edgeWeight
-                                     << " emitting edgeCreate() to parent" ;
-
-                            emit edgeCreate( source, target, edgeWeight, initEdgeColor,
-                                             EdgeType::Directed, arrows, bezier);
-                            totalLinks++;
-                            qDebug() << "Parser::loadDL() - TotalLinks= " << totalLinks;
-
-                        }
-                        target++;
-                    } // end for
-
-                    source++;
+                    break;
 
                 }
                 else {
@@ -788,8 +1538,8 @@ bool Parser::loadDL(){
                                      << " weight " << edgeWeight
                                      << " emitting edgeCreate() to parent" ;
 
-                            emit edgeCreate( source, target, edgeWeight, initEdgeColor,
-                                             EdgeType::Directed, arrows, bezier);
+                            batchEdge( source, target, edgeWeight, initEdgeColor,
+                                       EdgeType::Directed, arrows, bezier);
                             totalLinks++;
                             qDebug() << "Parser::loadDL() - TotalLinks= " << totalLinks;
 
@@ -840,8 +1590,8 @@ bool Parser::loadDL(){
                 qDebug() << "Parser::loadDL() - Creating link "
                          << source << " -> "<< target << " weight= "<< edgeWeight
                          <<  " TotalLinks=  " << totalLinks+1;
-                emit edgeCreate(source, target, edgeWeight, initEdgeColor, EdgeType::Directed,
-                                arrows, bezier);
+                batchEdge(source, target, edgeWeight, initEdgeColor, EdgeType::Directed,
+                          arrows, bezier);
                 totalLinks++;
             } // END edgelist1 format reading.
 
@@ -858,6 +1608,11 @@ bool Parser::loadDL(){
         return false;
     }
 
+    if ( fileReadFailed(file) ) {
+        return false;
+    }
+
+    batchFlush();
     if (relationsList.count() == 0) {
         emit addRelation("unnamed");
     }
@@ -881,6 +1636,92 @@ bool Parser::loadDL(){
 
 
 
+/**
+ * @brief Reads the data section of a one-mode fullmatrix UCINET file,
+ * which starts at firstLine and continues to the end of ts.
+ *
+ * The values are row-major N x N matrices, one per relation, which may
+ * wrap over several lines. The section is split at line boundaries in
+ * chunks, which are parsed on the thread pool; the values are then
+ * numbered in file order to find the relation, source and target of each
+ * non-zero one. An incomplete last row is ignored.
+ * @param ts
+ * @param firstLine
+ * @return false if a value cannot be converted to a number
+ */
+bool Parser::loadDLFullMatrix(QTextStream &ts, const QString &firstLine) {
+
+    const QByteArray contents = ( firstLine + "\n" + ts.readAll() ).toUtf8();
+    const char *data = contents.constData();
+    const qint64 size = contents.size();
+    const qint64 N = totalNodes;
+
+    const QVector<qint64> bounds = splitAtLines(data, size);
+    QVector<MatrixValuesChunk> chunks(bounds.count() - 1);
+    QVector<int> chunkIndex(chunks.count());
+    for (int k = 0 ; k < chunks.count() ; k++ ) {
+        chunkIndex[k] = k;
+    }
+
+    qDebug() << "Parser::loadDLFullMatrix() - parsing" << size << "bytes in"
+             << chunks.count() << "chunks";
+
+    QtConcurrent::blockingMap(chunkIndex, [&](const int &k) {
+        scanMatrixValuesChunk(data + bounds[k], bounds[k+1] - bounds[k], chunks[k]);
+    });
+
+    if ( N <= 0 ) {
+        return true;
+    }
+
+    qint64 offset = 0;
+    for (int k = 0 ; k < chunks.count() ; k++ ) {
+        if ( chunks[k].errorValue != -1 ) {
+            const qint64 v = offset + chunks[k].errorValue;
+            errorMessage = tr("Error reading loadDL-formatted fullmatrix file. "
+                              "in edge (%1->%2), the weight (%3) cannot be converted.")
+                    .arg( (v % (N*N)) / N + 1 ).arg( v % N + 1 )
+                    .arg( QString::fromUtf8(chunks[k].errorToken) );
+            return false;
+        }
+        offset += chunks[k].values;
+    }
+
+    const qint64 complete = ( offset / N ) * N;
+    int relationCounter = 0;
+
+    offset = 0;
+    for (int k = 0 ; k < chunks.count() ; k++ ) {
+        const MatrixValuesChunk &chunk = chunks[k];
+        for (int e = 0 ; e < chunk.nonZero.count() ; e++ ) {
+            const qint64 v = offset + chunk.nonZero[e];
+            if ( v >= complete ) {
+                break;
+            }
+            const int relation = (int) ( v / (N*N) );
+            while ( relationCounter < relation ) {
+                relationCounter++;
+                qDebug() << "Parser::loadDLFullMatrix() - "
+                            "ENTERED A NEW DATASET/MATRIX, relation" << relationCounter;
+                batchFlush();
+                emit relationSet (relationCounter);
+            }
+            batchEdge( (int) ( (v % (N*N)) / N + 1 ), (int) ( v % N + 1 ),
+                       chunk.weight[e], initEdgeColor,
+                       EdgeType::Directed, arrows, bezier);
+            totalLinks++;
+        }
+        offset += chunk.values;
+    }
+
+    qDebug() << "Parser::loadDLFullMatrix() - values" << offset
+             << "TotalLinks= " << totalLinks;
+
+    return true;
+}
+
+
+
 bool Parser::readDLKeywords(QStringList &strList,
                             int &N,
                             int &NM,
@@ -992,37 +1833,182 @@ bool Parser::readDLKeywords(QStringList &strList,
 
 
 /**
-    Tries to load the file as Pajek-formatted network. If not it returns -1
-*/
-bool Parser::loadPajek(){
+ * @brief Sections of a Pajek-formatted file, started by keyword lines
+ */
+enum PajekSection {
+    PajekNone,
+    PajekNetwork,
+    PajekVertices,
+    PajekArcs,
+    PajekEdges,
+    PajekArcslist,
+    PajekEdgeslist,
+    PajekMatrix,
+    PajekUnknown
+};
 
-    qDebug ("\n\nParser: loadPajek");
-    QFile file ( fileName );
-    if ( ! file.open(QIODevice::ReadOnly ))  {
-        errorMessage = tr("Cannot open Pajek file");
-        return false;
-    }
-    QTextStream ts( &file );
-    ts.setCodec(userSelectedCodecName.toUtf8());
-    QString str, label, temp;
-    nodeColor="";
-    edgeColor="";
-    nodeShape="";
+
+
+/**
+ * @brief Splits a Pajek line into whitespace separated tokens without
+ * copying any text. A double quoted string is a single token (the quotes
+ * excluded), so that labels may contain spaces.
+ * @param line
+ * @param tokens
+ * @return the number of tokens
+ */
+static int pajekTokenize(const QString &line, QVector<QStringRef> &tokens) {
+    tokens.clear();
+    const QChar *data = line.constData();
+    const int n = line.size();
+    int i = 0, start = 0, end = 0;
+    while ( i < n ) {
+        while ( i < n && data[i].isSpace() ) {
+            ++i;
+        }
+        if ( i == n ) {
+            break;
+        }
+        if ( data[i] == QLatin1Char('"') ) {
+            start = ++i;
+            while ( i < n && data[i] != QLatin1Char('"') ) {
+                ++i;
+            }
+            end = i;
+            if ( i < n ) {
+                ++i;
+            }
+        }
+        else {
+            start = i;
+            while ( i < n && !data[i].isSpace() ) {
+                ++i;
+            }
+            end = i;
+        }
+        tokens.append( QStringRef( &line, start, end - start ) );
+    }
+    return tokens.size();
+}
+
+
+
+/**
+ * @brief Returns the PajekSection started by a keyword token such as
+ * "*Vertices" or "*Arcs:2".
+ * @param token
+ * @return
+ */
+static int pajekSection(const QStringRef &token) {
+    static const struct {
+        const char *keyword;
+        int section;
+    } keywords[] = {
+        { "*network",   PajekNetwork },
+        { "*vertices",  PajekVertices },
+        { "*arcs",      PajekArcs },
+        { "*edges",     PajekEdges },
+        { "*arcslist",  PajekArcslist },
+        { "*edgeslist", PajekEdgeslist },
+        { "*matrix",    PajekMatrix }
+    };
+    const int colon = token.indexOf(QLatin1Char(':'));
+    const QStringRef keyword = ( colon == -1 ) ? token : token.left(colon);
+    for (unsigned int k = 0; k < sizeof(keywords) / sizeof(keywords[0]); ++k) {
+        if ( keyword.compare( QLatin1String(keywords[k].keyword),
+                              Qt::CaseInsensitive ) == 0 ) {
+            return keywords[k].section;
+        }
+    }
+    return PajekUnknown;
+}
+
+
+
+/**
+ * @brief Returns true if token is a Pajek vertex shape, setting shape to
+ * the corresponding SocNetV shape name.
+ * @param token
+ * @param shape
+ * @return
+ */
+static bool pajekShape(const QStringRef &token, QString &shape) {
+    static const char *shapes[] = {
+        "ellipse", "circle", "box", "star", "triangle", "diamond"
+    };
+    for (unsigned int s = 0; s < sizeof(shapes) / sizeof(shapes[0]); ++s) {
+        if ( token.compare( QLatin1String(shapes[s]), Qt::CaseInsensitive ) == 0 ) {
+            shape = QLatin1String(shapes[s]);
+            return true;
+        }
+    }
+    return false;
+}
+
+
+
+/**
+ * @brief Returns true if token is a Pajek vertex or line parameter which
+ * takes a value but has no SocNetV counterpart, i.e. border colour or width.
+ * The loader skips these together with their values.
+ * @param token
+ * @return
+ */
+static bool pajekIgnoredParameter(const QStringRef &token) {
+    static const char *parameters[] = {
+        "bc", "bw", "lc", "x_fact", "y_fact", "s_size", "phi", "r", "q",
+        "la", "lr", "lphi", "fos", "font", "w", "p", "a", "s", "ap", "h1", "h2",
+        "k1", "k2", "a1", "a2"
+    };
+    for (unsigned int p = 0; p < sizeof(parameters) / sizeof(parameters[0]); ++p) {
+        if ( token == QLatin1String(parameters[p]) ) {
+            return true;
+        }
+    }
+    return false;
+}
+
+
+
+/**
+ * @brief Loads a Pajek-formatted network.
+ * Each line is split by pajekTokenize() into references to its text.
+ * Keyword lines (*Network, *Vertices, *Arcs, *Edges, *Arcslist, *Edgeslist
+ * and *Matrix) switch the section the next lines belong to; vertex and line
+ * parameters (coordinates, shape, ic, c, l) are then read by position and
+ * name, without any regular expression.
+ * @return false if the file is not Pajek-formatted.
+ */
+bool Parser::loadPajek(){
+
+    qDebug ("\n\nParser: loadPajek");
+    NetworkFile file ( fileName );
+    if ( ! file.open(QIODevice::ReadOnly ))  {
+        errorMessage = tr("Cannot open Pajek file");
+        return false;
+    }
+    QTextStream ts( &file );
+    ts.setCodec(userSelectedCodecName.toUtf8());
+    QString str, label;
+    nodeColor="";
+    edgeColor="";
+    nodeShape="";
     initEdgeLabel = QString::null;
-    QStringList lineElement;
-    bool ok=false, intOk=false, check1=false, check2=false;
-    bool has_arcs=false;
-    bool nodes_flag=false, edges_flag=false, arcs_flag=false, arcslist_flag=false, matrix_flag=false;
+    QVector<QStringRef> tokens;
+    tokens.reserve(32);
+    bool ok=false, check1=false;
+    bool has_arcs=false, nodesChecked=false;
+    int section=PajekNone;
     fileContainsNodeColors=false;
     fileContainsNodeCoords=false;
     fileContainsLinkColors=false;
     fileContainsLinkLabels=false;
     bool zero_flag=false;
-    int   i=0, j=0, miss=0, source= -1, target=-1, nodeNum, colorIndex=-1;
-    int coordIndex=-1, labelIndex=-1;
+    int   i=0, j=0, miss=0, source= -1, target=-1, nodeNum, count=0, k=0;
     unsigned long int lineCounter=0;
     int pos=-1, relationCounter=0;
-    qreal weight=1;
+    qreal coords[3];
+    int coordsCount=0;
     QString relation;
     list<int> listDummiesPajek;
     totalLinks=0;
@@ -1035,25 +2021,21 @@ bool Parser::loadPajek(){
 
     while ( !ts.atEnd() )   {
         str= ts.readLine();
-        str = str.simplified();
+        count = pajekTokenize(str, tokens);
 
-        if ( isComment(str)  )
+        if ( count == 0
+             || tokens[0].startsWith(QLatin1Char('#'))
+             || tokens[0].startsWith(QLatin1Char('%'))
+             || tokens[0].startsWith(QLatin1String("//"))
+             || tokens[0].startsWith(QLatin1String("/*")) )
             continue;
 
         lineCounter++;
-        qDebug()<< "*** Parser:loadPajek(): "
-                << str;
-        if (lineCounter==1) {
-            if ( str.startsWith("graph",Qt::CaseInsensitive)
-                 || str.startsWith("digraph",Qt::CaseInsensitive)
-                 || str.startsWith("DL",Qt::CaseInsensitive)
-                 || str.startsWith("list",Qt::CaseInsensitive)
-                 || str.startsWith("graphml",Qt::CaseInsensitive)
-                 || str.startsWith("<?xml",Qt::CaseInsensitive)
-                 || str.startsWith("LEDA.GRAPH",Qt::CaseInsensitive)
-                 || ( !str.startsWith("*network",Qt::CaseInsensitive)
-                    && !str.startsWith("*vertices",Qt::CaseInsensitive) )
-                 ) {
+
+        /** KEYWORD LINES */
+        if ( tokens[0].startsWith(QLatin1Char('*')) ) {
+            const int keyword = pajekSection(tokens[0]);
+            if ( lineCounter==1 && keyword != PajekNetwork && keyword != PajekVertices ) {
                 qDebug()<< "*** Parser:loadPajek(): Not a Pajek-formatted file. Aborting!!";
                 file.close();
                 errorMessage = tr("Not a Pajek-formatted file. "
@@ -1061,25 +2043,12 @@ bool Parser::loadPajek(){
                                   "Network or Vertices");
                 return false;
             }
-        }
-
-        if (!edges_flag && !arcs_flag && !nodes_flag && !arcslist_flag && !matrix_flag) {
-            //qDebug("Parser-loadPajek(): reading headlines");
-            if ( (lineCounter == 1) &&
-                 (!str.contains("network",Qt::CaseInsensitive)
-                  && !str.contains("vertices",Qt::CaseInsensitive)
-                  )
-                )
-            {
-                qDebug("*** Parser-loadPajek(): Not a Pajek file. Aborting!");
-                errorMessage = tr("Not a Pajek-formatted file. "
-                                  "First not-comment line does not start with "
-                                  "Network or Vertices");
-                file.close();
-                return false;
-            }
-            else if (str.startsWith( "*network",Qt::CaseInsensitive) )  { //NETWORK NAME
-                networkName = (str.right(str.size() - 8 )).simplified() ;
+            switch (keyword) {
+            case PajekNetwork: {
+                networkName = str.mid( tokens[0].position() + tokens[0].size() ).simplified();
+                if ( networkName.startsWith('"') ) {
+                    networkName.remove('"');
+                }
                 if (!networkName.isEmpty() ) {
                     qDebug()<<"Parser::loadPajek(): networkName: "
                            <<networkName;
@@ -1090,80 +2059,94 @@ bool Parser::loadPajek(){
                 }
                 continue;
             }
-            if (str.contains( "vertices", Qt::CaseInsensitive) )  {
-                lineElement=str.split(QRegExp("\\s+"));
-                if (!lineElement[1].isEmpty()) 	totalNodes=lineElement[1].toInt(&intOk,10);
+            case PajekVertices: {
+                if ( count > 1 ) {
+                    totalNodes=tokens[1].toInt(&ok,10);
+                }
                 qDebug ("Parser-loadPajek(): Vertices %i.",totalNodes);
+                section = PajekVertices;
                 continue;
             }
-            qDebug("Parser-loadPajek(): headlines end here");
-        }
-        /**SPLIT EACH LINE (ON EMPTY SPACE CHARACTERS) IN SEVERAL ELEMENTS*/
-        lineElement=str.split(QRegExp("\\s+"), QString::SkipEmptyParts);
-
-        if ( str.contains( "*edges", Qt::CaseInsensitive) ) {
-            edges_flag=true; arcs_flag=false; arcslist_flag=false; matrix_flag=false;
-            continue;
-        }
-        else if ( str.contains( "*arcs", Qt::CaseInsensitive) ) {
-            arcs_flag=true; edges_flag=false; arcslist_flag=false;
-            matrix_flag=false;
-            //check if row has label for arcs data,
-            // and use it as relation name
-            if ( (pos = str.indexOf(":")) != -1 ) {
-                relation = str.right(str.size() - pos -1) ;
-                relation = relation.simplified();
-                qDebug() << "Parser::loadPajek() - adding relation "<< relation
-                         << " to relationsList and emitting addRelation ";
-                relationsList << relation;
-                emit addRelation( relation );
-                if (relationCounter > 0) {
-                    qDebug () << "Parser::loadPajek() relationCounter "
-                              << relationCounter
-                              << "emitting relationSet";
-                    emit relationSet(relationCounter);
-                    i=0; // reset the source node index
+            case PajekArcs:
+            case PajekEdges:
+            case PajekArcslist:
+            case PajekEdgeslist:
+            case PajekMatrix: {
+                section = keyword;
+                //check if row has label for the lines data,
+                // and use it as relation name
+                if ( (pos = str.indexOf(":")) != -1 ) {
+                    relation = str.right(str.size() - pos -1) ;
+                    relation = relation.simplified();
+                    qDebug() << "Parser::loadPajek() - adding relation "<< relation
+                             << " to relationsList and emitting addRelation ";
+                    relationsList << relation;
+                    batchFlush();
+                    emit addRelation( relation );
+                    if (relationCounter > 0) {
+                        qDebug () << "Parser::loadPajek() relationCounter "
+                                  << relationCounter
+                                  << "emitting relationSet";
+                        emit relationSet(relationCounter);
+                        i=0; // reset the source node index
+                    }
+                    relationCounter++;
                 }
-                relationCounter++;
+                break;
             }
-
-            continue;
-        }
-        else if ( str.contains( "*arcslist", Qt::CaseInsensitive) ) {
-            arcs_flag=false; edges_flag=false; arcslist_flag=true; matrix_flag=false;
-            continue;
-        }
-        else if ( str.contains( "*matrix", Qt::CaseInsensitive) ) {
-            qDebug() << str ;
-            arcs_flag=false; edges_flag=false; arcslist_flag=false;
-            matrix_flag=true;
-            //check if row has label for matrix data,
-            // and use it as relation name
-            if ( (pos = str.indexOf(":")) != -1 ) {
-                relation = str.right(str.size() - pos -1) ;
-                relation = relation.simplified();
-                qDebug() << "Parser::loadPajek() - adding relation "<< relation
-                         << " to relationsList and emitting addRelation ";
-                relationsList << relation;
-                emit addRelation( relation );
-                if (relationCounter > 0) {
-                    qDebug () << "Parser::loadPajek() relationCounter "
-                              << relationCounter
-                              << "emitting relationSet";
-                    emit relationSet(relationCounter);
-                    i=0; // reset the source node index
+            default: {
+                qDebug() << "Parser::loadPajek() - unknown keyword"
+                         << tokens[0].toString() << "- skipping its section";
+                section = PajekUnknown;
+                continue;
+            }
+            };
+
+            // NODES CREATED. CREATE EDGES/ARCS NOW.
+            // first check that all nodes are already created
+            if ( !nodesChecked ) {
+                nodesChecked = true;
+                if (j && j!=totalNodes)  {  //if there were more or less nodes than the file declared
+                    qDebug()<<"*** WARNING ***: The Pajek file declares " << totalNodes <<"  nodes, but I found " <<  j << " nodes...." ;
+                    totalNodes=j;
+                }
+                else if (j==0) {  //if there were no nodes at all, we need to create them now.
+                    qDebug()<< "The Pajek file declares "<< totalNodes<< " but I didnt found any nodes. I will create them....";
+                    for (int num=j+1; num<= totalNodes; num++) {
+                        randX=rand()%gwWidth;
+                        randY=rand()%gwHeight;
+                        batchNode(
+                                    num,
+                                    initNodeSize,
+                                    initNodeColor,
+                                    initNodeNumberColor,
+                                    initNodeNumberSize,
+                                    QString::number(num),
+                                    initNodeLabelColor,
+                                    initNodeLabelSize,
+                                    QPointF(randX, randY),
+                                    initNodeShape,
+                                    QString::null);
+                    }
+                    j=totalNodes;
                 }
-                relationCounter++;
             }
             continue;
         }
 
-        /** READING NODES */
-        if (!edges_flag && !arcs_flag && !arcslist_flag && !matrix_flag) {
-            //qDebug("=== Reading nodes ===");
-            nodes_flag=true;
-            nodeNum=lineElement[0].toInt(&intOk, 10);
-            //qDebug()<<"node number: "<<nodeNum;
+        if (lineCounter==1) {
+            qDebug()<< "*** Parser:loadPajek(): Not a Pajek-formatted file. Aborting!!";
+            file.close();
+            errorMessage = tr("Not a Pajek-formatted file. "
+                              "First not-comment line does not start with "
+                              "Network or Vertices");
+            return false;
+        }
+
+        switch (section) {
+        case PajekNone:
+        case PajekVertices: {  /** READING NODES */
+            nodeNum=tokens[0].toInt(&ok, 10);
             if (nodeNum==0) {
                 qDebug ("Node is zero numbered! Raising zero-start-flag - increasing nodenum");
                 zero_flag=true;
@@ -1171,115 +2154,82 @@ bool Parser::loadPajek(){
             if (zero_flag){
                 nodeNum++;
             }
-            if (lineElement.size() < 2 ){
-                label=lineElement[0];
+            if (count < 2 ){
+                label=tokens[0].toString();
                 randX=rand()%gwWidth;
                 randY=rand()%gwHeight;
                 nodeColor=initNodeColor;
                 nodeShape=initNodeShape;
             }
             else {	/** NODELABEL */
-                label=lineElement[1];
-                //qDebug()<< "node label: " << lineElement[1].toLatin1();
-                str.remove (0, str.lastIndexOf(label)+label.size() );
-                //qDebug()<<"cropped str: "<< str.toLatin1();
-                if (label.contains('"', Qt::CaseInsensitive) )
-                    label=label.remove('\"');
-                //qDebug()<<"node label now: " << label.toLatin1();
-
-                /** NODESHAPE: There are five possible . */
-                if (str.contains("Ellipse", Qt::CaseInsensitive) ) nodeShape="ellipse";
-                else if (str.contains("circle", Qt::CaseInsensitive) ) nodeShape="circle";
-                else if (str.contains("box", Qt::CaseInsensitive) ) nodeShape="box";
-                else if (str.contains("star", Qt::CaseInsensitive) ) nodeShape="star";
-                else if (str.contains("triangle", Qt::CaseInsensitive) ) nodeShape="triangle";
-                else nodeShape="diamond";
-                /** NODECOLORS */
-                //if there is an "ic" tag, a specific NodeColor for this node follows...
-                if (str.contains("ic",Qt::CaseInsensitive)) {
-                    for (int c=0; c< lineElement.count(); c++) {
-                        if (lineElement[c] == "ic") {
-                            //the colourname is at c+1 position.
-                            nodeColor=lineElement[c+1];
-                            fileContainsNodeColors=true;
-                            break;
-                        }
+                label=tokens[1].toString();
+                label.remove('\"');
+
+                /** NODE COORDINATES: up to three numbers after the label */
+                k = 2;
+                coordsCount = 0;
+                while ( k < count && coordsCount < 3 ) {
+                    coords[coordsCount] = tokens[k].toDouble(&check1);
+                    if ( !check1 ) {
+                        break;
                     }
-                    //qDebug()<<"nodeColor:" << nodeColor;
-                    if (nodeColor.contains (".") )  nodeColor=initNodeColor;
-                    if (nodeColor.startsWith("RGB")) nodeColor.replace(0,3,"#");
-                    qDebug () << " \n\n PAJEK color " << nodeColor;
+                    ++coordsCount;
+                    ++k;
                 }
-                else { //there is no nodeColor. Use the default
-                    //qDebug("No nodeColor");
-                    fileContainsNodeColors=false;
-                    nodeColor=initNodeColor;
 
+                /** NODESHAPE AND NODECOLORS */
+                nodeShape="diamond";
+                nodeColor=initNodeColor;
+                fileContainsNodeColors=false;
+                for ( ; k < count; ++k) {
+                    if ( pajekShape(tokens[k], nodeShape) ) {
+                        continue;
+                    }
+                    if ( tokens[k] == QLatin1String("ic") && k + 1 < count ) {
+                        //the colourname is at k+1 position.
+                        nodeColor=tokens[++k].toString();
+                        fileContainsNodeColors=true;
+                        if (nodeColor.contains (".") )  nodeColor=initNodeColor;
+                        if (nodeColor.startsWith("RGB")) nodeColor.replace(0,3,"#");
+                    }
+                    else if ( pajekIgnoredParameter(tokens[k]) ) {
+                        ++k;
+                    }
                 }
-                /**READ NODE COORDINATES */
-                if ( str.contains(".",Qt::CaseInsensitive) ) {
-                    for (int c=0; c< lineElement.count(); c++)   {
-                        temp=lineElement.at(c);
-                        //		qDebug()<< temp.toLatin1();
-                        if ((coordIndex=temp.indexOf(".", Qt::CaseInsensitive)) != -1 ){
-                            if (lineElement.at(c-1) == "ic" ) continue;  //pajek declares colors with numbers!
-                            if ( !temp[coordIndex-1].isDigit()) continue;  //needs 0.XX
-                            if (c+1 == lineElement.count() ) {//first coord zero, i.e: 0  0.455
-                                //qDebug ()<<"coords: " <<lineElement.at(c-1).toLatin1() << " " <<temp.toLatin1() ;
-                                randX=lineElement.at(c-1).toDouble(&check1);
-                                randY=temp.toDouble(&check2);
-                            }
-                            else {
-                                //qDebug ()<<"coords: " << temp.toLatin1() << " " <<lineElement[c+1].toLatin1();
-                                randX=temp.toDouble(&check1);
-                                randY=lineElement[c+1].toDouble(&check2);
-                            }
-
-                            if (check1 && check2)    {
-                                randX=randX * gwWidth;
-                                randY=randY * gwHeight;
-                                fileContainsNodeCoords=true;
-                            }
-                            if (randX <= 0.0 || randY <= 0.0 ) {
-                                randX=rand()%gwWidth;
-                                randY=rand()%gwHeight;
-                            }
-                            break;
-                        }
+
+                if ( coordsCount >= 2 ) {
+                    randX=coords[0] * gwWidth;
+                    randY=coords[1] * gwHeight;
+                    fileContainsNodeCoords=true;
+                    if (randX <= 0.0 || randY <= 0.0 ) {
+                        randX=rand()%gwWidth;
+                        randY=rand()%gwHeight;
                     }
-                    //qDebug()<<"Coords: "<<randX << randY<< gwHeight;
                 }
                 else {
                     fileContainsNodeCoords=false;
                     randX=rand()%gwWidth;
                     randY=rand()%gwHeight;
-                    //qDebug()<<"No coords. Using random "<<randX << randY;
                 }
             }
             /**START NODE CREATION */
-            qDebug ()<<"Creating node numbered "<< nodeNum << " Real nodes count (j)= "<< j+1;
             j++;  //Controls the real number of nodes.
             //If the file misses some nodenumbers then we create dummies and delete them afterwards!
             if ( j + miss < nodeNum)  {
                 qDebug ()<<"MW There are "<< j << " nodes but this node has number "<< nodeNum
                         <<"Creating node at "<< randX<<","<< randY;
                 for (int num=j; num< nodeNum; num++) {
-                    //qDebug()<< "Parser-loadPajek(): Creating dummy node number num = "<< num;
-                    //qDebug()<<"Creating node at "<< randX<<","<< randY;
-
-                    emit createNode( num,
-                                     initNodeSize,
-                                     nodeColor,
-                                     initNodeNumberColor,
-                                     initNodeNumberSize,
-                                     label,
-                                     lineElement[3],
-                                    initNodeLabelSize,
-                                    QPointF(randX, randY),
-                                    nodeShape,
-                                    QString::null,
-                                    false
-                                    );
+                    batchNode( num,
+                               initNodeSize,
+                               nodeColor,
+                               initNodeNumberColor,
+                               initNodeNumberSize,
+                               label,
+                               initNodeLabelColor,
+                               initNodeLabelSize,
+                               QPointF(randX, randY),
+                               nodeShape,
+                               QString::null);
 
                     listDummiesPajek.push_back(num);
                     miss++;
@@ -1291,228 +2241,152 @@ bool Parser::loadPajek(){
                                   "nodeNumber smaller than previous nodes.");
                 return false;
             }
-            qDebug ()<<"emitting createNode()";
-            emit createNode(
+            batchNode(
                         nodeNum,initNodeSize, nodeColor,
                         initNodeNumberColor, initNodeNumberSize,
                         label, initNodeLabelColor, initNodeLabelSize,
                         QPointF(randX, randY),
-                        nodeShape, QString::null, false
-                        );
+                        nodeShape, QString::null);
             initNodeColor=nodeColor;
+            break;
         }
-        // NODES CREATED. CREATE EDGES/ARCS NOW.
-        // first check that all nodes are already created
-        else {
-            if (j && j!=totalNodes)  {  //if there were more or less nodes than the file declared
-                qDebug()<<"*** WARNING ***: The Pajek file declares " << totalNodes <<"  nodes, but I found " <<  j << " nodes...." ;
-                totalNodes=j;
+        case PajekEdges:
+        case PajekArcs: {  /** EDGES AND ARCS */
+            if ( count < 2 ) {
+                continue;
             }
-            else if (j==0) {  //if there were no nodes at all, we need to create them now.
-                qDebug()<< "The Pajek file declares "<< totalNodes<< " but I didnt found any nodes. I will create them....";
-                for (int num=j+1; num<= totalNodes; num++) {
-                    qDebug() << "Parser-loadPajek(): Creating node number i = "<< num;
-                    randX=rand()%gwWidth;
-                    randY=rand()%gwHeight;
-                    emit createNode(
-                                num,
-                                initNodeSize,
-                                initNodeColor,
-                                initNodeNumberColor,
-                                initNodeNumberSize,
-                                QString::number(i),
-                                initNodeLabelColor,
-                                initNodeLabelSize,
-                                QPointF(randX, randY),
-                                initNodeShape,
-                                QString::null,
-                                false
-                                );
-                }
-                j=totalNodes;
+            source = tokens[0].toInt(&ok, 10);
+            target = tokens[1].toInt(&ok, 10);
+            k = 2;
+
+            if (source == 0 || target == 0 ) {
+                errorMessage = tr("Pajek-formatted file declares %1 "
+                                  "with a zero source or target nodeNumber. "
+                                  "Each node should have a nodeNumber > 0.")
+                        .arg( (section == PajekEdges) ? tr("edge") : tr("arc") );
+                return false;  //  i --> (i-1)   internally
             }
-            if (edges_flag && !arcs_flag)   {  /**EDGES */
-
-                qDebug("Parser-loadPajek(): ==== Reading edges ====");
-                qDebug()<<lineElement;
-
-                source =  lineElement[0].toInt(&ok, 10);
-                target = lineElement[1].toInt(&ok,10);
-
-                if (source == 0 || target == 0 ) {
-                    errorMessage = tr("Pajek-formatted file declares edge "
-                                            "with a zero source or target nodeNumber. "
-                                            "Each node should have a nodeNumber > 0.");
-                    return false;  //  i --> (i-1)   internally
+            else if (source < 0 && target >0  ) {  //weights come first...
+                edgeWeight  = tokens[0].toDouble(&ok);
+                source = tokens[1].toInt(&ok, 10);
+                if ( count > 2 ) {
+                    target = tokens[2].toInt(&ok,10);
+                    k = 3;
                 }
-                else if (source < 0 && target >0  ) {  //weights come first...
-
-                    edgeWeight  = lineElement[0].toDouble(&ok);
-
-                    source=  lineElement[1].toInt(&ok, 10);
-
-                    if (lineElement.count()>2) {
-                        target = lineElement[2].toInt(&ok,10);
-                    }
-                    else {
-                        target = lineElement[1].toInt(&ok,10);  //self link
-                    }
-
+                else {
+                    target = source;  //self link
                 }
-                else if (lineElement.count()>2) {
-                    edgeWeight =lineElement[2].toDouble(&ok);
+            }
+            else if ( count > 2 ) {
+                edgeWeight = tokens[2].toDouble(&ok);
+                if (ok) {
+                    k = 3;
                 }
                 else {
-                    edgeWeight =1.0;
+                    edgeWeight = 1.0;   // no weight, parameters follow
                 }
+            }
+            else {
+                edgeWeight = 1.0;
+            }
 
-                //qDebug()<<"Parser-loadPajek(): weight "<< weight;
-
-                if (lineElement.contains("c", Qt::CaseSensitive ) ) {
-                    //qDebug("Parser-loadPajek(): file with link colours");
+            /** LINE PARAMETERS */
+            edgeColor=initEdgeColor;
+            edgeLabel=initEdgeLabel;
+            for ( ; k < count; ++k) {
+                if ( k + 1 >= count ) {
+                    break;
+                }
+                if ( tokens[k] == QLatin1String("c") ) {
                     fileContainsLinkColors=true;
-                    colorIndex=lineElement.indexOf( QRegExp("[c]"), 0 ) + 1;
-                    if (colorIndex >= lineElement.count()) edgeColor=initEdgeColor;
-                    else 	edgeColor=lineElement [ colorIndex ];
+                    edgeColor=tokens[++k].toString();
                     if (edgeColor.contains (".") )  edgeColor=initEdgeColor;
-                    //qDebug()<< " current color "<< edgeColor;
                 }
-                else  {
-                    //qDebug("Parser-loadPajek(): file with no link colours");
-                    edgeColor=initEdgeColor;
-                }
-
-                if (lineElement.contains("l", Qt::CaseSensitive ) ) {
-                    qDebug("Parser-loadPajek(): file with link labels");
+                else if ( tokens[k] == QLatin1String("l") ) {
                     fileContainsLinkLabels=true;
-                    labelIndex=lineElement.indexOf( QRegExp("[l]"), 0 ) + 1;
-                    if (labelIndex >= lineElement.count()) edgeLabel=initEdgeLabel;
-                    else 	edgeLabel=lineElement [ labelIndex ];
-                    if (edgeLabel.contains (".") )  edgeLabel=initEdgeLabel;
-                    qDebug()<< " edge label "<< edgeLabel;
+                    edgeLabel=tokens[++k].toString();
                 }
-                else  {
-                    //qDebug("Parser-loadPajek(): file with no link labels");
-                    edgeLabel=initEdgeLabel;
+                else if ( pajekIgnoredParameter(tokens[k]) ) {
+                    ++k;
                 }
+            }
 
+            bezier=false;
+            if ( section == PajekEdges ) {
                 arrows=false;
-                bezier=false;
-                qDebug()<< "Parser-loadPajek(): EDGES: Create edge between " << source << " - "<< target;
-                emit edgeCreate(source, target, edgeWeight, edgeColor,
-                                EdgeType::Undirected, arrows, bezier, edgeLabel);
+                batchEdge(source, target, edgeWeight, edgeColor,
+                          EdgeType::Undirected, arrows, bezier, edgeLabel);
                 totalLinks=totalLinks+2;
-
-            } //end if EDGES
-            else if (!edges_flag && arcs_flag)   {  /** ARCS */
-
-                //qDebug("Parser-loadPajek(): === Reading arcs ===");
-                source=  lineElement[0].toInt(&ok, 10);
-                target = lineElement[1].toInt(&ok,10);
-
-                if (source == 0 || target == 0 ) {
-                    errorMessage = tr("Pajek-formatted file declares arc "
-                                            "with a zero source or target nodeNumber. "
-                                            "Each node should have a nodeNumber > 0.");
-                    return false;   //  i --> (i-1)   internally
-                }
-                else if (source < 0 && target >0 ) {  //weights come first...
-
-                    edgeWeight  = lineElement[0].toDouble(&ok);
-                    source=  lineElement[1].toInt(&ok, 10);
-
-                    if (lineElement.count()>2) {
-                        target = lineElement[2].toInt(&ok,10);
-                    }
-                    else {
-                        target = lineElement[1].toInt(&ok,10);  //self link
-                    }
-
-                }
-                else if (lineElement.count()>2) {
-                    edgeWeight  =lineElement[2].toDouble(&ok);
-                }
-                else {
-                    edgeWeight =1.0;
-                }
-
-                if (lineElement.contains("c", Qt::CaseSensitive ) ) {
-                    //qDebug("Parser-loadPajek(): file with link colours");
-                    edgeColor=lineElement.at ( lineElement.indexOf( QRegExp("[c]"), 0 ) + 1 );
-                    fileContainsLinkColors=true;
-                }
-                else  {
-                    //qDebug("Parser-loadPajek(): file with no link colours");
-                    edgeColor=initEdgeColor;
-                }
-
-                if (lineElement.contains("l", Qt::CaseSensitive ) ) {
-                    qDebug("Parser-loadPajek(): file with link labels");
-                    fileContainsLinkLabels=true;
-                    labelIndex=lineElement.indexOf( QRegExp("[l]"), 0 ) + 1;
-                    if (labelIndex >= lineElement.count()) edgeLabel=initEdgeLabel;
-                    else 	edgeLabel=lineElement.at ( labelIndex );
-                    //if (edgeLabel.contains (".") )  edgeLabel=initEdgeLabel;
-                    qDebug()<< " edge label "<< edgeLabel;
-                }
-                else  {
-                    //qDebug("Parser-loadPajek(): file with no link labels");
-                    edgeLabel=initEdgeLabel;
-                }
+            }
+            else {
                 arrows=true;
-                bezier=false;
                 has_arcs=true;
-                qDebug()<<"Parser-loadPajek(): ARCS: Creating arc from node "<< source << " to node "<< target << " with weight "<< weight;
-                emit edgeCreate(source, target, edgeWeight , edgeColor,
-                                EdgeType::Directed, arrows, bezier, edgeLabel);
+                batchEdge(source, target, edgeWeight , edgeColor,
+                          EdgeType::Directed, arrows, bezier, edgeLabel);
                 totalLinks++;
-            } //else if ARCS
-            else if (arcslist_flag)   {  /** ARCSlist */
-                //qDebug("Parser-loadPajek(): === Reading arcs list===");
-                if (lineElement[0].startsWith("-") ) lineElement[0].remove(0,1);
-                source= lineElement[0].toInt(&ok, 10);
-                fileContainsLinkColors=false;
-                edgeColor=initEdgeColor;
+            }
+            break;
+        }
+        case PajekArcslist:
+        case PajekEdgeslist: {  /** ARCSLIST AND EDGESLIST */
+            source= tokens[0].startsWith(QLatin1Char('-'))
+                    ? tokens[0].mid(1).toInt(&ok, 10)
+                    : tokens[0].toInt(&ok, 10);
+            edgeColor=initEdgeColor;
+            edgeWeight=1.0;
+            bezier=false;
+            arrows = ( section == PajekArcslist );
+            if (arrows) {
                 has_arcs=true;
-                arrows=true;
-                bezier=false;
-                for (int index = 1; index < lineElement.size(); index++) {
-                    target = lineElement.at(index).toInt(&ok,10);
-                    qDebug()<<"Parser-loadPajek(): ARCS LIST: Creating ARC source "<< source << " target "<< target << " with weight "<< weight;
-                    emit edgeCreate(source, target, edgeWeight, edgeColor,
-                                    EdgeType::Directed, arrows, bezier);
+            }
+            for (int index = 1; index < count; index++) {
+                target = tokens[index].toInt(&ok,10);
+                if (arrows) {
+                    batchEdge(source, target, edgeWeight, edgeColor,
+                              EdgeType::Directed, arrows, bezier);
                     totalLinks++;
                 }
-            } //else if ARCSLIST
-            else if (matrix_flag)   {  /** matrix */
-                //qDebug("Parser-loadPajek(): === Reading matrix of edges===");
-                i++;
-                source= i;
-                fileContainsLinkColors=false;
-                edgeColor=initEdgeColor;
-                has_arcs=true;
-                arrows=true;
-                bezier=false;
-                for (target = 0; target < lineElement.size(); target ++) {
-                    if ( lineElement.at(target) != "0" ) {
-                        edgeWeight  = lineElement.at(target).toFloat(&ok);
-                        qDebug()<<"Parser-loadPajek():  MATRIX: Creating arc source "
-                               << source << " target "<< target +1
-                               << " with weight "<< weight;
-                        emit edgeCreate(source, target+1, edgeWeight, edgeColor,
-                                        EdgeType::Directed, arrows, bezier);
-                        totalLinks++;
-                    }
+                else {
+                    batchEdge(source, target, edgeWeight, edgeColor,
+                              EdgeType::Undirected, arrows, bezier);
+                    totalLinks=totalLinks+2;
+                }
+            }
+            break;
+        }
+        case PajekMatrix: {  /** MATRIX */
+            i++;
+            source= i;
+            edgeColor=initEdgeColor;
+            has_arcs=true;
+            arrows=true;
+            bezier=false;
+            for (target = 0; target < count; target ++) {
+                edgeWeight = tokens[target].toDouble(&ok);
+                if ( ok && edgeWeight != 0 ) {
+                    batchEdge(source, target+1, edgeWeight, edgeColor,
+                              EdgeType::Directed, arrows, bezier);
+                    totalLinks++;
                 }
-            } //else if matrix
-        } //end if BOTH ARCS AND EDGES
+            }
+            break;
+        }
+        default:
+            break;
+        };
     } //end WHILE
+
     file.close();
     if (j==0) {
         errorMessage = tr("Could not find node declarations in this Pajek-formatted file.");
         return false;
     }
 
+    if ( fileReadFailed(file) ) {
+        return false;
+    }
+
+    batchFlush();
     qDebug("Parser-loadPajek(): Removing all dummy nodes, if any");
     if (listDummiesPajek.size() > 0 ) {
         qDebug("Trying to delete the dummies now");
@@ -1545,6 +2419,103 @@ bool Parser::loadPajek(){
 
 
 
+/**
+ * @brief Rows and non-zero elements found in a chunk of an adjacency
+ * (socio)matrix file. Rows are numbered from 0 within the chunk.
+ * Scanning stops at the first row which has a different number of
+ * elements than the first row of the chunk, or has an element which cannot
+ * be converted to a number.
+ */
+struct AdjacencyChunk {
+    int rows;
+    int firstColumns;       // elements of the first row, or -1 if no rows
+    int badRow;             // row with different number of elements, or -1
+    int errorRow;           // row with an element that cannot be converted, or -1
+    int errorColumn;
+    QVector<int> edgeRow;
+    QVector<int> edgeColumn;
+    QVector<qreal> edgeWeight;
+};
+
+
+
+/**
+ * @brief Scans the size bytes at data as rows of an adjacency matrix.
+ * Like Parser::loadAdjacency, rows are split at commas, if there are any,
+ * or else at spaces.
+ * @param data
+ * @param size
+ * @param chunk
+ */
+static void scanAdjacencyChunk(const char *data, const qint64 &size,
+                               AdjacencyChunk &chunk) {
+    const char *end = data + size;
+    const char *lineStart = data;
+    QByteArray buffer;
+    bool hasLetters = false;
+
+    chunk.rows = 0;
+    chunk.firstColumns = -1;
+    chunk.badRow = -1;
+    chunk.errorRow = -1;
+    chunk.errorColumn = -1;
+
+    while ( lineStart < end ) {
+
+        const char *lineEnd = (const char *) memchr(lineStart, '\n', end - lineStart);
+        if ( lineEnd == 0 ) {
+            lineEnd = end;
+        }
+        const int n = simplifyLine(lineStart, lineEnd, buffer, hasLetters);
+        const char *out = buffer.constData();
+        lineStart = lineEnd + 1;
+
+        if ( isCommentLine(out, n) ) {
+            continue;
+        }
+
+        const char separator = ( memchr(out, ',', n) != 0 ) ? ',' : ' ';
+
+        int columns = 1;
+        for (int i = 0 ; i < n ; i++ ) {
+            if ( out[i] == separator ) {
+                columns++;
+            }
+        }
+        if ( chunk.firstColumns == -1 ) {
+            chunk.firstColumns = columns;
+        }
+        else if ( columns != chunk.firstColumns ) {
+            chunk.badRow = chunk.rows;
+            return;
+        }
+
+        int column = 0, from = 0;
+        for (int i = 0 ; i <= n ; i++ ) {
+            if ( i < n && out[i] != separator ) {
+                continue;
+            }
+            qreal weight = 0;
+            if ( ! parseReal(out + from, i - from, weight) ) {
+                chunk.errorRow = chunk.rows;
+                chunk.errorColumn = column;
+                return;
+            }
+            if ( weight ) {
+                chunk.edgeRow.append(chunk.rows);
+                chunk.edgeColumn.append(column);
+                chunk.edgeWeight.append(weight);
+            }
+            column++;
+            from = i + 1;
+        }
+
+        chunk.rows++;
+    }
+}
+
+
+
 /**
  * @brief Tries to load the file as adjacency sociomatrix-formatted.
  * If not it returns -1
@@ -1554,7 +2525,7 @@ bool Parser::loadAdjacency(){
 
     qDebug()<< "\n\nParser: loadAdjacency()";
 
-    QFile file ( fileName );
+    NetworkFile file ( fileName );
     if ( ! file.open(QIODevice::ReadOnly )) {
         return false;
     }
@@ -1564,10 +2535,7 @@ bool Parser::loadAdjacency(){
     ts.setCodec(userSelectedCodecName.toUtf8());
 
     QString rowStr;
-    QString edgeStr;
-    QStringList currentRow;
     int i=0, j=0, colCount=0, lastCount=0;
-    bool conversionOK=false;
 
     relationsList.clear();
     totalNodes=0;
@@ -1627,112 +2595,120 @@ bool Parser::loadAdjacency(){
 
     }  // end while
 
-    // RESET file and row counter
-    ts.reset();
-    ts.seek(0);
-    i=0;
-
-    // Now do the full read
-    while ( !ts.atEnd() )   {
-
-        rowStr= ts.readLine().simplified();
-
-        if ( isComment(rowStr) )
-            continue;
-
-        if ( rowStr.contains (",")) {
-            currentRow=rowStr.split(",");
-        }
-        else {
-            currentRow=rowStr.split(" ");
-        }
-
-        if (i == 0 ) {
+    file.close();
 
-            // Since a sociomatrix is NxN matrix,
-            // the number of items in the first row
-            // is the total nodes declared in this file.
-            totalNodes=currentRow.count();
+    // Now do the full read: the file is split at line boundaries in chunks,
+    // which are parsed on the thread pool and merged in order.
+    if ( ! file.open(QIODevice::ReadOnly )) {
+        return false;
+    }
+    QTextCodec *codec = QTextCodec::codecForName( userSelectedCodecName.toUtf8() );
+    if ( codec == 0 ) {
+        codec = QTextCodec::codecForName("UTF-8");
+    }
+    QByteArray contents;
+    qint64 size = 0;
+    uchar *mapped = 0;
+    const char *data = fileBytes(file, contents, size, mapped, codec);
+    if ( fileReadFailed(file) ) {
+        return false;
+    }
 
-            qDebug()<< "Parser-loadAdjacency(): Nodes to be created:"<< totalNodes;
+    const QVector<qint64> bounds = splitAtLines(data, size);
+    QVector<AdjacencyChunk> chunks(bounds.count() - 1);
+    QVector<int> chunkIndex(chunks.count());
+    for (int k = 0 ; k < chunks.count() ; k++ ) {
+        chunkIndex[k] = k;
+    }
 
-            // We know how many nodes there are in this adjacency sociomatrix
-            // thus we create them, one by one.
+    qDebug()<< "Parser-loadAdjacency(): parsing" << size << "bytes in"
+            << chunks.count() << "chunks";
 
-            for (j=0; j<totalNodes; j++) {
+    QtConcurrent::blockingMap(chunkIndex, [&](const int &k) {
+        scanAdjacencyChunk(data + bounds[k], bounds[k+1] - bounds[k], chunks[k]);
+    });
 
-                // compute random position for this node
-                randX=rand()%gwWidth;
-                randY=rand()%gwHeight;
+    if ( mapped ) {
+        file.file().unmap(mapped);
+    }
+    file.close();
 
-                qDebug()<<"Parser-loadAdjacency(): Calling createNode() for node "<< j+1
-                       <<" using random position:"<<randX <<", " << randY;
-
-                emit createNode( j+1,
-                                 initNodeSize,
-                                 initNodeColor,
-                                 initNodeNumberColor,
-                                 initNodeNumberSize,
-                                 QString::number(j+1),
-                                 initNodeLabelColor,
-                                 initNodeLabelSize,
-                                 QPointF(randX, randY),
-                                 initNodeShape,
-                                 QString::null,
-                                 false
-                                 );
-            }
-            qDebug() << "Parser-loadAdjacency(): Finished creating nodes";
+    // Since a sociomatrix is NxN matrix,
+    // the number of items in the first row
+    // is the total nodes declared in this file.
+    for (int k = 0 ; k < chunks.count() ; k++ ) {
+        if ( chunks[k].firstColumns != -1 ) {
+            totalNodes = chunks[k].firstColumns;
+            break;
         }
+    }
 
-        // Check the number of items in this line,
-        // if it is different that totalNodes, then return with an error
-        if ( totalNodes != (int) currentRow.count() )  {
+    // Check every row, in file order, before creating anything
+    i = 0;
+    for (int k = 0 ; k < chunks.count() ; k++ ) {
+        const AdjacencyChunk &chunk = chunks[k];
+        if ( chunk.firstColumns != -1 && chunk.firstColumns != totalNodes ) {
             errorMessage = tr("Error reading Adjacency-formatted file. "
                                     "Matrix row %1 has different number of items than previous row.").arg(i);
             return false;
         }
+        if ( chunk.badRow != -1 ) {
+            errorMessage = tr("Error reading Adjacency-formatted file. "
+                                    "Matrix row %1 has different number of items than previous row.").arg(i + chunk.badRow);
+            return false;
+        }
+        if ( chunk.errorRow != -1 ) {
+            errorMessage = tr("Error reading Adjacency-formatted file. "
+                                    "Element (%1,%2) can be converted.").arg(i + chunk.errorRow + 1).arg(chunk.errorColumn + 1);
+            return false;
+        }
+        i += chunk.rows;
+    }
 
-        // Edge creation loop
-        // Create the edges declared in current row.
-        j=0;
-
-        qDebug()<< "Parser-loadAdjacency(): Starting edge creation loop for row:" << i+1;
-
-        for (QStringList::Iterator it1 = currentRow.begin(); it1!=currentRow.end(); ++it1)  {
-            edgeStr = (*it1);
-            edgeWeight =edgeStr.toDouble(&conversionOK);
-
-            if ( !conversionOK )  {
-                errorMessage = tr("Error reading Adjacency-formatted file. "
-                                        "Element (%1,%2) can be converted.").arg(i+1).arg(j+1);
-                return false;
-            }
-
-            if ( edgeWeight ){
-
-                arrows=true;
-                bezier=false;
-
-                qDebug() << "Parser-loadAdjacency(): New edge: " << i+1 << "->" <<  j+1
-                         << "has weight" << edgeWeight << "TotalLinks: " << totalLinks+1;
+    qDebug()<< "Parser-loadAdjacency(): Nodes to be created:"<< totalNodes;
 
-                emit edgeCreate(i+1, j+1, edgeWeight, initEdgeColor, EdgeType::Directed, arrows, bezier);
+    // We know how many nodes there are in this adjacency sociomatrix
+    // thus we create them, one by one.
 
-                totalLinks++;
+    for (j=0; j<totalNodes; j++) {
 
-            }
-
-            j++;
+        // compute random position for this node
+        randX=rand()%gwWidth;
+        randY=rand()%gwHeight;
 
-        } // end edge creation loop
+        batchNode( j+1,
+                   initNodeSize,
+                   initNodeColor,
+                   initNodeNumberColor,
+                   initNodeNumberSize,
+                   QString::number(j+1),
+                   initNodeLabelColor,
+                   initNodeLabelSize,
+                   QPointF(randX, randY),
+                   initNodeShape,
+                   QString::null);
+    }
+    qDebug() << "Parser-loadAdjacency(): Finished creating nodes";
 
-        i++;
+    // Edge creation loop
+    arrows=true;
+    bezier=false;
+    i = 0;
+    for (int k = 0 ; k < chunks.count() ; k++ ) {
+        const AdjacencyChunk &chunk = chunks[k];
+        for (int e = 0 ; e < chunk.edgeRow.count() ; e++ ) {
+            batchEdge(i + chunk.edgeRow[e] + 1, chunk.edgeColumn[e] + 1,
+                      chunk.edgeWeight[e], initEdgeColor,
+                      EdgeType::Directed, arrows, bezier);
+        }
+        totalLinks += chunk.edgeRow.count();
+        i += chunk.rows;
+    }
 
-    }  // end full while
+    qDebug()<< "Parser-loadAdjacency(): rows" << i << "edges" << totalLinks;
 
-    file.close();
 
+    batchFlush();
     if (relationsList.count() == 0 ) {
         emit addRelation( "unnamed" );
     }
@@ -1749,100 +2725,249 @@ bool Parser::loadAdjacency(){
 
 
 /**
-    Tries to load the file as two-mode sociomatrix. If not it returns -1
-*/
+ * @brief The edges of a block of nodes of a two-mode projection, in order
+ */
+struct TwoModeProjectionBlock {
+    QVector<int> edgeSource;
+    QVector<int> edgeTarget;
+    QVector<qreal> edgeWeight;
+};
+
+
+
+/**
+ * @brief Tries to load the file as two-mode sociomatrix (affiliation network).
+ *
+ * The file is scanned like an adjacency matrix (see scanAdjacencyChunk), in
+ * parallel chunks, keeping only the non-zero elements. These are the sparse
+ * incidence matrix A of actors (rows) to events (columns).
+ *
+ * The one-mode network of the selected mode is the projection A·Aᵀ (rows
+ * are nodes) or Aᵀ·A (columns are nodes). It is computed row by row with a
+ * sparse accumulator: for each node, the events it belongs to are visited
+ * and every earlier node of each event gets the event's weight added. The
+ * cost is the number of co-affiliation pairs, not nodes × nodes. Blocks of
+ * nodes are projected on the thread pool and their edges are batched in
+ * node order.
+ *
+ * Each shared event weighs 1, so ties count the events two nodes share.
+ * With TWOMODE_NEWMAN_WEIGHTS in two_sm_mode, an event with n members
+ * weighs 1/(n-1) instead (Newman's collaboration weighting).
+ * @return
+ */
 bool Parser::loadTwoModeSociomatrix(){
     qDebug("\n\nParser: loadTwoModeSociomatrix()");
-    QFile file ( fileName );
+    NetworkFile file ( fileName );
     if ( ! file.open(QIODevice::ReadOnly )) {
         errorMessage = tr("Cannot open two-mode sociomatrix file. ") ;
         return false;
     }
-    QTextStream ts( &file );
-    ts.setCodec(userSelectedCodecName.toUtf8());
-    QString str;
-    QStringList lineElement;
-    int i=0, j=0,  newCount=0, lastCount=0;
+
+    QTextCodec *codec = QTextCodec::codecForName( userSelectedCodecName.toUtf8() );
+    if ( codec == 0 ) {
+        codec = QTextCodec::codecForName("UTF-8");
+    }
+    QByteArray contents;
+    qint64 size = 0;
+    uchar *mapped = 0;
+    const char *data = fileBytes(file, contents, size, mapped, codec);
+    if ( fileReadFailed(file) ) {
+        return false;
+    }
+
     totalNodes=0;
+    totalLinks=0;
     edgeWeight=1.0;
     relationsList.clear();
 
-    while (  !ts.atEnd() )  {
-        i++;
-        str= ts.readLine();
-        str=str.simplified();
-        if ( isComment(str) )
-            continue;
-        if ( str.contains("vertices",Qt::CaseInsensitive)
-             || str.contains("network",Qt::CaseInsensitive)
-             || str.contains("graph",Qt::CaseInsensitive)
-             || str.contains("digraph",Qt::CaseInsensitive)
-             || str.contains("DL",Qt::CaseInsensitive)
-             || str.contains("list",Qt::CaseInsensitive)
-             || str.contains("graphml",Qt::CaseInsensitive)
-             || str.contains("xml",Qt::CaseInsensitive)
-             ) {
+    const QVector<qint64> bounds = splitAtLines(data, size);
+    QVector<AdjacencyChunk> chunks(bounds.count() - 1);
+    QVector<int> chunkIndex(chunks.count());
+    for (int k = 0 ; k < chunks.count() ; k++ ) {
+        chunkIndex[k] = k;
+    }
+
+    qDebug()<< "Parser-loadTwoModeSociomatrix(): parsing" << size << "bytes in"
+            << chunks.count() << "chunks";
+
+    QtConcurrent::blockingMap(chunkIndex, [&](const int &k) {
+        scanAdjacencyChunk(data + bounds[k], bounds[k+1] - bounds[k], chunks[k]);
+    });
+
+    if ( mapped ) {
+        file.file().unmap(mapped);
+    }
+    file.close();
+
+    // Check every row, in file order, before creating anything
+    int columns = -1, rows = 0, affiliations = 0;
+    for (int k = 0 ; k < chunks.count() ; k++ ) {
+        const AdjacencyChunk &chunk = chunks[k];
+        if ( chunk.firstColumns != -1 ) {
+            if ( columns == -1 ) {
+                columns = chunk.firstColumns;
+            }
+            else if ( chunk.firstColumns != columns ) {
+                errorMessage = tr("Row %1 has fewer or more elements than previous line.")
+                        .arg(rows + 1);
+                return false;
+            }
+        }
+        if ( chunk.badRow != -1 ) {
+            errorMessage = tr("Row %1 has fewer or more elements than previous line.")
+                    .arg(rows + chunk.badRow + 1);
+            return false;
+        }
+        if ( chunk.errorRow != -1 ) {
             qDebug()<< "*** Parser:loadTwoModeSociomatrix(): Not a two mode sociomatrix-formatted file. Aborting!!";
-            file.close();
             errorMessage = tr("Not a two-mode sociomatrix formatted file. "
-                              "A non-comment line includes prohibited strings (i.e GraphML), "
-                              "not only numbers and delimiters as expected.");
+                              "Element (%1,%2) is not a number, "
+                              "while only numbers and delimiters are expected.")
+                    .arg(rows + chunk.errorRow + 1).arg(chunk.errorColumn + 1);
             return false;
         }
-        if ( str.contains (",")){
-            lineElement=str.split(",");
-            newCount = lineElement.count();
+        rows += chunk.rows;
+        affiliations += chunk.edgeRow.count();
+    }
+    if ( columns == -1 ) {
+        columns = 0;
+    }
+
+    // the nodes are the rows (1st mode) or the columns (2nd mode)
+    const bool secondMode = ( ( two_sm_mode & TWOMODE_SECOND_MODE ) != 0 );
+    const bool newmanWeights = ( ( two_sm_mode & TWOMODE_NEWMAN_WEIGHTS ) != 0 );
+    const int nodes = (secondMode) ? columns : rows;
+    const int events = (secondMode) ? rows : columns;
+
+    qDebug()<< "Parser-loadTwoModeSociomatrix(): rows" << rows << "columns" << columns
+            << "affiliations" << affiliations << "second mode" << secondMode
+            << "Newman weights" << newmanWeights;
+
+    // sparse incidence matrix, both ways: node -> events and event -> nodes.
+    // Elements come in row-major order, so the counting sort leaves every
+    // list in ascending order, in either mode.
+    QVector<int> nodeStart(nodes + 1, 0), eventStart(events + 1, 0);
+    QVector<int> nodeEvents(affiliations), eventNodes(affiliations);
+    int row = 0;
+    for (int k = 0 ; k < chunks.count() ; k++ ) {
+        const AdjacencyChunk &chunk = chunks[k];
+        for (int e = 0 ; e < chunk.edgeRow.count() ; e++ ) {
+            const int r = row + chunk.edgeRow[e];
+            const int c = chunk.edgeColumn[e];
+            nodeStart[ (secondMode) ? c + 1 : r + 1 ]++;
+            eventStart[ (secondMode) ? r + 1 : c + 1 ]++;
         }
-        else {
-            lineElement=str.split(" ");
-            newCount = lineElement.count();
+        row += chunk.rows;
+    }
+    for (int v = 0 ; v < nodes ; v++ ) {
+        nodeStart[v + 1] += nodeStart[v];
+    }
+    for (int ev = 0 ; ev < events ; ev++ ) {
+        eventStart[ev + 1] += eventStart[ev];
+    }
+    {
+        QVector<int> nodeFill = nodeStart, eventFill = eventStart;
+        row = 0;
+        for (int k = 0 ; k < chunks.count() ; k++ ) {
+            const AdjacencyChunk &chunk = chunks[k];
+            for (int e = 0 ; e < chunk.edgeRow.count() ; e++ ) {
+                const int r = row + chunk.edgeRow[e];
+                const int c = chunk.edgeColumn[e];
+                const int node = (secondMode) ? c : r;
+                const int event = (secondMode) ? r : c;
+                nodeEvents[ nodeFill[node]++ ] = event;
+                eventNodes[ eventFill[event]++ ] = node;
+            }
+            row += chunk.rows;
+            chunks[k] = AdjacencyChunk();
         }
-        qDebug() << str;
-        qDebug() << "newCount "<<newCount << " nodes. We are at i = " << i;
-        if  ( (newCount != lastCount && i>1 )  ) { // line element count differ
-            qDebug()<< "*** Parser:loadTwoModeSociomatrix(): Not a Sociomatrix-formatted file. Aborting!!";
-            file.close();
-            errorMessage = tr("Row %1 has fewer or more elements than previous line.").arg(i);
-            return false;
+    }
+    // the weight each event adds to the ties of its members
+    QVector<qreal> eventWeight(events, 1.0);
+    if ( newmanWeights ) {
+        for (int ev = 0 ; ev < events ; ev++ ) {
+            const int members = eventStart[ev + 1] - eventStart[ev];
+            eventWeight[ev] = ( members > 1 ) ? 1.0 / ( members - 1 ) : 0;
         }
-        lastCount=newCount;
-        randX=rand()%gwWidth;
-        randY=rand()%gwHeight;
-        qDebug()<< "Parser-loadTwoModeSociomatrix(): Calling createNode() for node "
-                << i << " at random x,y: "<<randX << randY;
-        emit createNode( i,initNodeSize, initNodeColor,
-                         initNodeNumberColor, initNodeNumberSize,
-                         QString::number(i), initNodeLabelColor, initNodeLabelSize,
-                         QPointF(randX, randY),
-                         initNodeShape, QString::null, false
-                         );
-        j=1;
-        qDebug()<< "Parser-loadTwoModeSociomatrix(): reading actor affiliations...";
-        for (QStringList::Iterator it1 = lineElement.begin(); it1!=lineElement.end(); ++it1)   {
-            if ( (*it1)!="0"){
-                qDebug() << "Parser-loadTwoModeSociomatrix(): there is an 1 from "<< i << " to "<<  j;
-                firstModeMultiMap.insert(i, j);
-                secondModeMultiMap.insert(j, i);
-                for (int k = 1; k < i ; ++k) {
-                    qDebug() << "Checking earlier discovered actor k = " << k;
-                    if ( firstModeMultiMap.contains(k, j) ) {
-                        arrows=true;
-                        bezier=false;
-                        edgeWeight = 1;
-                        qDebug() << " Actor " << i << " on the same event as actor " << k << ". Creating edge ";
-                        emit edgeCreate(i, k, edgeWeight, initEdgeColor,
-                                        EdgeType::Undirected, arrows, bezier);
-                        totalLinks++;
+    }
+
+    // project blocks of nodes in parallel
+    const int blockCount = qMax( 1, qMin( nodes, 4 * QThread::idealThreadCount() ) );
+    QVector<TwoModeProjectionBlock> blocks(blockCount);
+    QVector<int> blockIndex(blockCount);
+    for (int b = 0 ; b < blockCount ; b++ ) {
+        blockIndex[b] = b;
+    }
+
+    QtConcurrent::blockingMap(blockIndex, [&](const int &b) {
+        TwoModeProjectionBlock &block = blocks[b];
+        const int first = (int) ( (qint64) nodes * b / blockCount );
+        const int last = (int) ( (qint64) nodes * ( b + 1 ) / blockCount );
+        QVector<qreal> accumulator(nodes, 0);
+        QVector<bool> touched(nodes, false);
+        QVector<int> neighbors;
+        for (int v = first ; v < last ; v++ ) {
+            for (int i = nodeStart[v] ; i < nodeStart[v + 1] ; i++ ) {
+                const int ev = nodeEvents[i];
+                const qreal w = eventWeight[ev];
+                if ( w == 0 ) {
+                    continue;
+                }
+                // earlier nodes only: each tie is found once, from its later end
+                for (int m = eventStart[ev] ; m < eventStart[ev + 1] ; m++ ) {
+                    const int u = eventNodes[m];
+                    if ( u >= v ) {
+                        break;
+                    }
+                    if ( !touched[u] ) {
+                        touched[u] = true;
+                        neighbors.append(u);
                     }
+                    accumulator[u] += w;
                 }
-
             }
-            j++;
+            std::sort(neighbors.begin(), neighbors.end());
+            for (int n = 0 ; n < neighbors.count() ; n++ ) {
+                const int u = neighbors[n];
+                block.edgeSource.append(v);
+                block.edgeTarget.append(u);
+                block.edgeWeight.append(accumulator[u]);
+                accumulator[u] = 0;
+                touched[u] = false;
+            }
+            neighbors.clear();
         }
+    });
+
+    totalNodes = nodes;
+
+    for (int v = 0 ; v < nodes ; v++ ) {
+        randX=rand()%gwWidth;
+        randY=rand()%gwHeight;
+        batchNode( v + 1, initNodeSize, initNodeColor,
+                   initNodeNumberColor, initNodeNumberSize,
+                   QString::number(v + 1), initNodeLabelColor, initNodeLabelSize,
+                   QPointF(randX, randY),
+                   initNodeShape, QString::null);
     }
-    file.close();
 
+    arrows=true;
+    bezier=false;
+    for (int b = 0 ; b < blockCount ; b++ ) {
+        TwoModeProjectionBlock &block = blocks[b];
+        for (int e = 0 ; e < block.edgeSource.count() ; e++ ) {
+            batchEdge(block.edgeSource[e] + 1, block.edgeTarget[e] + 1,
+                      block.edgeWeight[e], initEdgeColor,
+                      EdgeType::Undirected, arrows, bezier);
+        }
+        totalLinks += block.edgeSource.count();
+        block = TwoModeProjectionBlock();
+    }
 
+    qDebug()<< "Parser-loadTwoModeSociomatrix(): nodes" << totalNodes
+            << "edges" << totalLinks;
+
+    batchFlush();
     if (relationsList.count() == 0) {
         emit addRelation("unnamed");
     }
@@ -1858,6 +2983,92 @@ bool Parser::loadTwoModeSociomatrix(){
 
 
 
+/**
+ * @brief Size of the blocks read from GraphML files
+ */
+static const qint64 GRAPHML_BLOCK_SIZE = 65536;
+
+
+
+/**
+ * @brief Read-only sequential device which decodes the source device block by
+ * block with the given codec and serves the text as UTF-8.
+ * The encoding in the XML declaration is rewritten to UTF-8, so that
+ * QXmlStreamReader does not decode the data again with the declared encoding.
+ * Used in loadGraphML when the user selected codec differs from the encoding
+ * declared in the file.
+ */
+class GraphMLTranscoder : public QIODevice {
+public:
+    GraphMLTranscoder(QIODevice *source, QTextCodec *codec) :
+        m_source(source), m_decoder(codec->makeDecoder()),
+        m_pos(0), m_prolog(true) {
+        open(QIODevice::ReadOnly | QIODevice::Unbuffered);
+    }
+    ~GraphMLTranscoder() {
+        delete m_decoder;
+    }
+    bool isSequential() const {
+        return true;
+    }
+    bool atEnd() const {
+        return m_pos >= m_buffer.size() && m_source->atEnd();
+    }
+    qint64 bytesAvailable() const {
+        return ( m_buffer.size() - m_pos ) + QIODevice::bytesAvailable();
+    }
+
+protected:
+    qint64 readData(char *data, qint64 maxSize) {
+        while ( m_pos >= m_buffer.size() && !m_source->atEnd() ) {
+            QByteArray block = m_source->read(GRAPHML_BLOCK_SIZE);
+            if ( block.isEmpty() ) {
+                break;
+            }
+            QString text = m_decoder->toUnicode(block);
+            if ( m_prolog && !text.isEmpty() ) {
+                m_prolog = false;
+                declareUtf8(text);
+            }
+            m_buffer = text.toUtf8();
+            m_pos = 0;
+        }
+        const qint64 n = qMin( maxSize, (qint64) ( m_buffer.size() - m_pos ) );
+        memcpy(data, m_buffer.constData() + m_pos, n);
+        m_pos += (int) n;
+        return n;
+    }
+    qint64 writeData(const char *, qint64) {
+        return -1;
+    }
+
+private:
+    void declareUtf8(QString &text) const {
+        if ( text.startsWith( QChar(0xFEFF) ) ) {
+            text.remove(0, 1);
+        }
+        if ( ! text.startsWith("<?xml") ) {
+            return;
+        }
+        int end = text.indexOf("?>");
+        if ( end == -1 ) {
+            return;
+        }
+        QString declaration = text.left(end);
+        declaration.replace( QRegularExpression("encoding\\s*=\\s*(\"[^\"]*\"|'[^']*')"),
+                             "encoding=\"UTF-8\"" );
+        text.replace(0, end, declaration);
+    }
+
+    QIODevice *m_source;
+    QTextDecoder *m_decoder;
+    QByteArray m_buffer;
+    int m_pos;
+    bool m_prolog;
+};
+
+
+
 /**
  * @brief Tries to load a file as GraphML (not GML) formatted network.
  * If not GraphML, it returns false
@@ -1883,46 +3094,44 @@ bool Parser::loadGraphML(){
     arrows=true;
     edgeDirType=EdgeType::Directed;
 
-    QFile file ( fileName );
+    NetworkFile file ( fileName );
     if ( ! file.open(QIODevice::ReadOnly )) {
         return false;
     }
 
     fileDirPath= QFileInfo(fileName).canonicalPath();
 
-    //QXmlStreamReader *xml = new QXmlStreamReader();
     QXmlStreamReader xml;
-
-    qDebug() << " Parser::loadGraphML(): read file to a byte array";
-    QByteArray encodedData = file.readAll();
-    QByteArray userSelectedCodec =userSelectedCodecName.toLatin1();
-    xml.addData(encodedData);
+    GraphMLTranscoder *transcoder = 0;
 
     qDebug() << " Parser::loadGraphML(): test if XML document encoding == userCodec";
 
-    xml.readNext();
-    if (xml.isStartDocument()) {
+    // Peek at the XML declaration only; the document is streamed from the file
+    QXmlStreamReader prolog( file.peek(GRAPHML_BLOCK_SIZE) );
+    prolog.readNext();
+    if (prolog.isStartDocument()) {
         qDebug()<< " Parser::loadGraphML(): Testing XML document " << " version "
-                << xml.documentVersion()
-                << " encoding " << xml.documentEncoding()
+                << prolog.documentVersion()
+                << " encoding " << prolog.documentEncoding()
                 << " userSelectedCodecName.toUtf8() "
                 << userSelectedCodecName.toUtf8();
-         if ( xml.documentEncoding().toString() != userSelectedCodecName) {
-                qDebug() << " Parser::loadGraphML(): Conflicting encodings. "
-                         << " Re-reading data with userCodec";
-                xml.clear();
-                QTextStream in(&encodedData);
-                in.setAutoDetectUnicode(false);
-                QTextCodec *codec = QTextCodec::codecForName( userSelectedCodec );
-                in.setCodec(codec);
-                QString decodedData = in.readAll();
-                xml.addData(decodedData);
-         }
-         else {
-             qDebug() << " Parser::loadGraphML(): Testing XML: OK";
-             xml.clear();
-             xml.addData(encodedData);
-         }
+        QTextCodec *codec = QTextCodec::codecForName( userSelectedCodecName.toLatin1() );
+        if ( prolog.documentEncoding().toString() != userSelectedCodecName && codec ) {
+            qDebug() << " Parser::loadGraphML(): Conflicting encodings. "
+                     << " Decoding data with userCodec while reading";
+            transcoder = new GraphMLTranscoder(&file, codec);
+        }
+        else {
+            qDebug() << " Parser::loadGraphML(): Testing XML: OK";
+        }
+    }
+    prolog.clear();
+
+    if (transcoder) {
+        xml.setDevice(transcoder);
+    }
+    else {
+        xml.setDevice(&file);
     }
 
 
@@ -1971,9 +3180,17 @@ bool Parser::loadGraphML(){
     keyName.clear();
     keyType.clear();
     keyDefaultValue.clear();
+    keyRole.clear();
     nodeHash.clear();
     edgeMissingNodesList.clear();
-    file.close();
+
+    // a truncated compressed file ends the document early, too
+    if ( fileReadFailed(file) ) {
+        xml.clear();
+        delete transcoder;
+        file.close();
+        return false;
+    }
 
     // if there was an error return false with error string
     if (xml.hasError()) {
@@ -1985,12 +3202,17 @@ bool Parser::loadGraphML(){
                     .arg(xml.name().toString())
                     .arg(xml.errorString());
         xml.clear();
+        delete transcoder;
+        file.close();
         return false;
     }
 
     xml.clear();
+    delete transcoder;
+    file.close();
 
     // if there was no error the rewind to first relation and emit signal
+    batchFlush();
     emit relationSet (0);
 
     //The network has been loaded. Tell MW the statistics and network type
@@ -2105,6 +3327,59 @@ bool Parser::readGraphML(QXmlStreamReader &xml){
 
 
 
+/**
+ * @brief What the data of a GraphML key sets, resolved once per key
+ * in readGraphMLElementKey instead of comparing its for and attr.name
+ * strings on every data element.
+ */
+enum GraphMLKeyRole {
+    KeyUnknown = 0,
+    KeyNodeColor,
+    KeyNodeLabel,
+    KeyNodeX,
+    KeyNodeY,
+    KeyNodeSize,
+    KeyNodeLabelSize,
+    KeyNodeLabelColor,
+    KeyNodeShape,
+    KeyNodeIcon,
+    KeyEdgeColor,
+    KeyEdgeWeight,
+    KeyEdgeArrowSize,
+    KeyEdgeLabel
+};
+
+
+
+/**
+ * @brief Returns the GraphMLKeyRole of a key declared for "what" with attr.name "name"
+ * @param what
+ * @param name
+ * @return
+ */
+static int graphMLKeyRole(const QString &what, const QString &name) {
+    if ( what == "node" ) {
+        if ( name == "color" ) return KeyNodeColor;
+        if ( name == "label" ) return KeyNodeLabel;
+        if ( name == "x_coordinate" ) return KeyNodeX;
+        if ( name == "y_coordinate" ) return KeyNodeY;
+        if ( name == "size" ) return KeyNodeSize;
+        if ( name == "label.size" ) return KeyNodeLabelSize;
+        if ( name == "label.color" ) return KeyNodeLabelColor;
+        if ( name == "shape" ) return KeyNodeShape;
+        if ( name == "custom-icon" ) return KeyNodeIcon;
+    }
+    else if ( what == "edge" ) {
+        if ( name == "color" ) return KeyEdgeColor;
+        if ( name == "value" || name == "weight" ) return KeyEdgeWeight;
+        if ( name == "size of arrow" ) return KeyEdgeArrowSize;
+        if ( name == "label" ) return KeyEdgeLabel;
+    }
+    return KeyUnknown;
+}
+
+
+
 /**
  * @brief Reads a graph definition
  * Called at Graph element
@@ -2129,6 +3404,7 @@ void Parser::readGraphMLElementGraph(QXmlStreamReader &xml){
     networkName = xmlStreamAttr.value("id").toString();
     relationsList << networkName;
     qDebug()<< "Parser::readGraphMLElementGraph() - emit addRelation()" <<networkName;
+    batchFlush();
     emit addRelation( networkName);
     int relationCounter = relationsList.count() - 1; //zero indexed
     if (relationCounter > 0) {
@@ -2195,6 +3471,8 @@ void Parser::readGraphMLElementKey ( QXmlStreamAttributes &xmlStreamAttr )
                 << key_type;
     }
 
+    keyRole [key_id] = graphMLKeyRole(key_what, keyName.value(key_id));
+
 }
 
 
@@ -2327,34 +3605,30 @@ void Parser::endGraphMLElementNode(QXmlStreamReader &xml){
            << " label " << nodeLabel << " coords " <<randX << ", " <<randY;
 
     if ( nodeShape == "custom") {
-        emit createNode( totalNodes,
-                         nodeSize,
-                         nodeColor,
-                         nodeNumberColor,
-                         nodeNumberSize,
-                         nodeLabel,
-                         nodeLabelColor,
-                         nodeLabelSize,
-                         QPointF(randX,randY),
-                         nodeShape,
-                         ( nodeIconPath.isEmpty() ? initNodeCustomIcon: nodeIconPath),
-                         false
-                         );
+        batchNode( totalNodes,
+                   nodeSize,
+                   nodeColor,
+                   nodeNumberColor,
+                   nodeNumberSize,
+                   nodeLabel,
+                   nodeLabelColor,
+                   nodeLabelSize,
+                   QPointF(randX,randY),
+                   nodeShape,
+                   ( nodeIconPath.isEmpty() ? initNodeCustomIcon: nodeIconPath));
     }
     else {
-        emit createNode( totalNodes,
-                         nodeSize,
-                         nodeColor,
-                         nodeNumberColor,
-                         nodeNumberSize,
-                         nodeLabel,
-                         nodeLabelColor,
-                         nodeLabelSize,
-                         QPointF(randX,randY),
-                         nodeShape,
-                         QString(),
-                         false
-                         );
+        batchNode( totalNodes,
+                   nodeSize,
+                   nodeColor,
+                   nodeNumberColor,
+                   nodeNumberSize,
+                   nodeLabel,
+                   nodeLabelColor,
+                   nodeLabelSize,
+                   QPointF(randX,randY),
+                   nodeShape,
+                   QString());
     }
 
 
@@ -2439,8 +3713,8 @@ void Parser::endGraphMLElementEdge(QXmlStreamReader &xml){
     }
     qDebug()<<"Parser::endGraphMLElementEdge() - signal edgeCreate "
            << source << " -> " << target << " edgeDirType value " << edgeDirType;
-    emit edgeCreate(source, target, edgeWeight, edgeColor, edgeDirType,
-                    arrows, bezier, edgeLabel);
+    batchEdge(source, target, edgeWeight, edgeColor, edgeDirType,
+              arrows, bezier, edgeLabel);
     totalLinks++;
     bool_edge= false;
 }
@@ -2486,17 +3760,20 @@ void Parser::readGraphMLElementData (QXmlStreamReader &xml){
 
     }
 
-    if (keyName.value(key_id) == "color" && keyFor.value(key_id) == "node" ) {
+    switch ( keyRole.value(key_id, KeyUnknown) ) {
+    case KeyNodeColor: {
         qDebug()<< "Parser::readGraphMLElementData() -Data found. Node color: "
                 << key_value << " for this node";
         nodeColor= key_value;
+        break;
     }
-    else if (keyName.value(key_id) == "label" && keyFor.value(key_id) == "node" ){
+    case KeyNodeLabel: {
         qDebug()<< "Parser::readGraphMLElementData() - Data found. Node label: "
                    ""<< key_value << " for this node";
         nodeLabel = key_value;
+        break;
     }
-    else if (keyName.value(key_id) == "x_coordinate" && keyFor.value(key_id) == "node" ) {
+    case KeyNodeX: {
         qDebug()<< "Parser::readGraphMLElementData() - Data found. Node x: "
                 << key_value << " for this node";
         conv_OK=false;
@@ -2506,8 +3783,9 @@ void Parser::readGraphMLElementData (QXmlStreamReader &xml){
         else
             randX=randX * gwWidth;
         qDebug()<< "Parser::readGraphMLElementData() - Using: "<< randX;
+        break;
     }
-    else if (keyName.value(key_id) == "y_coordinate" && keyFor.value(key_id) == "node" ) {
+    case KeyNodeY: {
         qDebug()<< "Parser::readGraphMLElementData() - Data found. Node y: "
                 << key_value << " for this node";
         conv_OK=false;
@@ -2517,8 +3795,9 @@ void Parser::readGraphMLElementData (QXmlStreamReader &xml){
         else
             randY=randY * gwHeight;
         qDebug()<< "Parser::readGraphMLElementData() - Using: "<< randY;
+        break;
     }
-    else if (keyName.value(key_id) == "size" && keyFor.value(key_id) == "node" ) {
+    case KeyNodeSize: {
         qDebug()<< "Parser::readGraphMLElementData() - Data found. Node size: "
                 << key_value << " for this node";
         conv_OK=false;
@@ -2526,8 +3805,9 @@ void Parser::readGraphMLElementData (QXmlStreamReader &xml){
         if (!conv_OK)
             nodeSize = initNodeSize;
         qDebug()<< "Parser::readGraphMLElementData() - Using: "<< nodeSize;
+        break;
     }
-    else if (keyName.value(key_id) == "label.size" && keyFor.value(key_id) == "node" ) {
+    case KeyNodeLabelSize: {
         qDebug()<< "Parser::readGraphMLElementData() - Data found. Node label size: "
                 << key_value << " for this node";
         conv_OK=false;
@@ -2535,26 +3815,30 @@ void Parser::readGraphMLElementData (QXmlStreamReader &xml){
         if (!conv_OK)
             nodeLabelSize = initNodeLabelSize;
         qDebug()<< "Parser::readGraphMLElementData() - Using: "<< nodeSize;
+        break;
     }
-    else if (keyName.value(key_id) == "label.color" && keyFor.value(key_id) == "node" ){
+    case KeyNodeLabelColor: {
         qDebug()<< "Parser::readGraphMLElementData() - Data found. Node label Color: "
                 << key_value << " for this node";
         nodeLabelColor = key_value;
+        break;
     }
-    else if (keyName.value(key_id) == "shape" && keyFor.value(key_id) == "node" ) {
+    case KeyNodeShape: {
         qDebug()<< "Parser::readGraphMLElementData() - Data found. Node shape: "
                 << key_value << " for this node";
         nodeShape= key_value;
+        break;
     }
-    else if (keyName.value(key_id) == "custom-icon" && keyFor.value(key_id) == "node" ) {
+    case KeyNodeIcon: {
         qDebug()<< "Parser::readGraphMLElementData() - Data found. Node custom-icon path: "
                 << key_value << " for this node";
         nodeIconPath = key_value;
         nodeIconPath = fileDirPath + ("/") + nodeIconPath;
         qDebug()<< "Parser::readGraphMLElementData() - full node custom-icon path: "
                     << nodeIconPath  ;
+        break;
     }
-    else if (keyName.value(key_id) == "color" && keyFor.value(key_id) == "edge" ) {
+    case KeyEdgeColor: {
         qDebug()<< "Parser::readGraphMLElementData() - Data found. Edge color: "
                 << key_value << " for this edge";
         edgeColor= key_value;
@@ -2563,8 +3847,9 @@ void Parser::readGraphMLElementData (QXmlStreamReader &xml){
                                          QString::number(edgeWeight)+"|"+edgeColor
                                          +"|"+QString::number(edgeDirType));
         }
+        break;
     }
-    else if ( ( keyName.value(key_id) == "value" ||  keyName.value(key_id) == "weight" ) && keyFor.value(key_id) == "edge" ) {
+    case KeyEdgeWeight: {
         conv_OK=false;
         edgeWeight= key_value.toDouble( &conv_OK );
         if (!conv_OK)
@@ -2576,16 +3861,18 @@ void Parser::readGraphMLElementData (QXmlStreamReader &xml){
         }
         qDebug()<< "Parser::readGraphMLElementData() - Data found. Edge value: "
                 << key_value << " Using "<< edgeWeight << " for this edge";
+        break;
     }
-    else if ( keyName.value(key_id) == "size of arrow"  && keyFor.value(key_id) == "edge" ) {
+    case KeyEdgeArrowSize: {
         conv_OK=false;
         qreal temp = key_value.toFloat( &conv_OK );
         if (!conv_OK) arrowSize = 1;
         else  arrowSize = temp;
         qDebug()<< "Parser::readGraphMLElementData() - Data found. Edge arrow size: "
                 << key_value << " Using  "<< arrowSize << " for this edge";
+        break;
     }
-    else if (keyName.value(key_id) == "label" && keyFor.value(key_id) == "edge" ){
+    case KeyEdgeLabel: {
         edgeLabel = key_value;
         if (missingNode){
             edgesMissingNodesHash.insert(edge_source+"===>"+edge_target,
@@ -2594,9 +3881,11 @@ void Parser::readGraphMLElementData (QXmlStreamReader &xml){
         }
         qDebug()<< "Parser::readGraphMLElementData() - Data found. Edge label: "
                 << edgeLabel << " for this edge";
+        break;
+    }
+    default:
+        break;
     }
-
-
 
 }
 
@@ -2836,7 +4125,7 @@ void Parser::createMissingNodeEdges(){
                 qDebug()<<"Parser::createMissingNodeEdges() - signal edgeCreate "
                        << source << " -> " << target << " edgeDirType value " << edgeDirType;
 
-                emit edgeCreate(source, target, edgeWeight, edgeColor, edgeDirType, arrows, bezier, edgeLabel);
+                batchEdge(source, target, edgeWeight, edgeColor, edgeDirType, arrows, bezier, edgeLabel);
 
             }
             ++it;
@@ -2854,7 +4143,7 @@ void Parser::createMissingNodeEdges(){
 bool Parser::loadGML(){
     qDebug()<< "Parser::loadGML()";
 
-    QFile file ( fileName );
+    NetworkFile file ( fileName );
     if ( ! file.open(QIODevice::ReadOnly )) {
         return false;
     }
@@ -3123,13 +4412,12 @@ bool Parser::loadGML(){
                 qDebug()<<" *** Creating node "<< node_id
                        << " at "<< randX <<","<< randY
                        <<" label "<<nodeLabel;
-                emit createNode(
+                batchNode(
                             node_id.toInt(0), initNodeSize, nodeColor,
                             initNodeNumberColor, initNodeNumberSize,
                             nodeLabel , initNodeLabelColor, initNodeLabelSize,
                             QPointF(randX,randY),
-                            nodeShape, QString::null, false
-                            );
+                            nodeShape, QString::null);
 
             }
             else if (edgeKey && !graphicsKey) {
@@ -3140,8 +4428,8 @@ bool Parser::loadGML(){
                 if (edgeLabel==QString::null) {
                     edgeLabel = edge_source + "->" + edge_target;
                 }
-                emit edgeCreate(source,target, edgeWeight, edgeColor,
-                                edgeDirType, arrows, bezier, edgeLabel);
+                batchEdge(source,target, edgeWeight, edgeColor,
+                          edgeDirType, arrows, bezier, edgeLabel);
             }
 
             else if (graphKey) {
@@ -3152,6 +4440,11 @@ bool Parser::loadGML(){
 
     }
 
+    if ( fileReadFailed(file) ) {
+        return false;
+    }
+
+    batchFlush();
     if (relationsList.count() == 0 ) {
         emit addRelation( "unnamed" );
     }
@@ -3190,7 +4483,7 @@ bool Parser::loadDot(){
     bezier=false;
     source=0, target=0;
 
-    QFile file ( fileName );
+    NetworkFile file ( fileName );
     if ( ! file.open(QIODevice::ReadOnly )) return false;
     QTextStream ts( &file );
     ts.setCodec(userSelectedCodecName.toUtf8());
@@ -3346,13 +4639,12 @@ bool Parser::loadDot(){
                       << "initNodeNumberSize " << initNodeNumberSize
                       << "initNodeLabelColor " << initNodeLabelColor
                       << "nodeShape" <<  initNodeShape;
-                emit createNode(
+                batchNode(
                             totalNodes, initNodeSize, initNodeColor,
                             initNodeNumberColor, initNodeNumberSize,
                             nodeLabel , initNodeLabelColor, initNodeLabelSize,
                             QPointF(randX,randY),
-                            initNodeShape,QString::null,  false
-                            );
+                            initNodeShape,QString::null);
                 // Note that we push the numbered nodelabel whereas we create
                 // the node with its file specified node label.
                 nodesDiscovered.push_back( node  );
@@ -3398,13 +4690,12 @@ bool Parser::loadDot(){
                       << "initNodeNumberSize " << initNodeNumberSize
                       << "initNodeLabelColor " << initNodeLabelColor
                       << "nodeShape" <<  initNodeShape;
-                emit createNode(
+                batchNode(
                             totalNodes, initNodeSize, initNodeColor,
                             initNodeNumberColor, initNodeNumberSize,
                             nodeLabel , initNodeLabelColor, initNodeLabelSize,
                             QPointF(randX,randY),
-                            initNodeShape,QString::null,  false
-                            );
+                            initNodeShape,QString::null);
                 nodesDiscovered.push_back( node  );			// Note that we push the numbered nodelabel whereas we create the node with its file specified node label.
                 qDebug()<<" * Total nodes" << totalNodes<< " nodesDiscovered  "<< nodesDiscovered.size() ;
                 target=totalNodes;
@@ -3470,13 +4761,12 @@ bool Parser::loadDot(){
                           << "initNodeNumberSize " << initNodeNumberSize
                           << "initNodeLabelColor " << initNodeLabelColor
                           << "nodeShape" <<  initNodeShape;
-                    emit createNode(
+                    batchNode(
                                 totalNodes, initNodeSize, nodeColor,
                                 initNodeNumberColor, initNodeNumberSize,
                                 node , initNodeLabelColor, initNodeLabelSize,
                                 QPointF(randX,randY),
-                                initNodeShape, QString::null, false
-                                );
+                                initNodeShape, QString::null);
                     nodesDiscovered.push_back( node  );
                     qDebug()<<" * Total totalNodes "
                            << totalNodes<< " nodesDiscovered  "<< nodesDiscovered.size() ;
@@ -3484,8 +4774,8 @@ bool Parser::loadDot(){
                     if (it!=nodeSequence.begin()) {
                         qDebug()<<"-- Drawing Link between node "
                                << source<< " and node " <<target;
-                        emit edgeCreate(source,target, edgeWeight, edgeColor,
-                                        edgeDirType, arrows, bezier);
+                        batchEdge(source,target, edgeWeight, edgeColor,
+                                  edgeDirType, arrows, bezier);
                     }
                 }
                 else {
@@ -3495,8 +4785,8 @@ bool Parser::loadDot(){
                     if (it!=nodeSequence.begin()) {
                         qDebug()<<"-- Drawing Link between node "
                                <<source<<" and node " << target;
-                        emit edgeCreate(source,target, edgeWeight , edgeColor,
-                                        edgeDirType, arrows, bezier);
+                        batchEdge(source,target, edgeWeight , edgeColor,
+                                  edgeDirType, arrows, bezier);
                     }
                 }
                 source=target;
@@ -3528,13 +4818,12 @@ bool Parser::loadDot(){
                     randX=rand()%gwWidth;
                     randY=rand()%gwHeight;
                     qDebug()<<"***  Creating node at "<<  randX << " "<< randY<< " label "<<node.toLatin1() << " colored "<< nodeColor;
-                    emit createNode(
+                    batchNode(
                                 totalNodes, initNodeSize, nodeColor,
                                 initNodeNumberColor, initNodeNumberSize,
                                 label, initNodeLabelColor, initNodeLabelSize,
                                 QPointF(randX,randY),
-                                nodeShape, QString::null, false
-                                );
+                                nodeShape, QString::null);
                     aNum=totalNodes;
                     nodesDiscovered.push_back( node);
                     qDebug()<<" Total totalNodes: "<<  totalNodes<< " nodesDiscovered = "<< nodesDiscovered.size();
@@ -3551,6 +4840,11 @@ bool Parser::loadDot(){
     }
     file.close();
 
+    if ( fileReadFailed(file) ) {
+        return false;
+    }
+
+    batchFlush();
     if (relationsList.count() == 0) {
         emit addRelation( (!networkName.isEmpty()) ? networkName :"unnamed");
     }
@@ -3655,620 +4949,681 @@ void Parser::readDotProperties(QString str, qreal &nValue, QString &label,
 
 
 /**
- * Debugging only - Used in loadEdgeListWeighed
+ * @brief Scans the edge list held in the size bytes at data, in a single pass.
+ *
+ * Lines are located with memchr (vectorised in the C library) and
+ * simplified into a reusable buffer, as QString::simplified() would do.
+ * Columns are split at the delimiter bytes without creating any strings:
+ * a node token is copied only the first time it is seen, when it is
+ * interned in scan.nodeIndex. Edges are deduplicated on the pair of
+ * interned node indices.
+ *
+ * In weighted lists, every line must have exactly 3 columns (source,
+ * target, weight) and the first occurrence of an edge gives its weight.
+ * In simple lists, the first column is the source and every other column
+ * a target; repeated edges increase their weight by 1.
+ *
+ * Only reads Parser members, so chunks of a file can be scanned in parallel.
+ * @param data
+ * @param size
+ * @param delim  the column delimiter, in the encoding of data
+ * @param weighted
+ * @param scan
+ * @return false if the data is not an edge list. scan.error and
+ * scan.errorLine tell why and where.
  */
-template<typename T> void print_queue(T& q) {
-    qDebug() << "print_queue() ";
-    while(!q.empty()) {
-        qDebug() << q.top().key << " value: " << q.top().value << " ";
-        q.pop();
-    }
-    qDebug() << endl;
-}
+bool Parser::scanEdgeList(const char *data,
+                          const qint64 &size,
+                          const QByteArray &delim,
+                          const bool &weighted,
+                          EdgeListScan &scan) const {
 
+    const char *end = data + size;
+    const char *lineStart = data;
+    const int delimLength = delim.size();
+    const char *delimData = delim.constData();
 
+    QByteArray buffer;   // the simplified current line
+    QVector<int> columnStart, columnLength;
+    QVector<int> lineNodes;
+    bool hasLetters = false;
 
+    scan.lines = 0;
+    scan.error = EdgeListScan::NoError;
+    scan.errorLine = 0;
 
-/**
- * @brief A method to load a weighted edge list formatted file.
- * @param delimiter
- * @return
- * This method can read and parse edgelist formated files
- * where edge source and target are either named with numbers or with labels
- * That is the following formats can be parsed:
-# edgelist with node numbers
-1 2 1
-1 3 2
-1 6 2
-1 8 2
-...
+    while ( lineStart < end ) {
 
-# edgelist with node labels
-actor1 actor2 1
-actor2 actor4 2
-actor1 actor3 1
-actorX actorY 3
-name othername 1
-othername somename 2
-....
- */
-bool Parser::loadEdgeListWeighed(const QString &delimiter){
-    qDebug() << "Parser::loadEdgeListWeighed() - column delimiter" << delimiter ;
+        scan.lines++;
 
-    QFile file ( fileName );
-    if ( ! file.open(QIODevice::ReadOnly ))
-        return false;
-    QTextStream ts( &file );
-    ts.setCodec(userSelectedCodecName.toUtf8());
-
-    QMap<QString, int> nodeMap;
-    // use a minimum priority queue to order Actors<QString key, int value> by their value
-    // so that we can create the discovered nodes by either their increasing nodeNumber
-    // (if nodesWithLabels == true) or by their actual number in the file (if nodesWithLabels == false).
-    priority_queue<Actor, vector<Actor>, CompareActors> nodeQ;
-    QHash<QString, qreal> edgeList;
-    QString str, edgeKey,edgeKeyDelimiter="====>" ;
-    QStringList lineElement, edgeElement;
-    // one or more digits
-    QRegularExpression onlyDigitsExp("^\\d+$");
-
-    bool nodesWithLabels = false;
-    bool conversionOK = false;
-    int fileLine = 1;
-    totalNodes=0;
-    edgeWeight=1.0;
-    edgeDirType=EdgeType::Directed;
-    arrows=true;
-    bezier=false;
-
-    relationsList.clear();
+        const char *lineEnd = (const char *) memchr(lineStart, '\n', end - lineStart);
+        if ( lineEnd == 0 ) {
+            lineEnd = end;
+        }
 
-    qDebug()<< "*** Parser::loadEdgeListWeighed() - Initial file parsing "
-               "to test integrity and edge naming scheme";
-    while ( !ts.atEnd() )   {
-        str= ts.readLine() ;
+        const int n = simplifyLine(lineStart, lineEnd, buffer, hasLetters);
+        const char *out = buffer.constData();
 
-        qDebug()<< "Parser::loadEdgeListWeighed() - str" << str;
+        lineStart = lineEnd + 1;
 
-        str=str.simplified();
-        qDebug()<< "Parser::loadEdgeListWeighed() - simplified str" << str;
-        if ( isComment(str) )
+        if ( isCommentLine(out, n) ) {
             continue;
-
-        if ( str.contains("vertices",Qt::CaseInsensitive)
-             || str.contains("network",Qt::CaseInsensitive)
-             || str.contains("graph",Qt::CaseInsensitive)
-             || str.contains("digraph",Qt::CaseInsensitive)
-             || str.contains("DL",Qt::CaseInsensitive)
-             || str.contains("list",Qt::CaseInsensitive)
-             || str.contains("graphml",Qt::CaseInsensitive)
-             || str.contains("xml",Qt::CaseInsensitive)
-             ) {
-            qDebug()<< "Parser::loadEdgeListWeighed() - "
-                       "Not a Weighted list-formatted file. Aborting!!";
-            file.close();
-            errorMessage = tr("Not an EdgeList-formatted file. "
-                              "A non-comment line includes prohibited strings (i.e GraphML)");
-            return false;
         }
 
-        lineElement=str.split(delimiter);
-
-        if ( lineElement.count()  != 3 ) {
-            qDebug()<< "*** Parser::loadEdgeListWeighed() - "
-                       "Not a Weighted list-formatted file. Aborting!!";
-            file.close();
-            errorMessage = tr("Not a properly EdgeList-formatted file. "
-                              "Row %1 has not 3 elements as expected (i.e. source, target, weight)")
-                    .arg(fileLine);
+        if ( hasLetters && containsOtherFormatKeywords(out, n) ) {
+            scan.error = EdgeListScan::ProhibitedStrings;
+            scan.errorLine = scan.lines;
             return false;
         }
 
-        edge_source = lineElement[0];
-        edge_target = lineElement[1];
-        edge_weight = lineElement[2];
-        qDebug()<< "Parser::loadEdgeListWeighed() - Dissecting line - "
-                   "source:"
-                << edge_source
-                << "target:"
-                << edge_target
-                << "weight:"
-                << edge_weight;
-
-        if (!edge_source.contains(onlyDigitsExp)) {
-            qDebug()<< "Parser::loadEdgeListWeighed() - node named by non-digit only string. "
-                       "nodesWithLabels = true";
-            nodesWithLabels = true;
+        // split columns at the delimiter
+        columnStart.clear();
+        columnLength.clear();
+        int from = 0;
+        for (int i = 0 ; i + delimLength <= n ; ) {
+            if ( memcmp(out + i, delimData, delimLength) == 0 ) {
+                columnStart.append(from);
+                columnLength.append(i - from);
+                i += delimLength;
+                from = i;
+            }
+            else {
+                i++;
+            }
         }
+        columnStart.append(from);
+        columnLength.append(n - from);
 
-        if (!edge_target.contains(onlyDigitsExp)) {
-            qDebug()<< "Parser::loadEdgeListWeighed() - node named by non-digit only string. "
-                       "nodesWithLabels = true";
-            nodesWithLabels = true;
+        if ( weighted && columnStart.count() != 3 ) {
+            scan.error = EdgeListScan::ColumnCount;
+            scan.errorLine = scan.lines;
+            return false;
         }
-        fileLine ++;
-    }
-
-    ts.seek(0);
-
-    qDebug()<< "*** Parser::loadEdgeListWeighed() - Initial file parsing finished. "
-               "This is really a weighted edge list. Proceed to main parsing";
-
-    while ( !ts.atEnd() )   {
-        str= ts.readLine() ;
 
-        qDebug()<< "Parser::loadEdgeListWeighed() - str" << str;
-
-        str=str.simplified();
-        qDebug()<< "Parser::loadEdgeListWeighed() - simplified str" << str;
-
-        if ( isComment(str) )
-            continue;
-
-        lineElement=str.split(delimiter);
-
-        edge_source = lineElement[0];
-        edge_target = lineElement[1];
-        edge_weight = lineElement[2];
-        qDebug()<< "Parser::loadEdgeListWeighed() - Dissecting line - "
-                   "source:"
-                << edge_source
-                << "target:"
-                << edge_target
-                << "weight:"
-                << edge_weight;
-
-        if ( ! nodeMap.contains(edge_source) ) {
-            totalNodes++;
-            Actor sourceActor;
-            sourceActor.key = edge_source;
-            if (nodesWithLabels) {
-                sourceActor.value = totalNodes;
-                // order by an increasing totalNodes index
-                nodeQ.push( sourceActor );
-                nodeMap.insert(edge_source, totalNodes);
+        // intern the node columns
+        const int nodeColumns = (weighted) ? 2 : columnStart.count();
+        lineNodes.resize(nodeColumns);
+        for (int c = 0 ; c < nodeColumns ; c++ ) {
+            const char *token = out + columnStart[c];
+            const int length = columnLength[c];
+            const QByteArray key = QByteArray::fromRawData(token, length);
+            QHash<QByteArray, int>::const_iterator it = scan.nodeIndex.constFind(key);
+            if ( it != scan.nodeIndex.constEnd() ) {
+                lineNodes[c] = it.value();
+                continue;
             }
-            else {
-                sourceActor.value = edge_source.toInt();
-                // order by the actual actor number in the file
-                nodeQ.push( sourceActor );
-                nodeMap.insert(edge_source, edge_source.toInt() );
+            bool digitsOnly = ( length > 0 );
+            for (int i = 0 ; i < length && digitsOnly ; i++ ) {
+                digitsOnly = ( token[i] >= '0' && token[i] <= '9' );
             }
-            qDebug()<< "Parser::loadEdgeListWeighed() - source, new node named"
-                    << edge_source
-                    << "totalNodes" << totalNodes
-                    << "nodeMap.count"
-                    << nodeMap.count();
-
+            if ( !digitsOnly || ( !weighted && length == 1 && token[0] == '0' ) ) {
+                scan.nodesWithLabels = true;
+            }
+            const QByteArray ownKey(token, length);
+            lineNodes[c] = scan.nodeKeys.count();
+            scan.nodeIndex.insert(ownKey, lineNodes[c]);
+            scan.nodeKeys.append(ownKey);
         }
-        else {
-            qDebug()<< "Parser::loadEdgeListWeighed() - source already found, continue";
-        }
-        if ( ! nodeMap.contains(edge_target) ) {
-            totalNodes++;
-            Actor targetActor;
-            targetActor.key = edge_target;
-            if (nodesWithLabels) {
-                targetActor.value = totalNodes ;
-                // order by an increasing totalNodes index
-                nodeQ.push( targetActor );
-                nodeMap.insert(edge_target, totalNodes);
+
+        // add or update the edges of this line
+        if (weighted) {
+            qreal weight = 1.0;
+            if ( ! parseReal(out + columnStart[2], columnLength[2], weight) ) {
+                weight = 1.0;
             }
-            else {
-                targetActor.value = edge_target.toInt();
-                // order by the actual actor number in the file
-                nodeQ.push( targetActor );
-                nodeMap.insert(edge_target, edge_target.toInt() );
+            const quint64 pair = ( (quint64) lineNodes[0] << 32 ) | (quint32) lineNodes[1];
+            if ( ! scan.edgeIndex.contains(pair) ) {
+                scan.edgeIndex.insert(pair, scan.edgeSource.count());
+                scan.edgeSource.append(lineNodes[0]);
+                scan.edgeTarget.append(lineNodes[1]);
+                scan.edgeWeight.append(weight);
             }
-            qDebug()<< "Parser::loadEdgeListWeighed() - target, new node named"
-                    << edge_target
-                    << "totalNodes" << totalNodes
-                    << "nodeMap.count"
-                    << nodeMap.count();
-
         }
         else {
-            qDebug()<< "Parser::loadEdgeListWeighed() - target already found, continue";
+            for (int c = 1 ; c < nodeColumns ; c++ ) {
+                const quint64 pair = ( (quint64) lineNodes[0] << 32 ) | (quint32) lineNodes[c];
+                QHash<quint64, int>::const_iterator it = scan.edgeIndex.constFind(pair);
+                if ( it == scan.edgeIndex.constEnd() ) {
+                    scan.edgeIndex.insert(pair, scan.edgeSource.count());
+                    scan.edgeSource.append(lineNodes[0]);
+                    scan.edgeTarget.append(lineNodes[c]);
+                    scan.edgeWeight.append(initEdgeWeight);
+                }
+                else {
+                    scan.edgeWeight[it.value()] += 1;
+                }
+            }
         }
+    }
 
-        edgeWeight = edge_weight.toDouble(&conversionOK);
-        if (conversionOK) {
-            qDebug()<< "Parser::loadEdgeListWeighed() - read edge weight"
-                    << edgeWeight;
+    return true;
+}
+
+
+
+/**
+ * @brief Appends the nodes and edges of a scanned chunk to scan, in order.
+ * Nodes new to scan are numbered in their order of appearance in the chunk.
+ * Edges already in scan keep their weight (weighted lists) or add the
+ * chunk's occurrences to it (simple lists), as if the chunk had been
+ * scanned right after the data of scan.
+ * @param scan
+ * @param chunk
+ * @param weighted
+ */
+void Parser::mergeEdgeListScan(EdgeListScan &scan,
+                               const EdgeListScan &chunk,
+                               const bool &weighted) const {
+
+    QVector<int> globalIndex(chunk.nodeKeys.count());
+    for (int i = 0 ; i < chunk.nodeKeys.count() ; i++ ) {
+        const QByteArray &key = chunk.nodeKeys.at(i);
+        QHash<QByteArray, int>::const_iterator it = scan.nodeIndex.constFind(key);
+        if ( it != scan.nodeIndex.constEnd() ) {
+            globalIndex[i] = it.value();
         }
         else {
-            edgeWeight = 1.0;
-            qDebug()<< "Parser::loadEdgeListWeighed() - error reading edge weight."
-                       "Using default edgeWeight"
-                    << edgeWeight;
+            globalIndex[i] = scan.nodeKeys.count();
+            scan.nodeIndex.insert(key, globalIndex[i]);
+            scan.nodeKeys.append(key);
         }
-        edgeKey = edge_source + edgeKeyDelimiter + edge_target;
-        if ( ! edgeList.contains( edgeKey ) ) {
-            qDebug()<< "Parser::loadEdgeListWeighed() - inserting edgeKey"
-                    << edgeKey
-                    << "in edgeList with weight" << edgeWeight;
-            edgeList.insert( edgeKey, edgeWeight );
-            totalLinks++;
+    }
+    scan.nodesWithLabels = scan.nodesWithLabels || chunk.nodesWithLabels;
+
+    for (int e = 0 ; e < chunk.edgeSource.count() ; e++ ) {
+        const int s = globalIndex[ chunk.edgeSource[e] ];
+        const int t = globalIndex[ chunk.edgeTarget[e] ];
+        const quint64 pair = ( (quint64) s << 32 ) | (quint32) t;
+        QHash<quint64, int>::const_iterator it = scan.edgeIndex.constFind(pair);
+        if ( it == scan.edgeIndex.constEnd() ) {
+            scan.edgeIndex.insert(pair, scan.edgeSource.count());
+            scan.edgeSource.append(s);
+            scan.edgeTarget.append(t);
+            scan.edgeWeight.append(chunk.edgeWeight[e]);
         }
+        else if ( !weighted ) {
+            // chunk weight = initEdgeWeight + repetitions = occurrences
+            scan.edgeWeight[it.value()] += chunk.edgeWeight[e];
+        }
+    }
+    scan.lines += chunk.lines;
+}
 
 
-    } //end ts.stream while here
-    file.close();
 
-    qDebug() << "Parser::loadEdgeListWeighed() - finished reading file, "
-                "start creating nodes and edges";
+/**
+ * Number of bytes before the parsed offset of an edge list which are
+ * checksummed, to tell whether the file was rewritten before appending.
+ */
+static const qint64 EDGE_LIST_CHECKSUM_BYTES = 256;
 
-    //print_queue(nodeQ);
 
-    // create nodes one by one
-    while (!nodeQ.empty()) {
+/**
+ * @brief Returns the checksum of the bytes just before offset in data
+ */
+static quint16 edgeListChecksum(const char *data, const qint64 &offset) {
+    const qint64 length = qMin(offset, EDGE_LIST_CHECKSUM_BYTES);
+    return qChecksum(data + offset - length, (uint) length);
+}
 
-        Actor node = nodeQ.top();
-        nodeQ.pop();
-        randX=rand()%gwWidth;
-        randY=rand()%gwHeight;
 
-        if (nodesWithLabels) {
-            qDebug() << "Parser::loadEdgeListWeighed() - creating node named"
-                     << node.key << "numbered" << node.value
-                     << "at position" << QPointF(randX, randY);
-            emit createNode( node.value,
-                             initNodeSize,
-                             initNodeColor,
-                             initNodeNumberColor,
-                             initNodeNumberSize,
-                             node.key,
-                             initNodeLabelColor, initNodeLabelSize,
-                             QPointF(randX, randY),
-                             initNodeShape,QString::null,
-                             false
-                             );
-        }
-        else {
+/**
+ * @brief Returns the key of the edge from source to target node numbers
+ */
+static quint64 edgeListEdgeKey(const int &source, const int &target) {
+    return ( (quint64) (quint32) source << 32 ) | (quint32) target;
+}
 
-            qDebug() << "Parser::loadEdgeListWeighed() - creating node named"
-                     << node.key << "numbered" << node.key.toInt()
-                     << "at position" << QPointF(randX, randY);
-            emit createNode( node.key.toInt(),
-                             initNodeSize,
-                             initNodeColor,
-                             initNodeNumberColor,
-                             initNodeNumberSize,
-                             node.key,
-                             initNodeLabelColor, initNodeLabelSize,
-                             QPointF(randX, randY),
-                             initNodeShape,QString::null,
-                             false
-                             );
 
-        }
 
+/**
+ * @brief Loads an edge list file (weighted or simple) in a single pass.
+ *
+ * The file is memory-mapped (see fileBytes) and split at line boundaries
+ * in chunks, which are scanned by scanEdgeList on the thread pool. The
+ * chunks are then merged in file order, so that node numbering and edge
+ * weights are the same as in a sequential scan. The user selected codec
+ * is applied only to the node labels.
+ *
+ * Nodes are numbered by their order of appearance if any of them is named
+ * by a label, or by their actual number in the file otherwise, and they are
+ * created in increasing number. Edges are created in order of appearance.
+ * @param delimiter
+ * @param weighted
+ * @return
+ */
+bool Parser::loadEdgeList(const QString &delimiter, const bool &weighted) {
+
+    NetworkFile file ( fileName );
+    if ( ! file.open(QIODevice::ReadOnly ))
+        return false;
+
+    QTextCodec *codec = QTextCodec::codecForName( userSelectedCodecName.toUtf8() );
+    if ( codec == 0 ) {
+        codec = QTextCodec::codecForName("UTF-8");
     }
 
-    //create edges one by one
-    QHash<QString, qreal>::const_iterator edge = edgeList.constBegin();
-    while (edge!= edgeList.constEnd()) {
+    QByteArray contents;
+    qint64 size = 0;
+    uchar *mapped = 0;
+    const char *data = fileBytes(file, contents, size, mapped, codec);
+    if ( fileReadFailed(file) ) {
+        return false;
+    }
 
-        qDebug() << "Parser::loadEdgeListWeighed() - creating edge named"
-                 << edge.key() << " weight " << edge.value();
+    const QByteArray delim = codec->fromUnicode( (delimiter.isEmpty()) ? QString(" ") : delimiter );
+
+    totalNodes = 0;
+    totalLinks = 0;
+    initEdgeWeight = 1.0;
+    edgeWeight = 1.0;
+    edgeDirType=EdgeType::Directed;
+    arrows=true;
+    bezier=false;
 
-        edgeElement=edge.key().split(edgeKeyDelimiter);
-        if (nodesWithLabels) {
-            source = nodeMap.value( edgeElement[0] ) ;
-            target = nodeMap.value( edgeElement[1] ) ;
+    relationsList.clear();
+
+    // Whole lines only: a last line without its newline may still be being
+    // written, so it is left for appendEdgeList() to read once it is complete.
+    qint64 end = size;
+    while ( end > 0 && data[end - 1] != '\n' ) {
+        end--;
+    }
+    if ( end < size ) {
+        qDebug() << "Parser::loadEdgeList() - leaving" << size - end
+                 << "bytes of an unterminated last line for the next append";
+    }
+
+    const QVector<qint64> bounds = splitAtLines(data, end);
+    QVector<EdgeListScan> chunks(bounds.count() - 1);
+    QVector<int> chunkIndex(chunks.count());
+    for (int k = 0 ; k < chunks.count() ; k++ ) {
+        chunkIndex[k] = k;
+        chunks[k].nodesWithLabels = false;
+    }
+
+    qDebug() << "Parser::loadEdgeList() - scanning" << end << "bytes in"
+             << chunks.count() << "chunks. weighted" << weighted
+             << "mapped" << ( mapped != 0 );
+
+    QtConcurrent::blockingMap(chunkIndex, [&](const int &k) {
+        scanEdgeList(data + bounds[k], bounds[k+1] - bounds[k],
+                     delim, weighted, chunks[k]);
+    });
+
+    const quint16 checksum = edgeListChecksum(data, end);
+
+    if ( mapped ) {
+        file.file().unmap(mapped);
+    }
+    file.close();
+
+    EdgeListScan scan;
+    scan.nodesWithLabels = false;
+    scan.lines = 0;
+    for (int k = 0 ; k < chunks.count() ; k++ ) {
+        if ( chunks[k].error != EdgeListScan::NoError ) {
+            const int fileLine = scan.lines + chunks[k].errorLine;
+            qDebug()<< "*** Parser::loadEdgeList() - "
+                       "Not an EdgeList-formatted file. Aborting!! Line" << fileLine;
+            if ( chunks[k].error == EdgeListScan::ProhibitedStrings ) {
+                errorMessage = tr("Not an EdgeList-formatted file. "
+                                  "Non-comment line %1 includes prohibited strings (i.e GraphML)")
+                        .arg(fileLine);
+            }
+            else {
+                errorMessage = tr("Not a properly EdgeList-formatted file. "
+                                  "Row %1 has not 3 elements as expected (i.e. source, target, weight)")
+                        .arg(fileLine);
+            }
+            return false;
+        }
+        if ( k == 0 ) {
+            scan = chunks[0];
         }
         else {
-            source = edgeElement[0].toInt() ;
-            target = edgeElement[1].toInt() ;
+            mergeEdgeListScan(scan, chunks[k], weighted);
         }
-        edgeWeight = edge.value();
-        emit edgeCreate(source,
-                        target,
-                        edgeWeight,
-                        initEdgeColor,
-                        edgeDirType,
-                        arrows,
-                        bezier);
+        chunks[k] = EdgeListScan();
+    }
+
+    totalNodes = scan.nodeKeys.count();
+    totalLinks = scan.edgeSource.count();
 
-        ++edge;
+    qDebug() << "Parser::loadEdgeList() - finished reading file."
+             << "nodes" << totalNodes << "edges" << totalLinks
+             << "nodesWithLabels" << scan.nodesWithLabels;
+
+    // node numbers: order of appearance or actual numbers in the file
+    QVector<int> nodeNumber(totalNodes);
+    for (int i = 0 ; i < totalNodes ; i++ ) {
+        nodeNumber[i] = (scan.nodesWithLabels) ? i + 1 : scan.nodeKeys[i].toInt();
     }
 
+    // create nodes in increasing number (ties by name)
+    QVector<int> order(totalNodes);
+    for (int i = 0 ; i < totalNodes ; i++ ) {
+        order[i] = i;
+    }
+    if ( ! scan.nodesWithLabels ) {
+        std::stable_sort(order.begin(), order.end(), [&](const int &a, const int &b) {
+            if ( nodeNumber[a] != nodeNumber[b] ) {
+                return nodeNumber[a] < nodeNumber[b];
+            }
+            return scan.nodeKeys[a] < scan.nodeKeys[b];
+        });
+    }
 
+    for (int i = 0 ; i < totalNodes ; i++ ) {
+        const int node = order[i];
+        randX=rand()%gwWidth;
+        randY=rand()%gwHeight;
+        batchNode( nodeNumber[node],
+                   initNodeSize,
+                   initNodeColor,
+                   initNodeNumberColor,
+                   initNodeNumberSize,
+                   codec->toUnicode( scan.nodeKeys[node] ),
+                   initNodeLabelColor, initNodeLabelSize,
+                   QPointF(randX, randY),
+                   initNodeShape,QString::null);
+    }
 
+    for (int e = 0 ; e < totalLinks ; e++ ) {
+        batchEdge(nodeNumber[ scan.edgeSource[e] ],
+                  nodeNumber[ scan.edgeTarget[e] ],
+                  scan.edgeWeight[e],
+                  initEdgeColor,
+                  edgeDirType,
+                  arrows,
+                  bezier);
+    }
+
+    batchFlush();
     if (relationsList.count() == 0) {
         emit addRelation("unnamed");
     }
 
-    //The network has been loaded. Tell MW the statistics and network type
-    emit networkFileLoaded(FileType::EDGELIST_WEIGHTED, fileName, networkName,
-                           totalNodes, totalLinks, edgeDirType);
-    qDebug() << "Parser::loadEdgeListWeighed() - END. Returning.";
+    // Leave behind what appendEdgeList() needs to read the lines added later
+    EdgeListAppendState *state = new EdgeListAppendState;
+    state->fileName = fileName;
+    state->fileType = (weighted) ? FileType::EDGELIST_WEIGHTED : FileType::EDGELIST_SIMPLE;
+    state->delimiter = delimiter;
+    state->codecName = userSelectedCodecName;
+    state->offset = end;
+    state->checksum = checksum;
+    state->lines = scan.lines;
+    state->nodesWithLabels = scan.nodesWithLabels;
+    state->maxNodeNumber = 0;
+    state->nodeNumber.reserve(totalNodes);
+    for (int i = 0 ; i < totalNodes ; i++ ) {
+        state->nodeNumber.insert(scan.nodeKeys[i], nodeNumber[i]);
+        state->nodeNumbers.insert(nodeNumber[i]);
+        state->maxNodeNumber = qMax(state->maxNodeNumber, nodeNumber[i]);
+    }
+    if ( !weighted ) {
+        state->edgeWeight.reserve(totalLinks);
+        for (int e = 0 ; e < totalLinks ; e++ ) {
+            state->edgeWeight.insert( edgeListEdgeKey( nodeNumber[ scan.edgeSource[e] ],
+                                                       nodeNumber[ scan.edgeTarget[e] ] ),
+                                      scan.edgeWeight[e] );
+        }
+    }
+    emit edgeListStateReady(state);
 
     return true;
-
 }
 
 
 
+/**
+ * @brief Gives the Parser the state of an earlier edge list load, so that
+ * the next load() reads only the lines appended to that file since.
+ * The Parser owns state until it hands it back with edgeListStateReady().
+ * @param state
+ */
+void Parser::setEdgeListState(EdgeListAppendState *state) {
+    delete m_edgeListState;
+    m_edgeListState = state;
+}
 
-bool Parser::loadEdgeListSimple(const QString &delimiter){
-    qDebug() << "Parser::loadEdgeListSimple() - column delimiter" << delimiter ;
-    QFile file ( fileName );
-    if ( ! file.open(QIODevice::ReadOnly ))
-        return false;
-    QTextStream ts( &file );
-    ts.setCodec(userSelectedCodecName.toUtf8());  // set the userselectedCodec
-    QString str, edgeKey,edgeKeyDelimiter="====>" ;
-    QStringList lineElement,edgeElement;
-    int columnCount=0;
-    int fileLine = 0;
-    bool nodesWithLabels= false;
-    //@TODO Always use nodesWithLabels= true
-
-    QMap<QString, int> nodeMap;
-    // use a minimum priority queue to order Actors<QString key, int value> by their value
-    // so that we can create the discovered nodes by either their increasing nodeNumber
-    // (if nodesWithLabels == true) or by their actual number in the file (if nodesWithLabels == false).
-    priority_queue<Actor, vector<Actor>, CompareActors> nodeQ;
-    QHash<QString, qreal> edgeList;
 
-    QRegularExpression onlyDigitsExp("^\\d+$");
 
-    totalNodes = 0;
-    initEdgeWeight=1.0;
-
-    edgeDirType=EdgeType::Directed;
-    arrows=true;
-    bezier=false;
+/**
+ * @brief Reads the lines appended to an edge list file since it was loaded.
+ *
+ * Only the complete lines after the offset kept in m_edgeListState are
+ * scanned; a partially written last line is left for the next append.
+ * Node tokens seen before keep their node numbers. New tokens are numbered
+ * as loadEdgeList() would: by their value in lists of numbered nodes, or
+ * after the last node otherwise. New nodes and edges are handed to Graph
+ * in batches. In simple lists, the edges already in the graph get their
+ * increased weight; in weighted lists, their first weight is kept.
+ *
+ * Emits networkFileAppended() with the counts or an error message, and
+ * hands the updated state back with edgeListStateReady(), unless the file
+ * was truncated or rewritten since and has to be loaded again.
+ * @return
+ */
+bool Parser::appendEdgeList() {
 
-    relationsList.clear();
+    EdgeListAppendState *state = m_edgeListState;
+    m_edgeListState = 0;
 
-    qDebug()<< "*** Parser::loadEdgeListSimple() - Initial file parsing "
-               "to test integrity and edge naming scheme";
+    const bool weighted = ( state->fileType == FileType::EDGELIST_WEIGHTED );
 
-    while ( !ts.atEnd() )   {
-        fileLine++;
-        str= ts.readLine() ;
-        qDebug()<< "Parser::loadEdgeListSimple() - line "  << fileLine
-                << endl << str;
-        str=str.simplified();
+    qDebug() << "Parser::appendEdgeList() - file" << state->fileName
+             << "from offset" << state->offset << "weighted" << weighted;
 
-        if ( isComment(str) )
-            continue;
+    NetworkFile file ( state->fileName );
+    if ( ! file.open(QIODevice::ReadOnly )) {
+        emit edgeListStateReady(state);
+        emit networkFileAppended(0, 0, tr("Cannot read file %1: %2")
+                                 .arg(state->fileName).arg(file.errorString()) );
+        return false;
+    }
 
-        if ( str.contains("vertices",Qt::CaseInsensitive)
-             || str.contains("network",Qt::CaseInsensitive)
-             || str.contains("graph",Qt::CaseInsensitive)
-             || str.contains("digraph",Qt::CaseInsensitive)
-             || str.contains("DL",Qt::CaseInsensitive)
-             || str.contains("list",Qt::CaseInsensitive)
-             || str.contains("graphml",Qt::CaseInsensitive)
-             || str.contains("xml",Qt::CaseInsensitive)
-             ) {
-            qDebug()<< "*** Parser:loadEdgeListSimple(): Not an EdgeList-formatted file. Aborting!!";
-            errorMessage = tr("Not an EdgeList-formatted file. "
-                              "Non-comment line %1 includes prohibited strings (i.e GraphML)")
-                    .arg(fileLine);
-            file.close();
-            return false;
-        }
+    QTextCodec *codec = QTextCodec::codecForName( state->codecName.toUtf8() );
+    if ( codec == 0 ) {
+        codec = QTextCodec::codecForName("UTF-8");
+    }
 
-        lineElement=str.split(delimiter);
+    QByteArray contents;
+    qint64 size = 0;
+    uchar *mapped = 0;
+    const char *data = fileBytes(file, contents, size, mapped, codec);
+
+    if ( !file.streamError().isEmpty() ) {
+        // compressed files are never mapped
+        file.close();
+        emit edgeListStateReady(state);
+        emit networkFileAppended(0, 0, tr("Cannot read file %1: %2")
+                                 .arg(state->fileName).arg(file.streamError()) );
+        return false;
+    }
 
-        for (QStringList::Iterator it1 = lineElement.begin(); it1!=lineElement.end(); ++it1)   {
-            edge_source = (*it1);
-            if (!edge_source.contains(onlyDigitsExp)) {
-                qDebug()<< "Parser::loadEdgeListSimple() - node named by non-digit only string. "
-                           "nodesWithLabels = true";
-                nodesWithLabels = true;
-            }
-            if ( edge_source == "0" ) {
-                nodesWithLabels = true;
-            }
+    if ( size < state->offset
+         || edgeListChecksum(data, state->offset) != state->checksum ) {
+        if ( mapped ) {
+            file.file().unmap(mapped);
         }
-
+        file.close();
+        qDebug() << "Parser::appendEdgeList() - file truncated or rewritten. size"
+                 << size;
+        const QString message = tr("File %1 was truncated or rewritten since it "
+                                   "was loaded. Please load it again.")
+                .arg(state->fileName);
+        delete state;
+        emit networkFileAppended(0, 0, message);
+        return false;
     }
 
+    // whole lines only
+    qint64 end = size;
+    while ( end > state->offset && data[end - 1] != '\n' ) {
+        end--;
+    }
 
-    ts.seek(0);
-    fileLine = 0;
+    const QByteArray delim = codec->fromUnicode( (state->delimiter.isEmpty())
+                                                 ? QString(" ") : state->delimiter );
+    initEdgeWeight = 1.0;
 
-    qDebug () << "Parser::loadEdgeListSimple() - Reset and read lines. nodesWithLabels"
-                 << nodesWithLabels;
+    EdgeListScan scan;
+    scan.nodesWithLabels = false;
+    const bool scanned = scanEdgeList(data + state->offset, end - state->offset,
+                                      delim, weighted, scan);
+    const quint16 checksum = edgeListChecksum(data, end);
 
-    while ( !ts.atEnd() )   {
-        fileLine++;
-        str= ts.readLine() ;
+    if ( mapped ) {
+        file.file().unmap(mapped);
+    }
+    file.close();
 
-        str=str.simplified();
+    if ( !scanned ) {
+        const int fileLine = state->lines + scan.errorLine;
+        emit edgeListStateReady(state);
+        emit networkFileAppended(0, 0, ( scan.error == EdgeListScan::ProhibitedStrings )
+                                 ? tr("Appended line %1 includes prohibited strings "
+                                      "(i.e GraphML)").arg(fileLine)
+                                 : tr("Appended line %1 has not 3 elements as expected "
+                                      "(i.e. source, target, weight)").arg(fileLine) );
+        return false;
+    }
 
-        qDebug()<< "Parser::loadEdgeListSimple() - line" << fileLine
-                << endl << str;
+    // set before the first batchNode(), which creates the batch
+    m_batchUpdatesEdgeWeights = !weighted;
 
-        if ( isComment(str) )
+    int newNodes = 0;
+    QVector<int> nodeNumber(scan.nodeKeys.count());
+    for (int i = 0 ; i < scan.nodeKeys.count() ; i++ ) {
+        const QByteArray &key = scan.nodeKeys.at(i);
+        QHash<QByteArray, int>::const_iterator it = state->nodeNumber.constFind(key);
+        if ( it != state->nodeNumber.constEnd() ) {
+            nodeNumber[i] = it.value();
             continue;
+        }
+        int number = 0;
+        if ( !state->nodesWithLabels ) {
+            bool isNumber = false;
+            number = key.toInt(&isNumber);
+            if ( !isNumber || number <= 0 || state->nodeNumbers.contains(number) ) {
+                number = 0;
+            }
+        }
+        if ( number == 0 ) {
+            number = state->maxNodeNumber + 1;
+        }
+        nodeNumber[i] = number;
+        state->nodeNumber.insert(key, number);
+        state->nodeNumbers.insert(number);
+        state->maxNodeNumber = qMax(state->maxNodeNumber, number);
 
-        lineElement=str.split(delimiter);
+        randX=rand()%gwWidth;
+        randY=rand()%gwHeight;
+        batchNode( number,
+                   initNodeSize,
+                   initNodeColor,
+                   initNodeNumberColor,
+                   initNodeNumberSize,
+                   codec->toUnicode( key ),
+                   initNodeLabelColor, initNodeLabelSize,
+                   QPointF(randX, randY),
+                   initNodeShape,QString::null);
+        newNodes++;
+    }
 
-        columnCount = 0;
-        for (QStringList::Iterator it1 = lineElement.begin(); it1!=lineElement.end(); ++it1)   {
-            columnCount ++;
-            if (columnCount == 1) {  // source node
-                edge_source = (*it1);
-                qDebug()<< "Parser::loadEdgeListSimple() - Dissecting line - "
-                           "source node:"
-                        << edge_source;
+    for (int e = 0 ; e < scan.edgeSource.count() ; e++ ) {
+        const int source = nodeNumber[ scan.edgeSource[e] ];
+        const int target = nodeNumber[ scan.edgeTarget[e] ];
+        qreal weight = scan.edgeWeight[e];
+        if ( !weighted ) {
+            // occurrences in the appended lines add to the earlier weight
+            const quint64 key = edgeListEdgeKey(source, target);
+            weight += state->edgeWeight.value(key, 0);
+            state->edgeWeight.insert(key, weight);
+        }
+        batchEdge(source,
+                  target,
+                  weight,
+                  initEdgeColor,
+                  EdgeType::Directed,
+                  true,
+                  false);
+    }
+    batchFlush();
+    m_batchUpdatesEdgeWeights = false;
 
-                if ( ! nodeMap.contains(edge_source) ) {
+    state->offset = end;
+    state->checksum = checksum;
+    state->lines += scan.lines;
 
+    qDebug() << "Parser::appendEdgeList() - new nodes" << newNodes
+             << "edges" << scan.edgeSource.count() << "offset now" << end;
 
-                    totalNodes++;
-                    Actor sourceActor;
-                    sourceActor.key = edge_source;
-                    if (nodesWithLabels) {
-                        sourceActor.value = totalNodes;
-                        // order by an increasing totalNodes index
-                        nodeQ.push( sourceActor );
-                        nodeMap.insert(edge_source, totalNodes);
-                    }
-                    else {
-                        sourceActor.value = edge_source.toInt();
-                        // order by the actual actor number in the file
-                        nodeQ.push( sourceActor );
-                        nodeMap.insert(edge_source, edge_source.toInt() );
-                    }
-                    qDebug()<< "Parser::loadEdgeListSimple() - source, new node named"
-                            << edge_source
-                            << "totalNodes" << totalNodes
-                            << "nodeMap.count"
-                            << nodeMap.count();
+    emit edgeListStateReady(state);
+    emit networkFileAppended(newNodes, scan.edgeSource.count());
 
-                }
-                else {
-                    qDebug()<< "Parser::loadEdgeListWeighed() - source already found, continue";
-                }
-            }
-            else { // target nodes
-                edge_target= (*it1);
-                qDebug()<< "Parser::loadEdgeListSimple() - Dissecting line - "
-                           "target node:"
-                        << edge_target;
+    return true;
+}
 
-                if ( ! nodeMap.contains(edge_target) ) {
 
-                    totalNodes++;
-                    Actor targetActor;
-                    targetActor.key = edge_target;
-                    if (nodesWithLabels) {
-                        targetActor.value = totalNodes ;
-                        // order by an increasing totalNodes index
-                        nodeQ.push( targetActor );
-                        nodeMap.insert(edge_target, totalNodes);
-                    }
-                    else {
-                        targetActor.value = edge_target.toInt();
-                        // order by the actual actor number in the file
-                        nodeQ.push( targetActor );
-                        nodeMap.insert(edge_target, edge_target.toInt() );
-                    }
-                    qDebug()<< "Parser::loadEdgeListSimple() - target, new node named"
-                            << edge_target
-                            << "totalNodes" << totalNodes
-                            << "nodeMap.count"
-                            << nodeMap.count();
 
-                }
-                else {
-                    qDebug()<< "Parser::loadEdgeListSimple() - target already found, continue";
-                }
+/**
+ * @brief A method to load a weighted edge list formatted file.
+ * @param delimiter
+ * @return
+ * This method can read and parse edgelist formated files
+ * where edge source and target are either named with numbers or with labels
+ * That is the following formats can be parsed:
+# edgelist with node numbers
+1 2 1
+1 3 2
+1 6 2
+1 8 2
+...
 
-            }
+# edgelist with node labels
+actor1 actor2 1
+actor2 actor4 2
+actor1 actor3 1
+actorX actorY 3
+name othername 1
+othername somename 2
+....
+ * See loadEdgeList
+ */
+bool Parser::loadEdgeListWeighed(const QString &delimiter){
+    qDebug() << "Parser::loadEdgeListWeighed() - column delimiter" << delimiter ;
 
-            if (columnCount > 1)  {
-                edgeKey = edge_source + edgeKeyDelimiter + edge_target;
-                if ( ! edgeList.contains( edgeKey ) ) {
-                    qDebug()<< "Parser::loadEdgeListSimple() - inserting edgeKey"
-                            << edgeKey
-                            << "in edgeList with initial weight" << initEdgeWeight;
-                    edgeList.insert( edgeKey, initEdgeWeight );
-                    totalLinks++;
-                }
-                else { // if edge already discovered, then increase its weight by 1
-                    edgeWeight = edgeList.value(edgeKey);
-                    edgeWeight = edgeWeight + 1;
-                    qDebug()<< "Parser::loadEdgeListSimple() - edgeKey"
-                            << edgeKey
-                            << "found before, adding in edgeList with increased weight"
-                            << edgeWeight;
-
-                    edgeList.insert( edgeKey, edgeWeight );
-                }
-            }
+    if ( ! loadEdgeList(delimiter, true) ) {
+        return false;
+    }
+
+    //The network has been loaded. Tell MW the statistics and network type
+    emit networkFileLoaded(FileType::EDGELIST_WEIGHTED, fileName, networkName,
+                           totalNodes, totalLinks, edgeDirType);
+    qDebug() << "Parser::loadEdgeListWeighed() - END. Returning.";
 
-        }  // end for QStringList::Iterator
+    return true;
+
+}
 
-    } //end ts.stream while here
-    file.close();
 
 
-    // create nodes one by one
-    while (!nodeQ.empty()) {
-
-        Actor node = nodeQ.top();
-         nodeQ.pop();
-         randX=rand()%gwWidth;
-         randY=rand()%gwHeight;
-
-         if (nodesWithLabels) {
-             qDebug() << "Parser::loadEdgeListSimple() - creating node named"
-                      << node.key << "numbered" << node.value
-                      << "at position" << QPointF(randX, randY);
-             emit createNode( node.value,
-                              initNodeSize,
-                              initNodeColor,
-                              initNodeNumberColor,
-                              initNodeNumberSize,
-                              node.key,
-                              initNodeLabelColor, initNodeLabelSize,
-                              QPointF(randX, randY),
-                              initNodeShape,QString::null,
-                              false
-                              );
-         }
-         else {
-
-             qDebug() << "Parser::loadEdgeListSimple() - creating node named"
-                      << node.key << "numbered" << node.key.toInt()
-                      << "at position" << QPointF(randX, randY);
-             emit createNode( node.key.toInt(),
-                              initNodeSize,
-                              initNodeColor,
-                              initNodeNumberColor,
-                              initNodeNumberSize,
-                              node.key,
-                              initNodeLabelColor, initNodeLabelSize,
-                              QPointF(randX, randY),
-                              initNodeShape,QString::null,
-                              false
-                              );
-
-         }
-
-     }
-
-
-    //create edges one by one
-    QHash<QString, qreal>::const_iterator edge = edgeList.constBegin();
-     while (edge!= edgeList.constEnd()) {
-
-         qDebug() << "Parser::loadEdgeListWeighed() - creating edge named"
-                  << edge.key() << " weight " << edge.value();
-
-         edgeElement=edge.key().split(edgeKeyDelimiter);
-         if (nodesWithLabels) {
-             source = nodeMap.value( edgeElement[0] ) ;
-             target = nodeMap.value( edgeElement[1] ) ;
-         }
-         else {
-             source = edgeElement[0].toInt() ;
-             target = edgeElement[1].toInt() ;
-         }
-         edgeWeight = edge.value();
-         emit edgeCreate(source,
-                         target,
-                         edgeWeight,
-                         initEdgeColor,
-                         edgeDirType,
-                         arrows,
-                         bezier);
-
-         ++edge;
-     }
-
-
-     if (relationsList.count() == 0) {
-         emit addRelation("unnamed");
-     }
+/**
+ * @brief A method to load a simple (unweighted) edge list formatted file,
+ * where each line has a source node followed by one or more target nodes.
+ * Repeated edges increase the edge weight.
+ * See loadEdgeList
+ * @param delimiter
+ * @return
+ */
+bool Parser::loadEdgeListSimple(const QString &delimiter){
+    qDebug() << "Parser::loadEdgeListSimple() - column delimiter" << delimiter ;
+
+    if ( ! loadEdgeList(delimiter, false) ) {
+        return false;
+    }
 
     //The network has been loaded. Tell MW the statistics and network type
     emit networkFileLoaded(FileType::EDGELIST_SIMPLE, fileName, networkName, totalNodes, totalLinks, edgeDirType);
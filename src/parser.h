@@ -30,46 +30,179 @@
 
 #include <QThread>
 #include <QHash>
+#include <QSet>
 #include <QStringList>
 #include <QPointF>
 #include <QObject>
 #include <QMultiMap>
+#include <QVector>
+#include <QByteArray>
 #include <QDebug>
+#include <QFile>
+#include <QIODevice>
 class QXmlStreamReader;
 class QXmlStreamAttributes;
+class QTextStream;
+struct z_stream_s;
+struct ZSTD_DCtx_s;
+
+
+
+/**
+ * @brief Read-only network file which is decompressed while it is read.
+ * open() detects gzip and zstd compressed files by their magic bytes; these
+ * are inflated block by block into the caller's buffer, so the decompressed
+ * file never exists on disk. Other files are read as they are, and file()
+ * gives access to the underlying QFile for memory mapping.
+ * Compressed data that is corrupt or ends before its end-of-stream marker
+ * makes reads fail; streamError() then tells why, even after close().
+ * Used by all Parser load methods and by the file preview.
+ */
+class NetworkFile : public QIODevice {
+    Q_OBJECT
+public:
+    enum Compression { None, Gzip, Zstd };
+
+    explicit NetworkFile(const QString &fileName);
+    ~NetworkFile();
+
+    bool open(OpenMode mode);
+    void close();
+    bool isSequential() const;
+    bool atEnd() const;
+    qint64 size() const;
+    bool seek(qint64 pos);
+
+    Compression compression() const { return m_compression; }
+    bool isCompressed() const { return m_compression != None; }
+    QFile &file() { return m_file; }
+    QString streamError() const { return m_streamError; }
+
+    static Compression compression(const QByteArray &magic);
+    static bool supported(const Compression &compression);
+
+protected:
+    qint64 readData(char *data, qint64 maxSize);
+    qint64 writeData(const char *, qint64) { return -1; }
+
+private:
+    qint64 inflateGzip(char *data, const qint64 &maxSize);
+    qint64 inflateZstd(char *data, const qint64 &maxSize);
+    bool fillInput();
+    void setStreamError(const QString &message);
+
+    QFile m_file;
+    Compression m_compression;
+    struct z_stream_s *m_gzip;
+    struct ZSTD_DCtx_s *m_zstd;
+    QByteArray m_input;
+    qint64 m_inputPos;
+    bool m_finished;
+    quint64 m_zstdRemaining;    // last ZSTD_decompressStream() hint, 0 at a frame end
+    QString m_streamError;
+};
 
 
 
 
 /**
- * @brief The Actor struct
+ * @brief The EdgeListScan struct
+ * Holds the nodes and edges found while scanning (a chunk of) an edge list
+ * file. Node tokens are interned in order of appearance; edges refer to
+ * nodes by their index in nodeKeys.
  * Used in loadEdgeListWeighed and loadEdgeListSimple
  */
-struct Actor {
-    QString key;
-    int value;
+struct EdgeListScan {
+    enum Error { NoError, ProhibitedStrings, ColumnCount };
+    QHash<QByteArray, int> nodeIndex;   // node token -> index in nodeKeys
+    QList<QByteArray> nodeKeys;
+    QHash<quint64, int> edgeIndex;      // (source index, target index) -> edge
+    QVector<int> edgeSource;
+    QVector<int> edgeTarget;
+    QVector<qreal> edgeWeight;
+    bool nodesWithLabels;
+    int lines;                          // lines scanned
+    int error;
+    int errorLine;
 };
 
 
 /**
- * @brief The CompareActors class
- * Implements a min-priority queue
- * Used in loadEdgeListWeighed
+ * @brief The ParserBatch struct
+ * A block of nodes and edges read by the Parser, handed over to Graph at once
+ * instead of emitting one signal per element. Nodes and edges are kept in
+ * struct-of-arrays form, in the order they were read. Colors, labels, shapes
+ * and icon paths are indices into the interned strings pool.
+ * Ownership passes to the receiver of Parser::batchReady.
  */
-class CompareActors {
-    public:
-    bool operator()(Actor& t1, Actor& t2)
-    {
-       if (t1.value== t2.value)
-            return t1.key  > t2.key ;
-//       qDebug () << t1.value << " > " << t2.value << "?"
-//                 << ( t1.value > t2.value ) ;
-       return t1.value > t2.value;  //minimum priority
-       // Returns true if t2.value smaller than t1.value
+struct ParserBatch {
+    QStringList strings;
+    QHash<QString, int> stringIndex;    // string -> index in strings
+
+    QVector<int> nodeNumber;
+    QVector<int> nodeSize;
+    QVector<int> nodeColor;
+    QVector<int> nodeNumberColor;
+    QVector<int> nodeNumberSize;
+    QVector<int> nodeLabel;
+    QVector<int> nodeLabelColor;
+    QVector<int> nodeLabelSize;
+    QVector<QPointF> nodePos;
+    QVector<int> nodeShape;
+    QVector<int> nodeIconPath;
+
+    QVector<int> edgeSource;
+    QVector<int> edgeTarget;
+    QVector<qreal> edgeWeight;
+    QVector<int> edgeColor;
+    QVector<int> edgeType;
+    QVector<bool> edgeArrows;
+    QVector<bool> edgeBezier;
+    QVector<int> edgeLabel;
+
+    bool updateEdgeWeights;             // existing edges take the batch weight
+
+    int intern(const QString &str) {
+        QHash<QString, int>::const_iterator it = stringIndex.constFind(str);
+        if ( it != stringIndex.constEnd() ) {
+            return it.value();
+        }
+        strings.append(str);
+        stringIndex.insert(str, strings.count() - 1);
+        return strings.count() - 1;
+    }
+    int count() const {
+        return nodeNumber.count() + edgeSource.count();
     }
 };
 
 
+/**
+ * @brief The EdgeListAppendState struct
+ * What an edge list load leaves behind, so that the lines appended to the
+ * file later can be read without loading it again: how far the file was
+ * parsed, a checksum of the bytes just before that offset, and the number
+ * given to every node token. Simple lists also keep the weight of each
+ * edge, as repeated edges add to it.
+ * Handed to Graph with Parser::edgeListStateReady, and back to a new
+ * Parser with Parser::setEdgeListState.
+ */
+struct EdgeListAppendState {
+    QString fileName;
+    int fileType;                       // EDGELIST_WEIGHTED or EDGELIST_SIMPLE
+    QString delimiter;
+    QString codecName;
+    qint64 offset;                      // bytes parsed, whole lines only
+    quint16 checksum;                   // of the bytes before offset
+    int lines;
+    bool nodesWithLabels;
+    int maxNodeNumber;
+    QHash<QByteArray, int> nodeNumber;  // node token -> node number
+    QSet<int> nodeNumbers;
+    QHash<quint64, qreal> edgeWeight;   // (source, target) -> weight, simple lists
+};
+
+
 /**
  * @brief The Parser class
  * Main class for network file parsing and loading
@@ -94,10 +227,20 @@ public:
 	bool loadGML();
 	bool loadGW();
 	bool loadDL();
+    bool loadDLFullMatrix(QTextStream &ts, const QString &firstLine);
     bool readDLKeywords(QStringList &strList, int &N, int &NM, int &NR, int &NC, bool &fullmatrixFormat, bool &edgelist1Format);
 
     bool loadEdgeListSimple(const QString &delimiter);
     bool loadEdgeListWeighed(const QString &delimiter);
+    bool loadEdgeList(const QString &delimiter, const bool &weighted);
+    bool appendEdgeList();
+    bool fileReadFailed(const NetworkFile &file);
+    void setEdgeListState(EdgeListAppendState *state);
+    bool scanEdgeList(const char *data, const qint64 &size,
+                      const QByteArray &delim, const bool &weighted,
+                      EdgeListScan &scan) const;
+    void mergeEdgeListScan(EdgeListScan &scan, const EdgeListScan &chunk,
+                           const bool &weighted) const;
 	bool loadTwoModeSociomatrix();
 
     void readDotProperties(QString str, qreal &, QString &label,
@@ -124,33 +267,38 @@ public:
 
     void loadFileError(const QString &errorMessage);
 
+    void batchNode( const int &num,
+                    const int &size,
+                    const QString &color,
+                    const QString &numColor,
+                    const int &numSize,
+                    const QString &label,
+                    const QString &lColor,
+                    const int &lSize,
+                    const QPointF &p,
+                    const QString &shape,
+                    const QString &iconPath=QString::null);
+    void batchEdge (const int &source, const int &target, const qreal &weight,
+                    const QString &color, const int &edgeDirType,
+                    const bool &arrows, const bool &bezier,
+                    const QString &edgeLabel=QString::null);
+    void batchFlush();
+
 signals:
 
     void addRelation( const QString & relName, const bool &changeRelation=false);
     void relationSet( int );
-    void createNode( const int &num,
-                     const int &size,
-                     const QString &color,
-                     const QString &numColor,
-                     const int &numSize,
-                     const QString &label,
-                     const QString &lColor,
-                     const int &lSize,
-                     const QPointF &p,
-                     const QString &shape,
-                     const QString &iconPath=QString::null,
-                     const bool &signalMW=false);
     void createNodeAtPosRandom(const bool &signalMW=false);
     void createNodeAtPosRandomWithLabel (const int &num,
                                          const QString &label,
                                          const bool &signalMW=false
                                          );
 
-    void edgeCreate (const int &source, const int &target, const qreal &weight,
-                     const QString &color, const int &edgeDirType,
-                     const bool &arrows, const bool &bezier,
-                     const QString &edgeLabel=QString::null,
-                     const bool &signalMW=false);
+    void batchReady(ParserBatch *batch);
+    void edgeListStateReady(EdgeListAppendState *state);
+    void networkFileAppended(const int &newNodes,
+                             const int &edges,
+                             const QString &message=QString::null);
     void networkFileLoaded(int fileType,
                            QString fileName,
                            QString netName,
@@ -168,10 +316,13 @@ protected:
 private: 
     QHash<QString, int> nodeHash;
 	QHash<QString, QString> keyFor, keyName, keyType, keyDefaultValue ;
+    QHash<QString, int> keyRole;
     QHash<QString, QString> edgesMissingNodesHash;
     QStringList edgeMissingNodesList,edgeMissingNodesListData, relationsList;
-	QMultiMap<int, int> firstModeMultiMap, secondModeMultiMap;
 	QXmlStreamReader *xml;
+    ParserBatch *m_batch;
+    bool m_batchUpdatesEdgeWeights;
+    EdgeListAppendState *m_edgeListState;
     QString fileName;
     QString fileDirPath;
     QString userSelectedCodecName;